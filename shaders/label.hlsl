@@ -0,0 +1,71 @@
+// SDF text billboards, one instance per label and six vertices per glyph slot
+#include "label_common.hlsli"
+
+[[vk::binding(2, 0)]] StructuredBuffer<uint> glyphString;
+[[vk::binding(3, 0)]] StructuredBuffer<GlyphInfo> glyphs;
+[[vk::binding(4, 0)]] StructuredBuffer<uint> visibility;
+[[vk::binding(6, 0)]] Texture2D<float> atlas;
+[[vk::binding(7, 0)]] SamplerState atlasSampler;
+
+// Screen offset of the label from its anchor, in pixels
+static const float2 LABEL_OFFSET = float2(10.0, 0.0);
+
+// Quad corners for two triangles
+static const float2 CORNERS[6] = {
+    float2(0.0, 0.0), float2(1.0, 0.0), float2(0.0, 1.0),
+    float2(1.0, 0.0), float2(1.0, 1.0), float2(0.0, 1.0)
+};
+
+struct VSOutput {
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+// Vertex Shader
+VSOutput VSMain(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID) {
+    VSOutput output;
+
+    // Unused glyph slots and decluttered labels collapse outside the clip volume
+    output.position = float4(0.0, 0.0, 2.0, 1.0);
+    output.uv = float2(0.0, 0.0);
+
+    LabelInstance label = labels[instanceId];
+    uint glyphSlot = vertexId / 6;
+    if (glyphSlot >= label.length || visibility[instanceId] == 0)
+        return output;
+
+    // Each string entry holds the glyph code and the pen position in quarter pixels
+    uint entry = glyphString[label.stringOffset + glyphSlot];
+    GlyphInfo glyph = glyphs[entry & 0xFFFF];
+    float penX = float(entry >> 16) * 0.25;
+
+    float2 corner = CORNERS[vertexId % 6];
+    float2 pixel = lerp(glyph.quad.xy, glyph.quad.zw, corner);
+    pixel.x += penX;
+
+    // Offset the projected anchor in screen space so the text always faces the camera
+    float4 clip = mul(pc.viewProjection, float4(anchors[label.anchorIndex].xyz, 1.0));
+    float2 offset = (pixel * pc.pixelScale + LABEL_OFFSET) * 2.0 / pc.viewportSize;
+
+    output.position = float4(clip.xy + offset * clip.w, clip.z, clip.w);
+    output.uv = lerp(glyph.uvRect.xy, glyph.uvRect.zw, corner);
+
+    return output;
+}
+
+// Pixel Shader
+float4 PSMain(VSOutput input) : SV_TARGET {
+    // 0.5 is the glyph edge in the distance field
+    float distance = atlas.Sample(atlasSampler, input.uv);
+    float width = max(fwidth(distance), 0.0001);
+
+    // Light text with a dark outline so labels stay readable over the Earth
+    float fill = smoothstep(0.5 - width, 0.5 + width, distance);
+    float outline = smoothstep(0.3 - width, 0.3 + width, distance);
+
+    if (outline < 0.01)
+        discard;
+
+    float3 color = lerp(float3(0.0, 0.0, 0.0), float3(0.9, 0.95, 1.0), fill);
+    return float4(color, outline);
+}
@@ -0,0 +1,29 @@
+// Shared declarations for the label declutter and billboard shaders.
+// Bindings and layouts must match LabelRenderer (src/vulkan/label_renderer.cpp).
+
+struct LabelInstance {
+    uint anchorIndex;   // Index into the anchor buffer
+    uint stringOffset;  // First entry in the glyph string buffer
+    uint length;        // Number of glyphs in the label
+    uint padding;
+};
+
+struct GlyphInfo {
+    float4 uvRect;      // u0, v0, u1, v1 in the atlas
+    float4 quad;        // x0, y0, x1, y1 in font pixels relative to the pen
+};
+
+struct PushConstants {
+    float4x4 viewProjection;
+    float2 viewportSize;
+    float2 cellSize;
+    uint labelCount;
+    uint gridWidth;
+    uint gridHeight;
+    float pixelScale;
+};
+
+[[vk::push_constant]] PushConstants pc;
+
+[[vk::binding(0, 0)]] StructuredBuffer<float4> anchors;
+[[vk::binding(1, 0)]] StructuredBuffer<LabelInstance> labels;
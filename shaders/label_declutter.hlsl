@@ -0,0 +1,56 @@
+// Screen-space label decluttering.
+//
+// The screen is divided into cells roughly the size of one label. Every visible
+// label tries to claim the cell its anchor projects into (CSClaim); the nearest
+// label wins. A second pass (CSResolve) marks the winners as visible.
+#include "label_common.hlsli"
+
+[[vk::binding(4, 0)]] RWStructuredBuffer<uint> visibility;
+[[vk::binding(5, 0)]] RWStructuredBuffer<uint> grid;
+
+// Projects a label anchor and returns its grid cell and claim key.
+// Returns false when the anchor is behind the camera or off screen.
+bool projectLabel(uint labelIndex, out uint cell, out uint key) {
+    cell = 0;
+    key = 0;
+
+    float4 clip = mul(pc.viewProjection, float4(anchors[labels[labelIndex].anchorIndex].xyz, 1.0));
+    if (clip.w <= 0.0)
+        return false;
+
+    float3 ndc = clip.xyz / clip.w;
+    if (any(abs(ndc.xy) > 1.0) || ndc.z < 0.0 || ndc.z > 1.0)
+        return false;
+
+    float2 pixel = (ndc.xy * 0.5 + 0.5) * pc.viewportSize;
+    uint2 cellCoord = min(uint2(pixel / pc.cellSize), uint2(pc.gridWidth - 1, pc.gridHeight - 1));
+    cell = cellCoord.y * pc.gridWidth + cellCoord.x;
+
+    // Nearer labels win: quantized depth in the high bits, label index breaks ties
+    key = (uint(ndc.z * 1023.0) << 22) | (labelIndex & 0x3FFFFF);
+    return true;
+}
+
+[numthreads(64, 1, 1)]
+void CSClaim(uint3 id : SV_DispatchThreadID) {
+    if (id.x >= pc.labelCount)
+        return;
+
+    uint cell;
+    uint key;
+    if (projectLabel(id.x, cell, key)) {
+        uint previous;
+        InterlockedMin(grid[cell], key, previous);
+    }
+}
+
+[numthreads(64, 1, 1)]
+void CSResolve(uint3 id : SV_DispatchThreadID) {
+    if (id.x >= pc.labelCount)
+        return;
+
+    uint cell;
+    uint key;
+    bool onScreen = projectLabel(id.x, cell, key);
+    visibility[id.x] = (onScreen && grid[cell] == key) ? 1 : 0;
+}
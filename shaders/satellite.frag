@@ -3,13 +3,24 @@
 // Output color
 layout(location = 0) out vec4 outColor;
 
+// Point parameters
+layout(push_constant) uniform PointParams {
+    vec2 viewportSize;
+    float pointSize;
+    uint smoothEdges;
+} pc;
+
 void main() {
     // Calculate distance from center of point
     vec2 center = gl_PointCoord - vec2(0.5);
     float dist = length(center);
     
-    // Create a circular point with soft edges
-    float alpha = 1.0 - smoothstep(0.4, 0.5, dist);
+    // Analytic coverage of the disc edge (one pixel wide ramp), or a hard edge
+    float pixelDist = dist * pc.pointSize;
+    float radius = pc.pointSize * 0.5;
+    float alpha = (pc.smoothEdges != 0u)
+        ? clamp(radius - pixelDist + 0.5, 0.0, 1.0)
+        : (pixelDist <= radius ? 1.0 : 0.0);
     
     // Set the satellite color (bright white/yellow)
     outColor = vec4(1.0, 0.9, 0.5, alpha);
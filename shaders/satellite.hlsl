@@ -5,7 +5,8 @@ struct VSInput {
 
 struct VSOutput {
     float4 position : SV_POSITION;
-    float pointSize : PSIZE;
+    [[vk::builtin("PointSize")]] float pointSize : PSIZE;
+    nointerpolation float2 center : TEXCOORD0;  // Point center in pixels
 };
 
 cbuffer UniformBufferObject : register(b0) {
@@ -14,6 +15,15 @@ cbuffer UniformBufferObject : register(b0) {
     float4x4 proj;
 };
 
+// Point parameters
+struct PointParams {
+    float2 viewportSize;
+    float pointSize;
+    uint smoothEdges;  // Analytic edge coverage (also used for alpha-to-coverage under MSAA)
+};
+
+[[vk::push_constant]] PointParams pc;
+
 VSOutput VSMain(VSInput input) {
     VSOutput output;
     
@@ -21,30 +31,32 @@ VSOutput VSMain(VSInput input) {
     output.position = mul(proj, mul(view, mul(model, float4(input.position, 1.0))));
     
     // Set the point size for the satellite
-    output.pointSize = 10.0;
+    output.pointSize = pc.pointSize;
+    
+    // Project the point center to pixels so the pixel shader can measure its distance
+    output.center = (output.position.xy / output.position.w * 0.5 + 0.5) * pc.viewportSize;
     
     return output;
 }
 
 // Pixel Shader
-float4 PSMain(VSOutput input, float2 pointCoord : SV_Position) : SV_TARGET {
-    // In HLSL for Vulkan via SPIR-V, we can access the point coordinates
-    // via a system-generated value during rasterization
+float4 PSMain(VSOutput input) : SV_TARGET {
+    // Distance from the point center in pixels
+    float radius = pc.pointSize * 0.5;
+    float pixelDist = length(input.position.xy - input.center);
     
-    // Calculate center-relative coordinates
-    float2 uv = pointCoord.xy; 
-    
-    // Calculate distance from center (using normalized device coordinates)
-    float2 center = float2(0.5, 0.5);
-    float dist = length(uv - center) * 2.0;  
-    
-    // Create a circular point with soft edges
-    float alpha = 1.0 - smoothstep(0.4, 0.5, dist);
+    // Analytic coverage of the disc edge (one pixel wide ramp), or a hard edge
+    float alpha = (pc.smoothEdges != 0)
+        ? saturate(radius - pixelDist + 0.5)
+        : (pixelDist <= radius ? 1.0 : 0.0);
     
     // Discard pixels outside the circle
     if (alpha < 0.01)
         discard;
     
+    // Normalized distance for the glow
+    float dist = pixelDist / radius * 0.5;
+    
     // Set the satellite color (bright white/yellow)
     float4 color = float4(1.0, 0.9, 0.5, alpha);
     
@@ -10,10 +10,17 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+// Point parameters
+layout(push_constant) uniform PointParams {
+    vec2 viewportSize;
+    float pointSize;
+    uint smoothEdges;
+} pc;
+
 void main() {
     // Transform the satellite position to clip space
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
     
     // Set the point size (satellite will be rendered as a point)
-    gl_PointSize = 10.0;
+    gl_PointSize = pc.pointSize;
 }
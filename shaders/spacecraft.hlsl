@@ -0,0 +1,65 @@
+// Oriented spacecraft models, one instance per object, vertices pulled from the model buffer
+struct PushConstants {
+    float4x4 viewProjection;
+    float4 nodeRows[3];     // Node-to-body affine transform, row by row
+    uint positionOffset;    // Byte offsets into modelData
+    uint normalOffset;
+    uint strides;           // Position stride in the low 16 bits, normal stride in the high
+    uint color;             // Base color as RGBA8
+};
+
+[[vk::push_constant]] PushConstants pc;
+
+// Vertex and index data of the whole model, in its file layout
+[[vk::binding(0, 0)]] ByteAddressBuffer modelData;
+
+// Same light as the Earth shader, so the models are lit from the Earth's bright side
+static const float3 LIGHT_DIRECTION = float3(0.57735, 0.57735, 0.57735);
+
+struct VSInput {
+    [[vk::location(0)]] float4 instancePosition : TEXCOORD0;  // World position, model scale in w
+    [[vk::location(1)]] float4 orientation : TEXCOORD1;       // Body-to-world quaternion (x, y, z, w)
+    uint vertexIndex : SV_VertexID;
+};
+
+struct VSOutput {
+    float4 position : SV_POSITION;
+    float3 normal : NORMAL;
+};
+
+// Rotates a body-axis vector into the world by a unit quaternion
+float3 rotate(float4 q, float3 v) {
+    float3 t = 2.0 * cross(q.xyz, v);
+    return v + q.w * t + cross(q.xyz, t);
+}
+
+// Vertex Shader
+VSOutput VSMain(VSInput input) {
+    VSOutput output;
+
+    float3 position = asfloat(modelData.Load3(pc.positionOffset + input.vertexIndex * (pc.strides & 0xFFFF)));
+    float3 normal = asfloat(modelData.Load3(pc.normalOffset + input.vertexIndex * (pc.strides >> 16)));
+
+    // Node transform into body axes; normals use its linear part, exact for rotation and uniform scale
+    float3 body = float3(dot(pc.nodeRows[0], float4(position, 1.0)),
+                         dot(pc.nodeRows[1], float4(position, 1.0)),
+                         dot(pc.nodeRows[2], float4(position, 1.0)));
+    float3 bodyNormal = float3(dot(pc.nodeRows[0].xyz, normal),
+                               dot(pc.nodeRows[1].xyz, normal),
+                               dot(pc.nodeRows[2].xyz, normal));
+
+    float3 world = input.instancePosition.xyz + input.instancePosition.w * rotate(input.orientation, body);
+    output.position = mul(pc.viewProjection, float4(world, 1.0));
+    output.normal = rotate(input.orientation, bodyNormal);
+
+    return output;
+}
+
+// Pixel Shader
+float4 PSMain(VSOutput input) : SV_TARGET {
+    float3 color = float3(pc.color & 0xFF, (pc.color >> 8) & 0xFF, (pc.color >> 16) & 0xFF) / 255.0;
+
+    // Lambert with enough ambient to keep the unlit side readable
+    float diffuse = max(dot(normalize(input.normal), LIGHT_DIRECTION), 0.0);
+    return float4(color * (0.3 + 0.7 * diffuse), 1.0);
+}
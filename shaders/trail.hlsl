@@ -0,0 +1,82 @@
+// Fading orbit trails read from the GPU history ring, one instance per object
+struct PushConstants {
+    float4x4 viewProjection;
+    float4 color;
+    uint objectCount;
+    uint trailLength;
+    uint head;
+    uint validCount;
+    float2 viewportSize;
+    float lineWidth;  // Ribbon width in pixels (analytic antialiasing)
+    float padding;
+};
+
+[[vk::push_constant]] PushConstants pc;
+
+// Slot-major history: ring[slot * objectCount + object]
+[[vk::binding(0, 0)]] StructuredBuffer<float4> ring;
+
+struct VSOutput {
+    float4 position : SV_POSITION;
+    float alpha : TEXCOORD0;
+    float edge : TEXCOORD1;  // Signed distance from the ribbon center in pixels
+};
+
+// Clip-space position of the sample that is 'age' ticks old
+float4 projectSample(uint age, uint object) {
+    uint slot = (pc.head + pc.trailLength - age) % pc.trailLength;
+    float3 position = ring[slot * pc.objectCount + object].xyz;
+    return mul(pc.viewProjection, float4(position, 1.0));
+}
+
+float ageFade(uint age) {
+    return 1.0 - float(age) / float(max(pc.validCount - 1, 1));
+}
+
+// Vertex Shader (hardware line strip)
+VSOutput VSMain(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID) {
+    VSOutput output;
+
+    // Vertex k is the k-th newest sample, walking backwards from the head
+    output.position = projectSample(vertexId, instanceId);
+    output.alpha = ageFade(vertexId);
+    output.edge = 0.0;
+
+    return output;
+}
+
+// Vertex Shader (triangle-strip ribbon, two vertices per sample)
+VSOutput VSMainSmooth(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID) {
+    VSOutput output;
+
+    uint age = vertexId / 2;
+    float side = (vertexId & 1) ? 1.0 : -1.0;
+
+    // Direction along the trail in pixels, always pointing towards older samples
+    float4 clip = projectSample(age, instanceId);
+    bool hasOlder = age + 1 < pc.validCount;
+    float4 neighbour = projectSample(hasOlder ? age + 1 : age - 1, instanceId);
+
+    float2 screen = clip.xy / clip.w * pc.viewportSize * 0.5;
+    float2 neighbourScreen = neighbour.xy / neighbour.w * pc.viewportSize * 0.5;
+    float2 direction = hasOlder ? neighbourScreen - screen : screen - neighbourScreen;
+    direction = (dot(direction, direction) > 1e-8) ? normalize(direction) : float2(1.0, 0.0);
+
+    // Widen by one extra pixel so the pixel shader has room for the coverage ramp
+    float halfExtent = pc.lineWidth * 0.5 + 1.0;
+    float2 normal = float2(-direction.y, direction.x);
+    clip.xy += normal * side * halfExtent * 2.0 / pc.viewportSize * clip.w;
+
+    output.position = clip;
+    output.alpha = ageFade(age);
+    output.edge = side * halfExtent;
+
+    return output;
+}
+
+// Pixel Shader
+float4 PSMain(VSOutput input) : SV_TARGET {
+    // Analytic edge coverage; hardware lines have edge == 0 and stay fully covered
+    float coverage = saturate(pc.lineWidth * 0.5 + 0.5 - abs(input.edge));
+    return float4(pc.color.rgb, pc.color.a * input.alpha * coverage);
+}
@@ -1,8 +1,17 @@
 #include "application.h"
+#include "vulkan/gpu_profiler.h"
+#include "vulkan/spacecraft_renderer.h"
+#include "orbit/orbit_kernels.h"
+#include "orbit/reference_frames.h"
+#include "orbit/relative_motion.h"
 #include <GLFW/glfw3.h>
 #include <stdexcept>
 #include <iostream>
 #include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <filesystem>
+#include <algorithm>
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <imgui.h>
@@ -12,6 +21,24 @@ static void glfwErrorCallback(int error, const char* description) {
     std::cerr << "GLFW Error " << error << ": " << description << std::endl;
 }
 
+// IERS data files, looked up relative to the working directory
+static const char* const LEAP_SECOND_FILE = "data/Leap_Second.dat";
+static const char* const EARTH_ORIENTATION_FILE = "data/finals2000A.all";
+
+// Frames still drawn after the last event, so ImGui can settle hover and active states
+static constexpr int REDRAW_FRAMES = 3;
+
+// Longest sleep while idle before the loop checks its state again
+static constexpr double IDLE_WAIT_SECONDS = 0.25;
+
+// Any window event may change what is on screen
+static void redrawCallback(GLFWwindow* window) {
+    Application* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+    if (app) {
+        app->requestRedraw();
+    }
+}
+
 // Mouse scroll callback for zooming
 static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
     // Retrieve the Application instance from user pointer
@@ -23,7 +50,7 @@ static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
 }
 
 Application::Application() 
-    : m_running(true), m_timeMultiplier(1.0f), m_lastFrameTime(0.0),
+    : m_running(true), m_timeMultiplier(1.0f), m_lastFrameTime(0.0), m_epoch(0),
       m_cameraPosition(0.0f, 0.0f, 15.0f), m_cameraTarget(0.0f, 0.0f, 0.0f),
       m_cameraDistance(15.0f), m_cameraYaw(0.0f), m_cameraPitch(0.0f),
       m_mousePressed(false), m_lastMouseX(0.0), m_lastMouseY(0.0) {
@@ -51,17 +78,48 @@ Application::Application()
     // Set scroll callback
     glfwSetScrollCallback(m_window, scrollCallback);
     
+    // Wake the render loop on input and window changes. Installed before ImGui,
+    // which chains to these callbacks from its own.
+    glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double, double) { redrawCallback(window); });
+    glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int, int, int) { redrawCallback(window); });
+    glfwSetKeyCallback(m_window, [](GLFWwindow* window, int, int, int, int) { redrawCallback(window); });
+    glfwSetCharCallback(m_window, [](GLFWwindow* window, unsigned int) { redrawCallback(window); });
+    glfwSetWindowFocusCallback(m_window, [](GLFWwindow* window, int) { redrawCallback(window); });
+    glfwSetCursorEnterCallback(m_window, [](GLFWwindow* window, int) { redrawCallback(window); });
+    glfwSetFramebufferSizeCallback(m_window, [](GLFWwindow* window, int, int) { redrawCallback(window); });
+    glfwSetWindowIconifyCallback(m_window, [](GLFWwindow* window, int) { redrawCallback(window); });
+    glfwSetWindowRefreshCallback(m_window, redrawCallback);
+    
     // Initialize renderer first (sets up Vulkan)
     m_renderer = std::make_unique<Renderer>(m_window);
     
     // Initialize ImGui after renderer
     m_uiManager = std::make_unique<ImGuiManager>(m_window, m_renderer.get());
     
-    // Initialize orbital mechanics
+    // Initialize orbital mechanics, selecting the CPU kernel variant once up front
+    std::cout << "Orbit kernels: " << cpuIsaName(getOrbitKernels().isa) << std::endl;
     m_orbitalMechanics = std::make_unique<OrbitalMechanics>();
+    m_orbitSnapshot.store(captureSnapshot(*m_orbitalMechanics));
+    
+    // Name the simulated objects for the label renderer
+    updateLabelStress();
+    
+    // Leap seconds and Earth orientation from IERS files when present; the built-in
+    // leap second table and zero dUT1 are used otherwise
+    if (std::filesystem::exists(LEAP_SECOND_FILE)) {
+        m_timeScales.loadLeapSeconds(LEAP_SECOND_FILE);
+    }
+    if (std::filesystem::exists(EARTH_ORIENTATION_FILE)) {
+        m_timeScales.loadEarthOrientation(EARTH_ORIENTATION_FILE);
+    }
     
-    // Set initial time
+    // Set initial time; the simulation epoch starts at the system clock
     m_lastFrameTime = glfwGetTime();
+    double unixSeconds = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    m_epoch = epochFromUnixSeconds(unixSeconds);
+    m_usageWindowStart = m_lastFrameTime;
+    m_usageCpuStart = std::clock();
+    requestRedraw();
 }
 
 Application::~Application() {
@@ -78,6 +136,17 @@ Application::~Application() {
 
 void Application::run() {
     while (m_running && !glfwWindowShouldClose(m_window)) {
+        // Nothing would change on screen: sleep until an event arrives instead of
+        // drawing identical frames
+        if (isIdle()) {
+            glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+            updateUsageStats();
+            if (isIdle()) {
+                m_lastFrameTime = glfwGetTime();
+                continue;
+            }
+        }
+        
         // Calculate delta time
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - m_lastFrameTime);
@@ -92,10 +161,15 @@ void Application::run() {
         processInput();
         
         // Update simulation
-        update(deltaTime * m_timeMultiplier);
+        update(m_paused ? 0.0f : deltaTime * m_timeMultiplier);
         
         // Render frame
         render();
+        m_usageFrames++;
+        updateUsageStats();
+        if (m_pendingFrames > 0) {
+            m_pendingFrames--;
+        }
         
         // Poll for events
         glfwPollEvents();
@@ -144,35 +218,156 @@ void Application::processInput() {
 
 void Application::handleMouseScroll(double yoffset) {
     // Handle mouse scroll for zoom
-    m_cameraDistance -= static_cast<float>(yoffset) * 0.5f;
-    
-    // Clamp distance to reasonable values
-    if (m_cameraDistance < 7.0f) m_cameraDistance = 7.0f;
-    if (m_cameraDistance > 50.0f) m_cameraDistance = 50.0f;
+    if (m_cameraFrame == CameraFrame::ChiefLvlh) {
+        // Close to the satellite a fixed step is too coarse; zoom by a factor instead
+        m_chiefCameraDistance *= std::pow(0.9f, static_cast<float>(yoffset));
+        m_chiefCameraDistance = std::clamp(m_chiefCameraDistance, 0.2f, 10.0f);
+    } else {
+        m_cameraDistance -= static_cast<float>(yoffset) * 0.5f;
+        
+        // Clamp distance to reasonable values
+        if (m_cameraDistance < 7.0f) m_cameraDistance = 7.0f;
+        if (m_cameraDistance > 50.0f) m_cameraDistance = 50.0f;
+    }
     
     // Update camera position
     updateCamera();
+    requestRedraw();
+}
+
+void Application::requestRedraw() {
+    m_pendingFrames = REDRAW_FRAMES;
+}
+
+bool Application::isIdle() const {
+    return m_renderOnDemand && m_paused && m_pendingFrames == 0 && m_unsentCommands.empty();
+}
+
+void Application::updateUsageStats() {
+    double now = glfwGetTime();
+    double elapsed = now - m_usageWindowStart;
+    if (elapsed < 1.0) {
+        return;
+    }
+    
+    std::clock_t cpuNow = std::clock();
+    double cpuSeconds = static_cast<double>(cpuNow - m_usageCpuStart) / CLOCKS_PER_SEC;
+    m_cpuUsage = static_cast<float>(100.0 * cpuSeconds / elapsed);
+    m_framesPerSecond = static_cast<float>(m_usageFrames / elapsed);
+    
+    m_usageWindowStart = now;
+    m_usageCpuStart = cpuNow;
+    m_usageFrames = 0;
 }
 
 void Application::update(float deltaTime) {
+    // Apply the UI's parameter changes at the tick boundary
+    OrbitalMechanics* objects[] = {m_orbitalMechanics.get()};
+    if (m_commands.drain(objects, 1) > 0) {
+        requestRedraw();
+    }
+    
     // Update orbital mechanics
     m_orbitalMechanics->update(deltaTime);
+    
+    // Publish the tick's parameters and state; the UI only reads this copy
+    OrbitSnapshot snapshot = captureSnapshot(*m_orbitalMechanics);
+    m_orbitSnapshot.store(snapshot);
+    
+    // Earth orientation follows the simulation clock, so it pauses and speeds up with it
+    m_epoch += static_cast<Epoch>(std::llround(static_cast<double>(deltaTime) * 1e9));
+    Epoch ut1 = m_timeScales.convert(m_epoch, TimeScale::Utc, TimeScale::Ut1);
+    m_renderer->setEarthRotationAngle(static_cast<float>(earthRotationAngle(epochDays(ut1))));
+    
+    // One trail sample per simulation tick; a paused simulation adds none
+    if (deltaTime > 0.0f) {
+        m_renderer->pushTrailSample({snapshot.position});
+    }
+    
+    // A camera riding with the satellite follows it in the same tick, or it would lag a frame
+    if (m_cameraFrame == CameraFrame::ChiefLvlh) {
+        updateCamera();
+    }
+}
+
+void Application::updateLabelStress() {
+    std::vector<std::string> names = {"Satellite"};
+    m_labelAnchors.assign(1, m_orbitSnapshot.load().position);
+    
+    // Fibonacci points over spherical shells from 1.1 to 1.9 Earth radii, so the labels
+    // spread over the whole view and crowd each other like a real catalog
+    const float goldenAngle = glm::pi<float>() * (3.0f - std::sqrt(5.0f));
+    for (int i = 0; i < m_labelStressCount; i++) {
+        float y = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(m_labelStressCount);
+        float ring = std::sqrt(1.0f - y * y);
+        float angle = goldenAngle * static_cast<float>(i);
+        float radius = 7.0f + 5.0f * static_cast<float>((i * 7919) % 1000) / 1000.0f;
+        m_labelAnchors.push_back(radius * glm::vec3(ring * std::cos(angle), y, ring * std::sin(angle)));
+        
+        char name[16];
+        std::snprintf(name, sizeof(name), "Object %05d", i + 1);
+        names.push_back(name);
+    }
+    
+    m_renderer->setLabels(names);
 }
 
 void Application::render() {
+    // Apply a new MSAA setting between frames (it rebuilds the render pass and the UI backend)
+    if (m_msaaSamples != static_cast<int>(m_renderer->getMsaaSamples())) {
+        m_renderer->setMsaaSamples(static_cast<VkSampleCountFlagBits>(m_msaaSamples));
+        m_uiManager->recreateVulkanBackend();
+        m_msaaSamples = static_cast<int>(m_renderer->getMsaaSamples());
+    }
+    
+    // Likewise a new trail length, which replaces the ring buffer the frame draws from
+    if (static_cast<uint32_t>(m_trailLength) != m_renderer->getTrailLength()) {
+        m_renderer->setTrailLength(static_cast<uint32_t>(m_trailLength));
+    }
+    
+    // And a new number of synthetic labels, which rewrites the shared label buffers
+    if (static_cast<size_t>(m_labelStressCount) + 1 != m_labelAnchors.size()) {
+        updateLabelStress();
+    }
+    
+    // Everything shown this frame comes from the state the simulation last published
+    OrbitSnapshot orbit = m_orbitSnapshot.load();
+    glm::vec3 satellitePosition = orbit.position;
+    
+    // Label anchors must be known before the frame starts (declutter runs first)
+    m_labelAnchors[0] = satellitePosition;
+    m_renderer->setLabelsEnabled(m_showLabels);
+    m_renderer->setLabelAnchors(m_labelAnchors);
+    m_renderer->setTrailsEnabled(m_showTrails);
+    
+    // Spacecraft models are uploaded at the start of the frame as well
+    std::vector<SpacecraftInstance> spacecraft;
+    if (m_showSpacecraftModel) {
+        spacecraft.push_back({glm::vec4(satellitePosition, m_spacecraftScale),
+                              orbit.attitude});
+    }
+    m_renderer->setSpacecraftInstances(spacecraft);
+    
     // Begin frame
     if (!m_renderer->beginFrame()) {
         return; // Frame was skipped (e.g., window minimized)
     }
     
-    // Get satellite position from orbital mechanics
-    glm::vec3 satellitePosition = m_orbitalMechanics->getSatellitePosition();
-    
     // Draw the Earth
     m_renderer->drawEarth();
     
-    // Draw the satellite
-    m_renderer->drawSatellite(satellitePosition);
+    // Draw the orbit trails behind the satellite
+    m_renderer->drawTrails();
+    
+    // Draw the satellite, as an oriented model or as a point
+    if (m_showSpacecraftModel) {
+        m_renderer->drawSpacecraft();
+    } else {
+        m_renderer->drawSatellite(satellitePosition);
+    }
+    
+    // Draw the object labels
+    m_renderer->drawLabels();
     
     // Render ImGui UI
     m_uiManager->beginFrame();
@@ -186,60 +381,106 @@ void Application::render() {
     if (ImGui::Button("Reset Time")) {
         m_timeMultiplier = 1.0f;
     }
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &m_paused);
+    ImGui::Checkbox("Render On Demand When Paused", &m_renderOnDemand);
     
     // Camera controls
     ImGui::Separator();
     ImGui::Text("Camera Controls");
-    ImGui::SliderFloat("Distance", &m_cameraDistance, 7.0f, 50.0f);
+    const char* frameLabels[] = {"Inertial", "Chief LVLH"};
+    int frameIndex = static_cast<int>(m_cameraFrame);
+    if (ImGui::Combo("Frame", &frameIndex, frameLabels, 2)) {
+        m_cameraFrame = static_cast<CameraFrame>(frameIndex);
+        updateCamera();
+    }
+    if (m_cameraFrame == CameraFrame::ChiefLvlh) {
+        ImGui::SliderFloat("Distance", &m_chiefCameraDistance, 0.2f, 10.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    } else {
+        ImGui::SliderFloat("Distance", &m_cameraDistance, 7.0f, 50.0f);
+    }
     ImGui::SliderFloat("Yaw", &m_cameraYaw, -180.0f, 180.0f);
     ImGui::SliderFloat("Pitch", &m_cameraPitch, -89.0f, 89.0f);
     if (ImGui::Button("Reset Camera")) {
         m_cameraDistance = 15.0f;
+        m_chiefCameraDistance = 1.0f;
         m_cameraYaw = 0.0f;
         m_cameraPitch = 0.0f;
         updateCamera();
     }
     
+    // Display options
+    ImGui::Separator();
+    ImGui::Text("Display");
+    ImGui::Checkbox("Show Labels", &m_showLabels);
+    if (m_showLabels) {
+        ImGui::SliderInt("Stress Labels", &m_labelStressCount, 0, 20000);
+    }
+    ImGui::Checkbox("Show Trails", &m_showTrails);
+    ImGui::Checkbox("Show Spacecraft Model", &m_showSpacecraftModel);
+    if (m_showSpacecraftModel) {
+        ImGui::SliderFloat("Model Scale", &m_spacecraftScale, 0.01f, 1.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    }
+    ImGui::SliderInt("Trail Length", &m_trailLength, 16, 1024);
+    
+    // Antialiasing: MSAA sample count and the cheaper shader-based point/line smoothing
+    const char* msaaLabels[] = {"Off", "2x", "4x", "8x"};
+    int msaaIndex = 0;
+    while ((2 << msaaIndex) <= m_msaaSamples && msaaIndex < 3) {
+        msaaIndex++;
+    }
+    int maxMsaaIndex = 0;
+    while ((2 << maxMsaaIndex) <= static_cast<int>(m_renderer->getMaxMsaaSamples()) && maxMsaaIndex < 3) {
+        maxMsaaIndex++;
+    }
+    if (ImGui::Combo("MSAA", &msaaIndex, msaaLabels, maxMsaaIndex + 1)) {
+        m_msaaSamples = 1 << msaaIndex;
+    }
+    bool analyticAntialiasing = m_renderer->isAnalyticAntialiasing();
+    if (ImGui::Checkbox("Analytic Line/Point AA", &analyticAntialiasing)) {
+        m_renderer->setAnalyticAntialiasing(analyticAntialiasing);
+    }
+    
     // Orbit parameters
     ImGui::Separator();
     ImGui::Text("Orbital Elements");
     
-    // Get current values
-    float semimajorAxis = m_orbitalMechanics->getSemimajorAxis();
-    float eccentricity = m_orbitalMechanics->getEccentricity();
-    float inclination = m_orbitalMechanics->getInclination();
-    float argOfPeriapsis = m_orbitalMechanics->getArgumentOfPeriapsis();
-    float longAscNode = m_orbitalMechanics->getLongitudeOfAscendingNode();
+    // Get current values, as published by the simulation
+    float semimajorAxis = orbit.semimajorAxis;
+    float eccentricity = orbit.eccentricity;
+    float inclination = orbit.inclination;
+    float argOfPeriapsis = orbit.argumentOfPeriapsis;
+    float longAscNode = orbit.longitudeOfAscendingNode;
     
     // Semi-major axis (orbit size)
     if (ImGui::SliderFloat("Semi-major Axis", &semimajorAxis, 8.0f, 20.0f, "%.1f")) {
-        m_orbitalMechanics->setSemimajorAxis(semimajorAxis);
+        sendCommand(SimulationCommandType::SetSemimajorAxis, semimajorAxis);
     }
     
     // Eccentricity (orbit shape)
     if (ImGui::SliderFloat("Eccentricity", &eccentricity, 0.0f, 0.9f, "%.2f")) {
-        m_orbitalMechanics->setEccentricity(eccentricity);
+        sendCommand(SimulationCommandType::SetEccentricity, eccentricity);
     }
     
     // Inclination (orbit tilt)
     if (ImGui::SliderFloat("Inclination", &inclination, 0.0f, 90.0f, "%.1f deg")) {
-        m_orbitalMechanics->setInclination(inclination);
+        sendCommand(SimulationCommandType::SetInclination, inclination);
     }
     
     // Argument of periapsis (orientation in orbit plane)
     if (ImGui::SliderFloat("Arg. of Periapsis", &argOfPeriapsis, 0.0f, 360.0f, "%.1f deg")) {
-        m_orbitalMechanics->setArgumentOfPeriapsis(argOfPeriapsis);
+        sendCommand(SimulationCommandType::SetArgumentOfPeriapsis, argOfPeriapsis);
     }
     
     // Longitude of ascending node (orbit plane orientation)
     if (ImGui::SliderFloat("Long. of Asc. Node", &longAscNode, 0.0f, 360.0f, "%.1f deg")) {
-        m_orbitalMechanics->setLongitudeOfAscendingNode(longAscNode);
+        sendCommand(SimulationCommandType::SetLongitudeOfAscendingNode, longAscNode);
     }
     
     // Orbital information section
     ImGui::Separator();
     ImGui::Text("Orbital Information");
-    ImGui::Text("Period: %.2f seconds", m_orbitalMechanics->getPeriod());
+    ImGui::Text("Period: %.2f seconds", orbit.period);
     ImGui::Text("Current Position: (%.2f, %.2f, %.2f)",
                satellitePosition.x, satellitePosition.y, satellitePosition.z);
     
@@ -251,13 +492,42 @@ void Application::render() {
     }
     
     if (ImGui::Button("Reset Orbit")) {
-        m_orbitalMechanics->setSemimajorAxis(12.0f);
-        m_orbitalMechanics->setEccentricity(0.3f);
-        m_orbitalMechanics->setInclination(30.0f);
-        m_orbitalMechanics->setArgumentOfPeriapsis(0.0f);
-        m_orbitalMechanics->setLongitudeOfAscendingNode(0.0f);
+        sendCommand(SimulationCommandType::ResetOrbit);
     }
     
+    // Frame timing and queue utilization (GPU busy time as a share of the frame)
+    ImGui::Separator();
+    ImGui::Text("Performance");
+    float frameTime = 1000.0f / std::max(ImGui::GetIO().Framerate, 1.0f);
+    ImGui::Text("Frame Time: %.2f ms", frameTime);
+    ImGui::Text("Process CPU: %.0f%% of a core, %.0f frames/s", m_cpuUsage, m_framesPerSecond);
+    ImGui::Text("Labels: %zu", m_labelAnchors.size());
+    
+    const GpuProfiler& profiler = m_renderer->getGpuProfiler();
+    if (profiler.isSupported()) {
+        for (uint32_t scope = 0; scope < profiler.getScopeCount(); scope++) {
+            float gpuTime = profiler.getScopeTime(scope);
+            ImGui::Text("%s: %.3f ms (%.0f%%)", profiler.getScopeName(scope).c_str(),
+                        gpuTime, 100.0f * gpuTime / frameTime);
+        }
+    } else {
+        ImGui::Text("GPU timestamps not supported");
+    }
+    
+    if (m_renderer->hasAsyncCompute()) {
+        bool asyncCompute = m_renderer->isAsyncComputeEnabled();
+        if (ImGui::Checkbox("Async Compute", &asyncCompute)) {
+            m_renderer->setAsyncComputeEnabled(asyncCompute);
+        }
+    } else {
+        ImGui::Text("Async Compute: unavailable (single queue)");
+    }
+    
+    ImGui::Text("CPU Kernels: %s", cpuIsaName(getOrbitKernels().isa));
+    ImGui::Text("Commands: %llu applied, %llu coalesced",
+                static_cast<unsigned long long>(m_commands.getAppliedCount()),
+                static_cast<unsigned long long>(m_commands.getCoalescedCount()));
+    
     ImGui::End();
     
     // Render controls for help and about
@@ -309,11 +579,45 @@ void Application::render() {
     m_renderer->endFrame();
 }
 
+void Application::sendCommand(SimulationCommandType type, float value) {
+    // Older commands first, so the simulation sees changes in the order they were made
+    m_unsentCommands.push_back({type, 0, value});
+    size_t sent = 0;
+    while (sent < m_unsentCommands.size() && m_commands.push(m_unsentCommands[sent])) {
+        sent++;
+    }
+    m_unsentCommands.erase(m_unsentCommands.begin(), m_unsentCommands.begin() + sent);
+}
+
 void Application::updateCamera() {
     // Convert spherical coordinates to Cartesian for camera position
     float yawRad = glm::radians(m_cameraYaw);
     float pitchRad = glm::radians(m_cameraPitch);
     
+    if (m_cameraFrame == CameraFrame::ChiefLvlh) {
+        // Same spherical angles about the satellite, in its RIC frame: yaw 0 looks along
+        // the in-track axis from behind, pitch raises the camera towards radial, which
+        // stays up on screen so the Earth is always below
+        OrbitSnapshot orbit = m_orbitSnapshot.load();
+        glm::vec3 position = orbit.position;
+        glm::vec3 velocity = orbit.velocity;
+        const double chiefPosition[3] = {position.x, position.y, position.z};
+        const double chiefVelocity[3] = {velocity.x, velocity.y, velocity.z};
+        double radial[3], inTrack[3], crossTrack[3];
+        relativeFrameAxes(chiefPosition, chiefVelocity, radial, inTrack, crossTrack);
+        glm::vec3 radialAxis(radial[0], radial[1], radial[2]);
+        glm::vec3 inTrackAxis(inTrack[0], inTrack[1], inTrack[2]);
+        glm::vec3 crossTrackAxis(crossTrack[0], crossTrack[1], crossTrack[2]);
+        
+        glm::vec3 offset = sin(pitchRad) * radialAxis - cos(pitchRad) * cos(yawRad) * inTrackAxis +
+                           cos(pitchRad) * sin(yawRad) * crossTrackAxis;
+        m_cameraTarget = position;
+        m_cameraPosition = position + m_chiefCameraDistance * offset;
+        m_renderer->updateCamera(m_cameraPosition, m_cameraTarget, radialAxis);
+        return;
+    }
+    
+    m_cameraTarget = glm::vec3(0.0f);
     m_cameraPosition.x = m_cameraDistance * cos(pitchRad) * cos(yawRad);
     m_cameraPosition.y = m_cameraDistance * sin(pitchRad);
     m_cameraPosition.z = m_cameraDistance * cos(pitchRad) * sin(yawRad);
@@ -3,9 +3,22 @@
 #include "vulkan/renderer.h"
 #include "ui/imgui_manager.h"
 #include "orbit/orbital_mechanics.h"
+#include "orbit/simulation_commands.h"
+#include "orbit/time_scales.h"
+#include "platform/seqlock.h"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include <ctime>
 #include <memory>
+#include <vector>
+
+/**
+ * Frame the camera orbits in.
+ */
+enum class CameraFrame : int {
+    Inertial,   // around the Earth, world up
+    ChiefLvlh   // around the satellite, in its radial/in-track/cross-track frame, radial up
+};
 
 /**
  * Main application class that manages the simulation.
@@ -37,6 +50,11 @@ public:
      * @param yoffset Vertical scroll offset
      */
     void handleMouseScroll(double yoffset);
+    
+    /**
+     * Render the next few frames even if the application is idle, e.g. after input.
+     */
+    void requestRedraw();
 
 private:
     /**
@@ -60,12 +78,57 @@ private:
      * Update camera position and orientation based on user input.
      */
     void updateCamera();
+    
+    /**
+     * Queue a change for the simulation to apply at its next tick.
+     * Commands that do not fit in the queue are kept and resent next frame.
+     * 
+     * @param type Change to make
+     * @param value New parameter value (ignored by object edits)
+     */
+    void sendCommand(SimulationCommandType type, float value = 0.0f);
+    
+    /**
+     * Check whether a frame would show nothing new: time is paused and no input,
+     * UI animation or queued change is pending.
+     * 
+     * @return True if rendering can wait for the next event
+     */
+    bool isIdle() const;
+    
+    /**
+     * Update the CPU usage and frame rate shown in the UI, once per second.
+     */
+    void updateUsageStats();
+    
+    /**
+     * Rebuild the labelled objects: the satellite plus m_labelStressCount synthetic
+     * objects on shells around the Earth, to load the label renderer. Must be called
+     * between frames.
+     */
+    void updateLabelStress();
 
     // Application state
     bool m_running;
     float m_timeMultiplier;
     double m_lastFrameTime;
     
+    // Simulation epoch (UTC), starting at the system clock
+    Epoch m_epoch;
+    TimeScales m_timeScales;
+    
+    // Render on demand: while paused, frames are only drawn after events
+    bool m_paused = false;
+    bool m_renderOnDemand = true;
+    int m_pendingFrames = 0;
+    
+    // Process CPU time and frames over the last second
+    double m_usageWindowStart = 0.0;
+    std::clock_t m_usageCpuStart = 0;
+    uint32_t m_usageFrames = 0;
+    float m_cpuUsage = 0.0f;
+    float m_framesPerSecond = 0.0f;
+    
     // GLFW window
     GLFWwindow* m_window;
     
@@ -74,12 +137,22 @@ private:
     std::unique_ptr<ImGuiManager> m_uiManager;
     std::unique_ptr<OrbitalMechanics> m_orbitalMechanics;
     
+    // UI-to-simulation parameter changes, drained at the start of each tick
+    SimulationCommandQueue m_commands;
+    std::vector<SimulationCommand> m_unsentCommands;
+    
+    // Simulation-to-UI state, published at the end of each tick; the UI, camera and
+    // drawing read only this
+    SeqLock<OrbitSnapshot> m_orbitSnapshot;
+    
     // Camera settings
     glm::vec3 m_cameraPosition;
     glm::vec3 m_cameraTarget;
     float m_cameraDistance;
     float m_cameraYaw;
     float m_cameraPitch;
+    CameraFrame m_cameraFrame = CameraFrame::Inertial;
+    float m_chiefCameraDistance = 1.0f;     // simulation units, in the LVLH frame
     
     // Mouse input tracking
     bool m_mousePressed;
@@ -89,4 +162,12 @@ private:
     // UI state
     bool m_showHelpWindow = false;
     bool m_showAboutWindow = false;
+    bool m_showLabels = true;
+    bool m_showTrails = true;
+    bool m_showSpacecraftModel = true;
+    float m_spacecraftScale = 0.3f;     // simulation units per model unit, far above true size
+    int m_trailLength = static_cast<int>(Renderer::DEFAULT_TRAIL_LENGTH);
+    int m_msaaSamples = 1;
+    int m_labelStressCount = 0;             // Synthetic labelled objects, for the 10k label target
+    std::vector<glm::vec3> m_labelAnchors;  // Satellite first, then the synthetic objects
 };
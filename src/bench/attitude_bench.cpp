@@ -0,0 +1,178 @@
+// Attitude propagation: spacecraft steps per second for a batch of rigid bodies,
+// single-threaded and across the thread pool, with checks of the integrator and the
+// control law.
+//
+// Torque-free bodies tumbling at up to 3 degrees per second run for 1000 steps of 0.1 s
+// and report their worst energy and angular momentum drift. Then every body starts at a
+// random attitude on a random LEO orbit and is driven to nadir pointing against gravity
+// gradient for an hour; orbits advance between 10 second batches of 0.5 s steps.
+//
+// Usage: OrbitAttitudeBench [spacecraftCount]
+
+#include "orbit/attitude_dynamics.h"
+#include "orbit/orbit_determination.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double MU = 3.986004415e14;
+constexpr double PI = 3.14159265358979323846;
+constexpr double EARTH_RADIUS = 6378137.0;
+
+struct Fleet {
+    std::vector<double> attitude[7];
+    std::vector<double> inertia[3];
+    std::vector<double> orbit[6];
+    std::vector<KeplerianElements> elements;
+
+    Fleet(size_t count, double maxRate) : elements(count) {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::normal_distribution<double> noise;
+        for (auto& component : attitude) {
+            component.resize(count);
+        }
+        for (auto& component : inertia) {
+            component.resize(count);
+        }
+        for (auto& component : orbit) {
+            component.resize(count);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            // Uniformly random rotations, rates up to maxRate per axis
+            double q[4] = {noise(rng), noise(rng), noise(rng), noise(rng)};
+            double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (int k = 0; k < 4; k++) {
+                attitude[k][i] = q[k] / norm;
+            }
+            for (int k = 4; k < 7; k++) {
+                attitude[k][i] = maxRate * (2.0 * unit(rng) - 1.0);
+            }
+
+            // Small satellites, long along z
+            inertia[0][i] = 80.0 + 40.0 * unit(rng);
+            inertia[1][i] = 100.0 + 40.0 * unit(rng);
+            inertia[2][i] = 20.0 + 20.0 * unit(rng);
+
+            KeplerianElements& orbitElements = elements[i];
+            orbitElements.semimajorAxis = EARTH_RADIUS + 400e3 + 1000e3 * unit(rng);
+            orbitElements.eccentricity = 0.01 * unit(rng);
+            orbitElements.inclination = std::acos(1.0 - 2.0 * unit(rng));
+            orbitElements.argumentOfPeriapsis = 2.0 * PI * unit(rng);
+            orbitElements.longitudeOfAscendingNode = 2.0 * PI * unit(rng);
+            orbitElements.meanAnomaly = 2.0 * PI * unit(rng);
+        }
+        setTime(0.0);
+    }
+
+    void setTime(double time) {
+        for (size_t i = 0; i < elements.size(); i++) {
+            double position[3], velocity[3];
+            keplerianToCartesian(elements[i], MU, time, position, velocity);
+            for (int k = 0; k < 3; k++) {
+                orbit[k][i] = position[k];
+                orbit[k + 3][i] = velocity[k];
+            }
+        }
+    }
+
+    AttitudeStateBatch state() {
+        return {attitude[0].data(), attitude[1].data(), attitude[2].data(), attitude[3].data(),
+                attitude[4].data(), attitude[5].data(), attitude[6].data(), elements.size()};
+    }
+
+    InertiaBatch bodies() const { return {inertia[0].data(), inertia[1].data(), inertia[2].data()}; }
+
+    CartesianStateBatch orbits() {
+        return {orbit[0].data(), orbit[1].data(), orbit[2].data(), orbit[3].data(), orbit[4].data(),
+                orbit[5].data(), elements.size()};
+    }
+
+    // Rotational energy and angular momentum magnitude of one body
+    void invariants(size_t i, double& energy, double& momentum) const {
+        double h[3], e = 0.0;
+        for (int k = 0; k < 3; k++) {
+            h[k] = inertia[k][i] * attitude[k + 4][i];
+            e += 0.5 * h[k] * attitude[k + 4][i];
+        }
+        energy = e;
+        momentum = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t spacecraftCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 10000;
+    if (spacecraftCount == 0) {
+        std::fprintf(stderr, "Usage: %s [spacecraftCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool pool;
+    std::printf("%zu spacecraft, %zu threads\n\n", spacecraftCount, pool.getThreadCount());
+
+    // Torque-free motion conserves energy and angular momentum
+    AttitudeModelConfig freeConfig;
+    freeConfig.gravityGradient = false;
+    std::printf("%-10s %-8s %18s %16s %16s\n", "torques", "threads", "M steps/s", "energy drift", "momentum drift");
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        Fleet fleet(spacecraftCount, 3.0 * PI / 180.0);
+        std::vector<double> energy(spacecraftCount), momentum(spacecraftCount);
+        for (size_t i = 0; i < spacecraftCount; i++) {
+            fleet.invariants(i, energy[i], momentum[i]);
+        }
+
+        const size_t steps = 1000;
+        auto start = std::chrono::steady_clock::now();
+        propagateAttitudes(freeConfig, fleet.state(), fleet.bodies(), fleet.orbits(), 0.1, steps, threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double energyDrift = 0.0, momentumDrift = 0.0;
+        for (size_t i = 0; i < spacecraftCount; i++) {
+            double e, h;
+            fleet.invariants(i, e, h);
+            energyDrift = std::max(energyDrift, std::abs(e / energy[i] - 1.0));
+            momentumDrift = std::max(momentumDrift, std::abs(h / momentum[i] - 1.0));
+        }
+        std::printf("%-10s %-8zu %18.2f %16.2e %16.2e\n", "none", threads ? threads->getThreadCount() : size_t(1),
+                    spacecraftCount * steps / seconds * 1e-6, energyDrift, momentumDrift);
+    }
+
+    // Nadir pointing from random attitudes against gravity gradient
+    AttitudeModelConfig nadirConfig;
+    nadirConfig.control = AttitudeControlMode::NadirPointing;
+    std::printf("\n%-10s %-8s %18s %16s %16s\n", "torques", "threads", "M steps/s", "median error", "worst error");
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        Fleet fleet(spacecraftCount, 0.5 * PI / 180.0);
+        const double step = 0.5;
+        const size_t stepsPerBatch = 20;
+        const size_t batches = 360;
+
+        double seconds = 0.0;
+        for (size_t batch = 0; batch < batches; batch++) {
+            fleet.setTime(batch * step * stepsPerBatch);
+            auto start = std::chrono::steady_clock::now();
+            propagateAttitudes(nadirConfig, fleet.state(), fleet.bodies(), fleet.orbits(), step, stepsPerBatch,
+                               threads);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        fleet.setTime(batches * step * stepsPerBatch);
+        std::vector<double> errors(spacecraftCount);
+        attitudePointingErrors(nadirConfig, fleet.state(), fleet.orbits(), errors.data());
+        std::sort(errors.begin(), errors.end());
+        std::printf("%-10s %-8zu %18.2f %14.4f deg %12.4f deg\n", "nadir", threads ? threads->getThreadCount() : size_t(1),
+                    spacecraftCount * stepsPerBatch * batches / seconds * 1e-6,
+                    errors[spacecraftCount / 2] * 180.0 / PI, errors.back() * 180.0 / PI);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+// Batch least-squares orbit determination: fits per second for a catalog of objects
+// fitted independently, single-threaded and across the thread pool, and the accuracy
+// of the fitted orbits against the truth the observations were simulated from.
+//
+// Observations are range, azimuth and elevation from three radar sites every minute
+// the object is more than 10 degrees above the horizon, over six hours, with 10 m and
+// 0.01 degree noise. Sites turn with a constant Earth rotation rate.
+//
+// Usage: OrbitFitBench [objectCount]
+
+#include "orbit/orbit_determination.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double MU = 3.986004415e14;
+constexpr double EARTH_RADIUS = 6378137.0;
+constexpr double EARTH_ROTATION_RATE = 7.292115e-5;
+constexpr double PI = 3.14159265358979323846;
+
+constexpr double TRACKING_SECONDS = 6.0 * 3600.0;
+constexpr double CADENCE = 60.0;
+constexpr double MIN_ELEVATION = 10.0 * PI / 180.0;
+constexpr double RANGE_SIGMA = 10.0;
+constexpr double ANGLE_SIGMA = 0.01 * PI / 180.0;
+
+// Latitude and longitude of the radar sites, radians
+constexpr double SITES[3][2] = {{0.74, -1.87}, {-0.35, 2.55}, {0.12, 0.65}};
+
+SiteGeometry siteAt(double latitude, double longitude, double time) {
+    double angle = longitude + EARTH_ROTATION_RATE * time;
+    double cosL = std::cos(latitude), sinL = std::sin(latitude);
+    double cosA = std::cos(angle), sinA = std::sin(angle);
+
+    SiteGeometry site;
+    const double up[3] = {cosL * cosA, cosL * sinA, sinL};
+    const double east[3] = {-sinA, cosA, 0.0};
+    const double north[3] = {-sinL * cosA, -sinL * sinA, cosL};
+    for (int k = 0; k < 3; k++) {
+        site.position[k] = EARTH_RADIUS * up[k];
+        site.up[k] = up[k];
+        site.east[k] = east[k];
+        site.north[k] = north[k];
+    }
+    return site;
+}
+
+struct Scenario {
+    std::vector<KeplerianElements> truth;
+    std::vector<SiteGeometry> geometries;
+    std::vector<Observation> observations;
+    std::vector<OrbitFitProblem> problems;
+
+    explicit Scenario(size_t objectCount) {
+        std::mt19937 rng(23);
+        std::uniform_real_distribution<double> altitude(400e3, 2000e3);
+        std::uniform_real_distribution<double> eccentricity(0.001, 0.05);
+        std::uniform_real_distribution<double> inclination(0.3, 1.7);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * PI);
+        std::normal_distribution<double> noise;
+
+        // Sites at every cadence step, shared by all objects
+        size_t epochCount = static_cast<size_t>(TRACKING_SECONDS / CADENCE);
+        for (size_t epoch = 0; epoch < epochCount; epoch++) {
+            for (const auto& site : SITES) {
+                geometries.push_back(siteAt(site[0], site[1], epoch * CADENCE));
+            }
+        }
+
+        std::vector<size_t> firstObservation;
+        for (size_t object = 0; object < objectCount; object++) {
+            KeplerianElements elements = {EARTH_RADIUS + altitude(rng), eccentricity(rng), inclination(rng),
+                                          angle(rng), angle(rng), angle(rng)};
+            truth.push_back(elements);
+            firstObservation.push_back(observations.size());
+
+            for (size_t epoch = 0; epoch < epochCount; epoch++) {
+                double time = epoch * CADENCE;
+                double position[3];
+                keplerianToCartesian(elements, MU, time, position, nullptr);
+                for (uint32_t site = 0; site < 3; site++) {
+                    uint32_t row = static_cast<uint32_t>(epoch * 3 + site);
+                    const SiteGeometry& geometry = geometries[row];
+                    if (predictMeasurement(MeasurementType::Elevation, geometry, position, nullptr) < MIN_ELEVATION) {
+                        continue;
+                    }
+                    for (MeasurementType type : {MeasurementType::Range, MeasurementType::Azimuth,
+                                                 MeasurementType::Elevation}) {
+                        double sigma = (type == MeasurementType::Range) ? RANGE_SIGMA : ANGLE_SIGMA;
+                        double value = predictMeasurement(type, geometry, position, nullptr) + sigma * noise(rng);
+                        observations.push_back({time, value, sigma, static_cast<uint32_t>(object), row, type});
+                    }
+                }
+            }
+        }
+        firstObservation.push_back(observations.size());
+
+        // Initial guesses a few kilometers and a few degrees off, as from a catalog
+        // element set several days old
+        for (size_t object = 0; object < objectCount; object++) {
+            KeplerianElements guess = truth[object];
+            guess.semimajorAxis += 5e3 * noise(rng);
+            guess.eccentricity = std::abs(guess.eccentricity + 0.002 * noise(rng));
+            guess.inclination += 0.003 * noise(rng);
+            guess.longitudeOfAscendingNode += 0.003 * noise(rng);
+            guess.meanAnomaly += 0.05 * noise(rng);
+            size_t count = firstObservation[object + 1] - firstObservation[object];
+            problems.push_back({guess, observations.data() + firstObservation[object], count});
+        }
+    }
+};
+
+double positionError(const KeplerianElements& fitted, const KeplerianElements& truth) {
+    double a[3], b[3];
+    keplerianToCartesian(fitted, MU, 0.0, a, nullptr);
+    keplerianToCartesian(truth, MU, 0.0, b, nullptr);
+    return std::hypot(a[0] - b[0], std::hypot(a[1] - b[1], a[2] - b[2]));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000;
+    if (objectCount == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Scenario scenario(objectCount);
+    ThreadPool pool;
+    OrbitFitSettings settings;
+    std::vector<OrbitFitResult> results(objectCount);
+    std::printf("%zu objects, %zu observations, %zu threads\n\n", objectCount, scenario.observations.size(),
+                pool.getThreadCount());
+
+    std::printf("%-24s %12s %14s\n", "mode", "fits/s", "Mobs/s");
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        auto start = std::chrono::steady_clock::now();
+        fitOrbits(scenario.problems.data(), results.data(), objectCount, scenario.geometries.data(), settings,
+                  threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Every iteration evaluates each observation once
+        double evaluations = 0.0;
+        for (size_t object = 0; object < objectCount; object++) {
+            evaluations += static_cast<double>(scenario.problems[object].observationCount) *
+                           (results[object].iterations + 1);
+        }
+        std::printf("%-24s %12.0f %14.2f\n", threads ? "objects across pool" : "single thread",
+                    objectCount / seconds, evaluations / seconds * 1e-6);
+    }
+
+    size_t converged = 0;
+    double iterations = 0.0, rms = 0.0;
+    std::vector<double> errors;
+    for (size_t object = 0; object < objectCount; object++) {
+        converged += results[object].converged ? 1 : 0;
+        iterations += results[object].iterations;
+        rms += results[object].weightedRms;
+        errors.push_back(positionError(results[object].elements, scenario.truth[object]));
+    }
+    std::sort(errors.begin(), errors.end());
+    std::printf("\nconverged: %zu of %zu, mean iterations %.1f, mean weighted rms %.3f\n", converged, objectCount,
+                iterations / objectCount, rms / objectCount);
+    std::printf("epoch position error: median %.1f m, 95%% %.1f m\n", errors[errors.size() / 2],
+                errors[errors.size() * 95 / 100]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+// Cost per object per step of numerical propagation with luni-solar third-body gravity
+// and solar radiation pressure, against plain two-body integration. Also shows what the
+// shared Sun/Moon evaluation saves over evaluating the series for every object.
+//
+// Usage: OrbitForceBench [objectCount] [stepCount]
+
+#include "orbit/cowell_propagator.h"
+#include "orbit/force_models.h"
+#include "orbit/gravity_field.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+// One minute steps from 2025-01-01
+constexpr double TIME_STEP = 60.0;
+constexpr double START_DAYS = 9131.5;
+
+constexpr double MU = 3.986004415e14;
+constexpr double RADIUS = 6378136.3;
+
+// EGM2008 zonal terms used for the gravity field row
+constexpr double C20 = -4.84165371736e-4;
+constexpr double C30 = 9.57161207093e-7;
+constexpr double C40 = 5.39965866639e-7;
+
+struct Catalog {
+    std::vector<double> x, y, z, vx, vy, vz;
+    std::vector<double> reflectivityAreaToMass;
+
+    /**
+     * Circular orbits from LEO to GEO at random inclinations and phases, with
+     * area-to-mass ratios from dense payloads to debris.
+     */
+    explicit Catalog(size_t count) {
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<double> radius(RADIUS + 400e3, 42164e3);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * 3.14159265358979);
+        std::uniform_real_distribution<double> logAreaToMass(-2.5, -0.5);
+        for (size_t i = 0; i < count; i++) {
+            double r = radius(rng);
+            double speed = std::sqrt(MU / r);
+            double inclination = 0.5 * angle(rng);
+            double node = angle(rng);
+            double phase = angle(rng);
+
+            // Position and velocity in the orbital plane, rotated by inclination and node
+            double px = r * std::cos(phase), py = r * std::sin(phase);
+            double qx = -speed * std::sin(phase), qy = speed * std::cos(phase);
+            double cosI = std::cos(inclination), sinI = std::sin(inclination);
+            double cosO = std::cos(node), sinO = std::sin(node);
+            x.push_back(cosO * px - sinO * cosI * py);
+            y.push_back(sinO * px + cosO * cosI * py);
+            z.push_back(sinI * py);
+            vx.push_back(cosO * qx - sinO * cosI * qy);
+            vy.push_back(sinO * qx + cosO * cosI * qy);
+            vz.push_back(sinI * qy);
+            reflectivityAreaToMass.push_back(1.3 * std::pow(10.0, logAreaToMass(rng)));
+        }
+    }
+
+    CartesianStateBatch getStates() {
+        return {x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data(), x.size()};
+    }
+};
+
+template <typename Function>
+double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 20000;
+    size_t stepCount = (argc > 2) ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 30;
+    if (objectCount == 0 || stepCount == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [stepCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool pool;
+    std::printf("%zu objects, %zu RK4 steps of %.0f s, %zu threads\n\n", objectCount, stepCount, TIME_STEP,
+                pool.getThreadCount());
+
+    GravityField zonal;
+    std::vector<double> cosine(15, 0.0), sine(15, 0.0);
+    cosine[0] = 1.0;
+    cosine[3] = C20;
+    cosine[6] = C30;
+    cosine[10] = C40;
+    zonal.setCoefficients(4, MU, RADIUS, cosine, sine);
+
+    struct Row {
+        const char* name;
+        ForceModelConfig config;
+    };
+    std::vector<Row> rows(5);
+    rows[0].name = "two-body";
+    rows[0].config.sun = rows[0].config.moon = rows[0].config.solarRadiationPressure = false;
+    rows[1].name = "+ sun, moon";
+    rows[1].config.solarRadiationPressure = false;
+    rows[2].name = "+ srp";
+    rows[2].config.sun = rows[2].config.moon = false;
+    rows[3].name = "+ sun, moon, srp";
+    rows[4].name = "J2-J4 + all";
+    rows[4].config.gravity = &zonal;
+
+    std::printf("%-18s %14s %14s %16s\n", "forces", "ns/obj/step", "env evals", "final |dr| km");
+    Catalog reference(objectCount);
+    {
+        Catalog twoBody = reference;
+        CartesianStateBatch states = twoBody.getStates();
+        CowellPropagator propagator(rows[0].config, &pool);
+        propagator.propagate(states, nullptr, START_DAYS, TIME_STEP, stepCount);
+        reference = twoBody;
+    }
+
+    for (const Row& row : rows) {
+        Catalog catalog(objectCount);
+        CartesianStateBatch states = catalog.getStates();
+        CowellPropagator propagator(row.config, &pool);
+        double seconds = measure([&]() {
+            propagator.propagate(states, catalog.reflectivityAreaToMass.data(), START_DAYS, TIME_STEP, stepCount);
+        });
+
+        // Displacement from two-body motion at the end of the run
+        double displacement = 0.0;
+        for (size_t i = 0; i < objectCount; i++) {
+            displacement = std::max(displacement, std::hypot(catalog.x[i] - reference.x[i],
+                                                             std::hypot(catalog.y[i] - reference.y[i],
+                                                                        catalog.z[i] - reference.z[i])));
+        }
+        std::printf("%-18s %14.1f %14llu %16.3f\n", row.name, seconds * 1e9 / (objectCount * stepCount),
+                    static_cast<unsigned long long>(propagator.getEnvironmentEvaluations()), displacement * 1e-3);
+    }
+
+    // The Sun/Moon series against the forces themselves
+    const size_t evaluations = 100000;
+    volatile double sink = 0.0;
+    double seriesSeconds = measure([&]() {
+        for (size_t k = 0; k < evaluations; k++) {
+            sink = sink + computeSolarSystemBodies(START_DAYS + k * 1e-3).moon[0];
+        }
+    });
+    double seriesNs = seriesSeconds * 1e9 / evaluations;
+    std::printf("\nSun/Moon series: %.0f ns per evaluation\n", seriesNs);
+    std::printf("shared, 2 per step:        %8.3f ns/obj/step\n", 2.0 * seriesNs / objectCount);
+    std::printf("per object, 4 per step:    %8.1f ns/obj/step\n", 4.0 * seriesNs);
+    return EXIT_SUCCESS;
+}
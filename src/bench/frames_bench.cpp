@@ -0,0 +1,140 @@
+// Conversion of a catalog from GCRF to ITRF over a run of time steps: the full
+// precession-nutation model evaluated per object, versus one interpolated matrix per
+// step from FrameRotationCache. Also reports the interpolation error of the cache.
+//
+// Usage: OrbitFramesBench [objectCount] [stepCount]
+
+#include "orbit/reference_frames.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Time step of the converted run: one minute, in days
+constexpr double TIME_STEP = 1.0 / 1440.0;
+
+// Start of the run, days since J2000.0 (2025-01-01)
+constexpr double START_DAYS = 9131.5;
+
+// Difference between TT and UT1 near the start epoch, in days (about 69 s)
+constexpr double TT_MINUS_UT1 = 69.0 / 86400.0;
+
+// Per-object evaluation is slow, so it runs on at most this many objects per step
+constexpr size_t FULL_MODEL_OBJECTS = 20000;
+
+constexpr double MICROARCSECONDS = 180.0 * 3600.0 * 1e6 / 3.14159265358979323846;
+
+template <typename Function>
+double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Largest difference between matrix elements, which for rotations is the angle in radians
+ * to first order.
+ */
+double maxDifference(const RotationMatrix& a, const RotationMatrix& b) {
+    double difference = 0.0;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            difference = std::max(difference, std::abs(a.m[row][column] - b.m[row][column]));
+        }
+    }
+    return difference;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 100000;
+    size_t stepCount = (argc > 2) ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 60;
+    if (objectCount == 0 || stepCount == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [stepCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-42.0f, 42.0f);
+    std::vector<float> x(objectCount), y(objectCount), z(objectCount);
+    for (size_t i = 0; i < objectCount; i++) {
+        x[i] = coordinate(rng);
+        y[i] = coordinate(rng);
+        z[i] = coordinate(rng);
+    }
+    std::vector<float> outX(objectCount), outY(objectCount), outZ(objectCount);
+    PolarMotion polarMotion = {0.15 / 206264.806, 0.35 / 206264.806};
+
+    // Interpolation error of the cached nutation over a year of random epochs
+    FrameRotationCache accuracyCache;
+    std::uniform_real_distribution<double> day(START_DAYS, START_DAYS + 365.0);
+    double worstError = 0.0;
+    for (int sample = 0; sample < 20000; sample++) {
+        double tt = day(rng);
+        double ut1 = tt - TT_MINUS_UT1;
+        RotationMatrix exact = frameRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf, tt, ut1, polarMotion);
+        const RotationMatrix& cached = accuracyCache.getRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf,
+                                                                 tt, ut1, polarMotion);
+        worstError = std::max(worstError, maxDifference(exact, cached));
+    }
+
+    std::printf("%zu objects x %zu steps of 1 min, GCRF -> ITRF\n", objectCount, stepCount);
+    std::printf("cache interpolation error over a year: %.3f microarcseconds\n\n", worstError * MICROARCSECONDS);
+    std::printf("%-26s %14s %14s %14s\n", "method", "ns/object", "Mobjects/s", "series evals");
+
+    // Full model per object: what converting each object independently would cost
+    size_t fullObjects = std::min(objectCount, FULL_MODEL_OBJECTS);
+    volatile float sink = 0.0f;
+    double fullSeconds = measure([&]() {
+        for (size_t i = 0; i < fullObjects; i++) {
+            double tt = START_DAYS;
+            RotationMatrix rotation = frameRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf, tt,
+                                                    tt - TT_MINUS_UT1, polarMotion);
+            rotatePositions(rotation, &x[i], &y[i], &z[i], &outX[i], &outY[i], &outZ[i], 1);
+        }
+    });
+    sink = sink + outX[0];
+    double fullPerObject = fullSeconds / static_cast<double>(fullObjects);
+    std::printf("%-26s %14.1f %14.2f %14zu\n", "full model per object", fullPerObject * 1e9,
+                1e-6 / fullPerObject, fullObjects);
+
+    // One exact matrix per step, applied to the whole catalog
+    double exactSeconds = measure([&]() {
+        for (size_t step = 0; step < stepCount; step++) {
+            double tt = START_DAYS + static_cast<double>(step) * TIME_STEP;
+            RotationMatrix rotation = frameRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf, tt,
+                                                    tt - TT_MINUS_UT1, polarMotion);
+            rotatePositions(rotation, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(),
+                            objectCount);
+        }
+    });
+    sink = sink + outX[0];
+    double exactPerObject = exactSeconds / static_cast<double>(objectCount * stepCount);
+    std::printf("%-26s %14.2f %14.1f %14zu\n", "full model per step", exactPerObject * 1e9,
+                1e-6 / exactPerObject, stepCount);
+
+    // Interpolated matrix per step from the cache
+    FrameRotationCache cache;
+    double cachedSeconds = measure([&]() {
+        for (size_t step = 0; step < stepCount; step++) {
+            double tt = START_DAYS + static_cast<double>(step) * TIME_STEP;
+            const RotationMatrix& rotation = cache.getRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf, tt,
+                                                               tt - TT_MINUS_UT1, polarMotion);
+            rotatePositions(rotation, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(),
+                            objectCount);
+        }
+    });
+    sink = sink + outX[0];
+    double cachedPerObject = cachedSeconds / static_cast<double>(objectCount * stepCount);
+    std::printf("%-26s %14.2f %14.1f %14llu\n", "cached matrix per step", cachedPerObject * 1e9,
+                1e-6 / cachedPerObject, static_cast<unsigned long long>(cache.getSeriesEvaluations()));
+
+    std::printf("\nspeedup over per-object evaluation: %.0fx\n", fullPerObject / cachedPerObject);
+    return EXIT_SUCCESS;
+}
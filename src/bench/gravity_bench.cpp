@@ -0,0 +1,233 @@
+// Spherical harmonic gravity: cost per object at degree 8, 20 and 70 for every
+// instruction set variant, single-threaded and across the thread pool, then the
+// precomputed grid against direct evaluation.
+//
+// Without a coefficient file the field is synthetic: EGM2008 J2 plus random
+// coefficients following Kaula's rule (1e-5 / n^2), which costs the same to evaluate
+// as a real model of that degree.
+//
+// Usage: OrbitGravityBench [objectCount] [coefficientFile]
+
+#include "orbit/gravity_field.h"
+#include "orbit/gravity_grid.h"
+#include "orbit/orbit_kernels.h"
+#include "platform/cpu_features.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Minimum wall time spent in each measurement
+constexpr double MIN_SECONDS = 0.25;
+
+constexpr uint32_t MAX_DEGREE = 70;
+
+// EGM2008
+constexpr double MU = 3.986004415e14;
+constexpr double RADIUS = 6378136.3;
+constexpr double C20 = -4.84165371736e-4;
+
+/**
+ * Runs a function repeatedly for at least MIN_SECONDS.
+ *
+ * @return Seconds per run
+ */
+double measure(const std::function<void()>& function) {
+    using Clock = std::chrono::steady_clock;
+    function();
+
+    size_t runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        function();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < MIN_SECONDS);
+    return elapsed / static_cast<double>(runs);
+}
+
+void loadSyntheticField(GravityField& field) {
+    size_t size = (MAX_DEGREE + 1) * (MAX_DEGREE + 2) / 2;
+    std::vector<double> cosine(size, 0.0), sine(size, 0.0);
+    std::mt19937 rng(11);
+    std::normal_distribution<double> normal;
+
+    cosine[0] = 1.0;
+    for (uint32_t n = 2; n <= MAX_DEGREE; n++) {
+        double sigma = 1e-5 / (static_cast<double>(n) * n);
+        for (uint32_t m = 0; m <= n; m++) {
+            size_t index = n * (n + 1) / 2 + m;
+            cosine[index] = (n == 2 && m == 0) ? C20 : sigma * normal(rng);
+            sine[index] = (m == 0) ? 0.0 : sigma * normal(rng);
+        }
+    }
+    field.setCoefficients(MAX_DEGREE, MU, RADIUS, cosine, sine);
+}
+
+struct Positions {
+    std::vector<double> x, y, z;
+
+    /**
+     * Random directions at radii uniform between two bounds.
+     */
+    Positions(size_t count, double minRadius, double maxRadius, uint32_t seed) : x(count), y(count), z(count) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> normal;
+        std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+        for (size_t i = 0; i < count; i++) {
+            double a = normal(rng), b = normal(rng), c = normal(rng);
+            double scale = radius(rng) / std::sqrt(a * a + b * b + c * c);
+            x[i] = a * scale;
+            y[i] = b * scale;
+            z[i] = c * scale;
+        }
+    }
+};
+
+double maxRelativeDifference(const std::vector<double> a[3], const std::vector<double> b[3]) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a[0].size(); i++) {
+        double dx = a[0][i] - b[0][i], dy = a[1][i] - b[1][i], dz = a[2][i] - b[2][i];
+        double magnitude = std::sqrt(b[0][i] * b[0][i] + b[1][i] * b[1][i] + b[2][i] * b[2][i]);
+        worst = std::max(worst, std::sqrt(dx * dx + dy * dy + dz * dz) / magnitude);
+    }
+    return worst;
+}
+
+void benchmarkDegrees(GravityField& field, const Positions& positions, ThreadPool& pool) {
+    size_t count = positions.x.size();
+    std::vector<double> reference[3], acceleration[3];
+    for (int k = 0; k < 3; k++) {
+        reference[k].resize(count);
+        acceleration[k].resize(count);
+    }
+
+    std::printf("%-8s %-10s %14s %14s %16s\n", "degree", "isa", "ns/obj (1 thr)", "ns/obj (pool)", "max rel diff");
+    for (uint32_t degree : {8u, 20u, 70u}) {
+        if (degree > field.getLoadedDegree()) {
+            continue;
+        }
+        field.setDegree(degree);
+        const GravityTerms& terms = field.getTerms();
+        std::vector<double> scratch(gravityScratchSize(degree));
+
+        for (uint32_t level = 0; level <= static_cast<uint32_t>(detectCpuIsa()); level++) {
+            CpuIsa isa = static_cast<CpuIsa>(level);
+            const OrbitKernels* kernels = getOrbitKernels(isa);
+            if (kernels == nullptr) {
+                continue;
+            }
+            auto* output = (isa == CpuIsa::Baseline) ? reference : acceleration;
+            double single = measure([&]() {
+                kernels->gravityAcceleration(terms, positions.x.data(), positions.y.data(), positions.z.data(),
+                                             output[0].data(), output[1].data(), output[2].data(), count,
+                                             scratch.data());
+            });
+            double difference = (isa == CpuIsa::Baseline) ? 0.0 : maxRelativeDifference(acceleration, reference);
+
+            // The pool runs whichever variant the dispatcher selected
+            double pooled = 0.0;
+            if (kernels == &getOrbitKernels()) {
+                pooled = measure([&]() {
+                    field.evaluate(positions.x.data(), positions.y.data(), positions.z.data(), output[0].data(),
+                                   output[1].data(), output[2].data(), count, &pool);
+                });
+            }
+
+            std::printf("%-8u %-10s %14.1f ", degree, cpuIsaName(isa), single * 1e9 / count);
+            if (pooled > 0.0) {
+                std::printf("%14.1f ", pooled * 1e9 / count);
+            } else {
+                std::printf("%14s ", "-");
+            }
+            std::printf("%16.2e\n", difference);
+        }
+    }
+}
+
+void benchmarkGrid(GravityField& field, size_t count, ThreadPool& pool) {
+    // LEO shell at 1 degree spacing and 25 km radial steps, for a degree 20 field
+    field.setDegree(std::min(20u, field.getLoadedDegree()));
+    GravityGrid::Layout layout = {RADIUS + 200e3, RADIUS + 2000e3, 73, 181, 360};
+
+    GravityGrid grid;
+    auto start = std::chrono::steady_clock::now();
+    grid.build(field, layout, &pool);
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Positions positions(count, layout.minRadius, layout.maxRadius, 5);
+    std::vector<double> exact[3], interpolated[3];
+    for (int k = 0; k < 3; k++) {
+        exact[k].resize(count);
+        interpolated[k].resize(count);
+    }
+
+    double direct = measure([&]() {
+        field.evaluate(positions.x.data(), positions.y.data(), positions.z.data(), exact[0].data(),
+                       exact[1].data(), exact[2].data(), count);
+    });
+    double lookup = measure([&]() {
+        grid.evaluate(positions.x.data(), positions.y.data(), positions.z.data(), interpolated[0].data(),
+                      interpolated[1].data(), interpolated[2].data(), count);
+    });
+
+    // Error relative to the total and to the non-central part, which is what the grid stores
+    double worstTotal = maxRelativeDifference(interpolated, exact);
+    double worstPerturbation = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double x = positions.x[i], y = positions.y[i], z = positions.z[i];
+        double r = std::sqrt(x * x + y * y + z * z);
+        double central = field.getMu() / (r * r * r);
+        double px = exact[0][i] + central * x, py = exact[1][i] + central * y, pz = exact[2][i] + central * z;
+        double dx = interpolated[0][i] - exact[0][i];
+        double dy = interpolated[1][i] - exact[1][i];
+        double dz = interpolated[2][i] - exact[2][i];
+        worstPerturbation = std::max(worstPerturbation,
+                                     std::sqrt(dx * dx + dy * dy + dz * dz) / std::sqrt(px * px + py * py + pz * pz));
+    }
+
+    std::printf("\nGrid cache, degree %u, %u x %u x %u nodes over %.0f-%.0f km altitude\n", field.getDegree(),
+                layout.radialCount, layout.latitudeCount, layout.longitudeCount, (layout.minRadius - RADIUS) * 1e-3,
+                (layout.maxRadius - RADIUS) * 1e-3);
+    std::printf("build: %.2f s, memory: %.1f MB\n", buildSeconds, grid.getBytes() / (1024.0 * 1024.0));
+    std::printf("%-20s %10s\n", "method", "ns/obj");
+    std::printf("%-20s %10.1f\n", "direct (1 thread)", direct * 1e9 / count);
+    std::printf("%-20s %10.1f\n", "grid lookup", lookup * 1e9 / count);
+    std::printf("max error: %.2e of total, %.2e of non-central\n", worstTotal, worstPerturbation);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 20000;
+    if (objectCount == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [coefficientFile]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    GravityField field;
+    if (argc > 2) {
+        field.load(argv[2], MAX_DEGREE);
+        std::printf("Loaded %s to degree %u\n", argv[2], field.getLoadedDegree());
+    } else {
+        loadSyntheticField(field);
+        std::printf("Synthetic field to degree %u\n", field.getLoadedDegree());
+    }
+
+    ThreadPool pool;
+    std::printf("%zu objects, LEO to GEO, %zu threads in pool\n\n", objectCount, pool.getThreadCount());
+
+    // Coefficient files are in SI units, like the synthetic field
+    Positions positions(objectCount, 6.6e6, 4.2e7, 3);
+    benchmarkDegrees(field, positions, pool);
+    benchmarkGrid(field, objectCount, pool);
+    return EXIT_SUCCESS;
+}
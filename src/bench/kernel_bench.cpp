@@ -0,0 +1,362 @@
+// Throughput benchmark for the orbit kernels, one run per instruction set variant
+// supported by this CPU. Results are checked against the baseline variant.
+//
+// Usage: OrbitKernelBench [objectCount]
+
+#include "orbit/kepler_buckets.h"
+#include "orbit/orbit_kernels.h"
+#include "orbit/propagator.h"
+#include "platform/cpu_features.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Minimum wall time spent in each kernel measurement
+constexpr double MIN_SECONDS = 0.25;
+
+struct Workload {
+    size_t count;
+    std::vector<float> meanAnomaly, eccentricity, semimajorAxis, semiminorAxis, meanMotion;
+    std::vector<float> orientation[6];
+    std::vector<float> eccentricAnomaly, cosE, sinE, planeX, planeY, velocityX, velocityY, x, y, z;
+    std::vector<uint8_t> within;
+
+    explicit Workload(size_t objectCount) : count(objectCount) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> anomaly(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> ecc(0.0f, 0.95f);
+        std::uniform_real_distribution<float> sma(6.6f, 45.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 3.1415926f);
+
+        std::vector<float> inclination(count), argumentOfPeriapsis(count), node(count);
+        for (size_t i = 0; i < count; i++) {
+            meanAnomaly.push_back(anomaly(rng));
+            eccentricity.push_back(ecc(rng));
+            semimajorAxis.push_back(sma(rng));
+            semiminorAxis.push_back(semimajorAxis.back() * std::sqrt(1.0f - eccentricity.back() * eccentricity.back()));
+            meanMotion.push_back(std::sqrt(398600.0f / (semimajorAxis.back() * semimajorAxis.back() * semimajorAxis.back())));
+            inclination[i] = angle(rng);
+            argumentOfPeriapsis[i] = 2.0f * angle(rng);
+            node[i] = 2.0f * angle(rng);
+        }
+
+        float* orientationOut[6];
+        for (int k = 0; k < 6; k++) {
+            orientation[k].resize(count);
+            orientationOut[k] = orientation[k].data();
+        }
+        computeOrientation(inclination.data(), argumentOfPeriapsis.data(), node.data(), orientationOut, count);
+
+        for (auto* output : {&eccentricAnomaly, &cosE, &sinE, &planeX, &planeY, &velocityX, &velocityY, &x, &y, &z}) {
+            output->resize(count);
+        }
+        within.resize(count);
+    }
+};
+
+/**
+ * Runs a kernel repeatedly for at least MIN_SECONDS.
+ *
+ * @return Throughput in millions of objects per second
+ */
+double measure(size_t count, const std::function<void()>& kernel) {
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and page in the outputs
+    kernel();
+
+    size_t runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        kernel();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < MIN_SECONDS);
+
+    return static_cast<double>(count) * static_cast<double>(runs) / elapsed * 1e-6;
+}
+
+void perifocalState(const OrbitKernels& kernels, Workload& w) {
+    kernels.perifocalState(w.cosE.data(), w.sinE.data(), w.eccentricity.data(), w.semimajorAxis.data(),
+                           w.semiminorAxis.data(), w.meanMotion.data(), w.planeX.data(), w.planeY.data(),
+                           w.velocityX.data(), w.velocityY.data(), w.count);
+}
+
+/**
+ * Perifocal position through the true anomaly, as OrbitalMechanics evaluated it
+ * before the trig-free form: half-angle sines and cosines, atan2, then cos/sin of nu.
+ */
+void trueAnomalyChain(const Workload& w, std::vector<float>& planeX, std::vector<float>& planeY) {
+    for (size_t i = 0; i < w.count; i++) {
+        float E = w.eccentricAnomaly[i];
+        float e = w.eccentricity[i];
+        float distance = w.semimajorAxis[i] * (1.0f - e * std::cos(E));
+        float trueAnomaly = 2.0f * std::atan2(std::sqrt(1.0f + e) * std::sin(E / 2.0f),
+                                              std::sqrt(1.0f - e) * std::cos(E / 2.0f));
+        planeX[i] = distance * std::cos(trueAnomaly);
+        planeY[i] = distance * std::sin(trueAnomaly);
+    }
+}
+
+/**
+ * Compares the trig-free perifocal evaluation with the true anomaly chain, against
+ * a double precision evaluation of the same eccentric anomalies.
+ */
+void comparePerifocalForms(const Workload& reference) {
+    Workload w = reference;
+    const OrbitKernels& kernels = getOrbitKernels();
+
+    std::vector<float> chainX(w.count), chainY(w.count);
+    double chainRate = measure(w.count, [&]() {
+        trueAnomalyChain(w, chainX, chainY);
+    });
+    double directRate = measure(w.count, [&]() {
+        perifocalState(kernels, w);
+    });
+
+    size_t identical = 0;
+    double directError = 0.0, chainError = 0.0;
+    for (size_t i = 0; i < w.count; i++) {
+        identical += (std::memcmp(&chainX[i], &w.planeX[i], sizeof(float)) == 0 &&
+                      std::memcmp(&chainY[i], &w.planeY[i], sizeof(float)) == 0) ? 1 : 0;
+
+        double E = w.eccentricAnomaly[i];
+        double e = w.eccentricity[i];
+        double a = w.semimajorAxis[i];
+        double exactX = a * (std::cos(E) - e);
+        double exactY = a * std::sqrt(1.0 - e * e) * std::sin(E);
+        directError = std::max(directError, std::hypot(w.planeX[i] - exactX, w.planeY[i] - exactY) / a);
+        chainError = std::max(chainError, std::hypot(chainX[i] - exactX, chainY[i] - exactY) / a);
+    }
+
+    std::printf("\nPerifocal position from E (%s kernels)\n", cpuIsaName(kernels.isa));
+    std::printf("%-22s %14s %18s\n", "form", "Mobj/s", "max |dr| / a");
+    std::printf("%-22s %14.1f %18.2e\n", "true anomaly chain", chainRate, chainError);
+    std::printf("%-22s %14.1f %18.2e\n", "cos E / sin E (+vel)", directRate, directError);
+    std::printf("bitwise identical: %zu of %zu (%.1f%%)\n", identical, w.count,
+                100.0 * static_cast<double>(identical) / static_cast<double>(w.count));
+}
+
+/**
+ * Draws eccentricities with the shape of the public space object catalog: mostly
+ * near-circular LEO, with transfer orbits and a tail of highly eccentric ones.
+ */
+std::vector<float> mixedCatalogEccentricities(size_t count) {
+    struct Band { float weight, low, high; };
+    const Band bands[] = {
+        {0.72f, 0.0f, 0.02f},     // LEO, GEO
+        {0.14f, 0.02f, 0.1f},
+        {0.07f, 0.1f, 0.5f},
+        {0.05f, 0.5f, 0.8f},      // GTO
+        {0.02f, 0.8f, 0.97f},     // HEO
+    };
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> eccentricity(count);
+    for (float& e : eccentricity) {
+        float pick = unit(rng);
+        const Band* band = &bands[0];
+        for (const Band& candidate : bands) {
+            band = &candidate;
+            if (pick < candidate.weight) {
+                break;
+            }
+            pick -= candidate.weight;
+        }
+        e = band->low + (band->high - band->low) * unit(rng);
+    }
+    return eccentricity;
+}
+
+/**
+ * Compares the general Kepler solver with regime-bucketed solving on a mixed catalog.
+ */
+void benchmarkKeplerBuckets(size_t count) {
+    Workload w(count);
+    w.eccentricity = mixedCatalogEccentricities(count);
+    const OrbitKernels& kernels = getOrbitKernels();
+
+    std::vector<float> E(count), cosE(count), sinE(count);
+    double general = measure(count, [&]() {
+        kernels.solveKepler(w.meanAnomaly.data(), w.eccentricity.data(), E.data(), cosE.data(), sinE.data(), count);
+    });
+
+    KeplerBuckets buckets;
+    double assign = measure(count, [&]() {
+        buckets.assign(w.eccentricity.data(), count);
+    });
+    double bucketed = measure(count, [&]() {
+        buckets.solve(kernels, w.meanAnomaly.data(), w.eccentricAnomaly.data(), w.cosE.data(), w.sinE.data());
+    });
+
+    // Data already stored in grouped order, as a caller that keeps its arrays sorted would have
+    std::vector<float> sortedAnomaly(count), sortedEccentricity(count);
+    for (size_t i = 0; i < count; i++) {
+        sortedAnomaly[i] = w.meanAnomaly[buckets.getPermutation()[i]];
+        sortedEccentricity[i] = w.eccentricity[buckets.getPermutation()[i]];
+    }
+    std::vector<float> sortedE(count), sortedCos(count), sortedSin(count);
+    double presorted = measure(count, [&]() {
+        size_t first = 0;
+        for (size_t r = 0; r < KEPLER_REGIME_COUNT; r++) {
+            size_t regimeCount = buckets.getCount(static_cast<KeplerRegime>(r));
+            kernels.solveKeplerRegime[r](sortedAnomaly.data() + first, sortedEccentricity.data() + first,
+                                         sortedE.data() + first, sortedCos.data() + first,
+                                         sortedSin.data() + first, regimeCount);
+            first += regimeCount;
+        }
+    });
+
+    // Kepler residuals of both solutions, in double precision
+    double generalResidual = 0.0, bucketedResidual = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double M = std::fmod(static_cast<double>(w.meanAnomaly[i]), 6.283185307179586);
+        double e = w.eccentricity[i];
+        double generalE = E[i], bucketedE = w.eccentricAnomaly[i];
+        generalResidual = std::max(generalResidual, std::fabs(generalE - e * std::sin(generalE) - M));
+        bucketedResidual = std::max(bucketedResidual, std::fabs(bucketedE - e * std::sin(bucketedE) - M));
+    }
+
+    std::printf("\nKepler solve on a mixed catalog (%s kernels), regimes:", cpuIsaName(kernels.isa));
+    for (size_t r = 0; r < KEPLER_REGIME_COUNT; r++) {
+        std::printf(" %.1f%%", 100.0 * static_cast<double>(buckets.getCount(static_cast<KeplerRegime>(r))) /
+                                   static_cast<double>(count));
+    }
+    std::printf("\n%-22s %14s %18s\n", "solver", "Mobj/s", "max |residual|");
+    std::printf("%-22s %14.1f %18.2e\n", "general", general, generalResidual);
+    std::printf("%-22s %14.1f %18.2e\n", "bucketed", bucketed, bucketedResidual);
+    std::printf("%-22s %14.1f\n", "bucketed, presorted", presorted);
+    std::printf("%-22s %14.1f\n", "assign (per change)", assign);
+}
+
+/**
+ * Runs every instantiated propagator configuration in one precision.
+ */
+template <typename T>
+void benchmarkPropagators(const Workload& w, const char* precision) {
+    size_t count = w.count;
+    std::vector<T> a(count), e(count), inclination(count), periapsis(count), node(count), M(count);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> angle(0.0f, 3.1415926f);
+    for (size_t i = 0; i < count; i++) {
+        a[i] = w.semimajorAxis[i];
+        e[i] = w.eccentricity[i];
+        M[i] = w.meanAnomaly[i];
+        inclination[i] = angle(rng);
+        periapsis[i] = 2.0f * angle(rng);
+        node[i] = 2.0f * angle(rng);
+    }
+
+    OrbitElementsBatch<T> elements = {a.data(), e.data(), inclination.data(), periapsis.data(),
+                                      node.data(), M.data(), count};
+    std::vector<T> x(count), y(count), z(count);
+    PositionBatch<T> positions = {x.data(), y.data(), z.data()};
+
+    for (uint32_t s = 0; s < static_cast<uint32_t>(KeplerSolverKind::Count); s++) {
+        for (uint32_t p = 0; p < static_cast<uint32_t>(PerturbationKind::Count); p++) {
+            for (uint32_t f = 0; f < static_cast<uint32_t>(OutputFrame::Count); f++) {
+                PropagatorConfig config;
+                config.solver = static_cast<KeplerSolverKind>(s);
+                config.perturbations = static_cast<PerturbationKind>(p);
+                config.frame = static_cast<OutputFrame>(f);
+
+                // Selected once per batch
+                PropagateFunction<T> propagate = findPropagator<T>(config);
+                if (propagate == nullptr) {
+                    continue;
+                }
+
+                double rate = measure(count, [&]() {
+                    propagate(elements, T(1000), positions);
+                });
+                std::printf("%-8s %-38s %10.1f\n", precision, propagatorName(config).c_str(), rate);
+            }
+        }
+    }
+}
+
+float maxDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    float difference = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) {
+        difference = std::max(difference, std::fabs(a[i] - b[i]));
+    }
+    return difference;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : (1u << 16);
+    if (count == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CpuIsa detected = detectCpuIsa();
+    std::printf("Detected ISA: %s, dispatching to: %s, %zu objects\n\n",
+                cpuIsaName(detected), cpuIsaName(getOrbitKernels().isa), count);
+    std::printf("%-10s %14s %14s %14s %14s %12s\n",
+                "variant", "kepler Mobj/s", "plane Mobj/s", "rotate Mobj/s", "screen Mobj/s", "max |dpos|");
+
+    // Baseline results are the reference for the other variants
+    Workload reference(count);
+    const OrbitKernels& baseline = *getOrbitKernels(CpuIsa::Baseline);
+    baseline.solveKepler(reference.meanAnomaly.data(), reference.eccentricity.data(),
+                         reference.eccentricAnomaly.data(), reference.cosE.data(), reference.sinE.data(), count);
+    perifocalState(baseline, reference);
+
+    for (uint32_t level = 0; level <= static_cast<uint32_t>(detected); level++) {
+        const OrbitKernels* kernels = getOrbitKernels(static_cast<CpuIsa>(level));
+        if (kernels == nullptr) {
+            continue;
+        }
+
+        Workload w(count);
+        const float* orientation[6];
+        for (int k = 0; k < 6; k++) {
+            orientation[k] = w.orientation[k].data();
+        }
+        const float origin[3] = {0.0f, 0.0f, 0.0f};
+
+        double kepler = measure(count, [&]() {
+            kernels->solveKepler(w.meanAnomaly.data(), w.eccentricity.data(), w.eccentricAnomaly.data(),
+                                 w.cosE.data(), w.sinE.data(), count);
+        });
+        double plane = measure(count, [&]() {
+            perifocalState(*kernels, w);
+        });
+        double rotate = measure(count, [&]() {
+            kernels->rotateToReference(w.planeX.data(), w.planeY.data(), orientation,
+                                       w.x.data(), w.y.data(), w.z.data(), count);
+        });
+        double screen = measure(count, [&]() {
+            kernels->screenDistances(w.x.data(), w.y.data(), w.z.data(), count, origin, 20.0f, w.within.data());
+        });
+
+        float difference = std::max(maxDifference(w.planeX, reference.planeX),
+                                    maxDifference(w.planeY, reference.planeY));
+
+        std::printf("%-10s %14.1f %14.1f %14.1f %14.1f %12.2e\n",
+                    cpuIsaName(kernels->isa), kepler, plane, rotate, screen, difference);
+    }
+
+    comparePerifocalForms(reference);
+    benchmarkKeplerBuckets(count);
+
+    std::printf("\nPropagators (scalar policies, baseline build)\n");
+    std::printf("%-8s %-38s %10s\n", "scalar", "solver/perturbations/frame", "Mobj/s");
+    benchmarkPropagators<float>(reference, "float");
+    benchmarkPropagators<double>(reference, "double");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,305 @@
+// Conjunction screening on a uniform grid before and after reordering the catalog
+// along a Morton curve (ObjectOrder). Reports screening time, hardware cache misses
+// where perf counters are available, and the mean memory distance between an object
+// and the candidates it inspects.
+//
+// Usage: OrbitLocalityBench [objectCount] [threadCount]
+
+#include "orbit/earth_constants.h"
+#include "orbit/orbit_kernels.h"
+#include "orbit/spatial_order.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Screening distance, also the grid cell size
+constexpr float THRESHOLD = 0.05f;
+
+constexpr int RUNS = 5;
+
+/**
+ * Counts user-space last-level cache misses of the calling thread, when the kernel
+ * lets us open a hardware counter.
+ */
+class CacheMissCounter {
+public:
+    CacheMissCounter() : m_fd(-1) {
+#if defined(__linux__)
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool isAvailable() const { return m_fd >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+#if defined(__linux__)
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int m_fd;
+};
+
+struct Catalog {
+    std::vector<float> x, y, z, vx, vy, vz, radius;
+    std::vector<uint32_t> flags;
+
+    explicit Catalog(size_t count) : x(count), y(count), z(count), vx(count), vy(count), vz(count),
+                                     radius(count), flags(count) {
+        // Mostly LEO shells with some MEO/GEO, positions from a Kepler propagation
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> leo(6.7f, 8.0f);
+        std::uniform_real_distribution<float> high(20.0f, 42.2f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 3.1415926f);
+
+        std::vector<float> a(count), e(count), b(count), n(count), M(count), inclination(count),
+                           periapsis(count), node(count);
+        for (size_t i = 0; i < count; i++) {
+            a[i] = (unit(rng) < 0.8f) ? leo(rng) : high(rng);
+            e[i] = 0.02f * unit(rng);
+            b[i] = a[i] * std::sqrt(1.0f - e[i] * e[i]);
+            n[i] = std::sqrt(EarthConstants<float>::MU / (a[i] * a[i] * a[i]));
+            M[i] = 2.0f * angle(rng);
+            inclination[i] = angle(rng);
+            periapsis[i] = 2.0f * angle(rng);
+            node[i] = 2.0f * angle(rng);
+            radius[i] = 0.001f;
+            flags[i] = static_cast<uint32_t>(i);
+        }
+
+        std::vector<float> orientation[6];
+        float* orientationOut[6];
+        const float* orientationIn[6];
+        for (int k = 0; k < 6; k++) {
+            orientation[k].resize(count);
+            orientationOut[k] = orientation[k].data();
+            orientationIn[k] = orientation[k].data();
+        }
+        computeOrientation(inclination.data(), periapsis.data(), node.data(), orientationOut, count);
+
+        const OrbitKernels& kernels = getOrbitKernels();
+        std::vector<float> E(count), cosE(count), sinE(count), px(count), py(count), pvx(count), pvy(count);
+        kernels.solveKepler(M.data(), e.data(), E.data(), cosE.data(), sinE.data(), count);
+        kernels.perifocalState(cosE.data(), sinE.data(), e.data(), a.data(), b.data(), n.data(),
+                               px.data(), py.data(), pvx.data(), pvy.data(), count);
+        kernels.rotateToReference(px.data(), py.data(), orientationIn, x.data(), y.data(), z.data(), count);
+        kernels.rotateToReference(pvx.data(), pvy.data(), orientationIn, vx.data(), vy.data(), vz.data(), count);
+    }
+};
+
+/**
+ * Uniform grid of cell size THRESHOLD over the catalog, stored as sorted cell lists.
+ */
+struct Grid {
+    float low[3];
+    int64_t dimensions[3];
+    std::vector<uint64_t> cellOf;      // per object
+    std::vector<uint32_t> objects;     // object slots sorted by cell
+    std::vector<uint64_t> cells;       // cell of each entry of objects
+
+    explicit Grid(const Catalog& catalog) {
+        size_t count = catalog.x.size();
+        const std::vector<float>* axes[3] = {&catalog.x, &catalog.y, &catalog.z};
+        for (int axis = 0; axis < 3; axis++) {
+            auto [lowIt, highIt] = std::minmax_element(axes[axis]->begin(), axes[axis]->end());
+            low[axis] = *lowIt;
+            dimensions[axis] = static_cast<int64_t>((*highIt - *lowIt) / THRESHOLD) + 1;
+        }
+
+        cellOf.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            cellOf[i] = cellIndex(cellCoordinate(catalog.x[i], 0), cellCoordinate(catalog.y[i], 1),
+                                  cellCoordinate(catalog.z[i], 2));
+        }
+
+        objects.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            objects[i] = static_cast<uint32_t>(i);
+        }
+        std::stable_sort(objects.begin(), objects.end(), [this](uint32_t a, uint32_t b) {
+            return cellOf[a] < cellOf[b];
+        });
+        cells.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            cells[i] = cellOf[objects[i]];
+        }
+    }
+
+    int64_t cellCoordinate(float value, int axis) const {
+        return static_cast<int64_t>((value - low[axis]) / THRESHOLD);
+    }
+
+    uint64_t cellIndex(int64_t cx, int64_t cy, int64_t cz) const {
+        return static_cast<uint64_t>((cz * dimensions[1] + cy) * dimensions[0] + cx);
+    }
+};
+
+struct ScreeningResult {
+    size_t pairs;
+    double candidateDistance;   // mean |slot difference| between object and candidate, in cache lines of x
+};
+
+/**
+ * Counts pairs closer than THRESHOLD, checking each object against the 27 cells around it.
+ */
+ScreeningResult screen(const Catalog& catalog, const Grid& grid, size_t begin, size_t end) {
+    ScreeningResult result = {0, 0.0};
+    double distanceSum = 0.0;
+    size_t candidates = 0;
+    float thresholdSquared = THRESHOLD * THRESHOLD;
+
+    for (size_t i = begin; i < end; i++) {
+        int64_t cx = grid.cellCoordinate(catalog.x[i], 0);
+        int64_t cy = grid.cellCoordinate(catalog.y[i], 1);
+        int64_t cz = grid.cellCoordinate(catalog.z[i], 2);
+
+        for (int64_t dz = -1; dz <= 1; dz++) {
+            for (int64_t dy = -1; dy <= 1; dy++) {
+                for (int64_t dx = -1; dx <= 1; dx++) {
+                    int64_t nx = cx + dx, ny = cy + dy, nz = cz + dz;
+                    if (nx < 0 || ny < 0 || nz < 0 || nx >= grid.dimensions[0] || ny >= grid.dimensions[1] ||
+                        nz >= grid.dimensions[2]) {
+                        continue;
+                    }
+
+                    uint64_t cell = grid.cellIndex(nx, ny, nz);
+                    auto first = std::lower_bound(grid.cells.begin(), grid.cells.end(), cell);
+                    for (auto it = first; it != grid.cells.end() && *it == cell; ++it) {
+                        uint32_t j = grid.objects[static_cast<size_t>(it - grid.cells.begin())];
+                        if (j <= i) {
+                            continue;
+                        }
+                        float ddx = catalog.x[i] - catalog.x[j];
+                        float ddy = catalog.y[i] - catalog.y[j];
+                        float ddz = catalog.z[i] - catalog.z[j];
+                        result.pairs += (ddx * ddx + ddy * ddy + ddz * ddz < thresholdSquared) ? 1 : 0;
+                        distanceSum += static_cast<double>(j - i) * sizeof(float) / 64.0;
+                        candidates++;
+                    }
+                }
+            }
+        }
+    }
+
+    result.candidateDistance = (candidates > 0) ? distanceSum / static_cast<double>(candidates) : 0.0;
+    return result;
+}
+
+void measure(const char* name, const Catalog& catalog, ThreadPool& pool) {
+    using Clock = std::chrono::steady_clock;
+    Grid grid(catalog);
+    CacheMissCounter counter;
+
+    // Cache misses of a single-threaded pass, then timed pool passes
+    counter.start();
+    ScreeningResult single = screen(catalog, grid, 0, catalog.x.size());
+    uint64_t misses = counter.stop();
+
+    double best = 1e30;
+    size_t pairs = 0;
+    for (int run = 0; run < RUNS; run++) {
+        std::vector<size_t> workerPairs(pool.getThreadCount(), 0);
+        auto start = Clock::now();
+        pool.parallelRanges(catalog.x.size(), [&](size_t begin, size_t end, size_t worker) {
+            workerPairs[worker] = screen(catalog, grid, begin, end).pairs;
+        });
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        pairs = 0;
+        for (size_t p : workerPairs) {
+            pairs += p;
+        }
+    }
+
+    char missText[32];
+    if (counter.isAvailable()) {
+        std::snprintf(missText, sizeof(missText), "%.2fM", static_cast<double>(misses) * 1e-6);
+    } else {
+        std::snprintf(missText, sizeof(missText), "n/a");
+    }
+    std::printf("%-18s %12.2f %10zu %14s %18.0f\n", name, best * 1e3, pairs, missText, single.candidateDistance);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    size_t threadCount = (argc > 2) ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 0;
+    if (objectCount == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [threadCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool pool(threadCount);
+    Catalog catalog(objectCount);
+    std::printf("%zu objects, %zu threads, screening distance %.3f\n\n", objectCount, pool.getThreadCount(), THRESHOLD);
+    std::printf("%-18s %12s %10s %14s %18s\n", "order", "screen ms", "pairs", "cache misses", "candidate dist (lines)");
+
+    measure("insertion", catalog, pool);
+
+    ObjectOrder order(objectCount);
+    uint32_t probeId = static_cast<uint32_t>(objectCount / 2);
+    float probeX = catalog.x[probeId];
+
+    auto start = std::chrono::steady_clock::now();
+    order.sortByPosition(catalog.x.data(), catalog.y.data(), catalog.z.data());
+    order.apply({catalog.x, catalog.y, catalog.z, catalog.vx, catalog.vy, catalog.vz, catalog.radius, catalog.flags},
+                &pool);
+    double reorderMs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e3;
+
+    measure("morton", catalog, pool);
+
+    // External IDs still find their object
+    bool idsStable = catalog.x[order.getSlot(probeId)] == probeX && catalog.flags[order.getSlot(probeId)] == probeId;
+    std::printf("\nreorder pass: %.2f ms for 8 arrays, IDs %s\n", reorderMs, idsStable ? "stable" : "BROKEN");
+
+    return idsStable ? EXIT_SUCCESS : EXIT_FAILURE;
+}
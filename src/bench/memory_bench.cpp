@@ -0,0 +1,222 @@
+// Propagation over large structure-of-arrays state, with the arrays in std::vector
+// (regular pages, zeroed by the main thread) versus LargeArray (huge pages, first
+// touched by the pinned workers that later process them).
+//
+// Usage: OrbitMemoryBench [objectCount] [historyLength] [threadCount]
+
+#include "orbit/earth_constants.h"
+#include "orbit/orbit_kernels.h"
+#include "platform/large_pages.h"
+#include "platform/numa_topology.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t BLOCK = 256;
+constexpr int STEPS = 20;
+
+/**
+ * Per-object state: elements with derived constants, orientation, current position and
+ * velocity, a ring of past positions per object, and a screening partner per object.
+ */
+template <typename Array>
+struct State {
+    Array semimajorAxis, eccentricity, semiminorAxis, meanMotion, meanAnomaly;
+    Array orientation[6];
+    Array position[3], velocity[3];
+    Array history[3];           // [object * historyLength + slot]
+    std::vector<uint32_t> partner;
+    size_t count;
+    size_t historyLength;
+
+    template <typename Make>
+    State(size_t objectCount, size_t length, Make make) : count(objectCount), historyLength(length) {
+        for (Array* array : {&semimajorAxis, &eccentricity, &semiminorAxis, &meanMotion, &meanAnomaly}) {
+            *array = make(count);
+        }
+        for (int k = 0; k < 3; k++) {
+            position[k] = make(count);
+            velocity[k] = make(count);
+            history[k] = make(count * historyLength);
+        }
+        for (int k = 0; k < 6; k++) {
+            orientation[k] = make(count);
+        }
+    }
+
+    size_t getBytes() const {
+        return count * (sizeof(float) * (5 + 6 + 3 + 3 + 3 * historyLength) + sizeof(uint32_t));
+    }
+};
+
+template <typename Array>
+void initialize(State<Array>& state) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> sma(6.6f, 45.0f);
+    std::uniform_real_distribution<float> ecc(0.0f, 0.7f);
+    std::uniform_real_distribution<float> angle(0.0f, 3.1415926f);
+
+    std::vector<float> inclination(state.count), periapsis(state.count), node(state.count);
+    for (size_t i = 0; i < state.count; i++) {
+        float a = sma(rng);
+        float e = ecc(rng);
+        state.semimajorAxis[i] = a;
+        state.eccentricity[i] = e;
+        state.semiminorAxis[i] = a * std::sqrt(1.0f - e * e);
+        state.meanMotion[i] = std::sqrt(EarthConstants<float>::MU / (a * a * a));
+        state.meanAnomaly[i] = 2.0f * angle(rng);
+        inclination[i] = angle(rng);
+        periapsis[i] = 2.0f * angle(rng);
+        node[i] = 2.0f * angle(rng);
+    }
+
+    float* orientation[6];
+    for (int k = 0; k < 6; k++) {
+        orientation[k] = state.orientation[k].data();
+    }
+    computeOrientation(inclination.data(), periapsis.data(), node.data(), orientation, state.count);
+
+    std::uniform_int_distribution<uint32_t> object(0, static_cast<uint32_t>(state.count - 1));
+    state.partner.resize(state.count);
+    for (uint32_t& partner : state.partner) {
+        partner = object(rng);
+    }
+}
+
+/**
+ * One propagation step over a worker's range: positions and velocities, a history
+ * append per object, and a distance check against a random partner.
+ */
+template <typename Array>
+size_t step(State<Array>& state, float time, size_t slot, size_t begin, size_t end) {
+    const OrbitKernels& kernels = getOrbitKernels();
+    float M[BLOCK], E[BLOCK], cosE[BLOCK], sinE[BLOCK], planeX[BLOCK], planeY[BLOCK], vx[BLOCK], vy[BLOCK];
+    size_t close = 0;
+
+    for (size_t first = begin; first < end; first += BLOCK) {
+        size_t n = std::min(BLOCK, end - first);
+        for (size_t i = 0; i < n; i++) {
+            M[i] = state.meanAnomaly[first + i] + state.meanMotion[first + i] * time;
+        }
+
+        const float* e = state.eccentricity.data() + first;
+        kernels.solveKepler(M, e, E, cosE, sinE, n);
+        kernels.perifocalState(cosE, sinE, e, state.semimajorAxis.data() + first, state.semiminorAxis.data() + first,
+                               state.meanMotion.data() + first, planeX, planeY, vx, vy, n);
+
+        const float* orientation[6];
+        for (int k = 0; k < 6; k++) {
+            orientation[k] = state.orientation[k].data() + first;
+        }
+        kernels.rotateToReference(planeX, planeY, orientation, state.position[0].data() + first,
+                                  state.position[1].data() + first, state.position[2].data() + first, n);
+        kernels.rotateToReference(vx, vy, orientation, state.velocity[0].data() + first,
+                                  state.velocity[1].data() + first, state.velocity[2].data() + first, n);
+
+        for (int k = 0; k < 3; k++) {
+            float* history = state.history[k].data();
+            const float* position = state.position[k].data();
+            for (size_t i = first; i < first + n; i++) {
+                history[i * state.historyLength + slot] = position[i];
+            }
+        }
+    }
+
+    // Partners are random, so these reads miss the TLB whenever pages are small
+    for (size_t i = begin; i < end; i++) {
+        uint32_t j = state.partner[i];
+        float dx = state.position[0][i] - state.position[0][j];
+        float dy = state.position[1][i] - state.position[1][j];
+        float dz = state.position[2][i] - state.position[2][j];
+        close += (dx * dx + dy * dy + dz * dz < 1.0f) ? 1 : 0;
+    }
+
+    return close;
+}
+
+template <typename Array>
+double run(State<Array>& state, ThreadPool& pool) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<size_t> close(pool.getThreadCount());
+
+    auto start = Clock::now();
+    for (int s = 0; s < STEPS; s++) {
+        pool.parallelRanges(state.count, [&](size_t begin, size_t end, size_t worker) {
+            close[worker] += step(state, 0.01f * static_cast<float>(s), static_cast<size_t>(s) % state.historyLength,
+                                  begin, end);
+        });
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    return static_cast<double>(state.count) * STEPS / elapsed * 1e-6;
+}
+
+size_t anonHugePagesKb() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    size_t value = 0;
+    while (meminfo >> key >> value) {
+        if (key == "AnonHugePages:") {
+            return value;
+        }
+        meminfo.ignore(256, '\n');
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 200000;
+    size_t historyLength = (argc > 2) ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : 64;
+    size_t threadCount = (argc > 3) ? static_cast<size_t>(std::strtoull(argv[3], nullptr, 10)) : 0;
+    if (objectCount == 0 || historyLength == 0) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [historyLength] [threadCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool pool(threadCount, true);
+    std::printf("%zu objects, history %zu, %zu threads pinned over %zu NUMA node(s)\n\n", objectCount,
+                historyLength, pool.getThreadCount(), getNumaTopology().getNodeCount());
+    std::printf("%-38s %10s %12s %16s\n", "storage", "MB", "Mobj/s", "AnonHuge MB");
+
+    {
+        // Regular pages, zero-filled by this thread as std::vector does
+        State<std::vector<float>> state(objectCount, historyLength, [](size_t n) {
+            return std::vector<float>(n);
+        });
+        initialize(state);
+        run(state, pool);
+        double rate = run(state, pool);
+        std::printf("%-38s %10.0f %12.1f %16s\n", "std::vector", state.getBytes() / 1e6, rate, "-");
+    }
+
+    for (PageMode mode : {PageMode::Transparent, PageMode::Explicit}) {
+        size_t hugeBefore = anonHugePagesKb();
+        PageMode obtained = PageMode::Default;
+        State<LargeArray<float>> state(objectCount, historyLength, [&](size_t n) {
+            LargeArray<float> array(n, mode);
+            array.firstTouch(&pool);
+            obtained = array.getPageMode();
+            return array;
+        });
+        initialize(state);
+        run(state, pool);
+        double rate = run(state, pool);
+        double hugeMb = static_cast<double>(anonHugePagesKb() - std::min(anonHugePagesKb(), hugeBefore)) / 1024.0;
+
+        std::string name = std::string("LargeArray, ") + pageModeName(mode) + " -> " + pageModeName(obtained);
+        std::printf("%-38s %10.0f %12.1f %16.0f\n", name.c_str(), state.getBytes() / 1e6, rate, hugeMb);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+// Synthetic observation generation: observations per minute for a catalog seen by a
+// network of radar and optical sensors, single-threaded and across the thread pool, and
+// optionally written to a CSV file.
+//
+// Six radars look at the whole sky above 10 degrees every 10 seconds out to 3000 km;
+// four telescopes with 30 degree fields of view take an exposure every 30 seconds at
+// night. The catalog mixes LEO, MEO and GEO orbits. The epoch is 2024-03-20 00:00 TT.
+//
+// Usage: OrbitObservationBench [objectCount] [hours] [output.csv]
+
+#include "orbit/observation_generator.h"
+#include "platform/thread_pool.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEGREES = PI / 180.0;
+constexpr double EARTH_RADIUS = 6378137.0;
+
+// 2024-03-20 00:00 TT, days since J2000.0
+constexpr double EPOCH_TT_DAYS = 8844.5;
+
+std::vector<SensorSite> makeSensors() {
+    std::vector<SensorSite> sensors;
+    const double radars[6][2] = {{42.6, -71.5}, {-20.0, 134.0}, {35.0, 139.0}, {64.3, -149.2},
+                                 {8.7, 167.7}, {52.7, 174.1}};
+    for (const auto& place : radars) {
+        SensorSite radar;
+        radar.type = SensorType::Radar;
+        radar.latitude = place[0] * DEGREES;
+        radar.longitude = place[1] * DEGREES;
+        sensors.push_back(radar);
+    }
+
+    const double telescopes[4][4] = {{33.8, -106.7, 90.0, 60.0}, {-30.2, -70.8, 0.0, 45.0},
+                                     {28.3, -16.5, 180.0, 50.0}, {-31.3, 149.1, 270.0, 70.0}};
+    for (const auto& place : telescopes) {
+        SensorSite telescope;
+        telescope.type = SensorType::Optical;
+        telescope.latitude = place[0] * DEGREES;
+        telescope.longitude = place[1] * DEGREES;
+        telescope.altitude = 2000.0;
+        telescope.boresightAzimuth = place[2] * DEGREES;
+        telescope.boresightElevation = place[3] * DEGREES;
+        telescope.fieldOfView = 15.0 * DEGREES;
+        telescope.maxRange = 50000e3;
+        telescope.cadence = 30.0;
+        telescope.angleSigma = 1.0 / 3600.0 * DEGREES;
+        sensors.push_back(telescope);
+    }
+    return sensors;
+}
+
+std::vector<KeplerianElements> makeCatalog(size_t count) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<KeplerianElements> catalog(count);
+    for (KeplerianElements& orbit : catalog) {
+        double regime = unit(rng);
+        if (regime < 0.8) {
+            orbit.semimajorAxis = EARTH_RADIUS + 400e3 + 1600e3 * unit(rng);
+            orbit.eccentricity = 0.02 * unit(rng);
+            orbit.inclination = std::acos(1.0 - 2.0 * unit(rng));
+        } else if (regime < 0.9) {
+            orbit.semimajorAxis = 26560e3 + 1000e3 * (unit(rng) - 0.5);
+            orbit.eccentricity = 0.01 * unit(rng);
+            orbit.inclination = (50.0 + 15.0 * unit(rng)) * DEGREES;
+        } else {
+            orbit.semimajorAxis = 42164e3 + 200e3 * (unit(rng) - 0.5);
+            orbit.eccentricity = 0.001 * unit(rng);
+            orbit.inclination = 5.0 * unit(rng) * DEGREES;
+        }
+        orbit.argumentOfPeriapsis = 2.0 * PI * unit(rng);
+        orbit.longitudeOfAscendingNode = 2.0 * PI * unit(rng);
+        orbit.meanAnomaly = 2.0 * PI * unit(rng);
+    }
+    return catalog;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t objectCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 20000;
+    double hours = (argc > 2) ? std::strtod(argv[2], nullptr) : 1.0;
+    const char* outputPath = (argc > 3) ? argv[3] : nullptr;
+    if (objectCount == 0 || !(hours > 0.0)) {
+        std::fprintf(stderr, "Usage: %s [objectCount] [hours] [output.csv]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<SensorSite> sensors = makeSensors();
+    std::vector<KeplerianElements> catalog = makeCatalog(objectCount);
+    ObservationGeneratorSettings settings;
+    settings.epochTtDays = EPOCH_TT_DAYS;
+    ThreadPool pool;
+    std::printf("%zu objects, %zu sensors, %.1f hours, %zu threads\n\n", objectCount, sensors.size(), hours,
+                pool.getThreadCount());
+
+    std::printf("%-24s %14s %16s %10s\n", "mode", "observations", "per minute", "ordered");
+    for (int mode = 0; mode < (outputPath ? 3 : 2); mode++) {
+        ThreadPool* threads = (mode == 0) ? nullptr : &pool;
+        ObservationGenerator generator(sensors, settings);
+        generator.setObjects(catalog.data(), catalog.size());
+        std::unique_ptr<ObservationWriter> writer;
+        if (mode == 2) {
+            writer = std::make_unique<ObservationWriter>(outputPath);
+        }
+
+        // Check the stream is in time order across windows as it arrives
+        double lastTime = -1e300;
+        bool ordered = true;
+        auto start = std::chrono::steady_clock::now();
+        generator.generate(0.0, hours * 3600.0, [&](const Observation* observations, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                ordered = ordered && observations[i].time >= lastTime;
+                lastTime = observations[i].time;
+            }
+            if (writer) {
+                writer->write(observations, count, generator);
+            }
+        }, threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const char* name = (mode == 0) ? "single thread" : (mode == 1) ? "looks across pool" : "pool, writing CSV";
+        std::printf("%-24s %14llu %14.2fM %10s\n", name, static_cast<unsigned long long>(generator.getObservationCount()),
+                    generator.getObservationCount() / seconds * 60.0 * 1e-6, ordered ? "yes" : "NO");
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+// Relative motion: RIC conversion and closed-form propagation throughput for a swarm of
+// deputies around one chief, and the accuracy of Clohessy-Wiltshire and
+// Yamanaka-Ankersen propagation against exact two-body motion.
+//
+// Deputies start at random RIC offsets of a given size with matching velocity offsets
+// (offset times the chief's mean motion). Both linear propagators run for one chief
+// period; the truth converts every deputy to elements and back at the final time.
+//
+// Usage: OrbitRelativeBench [deputyCount]
+
+#include "orbit/relative_motion.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double MU = 3.986004415e14;
+constexpr double PI = 3.14159265358979323846;
+constexpr double STEP = 10.0;
+
+struct StateArrays {
+    std::vector<double> values[6];
+
+    explicit StateArrays(size_t count) {
+        for (std::vector<double>& component : values) {
+            component.assign(count, 0.0);
+        }
+    }
+
+    CartesianStateBatch batch() {
+        return {values[0].data(), values[1].data(), values[2].data(), values[3].data(), values[4].data(),
+                values[5].data(), values[0].size()};
+    }
+};
+
+KeplerianElements makeChief(double eccentricity) {
+    KeplerianElements chief;
+    chief.semimajorAxis = 7000e3 / (1.0 - eccentricity);  // perigee near 630 km altitude
+    chief.eccentricity = eccentricity;
+    chief.inclination = 51.6 * PI / 180.0;
+    chief.argumentOfPeriapsis = 0.5;
+    chief.longitudeOfAscendingNode = 1.2;
+    chief.meanAnomaly = 0.3;
+    return chief;
+}
+
+StateArrays makeSwarm(size_t count, double offset, double meanMotion) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    StateArrays swarm(count);
+    for (size_t i = 0; i < count; i++) {
+        for (int k = 0; k < 3; k++) {
+            swarm.values[k][i] = offset * unit(rng);
+            swarm.values[k + 3][i] = offset * meanMotion * unit(rng);
+        }
+    }
+    return swarm;
+}
+
+struct Accuracy {
+    double clohessyWiltshire;
+    double yamanakaAnkersen;
+};
+
+/**
+ * Median position error after one chief period, meters.
+ */
+Accuracy measureAccuracy(const KeplerianElements& chief, size_t count, double offset) {
+    double period = 2.0 * PI * std::sqrt(chief.semimajorAxis * chief.semimajorAxis * chief.semimajorAxis / MU);
+    double meanMotion = 2.0 * PI / period;
+    StateArrays relative = makeSwarm(count, offset, meanMotion);
+
+    double chiefPosition[3], chiefVelocity[3];
+    keplerianToCartesian(chief, MU, 0.0, chiefPosition, chiefVelocity);
+    StateArrays inertial(count);
+    relativeToInertial(chiefPosition, chiefVelocity, relative.batch(), inertial.batch());
+
+    // Exact two-body truth at the end
+    double finalPosition[3], finalVelocity[3];
+    keplerianToCartesian(chief, MU, period, finalPosition, finalVelocity);
+    for (size_t i = 0; i < count; i++) {
+        double position[3], velocity[3];
+        for (int k = 0; k < 3; k++) {
+            position[k] = inertial.values[k][i];
+            velocity[k] = inertial.values[k + 3][i];
+        }
+        KeplerianElements deputy = cartesianToKeplerian(position, velocity, MU);
+        keplerianToCartesian(deputy, MU, period, position, velocity);
+        for (int k = 0; k < 3; k++) {
+            inertial.values[k][i] = position[k];
+            inertial.values[k + 3][i] = velocity[k];
+        }
+    }
+    StateArrays truth(count);
+    inertialToRelative(finalPosition, finalVelocity, inertial.batch(), truth.batch());
+
+    Accuracy accuracy;
+    for (int method = 0; method < 2; method++) {
+        double transition[6][6];
+        if (method == 0) {
+            clohessyWiltshireTransition(meanMotion, period, transition);
+        } else {
+            yamanakaAnkersenTransition(chief, MU, period, transition);
+        }
+        StateArrays propagated = relative;
+        applyRelativeTransition(transition, propagated.batch());
+
+        std::vector<double> errors(count);
+        for (size_t i = 0; i < count; i++) {
+            errors[i] = std::hypot(propagated.values[0][i] - truth.values[0][i],
+                                   std::hypot(propagated.values[1][i] - truth.values[1][i],
+                                              propagated.values[2][i] - truth.values[2][i]));
+        }
+        std::nth_element(errors.begin(), errors.begin() + count / 2, errors.end());
+        (method == 0 ? accuracy.clohessyWiltshire : accuracy.yamanakaAnkersen) = errors[count / 2];
+    }
+    return accuracy;
+}
+
+template <typename Function>
+double deputiesPerSecond(size_t count, size_t repeats, Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t repeat = 0; repeat < repeats; repeat++) {
+        function();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count * repeats / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t deputyCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 1000000;
+    if (deputyCount == 0) {
+        std::fprintf(stderr, "Usage: %s [deputyCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool pool;
+    std::printf("%zu deputies, %zu threads\n\n", deputyCount, pool.getThreadCount());
+
+    // Accuracy over one period against exact two-body motion
+    std::printf("%-14s %12s %20s %20s\n", "eccentricity", "offset", "Clohessy-Wiltshire", "Yamanaka-Ankersen");
+    for (double eccentricity : {0.0, 0.01, 0.1, 0.5}) {
+        for (double offset : {100.0, 1000.0, 10000.0}) {
+            Accuracy accuracy = measureAccuracy(makeChief(eccentricity), 2000, offset);
+            std::printf("%-14.2f %10.0f m %18.3f m %18.3f m\n", eccentricity, offset, accuracy.clohessyWiltshire,
+                        accuracy.yamanakaAnkersen);
+        }
+    }
+
+    // Throughput: one STM per step shared by the whole swarm
+    KeplerianElements chief = makeChief(0.1);
+    double chiefPosition[3], chiefVelocity[3];
+    keplerianToCartesian(chief, MU, 0.0, chiefPosition, chiefVelocity);
+    double meanMotion = std::sqrt(MU / (chief.semimajorAxis * chief.semimajorAxis * chief.semimajorAxis));
+    StateArrays relative = makeSwarm(deputyCount, 1000.0, meanMotion);
+    StateArrays inertial(deputyCount);
+    size_t repeats = std::max<size_t>(1, 20000000 / deputyCount);
+
+    std::printf("\n%-26s %-8s %16s\n", "operation", "threads", "M deputies/s");
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        size_t threadCount = threads ? threads->getThreadCount() : 1;
+        double rate = deputiesPerSecond(deputyCount, repeats, [&] {
+            relativeToInertial(chiefPosition, chiefVelocity, relative.batch(), inertial.batch(), threads);
+        });
+        std::printf("%-26s %-8zu %16.1f\n", "relative to inertial", threadCount, rate * 1e-6);
+
+        rate = deputiesPerSecond(deputyCount, repeats, [&] {
+            inertialToRelative(chiefPosition, chiefVelocity, inertial.batch(), relative.batch(), threads);
+        });
+        std::printf("%-26s %-8zu %16.1f\n", "inertial to relative", threadCount, rate * 1e-6);
+
+        double transition[6][6];
+        rate = deputiesPerSecond(deputyCount, repeats, [&] {
+            clohessyWiltshireTransition(meanMotion, STEP, transition);
+            applyRelativeTransition(transition, relative.batch(), threads);
+        });
+        std::printf("%-26s %-8zu %16.1f\n", "Clohessy-Wiltshire step", threadCount, rate * 1e-6);
+
+        double time = 0.0;
+        rate = deputiesPerSecond(deputyCount, repeats, [&] {
+            KeplerianElements current = chief;
+            current.meanAnomaly += meanMotion * time;
+            yamanakaAnkersenTransition(current, MU, STEP, transition);
+            applyRelativeTransition(transition, relative.batch(), threads);
+            time += STEP;
+        });
+        std::printf("%-26s %-8zu %16.1f\n", "Yamanaka-Ankersen step", threadCount, rate * 1e-6);
+    }
+    return EXIT_SUCCESS;
+}
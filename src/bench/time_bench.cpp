@@ -0,0 +1,97 @@
+// Time scale conversion throughput: a time-ordered batch through
+// TimeScales::convert(), which walks the leap second and Earth orientation segments,
+// versus converting each epoch on its own with a fresh table search.
+//
+// Usage: OrbitTimeBench [epochCount]
+
+#include "orbit/time_scales.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+template <typename Function>
+double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Daily Earth orientation values from 1992 to 2032, shaped like the real ones: dUT1
+ * drifting by about 1 ms per day and jumping by 1 s at each leap second.
+ */
+std::vector<TimeScales::EarthOrientation> syntheticEarthOrientation(const TimeScales& timeScales) {
+    std::vector<TimeScales::EarthOrientation> records;
+    Epoch first = epochFromCalendar(1992, 1, 1);
+    Epoch last = epochFromCalendar(2032, 1, 1);
+    double drift = 0.0;
+    for (Epoch utc = first; utc < last; utc += NANOSECONDS_PER_DAY) {
+        drift -= 0.001;
+        double taiMinusUtc = static_cast<double>(timeScales.getTaiMinusUtc(utc)) * 1e-9;
+        double ut1MinusUtc = std::fmod(drift + taiMinusUtc + 0.5, 1.0) - 0.5;
+        double phase = static_cast<double>(utc) / static_cast<double>(NANOSECONDS_PER_DAY) / 433.0;
+        records.push_back({utc, ut1MinusUtc, {1e-6 * std::cos(phase), 1.5e-6 * std::sin(phase)}});
+    }
+    return records;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t epochCount = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 10000000;
+    if (epochCount == 0) {
+        std::fprintf(stderr, "Usage: %s [epochCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    TimeScales timeScales;
+    timeScales.setEarthOrientation(syntheticEarthOrientation(timeScales));
+
+    // Ephemeris-like epochs: 10 s steps starting in 2016, crossing the 2017 leap second
+    std::vector<Epoch> epochs(epochCount);
+    Epoch start = epochFromCalendar(2016, 6, 1);
+    for (size_t i = 0; i < epochCount; i++) {
+        epochs[i] = start + static_cast<Epoch>(i) * 10 * NANOSECONDS_PER_SECOND;
+    }
+    std::vector<Epoch> batched(epochCount), single(epochCount);
+
+    std::printf("%zu epochs, %zu leap seconds, %zu Earth orientation days\n\n", epochCount,
+                timeScales.getLeapSecondCount(), timeScales.getEarthOrientationCount());
+    std::printf("%-14s %16s %16s %12s\n", "conversion", "batch ns/epoch", "single ns/epoch", "mismatches");
+
+    const struct {
+        const char* name;
+        TimeScale from;
+        TimeScale to;
+    } conversions[] = {
+        {"UTC -> TT", TimeScale::Utc, TimeScale::Tt},
+        {"UTC -> UT1", TimeScale::Utc, TimeScale::Ut1},
+        {"TT -> UT1", TimeScale::Tt, TimeScale::Ut1},
+        {"UT1 -> TT", TimeScale::Ut1, TimeScale::Tt},
+    };
+
+    for (const auto& conversion : conversions) {
+        double batchSeconds = measure([&]() {
+            timeScales.convert(epochs.data(), batched.data(), epochCount, conversion.from, conversion.to);
+        });
+        double singleSeconds = measure([&]() {
+            for (size_t i = 0; i < epochCount; i++) {
+                single[i] = timeScales.convert(epochs[i], conversion.from, conversion.to);
+            }
+        });
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < epochCount; i++) {
+            mismatches += (batched[i] != single[i]) ? 1 : 0;
+        }
+        std::printf("%-14s %16.2f %16.2f %12zu\n", conversion.name,
+                    batchSeconds * 1e9 / static_cast<double>(epochCount),
+                    singleSeconds * 1e9 / static_cast<double>(epochCount), mismatches);
+    }
+
+    return EXIT_SUCCESS;
+}
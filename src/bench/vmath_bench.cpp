@@ -0,0 +1,159 @@
+// Accuracy and throughput of the vmath functions (orbit/vector_math.h) against libm,
+// at float and double precision. Accuracy is measured in ULPs against long double.
+//
+// Usage: OrbitMathBench [sampleCount]
+
+#include "orbit/vector_math.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Minimum wall time spent in each throughput measurement
+constexpr double MIN_SECONDS = 0.25;
+
+// Elements per throughput batch (fits in L1/L2 so the math dominates)
+constexpr size_t BATCH = 4096;
+
+/**
+ * Distance from a result to the reference, in units of the reference's last place.
+ */
+template <typename T>
+double ulpError(T value, long double reference) {
+    T rounded = static_cast<T>(reference);
+    T magnitude = std::fabs(rounded);
+    T ulp = std::nextafter(magnitude, std::numeric_limits<T>::infinity()) - magnitude;
+    if (magnitude == T(0)) {
+        ulp = std::numeric_limits<T>::denorm_min();
+    }
+    return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / ulp);
+}
+
+template <typename T>
+void reportAccuracy(const char* typeName, T sincosRange, size_t samples) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> angle(-static_cast<double>(sincosRange), static_cast<double>(sincosRange));
+    std::uniform_real_distribution<double> coordinate(-1e3, 1e3);
+    std::uniform_real_distribution<double> positive(1e-6, 1e6);
+
+    double sinError = 0.0, cosError = 0.0, atan2Error = 0.0, rsqrtError = 0.0;
+    for (size_t i = 0; i < samples; i++) {
+        T x = static_cast<T>(angle(rng));
+        T s, c;
+        vmath::sincos(x, s, c);
+        sinError = std::max(sinError, ulpError(s, std::sin(static_cast<long double>(x))));
+        cosError = std::max(cosError, ulpError(c, std::cos(static_cast<long double>(x))));
+
+        T py = static_cast<T>(coordinate(rng));
+        T px = static_cast<T>(coordinate(rng));
+        atan2Error = std::max(atan2Error, ulpError(vmath::atan2(py, px),
+                                                   std::atan2(static_cast<long double>(py), static_cast<long double>(px))));
+
+        T v = static_cast<T>(positive(rng));
+        rsqrtError = std::max(rsqrtError, ulpError(vmath::rsqrt(v), 1.0L / std::sqrt(static_cast<long double>(v))));
+    }
+
+    std::printf("%-7s max ULP: sin %.2f, cos %.2f (|x| <= %g), atan2 %.2f, rsqrt %.2f\n",
+                typeName, sinError, cosError, static_cast<double>(sincosRange), atan2Error, rsqrtError);
+}
+
+template <typename Kernel>
+double measure(Kernel kernel) {
+    using Clock = std::chrono::steady_clock;
+
+    kernel();
+
+    size_t runs = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        kernel();
+        runs++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < MIN_SECONDS);
+
+    return static_cast<double>(BATCH) * static_cast<double>(runs) / elapsed * 1e-6;
+}
+
+template <typename T>
+void reportThroughput(const char* typeName) {
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> angle(-10.0, 10.0);
+
+    std::vector<T> x(BATCH), y(BATCH), out0(BATCH), out1(BATCH);
+    for (size_t i = 0; i < BATCH; i++) {
+        x[i] = static_cast<T>(angle(rng));
+        y[i] = static_cast<T>(angle(rng));
+    }
+    for (size_t i = 0; i < BATCH; i++) {
+        y[i] = std::fabs(y[i]) + T(0.1);
+    }
+
+    T* __restrict o0 = out0.data();
+    T* __restrict o1 = out1.data();
+    const T* __restrict xs = x.data();
+    const T* __restrict ys = y.data();
+
+    double libmSincos = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            o0[i] = std::sin(xs[i]);
+            o1[i] = std::cos(xs[i]);
+        }
+    });
+    double vmathSincos = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            vmath::sincos(xs[i], o0[i], o1[i]);
+        }
+    });
+    double libmAtan2 = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            o0[i] = std::atan2(ys[i], xs[i]);
+        }
+    });
+    double vmathAtan2 = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            o0[i] = vmath::atan2(ys[i], xs[i]);
+        }
+    });
+    double libmRsqrt = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            o0[i] = T(1) / std::sqrt(ys[i]);
+        }
+    });
+    double vmathRsqrt = measure([&]() {
+        for (size_t i = 0; i < BATCH; i++) {
+            o0[i] = vmath::rsqrt(ys[i]);
+        }
+    });
+
+    std::printf("%-7s %-8s %10.1f %10.1f %8.2fx\n", typeName, "sincos", libmSincos, vmathSincos, vmathSincos / libmSincos);
+    std::printf("%-7s %-8s %10.1f %10.1f %8.2fx\n", typeName, "atan2", libmAtan2, vmathAtan2, vmathAtan2 / libmAtan2);
+    std::printf("%-7s %-8s %10.1f %10.1f %8.2fx\n", typeName, "rsqrt", libmRsqrt, vmathRsqrt, vmathRsqrt / libmRsqrt);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t samples = (argc > 1) ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 2000000;
+    if (samples == 0) {
+        std::fprintf(stderr, "Usage: %s [sampleCount]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    reportAccuracy<float>("float", 4096.0f, samples);
+    reportAccuracy<float>("float", 6.3f, samples);
+    reportAccuracy<double>("double", 1e6, samples);
+    reportAccuracy<double>("double", 6.3, samples);
+
+    std::printf("\n%-7s %-8s %10s %10s %9s\n", "type", "function", "libm M/s", "vmath M/s", "speedup");
+    reportThroughput<float>("float");
+    reportThroughput<double>("double");
+
+    return EXIT_SUCCESS;
+}
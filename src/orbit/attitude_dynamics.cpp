@@ -0,0 +1,320 @@
+#include "orbit/attitude_dynamics.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Objects per chunk; the chunk's scratch (49 arrays) takes about 50 KB
+constexpr size_t CHUNK = 128;
+
+// State components: quaternion (scalar first), then body rates
+constexpr int STATE_SIZE = 7;
+
+/**
+ * Fills a rotation matrix, body axes as columns, from a scalar-first unit quaternion.
+ */
+void quaternionToMatrix(double w, double x, double y, double z, double m[3][3]) {
+    m[0][0] = 1.0 - 2.0 * (y * y + z * z);
+    m[0][1] = 2.0 * (x * y - w * z);
+    m[0][2] = 2.0 * (x * z + w * y);
+    m[1][0] = 2.0 * (x * y + w * z);
+    m[1][1] = 1.0 - 2.0 * (x * x + z * z);
+    m[1][2] = 2.0 * (y * z - w * x);
+    m[2][0] = 2.0 * (x * z - w * y);
+    m[2][1] = 2.0 * (y * z + w * x);
+    m[2][2] = 1.0 - 2.0 * (x * x + y * y);
+}
+
+/**
+ * Gets the attitude the control law drives one object towards, target body axes as
+ * columns, and its inertial angular rate.
+ */
+void targetAttitude(const AttitudeModelConfig& config, const double position[3], const double velocity[3],
+                    double target[3][3], double rate[3]) {
+    if (config.control != AttitudeControlMode::NadirPointing) {
+        const double* q = config.holdQuaternion;
+        double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        quaternionToMatrix(q[0] / norm, q[1] / norm, q[2] / norm, q[3] / norm, target);
+        rate[0] = rate[1] = rate[2] = 0.0;
+        return;
+    }
+
+    // The nadir-pointing frame turns with the radius vector, at h / r^2 about the normal
+    double h[3] = {position[1] * velocity[2] - position[2] * velocity[1],
+                   position[2] * velocity[0] - position[0] * velocity[2],
+                   position[0] * velocity[1] - position[1] * velocity[0]};
+    double r2 = position[0] * position[0] + position[1] * position[1] + position[2] * position[2];
+    double r = std::sqrt(r2);
+    double hNorm = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+    double z[3], y[3];
+    for (int k = 0; k < 3; k++) {
+        z[k] = -position[k] / r;
+        y[k] = -h[k] / hNorm;
+        rate[k] = h[k] / r2;
+    }
+    double x[3] = {y[1] * z[2] - y[2] * z[1], y[2] * z[0] - y[0] * z[2], y[0] * z[1] - y[1] * z[0]};
+    for (int k = 0; k < 3; k++) {
+        target[k][0] = x[k];
+        target[k][1] = y[k];
+        target[k][2] = z[k];
+    }
+}
+
+// Rows of a chunk's per-object constants, CHUNK doubles each
+constexpr size_t RADIAL = 0;            // unit position, 3 rows
+constexpr size_t GRAVITY_SCALE = 3;     // 3 mu / r^3, or zero without gravity gradient
+constexpr size_t TARGET = 4;            // target body axes as columns, 9 rows, row-major
+constexpr size_t TARGET_RATE = 13;      // inertial, 3 rows
+constexpr size_t ORBIT_NORMAL = 16;     // unit angular momentum, 3 rows
+constexpr size_t STEP_COSINE = 19;      // cosine and sine of the orbit's turn in one step
+constexpr size_t STEP_SINE = 20;
+constexpr size_t CONSTANT_ROWS = 21;
+
+// Chunk scratch: start state, slope sum, stage state and slope, then the constants
+constexpr size_t SCRATCH_SIZE = (4 * STATE_SIZE + CONSTANT_ROWS) * CHUNK;
+
+struct ControlGains {
+    double proportional;
+    double derivative;
+    double maxTorque;
+};
+
+/**
+ * Turns a chunk's radius directions, and the nadir-pointing targets, by one step of
+ * orbital motion about the orbit normals (Rodrigues' formula).
+ */
+void advanceOrbitFrames(double* __restrict constants, bool rotateTargets, size_t n) {
+    const double* __restrict normal = constants + ORBIT_NORMAL * CHUNK;
+    const double* __restrict cosine = constants + STEP_COSINE * CHUNK;
+    const double* __restrict sine = constants + STEP_SINE * CHUNK;
+
+    // Radius, then each target axis: rows (x, y, z) of a column of the target
+    size_t firstRows[4] = {RADIAL, TARGET, TARGET + 1, TARGET + 2};
+    size_t rowStrides[4] = {1, 3, 3, 3};
+    int vectorCount = rotateTargets ? 4 : 1;
+    for (int vector = 0; vector < vectorCount; vector++) {
+        double* __restrict vx = constants + firstRows[vector] * CHUNK;
+        double* __restrict vy = vx + rowStrides[vector] * CHUNK;
+        double* __restrict vz = vy + rowStrides[vector] * CHUNK;
+        for (size_t i = 0; i < n; i++) {
+            double kx = normal[i], ky = normal[CHUNK + i], kz = normal[2 * CHUNK + i];
+            double cosA = cosine[i], sinA = sine[i];
+            double x = vx[i], y = vy[i], z = vz[i];
+            double along = (kx * x + ky * y + kz * z) * (1.0 - cosA);
+            vx[i] = x * cosA + (ky * z - kz * y) * sinA + kx * along;
+            vy[i] = y * cosA + (kz * x - kx * z) * sinA + ky * along;
+            vz[i] = z * cosA + (kx * y - ky * x) * sinA + kz * along;
+        }
+    }
+}
+
+/**
+ * Evaluates the state derivative of a chunk. States, slopes and constants are rows of
+ * CHUNK doubles; restrict-qualified bases let the loop vectorize without alias checks.
+ */
+void attitudeRates(const double* __restrict y, double* __restrict dy, const double* __restrict constants,
+                   const double* __restrict inertiaX, const double* __restrict inertiaY,
+                   const double* __restrict inertiaZ, const ControlGains& gains, size_t n) {
+    const double kR = gains.proportional;
+    const double kW = gains.derivative;
+    const double maxTorque = gains.maxTorque;
+    const double* __restrict radial = constants + RADIAL * CHUNK;
+    const double* __restrict gravityScale = constants + GRAVITY_SCALE * CHUNK;
+    const double* __restrict target = constants + TARGET * CHUNK;
+    const double* __restrict targetRate = constants + TARGET_RATE * CHUNK;
+    for (size_t i = 0; i < n; i++) {
+        double qw = y[i], qx = y[CHUNK + i], qy = y[2 * CHUNK + i], qz = y[3 * CHUNK + i];
+        double wx = y[4 * CHUNK + i], wy = y[5 * CHUNK + i], wz = y[6 * CHUNK + i];
+        double ix = inertiaX[i], iy = inertiaY[i], iz = inertiaZ[i];
+
+        // Body axes in the inertial frame, as columns
+        double r00 = 1.0 - 2.0 * (qy * qy + qz * qz), r01 = 2.0 * (qx * qy - qw * qz), r02 = 2.0 * (qx * qz + qw * qy);
+        double r10 = 2.0 * (qx * qy + qw * qz), r11 = 1.0 - 2.0 * (qx * qx + qz * qz), r12 = 2.0 * (qy * qz - qw * qx);
+        double r20 = 2.0 * (qx * qz - qw * qy), r21 = 2.0 * (qy * qz + qw * qx), r22 = 1.0 - 2.0 * (qx * qx + qy * qy);
+
+        // Gravity gradient: 3 mu / r^3 (n x I n), n the unit radius in body axes
+        double ux = radial[i], uy = radial[CHUNK + i], uz = radial[2 * CHUNK + i];
+        double nx = r00 * ux + r10 * uy + r20 * uz;
+        double ny = r01 * ux + r11 * uy + r21 * uz;
+        double nz = r02 * ux + r12 * uy + r22 * uz;
+        double scale = gravityScale[i];
+        double tx = scale * (iz - iy) * ny * nz;
+        double ty = scale * (ix - iz) * nz * nx;
+        double tz = scale * (iy - ix) * nx * ny;
+
+        // Attitude error e_R = vee(D^T R - R^T D) / 2, rate error against the target
+        // rate in body axes; zero gains switch control off without a branch
+        double d00 = target[i], d01 = target[CHUNK + i], d02 = target[2 * CHUNK + i];
+        double d10 = target[3 * CHUNK + i], d11 = target[4 * CHUNK + i], d12 = target[5 * CHUNK + i];
+        double d20 = target[6 * CHUNK + i], d21 = target[7 * CHUNK + i], d22 = target[8 * CHUNK + i];
+        double m01 = d00 * r01 + d10 * r11 + d20 * r21, m10 = d01 * r00 + d11 * r10 + d21 * r20;
+        double m02 = d00 * r02 + d10 * r12 + d20 * r22, m20 = d02 * r00 + d12 * r10 + d22 * r20;
+        double m12 = d01 * r02 + d11 * r12 + d21 * r22, m21 = d02 * r01 + d12 * r11 + d22 * r21;
+        double ex = 0.5 * (m21 - m12), ey = 0.5 * (m02 - m20), ez = 0.5 * (m10 - m01);
+
+        double ox = targetRate[i], oy = targetRate[CHUNK + i], oz = targetRate[2 * CHUNK + i];
+        double fx = wx - (r00 * ox + r10 * oy + r20 * oz);
+        double fy = wy - (r01 * ox + r11 * oy + r21 * oz);
+        double fz = wz - (r02 * ox + r12 * oy + r22 * oz);
+
+        tx += std::clamp(-ix * (kR * ex + kW * fx), -maxTorque, maxTorque);
+        ty += std::clamp(-iy * (kR * ey + kW * fy), -maxTorque, maxTorque);
+        tz += std::clamp(-iz * (kR * ez + kW * fz), -maxTorque, maxTorque);
+
+        // Euler's equations and quaternion kinematics, q' = q (0, w) / 2
+        dy[i] = -0.5 * (qx * wx + qy * wy + qz * wz);
+        dy[CHUNK + i] = 0.5 * (qw * wx + qy * wz - qz * wy);
+        dy[2 * CHUNK + i] = 0.5 * (qw * wy + qz * wx - qx * wz);
+        dy[3 * CHUNK + i] = 0.5 * (qw * wz + qx * wy - qy * wx);
+        dy[4 * CHUNK + i] = (tx - (iz - iy) * wy * wz) / ix;
+        dy[5 * CHUNK + i] = (ty - (ix - iz) * wz * wx) / iy;
+        dy[6 * CHUNK + i] = (tz - (iy - ix) * wx * wy) / iz;
+    }
+}
+
+/**
+ * Fills a chunk's constants from the orbits at the start of the call.
+ */
+void prepareConstants(const AttitudeModelConfig& config, const CartesianStateBatch& orbits, double timeStep,
+                      size_t begin, size_t n, double* constants) {
+    for (size_t i = 0; i < n; i++) {
+        size_t object = begin + i;
+        double position[3] = {orbits.x[object], orbits.y[object], orbits.z[object]};
+        double velocity[3] = {orbits.vx[object], orbits.vy[object], orbits.vz[object]};
+        double r = std::sqrt(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+        double target[3][3], targetRate[3];
+        targetAttitude(config, position, velocity, target, targetRate);
+        for (size_t k = 0; k < 3; k++) {
+            constants[(RADIAL + k) * CHUNK + i] = position[k] / r;
+            constants[(TARGET_RATE + k) * CHUNK + i] = targetRate[k];
+            for (size_t column = 0; column < 3; column++) {
+                constants[(TARGET + 3 * k + column) * CHUNK + i] = target[k][column];
+            }
+        }
+        constants[GRAVITY_SCALE * CHUNK + i] = config.gravityGradient ? 3.0 * config.mu / (r * r * r) : 0.0;
+
+        // Orbital motion over the call as a uniform turn about the normal at h / r^2
+        double h[3] = {position[1] * velocity[2] - position[2] * velocity[1],
+                       position[2] * velocity[0] - position[0] * velocity[2],
+                       position[0] * velocity[1] - position[1] * velocity[0]};
+        double hNorm = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+        for (size_t k = 0; k < 3; k++) {
+            constants[(ORBIT_NORMAL + k) * CHUNK + i] = (hNorm > 0.0) ? h[k] / hNorm : 0.0;
+        }
+        double angle = hNorm / (r * r) * timeStep;
+        constants[STEP_COSINE * CHUNK + i] = std::cos(angle);
+        constants[STEP_SINE * CHUNK + i] = std::sin(angle);
+    }
+}
+
+void propagateChunk(const AttitudeModelConfig& config, const AttitudeStateBatch& state, const InertiaBatch& inertia,
+                    const CartesianStateBatch& orbits, double timeStep, size_t stepCount, size_t begin,
+                    size_t n, double* scratch) {
+    double* __restrict y0 = scratch;
+    double* __restrict sum = y0 + STATE_SIZE * CHUNK;
+    double* __restrict stage = sum + STATE_SIZE * CHUNK;
+    double* __restrict rate = stage + STATE_SIZE * CHUNK;
+    double* constants = rate + STATE_SIZE * CHUNK;
+    prepareConstants(config, orbits, timeStep, begin, n, constants);
+
+    bool controlled = config.control != AttitudeControlMode::None;
+    ControlGains gains;
+    gains.proportional = controlled ? config.controlBandwidth * config.controlBandwidth : 0.0;
+    gains.derivative = controlled ? 2.0 * config.controlDamping * config.controlBandwidth : 0.0;
+    gains.maxTorque = config.maxControlTorque;
+    bool rotateTargets = config.control == AttitudeControlMode::NadirPointing;
+    const double* inertiaX = inertia.x + begin;
+    const double* inertiaY = inertia.y + begin;
+    const double* inertiaZ = inertia.z + begin;
+
+    double* const components[STATE_SIZE] = {state.qw, state.qx, state.qy, state.qz, state.wx, state.wy, state.wz};
+    for (int k = 0; k < STATE_SIZE; k++) {
+        std::copy(components[k] + begin, components[k] + begin + n, y0 + k * CHUNK);
+    }
+
+    // Rows past n are never read back, so whole rows are updated at once
+    const size_t rows = STATE_SIZE * CHUNK;
+    const double half = 0.5 * timeStep;
+    const double sixth = timeStep / 6.0;
+    for (size_t step = 0; step < stepCount; step++) {
+        attitudeRates(y0, rate, constants, inertiaX, inertiaY, inertiaZ, gains, n);
+        for (size_t j = 0; j < rows; j++) {
+            sum[j] = rate[j];
+            stage[j] = y0[j] + half * rate[j];
+        }
+        attitudeRates(stage, rate, constants, inertiaX, inertiaY, inertiaZ, gains, n);
+        for (size_t j = 0; j < rows; j++) {
+            sum[j] += 2.0 * rate[j];
+            stage[j] = y0[j] + half * rate[j];
+        }
+        attitudeRates(stage, rate, constants, inertiaX, inertiaY, inertiaZ, gains, n);
+        for (size_t j = 0; j < rows; j++) {
+            sum[j] += 2.0 * rate[j];
+            stage[j] = y0[j] + timeStep * rate[j];
+        }
+        attitudeRates(stage, rate, constants, inertiaX, inertiaY, inertiaZ, gains, n);
+        for (size_t j = 0; j < rows; j++) {
+            y0[j] += sixth * (sum[j] + rate[j]);
+        }
+
+        // RK4 does not preserve the unit norm
+        for (size_t i = 0; i < n; i++) {
+            double qw = y0[i], qx = y0[CHUNK + i], qy = y0[2 * CHUNK + i], qz = y0[3 * CHUNK + i];
+            double scale = 1.0 / std::sqrt(qw * qw + qx * qx + qy * qy + qz * qz);
+            y0[i] = qw * scale;
+            y0[CHUNK + i] = qx * scale;
+            y0[2 * CHUNK + i] = qy * scale;
+            y0[3 * CHUNK + i] = qz * scale;
+        }
+        advanceOrbitFrames(constants, rotateTargets, n);
+    }
+
+    for (int k = 0; k < STATE_SIZE; k++) {
+        std::copy(y0 + k * CHUNK, y0 + k * CHUNK + n, components[k] + begin);
+    }
+}
+
+} // namespace
+
+void propagateAttitudes(const AttitudeModelConfig& config, const AttitudeStateBatch& state,
+                        const InertiaBatch& inertia, const CartesianStateBatch& orbits, double timeStep,
+                        size_t stepCount, ThreadPool* pool) {
+    size_t chunkCount = (state.count + CHUNK - 1) / CHUNK;
+    auto run = [&](size_t chunk, double* scratch) {
+        size_t begin = chunk * CHUNK;
+        size_t n = std::min(CHUNK, state.count - begin);
+        propagateChunk(config, state, inertia, orbits, timeStep, stepCount, begin, n, scratch);
+    };
+
+    if (pool != nullptr) {
+        std::vector<std::vector<double>> scratch(pool->getThreadCount(), std::vector<double>(SCRATCH_SIZE));
+        pool->parallelFor(chunkCount, [&](size_t chunk, size_t worker) { run(chunk, scratch[worker].data()); });
+    } else {
+        std::vector<double> scratch(SCRATCH_SIZE);
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            run(chunk, scratch.data());
+        }
+    }
+}
+
+void attitudePointingErrors(const AttitudeModelConfig& config, const AttitudeStateBatch& state,
+                            const CartesianStateBatch& orbits, double* errors) {
+    for (size_t i = 0; i < state.count; i++) {
+        double position[3] = {orbits.x[i], orbits.y[i], orbits.z[i]};
+        double velocity[3] = {orbits.vx[i], orbits.vy[i], orbits.vz[i]};
+        double target[3][3], rate[3], attitude[3][3];
+        targetAttitude(config, position, velocity, target, rate);
+        quaternionToMatrix(state.qw[i], state.qx[i], state.qy[i], state.qz[i], attitude);
+
+        // Rotation angle of D^T R from its trace
+        double trace = 0.0;
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                trace += target[row][column] * attitude[row][column];
+            }
+        }
+        errors[i] = std::acos(std::clamp(0.5 * (trace - 1.0), -1.0, 1.0));
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "orbit/cowell_propagator.h"
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+/**
+ * Attitudes of a batch of rigid spacecraft, structure-of-arrays: unit quaternions
+ * (scalar first) rotating body axes into the inertial frame, and body angular rates in
+ * rad/s.
+ */
+struct AttitudeStateBatch {
+    double* qw;
+    double* qx;
+    double* qy;
+    double* qz;
+    double* wx;
+    double* wy;
+    double* wz;
+    size_t count;
+};
+
+/**
+ * Principal moments of inertia of a batch, along the body axes, kg m^2.
+ */
+struct InertiaBatch {
+    const double* x;
+    const double* y;
+    const double* z;
+};
+
+/**
+ * Attitude the control law drives towards.
+ */
+enum class AttitudeControlMode : uint32_t {
+    None,           // torque-free apart from gravity gradient
+    InertialHold,   // body axes held at holdQuaternion
+    NadirPointing   // body +z to nadir, +y against the orbit normal, +x roughly along velocity
+};
+
+/**
+ * Torques acting on the spacecraft and the settings of the control law.
+ */
+struct AttitudeModelConfig {
+    // Gravitational parameter, in the units of the positions passed in
+    double mu = 3.986004415e14;
+
+    bool gravityGradient = true;
+
+    // Proportional-derivative control on SO(3): torque = -I (k_R e_R + k_w e_w), with
+    // gains from the closed-loop natural frequency and damping ratio, so every body
+    // responds alike whatever its inertia
+    AttitudeControlMode control = AttitudeControlMode::None;
+    double controlBandwidth = 0.05;     // rad/s
+    double controlDamping = 1.0;
+    double maxControlTorque = 0.01;     // N m per body axis, actuator saturation
+
+    // Target of InertialHold, scalar first
+    double holdQuaternion[4] = {1.0, 0.0, 0.0, 0.0};
+};
+
+/**
+ * Advances a batch of attitudes by equal RK4 steps of Euler's rigid body equations and
+ * quaternion kinematics, under gravity gradient and control torques.
+ *
+ * Objects are processed in chunks whose stages run back to back over local
+ * structure-of-arrays scratch, with branch-free loop bodies the compiler vectorizes;
+ * chunks are spread over the pool. Over the call each orbit is taken as a uniform turn
+ * about its normal at h / r^2, which moves the radius direction and the nadir target
+ * step by step; callers update the orbits between calls. Quaternions are renormalized
+ * after every step.
+ *
+ * @param config Torques and control law
+ * @param state Attitudes, replaced by the final attitudes
+ * @param inertia Principal moments of every object
+ * @param orbits Positions and velocities, in the units of config.mu
+ * @param timeStep Step in seconds
+ * @param stepCount Number of steps
+ * @param pool Threads to spread chunks over, or nullptr
+ */
+void propagateAttitudes(const AttitudeModelConfig& config, const AttitudeStateBatch& state,
+                        const InertiaBatch& inertia, const CartesianStateBatch& orbits, double timeStep,
+                        size_t stepCount, ThreadPool* pool = nullptr);
+
+/**
+ * Gets the angle between each attitude and the control target, e.g. to check pointing.
+ * Without control the target is holdQuaternion.
+ *
+ * @param config Control law whose target is measured against
+ * @param state Attitudes
+ * @param orbits Positions and velocities, in the units of config.mu
+ * @param errors Output angles in radians, one per object
+ */
+void attitudePointingErrors(const AttitudeModelConfig& config, const AttitudeStateBatch& state,
+                            const CartesianStateBatch& orbits, double* errors);
@@ -0,0 +1,255 @@
+#include "orbit/cowell_propagator.h"
+#include "orbit/gravity_field.h"
+#include "orbit/orbit_kernels.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double SECONDS_PER_DAY = 86400.0;
+
+// Arrays of CHUNK doubles per chunk: stage position and velocity, acceleration, and the
+// weighted sums of the RK4 slopes for position and velocity
+constexpr size_t STAGE_ARRAYS = 15;
+
+// Extra arrays with a gravity field: ITRF positions and accelerations
+constexpr size_t GRAVITY_ARRAYS = 6;
+
+/**
+ * Applies a rotation to a chunk of vectors; the transpose applies its inverse.
+ */
+void rotate(const RotationMatrix& rotation, bool transposed, const double* x, const double* y, const double* z,
+            double* outX, double* outY, double* outZ, size_t count) {
+    double m[3][3];
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            m[row][column] = transposed ? rotation.m[column][row] : rotation.m[row][column];
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        double vx = x[i], vy = y[i], vz = z[i];
+        outX[i] = m[0][0] * vx + m[0][1] * vy + m[0][2] * vz;
+        outY[i] = m[1][0] * vx + m[1][1] * vy + m[1][2] * vz;
+        outZ[i] = m[2][0] * vx + m[2][1] * vy + m[2][2] * vz;
+    }
+}
+
+} // namespace
+
+CowellPropagator::CowellPropagator(const ForceModelConfig& config, ThreadPool* pool)
+    : m_config(config), m_pool(pool), m_environments{}, m_nextEnvironment(0), m_environmentEvaluations(0) {
+    for (Environment& environment : m_environments) {
+        environment.ttDays = std::nan("");
+    }
+}
+
+const CowellPropagator::Environment& CowellPropagator::getEnvironment(double ttDays) {
+    for (const Environment& environment : m_environments) {
+        if (environment.ttDays == ttDays) {
+            return environment;
+        }
+    }
+
+    Environment& environment = m_environments[m_nextEnvironment];
+    m_nextEnvironment = (m_nextEnvironment + 1) % 3;
+    m_environmentEvaluations++;
+
+    environment.ttDays = ttDays;
+    environment.bodies = computeSolarSystemBodies(ttDays);
+    if (m_config.gravity != nullptr) {
+        double ut1Days = ttDays + m_config.ut1MinusTt / SECONDS_PER_DAY;
+        environment.toItrf = m_frames.getRotation(CoordinateFrame::Gcrf, CoordinateFrame::Itrf, ttDays, ut1Days);
+    }
+    return environment;
+}
+
+size_t CowellPropagator::scratchSize() const {
+    size_t size = STAGE_ARRAYS * CHUNK;
+    if (m_config.gravity != nullptr) {
+        size += GRAVITY_ARRAYS * CHUNK + gravityScratchSize(m_config.gravity->getDegree());
+    }
+    return size;
+}
+
+void CowellPropagator::accelerate(const Environment& environment, const double* x, const double* y,
+                                  const double* z, const double* reflectivityAreaToMass, double* accelerationX,
+                                  double* accelerationY, double* accelerationZ, size_t count,
+                                  double* scratch) const {
+    if (m_config.gravity != nullptr) {
+        double* itrfX = scratch;
+        double* itrfY = itrfX + CHUNK;
+        double* itrfZ = itrfY + CHUNK;
+        double* itrfAX = itrfZ + CHUNK;
+        double* itrfAY = itrfAX + CHUNK;
+        double* itrfAZ = itrfAY + CHUNK;
+        rotate(environment.toItrf, false, x, y, z, itrfX, itrfY, itrfZ, count);
+        getOrbitKernels().gravityAcceleration(m_config.gravity->getTerms(), itrfX, itrfY, itrfZ, itrfAX, itrfAY,
+                                              itrfAZ, count, itrfAZ + CHUNK);
+        rotate(environment.toItrf, true, itrfAX, itrfAY, itrfAZ, accelerationX, accelerationY, accelerationZ,
+               count);
+    } else {
+        const double mu = m_config.mu;
+        for (size_t i = 0; i < count; i++) {
+            double r2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            double inverseR = 1.0 / std::sqrt(r2);
+            double k = -mu * inverseR * inverseR * inverseR;
+            accelerationX[i] = k * x[i];
+            accelerationY[i] = k * y[i];
+            accelerationZ[i] = k * z[i];
+        }
+    }
+
+    if (m_config.sun) {
+        addThirdBodyAcceleration(environment.bodies.sun, SUN_MU, x, y, z, accelerationX, accelerationY,
+                                 accelerationZ, count);
+    }
+    if (m_config.moon) {
+        addThirdBodyAcceleration(environment.bodies.moon, MOON_MU, x, y, z, accelerationX, accelerationY,
+                                 accelerationZ, count);
+    }
+    if (m_config.solarRadiationPressure && reflectivityAreaToMass != nullptr) {
+        addSolarRadiationPressure(environment.bodies.sun, reflectivityAreaToMass, x, y, z, accelerationX,
+                                  accelerationY, accelerationZ, count);
+    }
+}
+
+void CowellPropagator::stepChunk(const Environment stages[3], CartesianStateBatch& state,
+                                 const double* reflectivityAreaToMass, size_t first, size_t count, double timeStep,
+                                 double* scratch) const {
+    double* __restrict px = scratch;
+    double* __restrict py = px + CHUNK;
+    double* __restrict pz = py + CHUNK;
+    double* __restrict vx = pz + CHUNK;
+    double* __restrict vy = vx + CHUNK;
+    double* __restrict vz = vy + CHUNK;
+    double* __restrict ax = vz + CHUNK;
+    double* __restrict ay = ax + CHUNK;
+    double* __restrict az = ay + CHUNK;
+    double* __restrict sumPX = az + CHUNK;
+    double* __restrict sumPY = sumPX + CHUNK;
+    double* __restrict sumPZ = sumPY + CHUNK;
+    double* __restrict sumVX = sumPZ + CHUNK;
+    double* __restrict sumVY = sumVX + CHUNK;
+    double* __restrict sumVZ = sumVY + CHUNK;
+    double* forceScratch = sumVZ + CHUNK;
+
+    double* __restrict x = state.x + first;
+    double* __restrict y = state.y + first;
+    double* __restrict z = state.z + first;
+    double* __restrict velocityX = state.vx + first;
+    double* __restrict velocityY = state.vy + first;
+    double* __restrict velocityZ = state.vz + first;
+    const double* areaToMass = (reflectivityAreaToMass != nullptr) ? reflectivityAreaToMass + first : nullptr;
+
+    // Slope 1 at the start
+    accelerate(stages[0], x, y, z, areaToMass, ax, ay, az, count, forceScratch);
+    for (size_t i = 0; i < count; i++) {
+        sumPX[i] = velocityX[i];
+        sumPY[i] = velocityY[i];
+        sumPZ[i] = velocityZ[i];
+        sumVX[i] = ax[i];
+        sumVY[i] = ay[i];
+        sumVZ[i] = az[i];
+    }
+
+    // Slopes 2 and 3 at the middle, slope 4 at the end; each stage state is the start
+    // state advanced along the previous slope
+    const double fractions[3] = {0.5, 0.5, 1.0};
+    const double weights[3] = {2.0, 2.0, 1.0};
+    const Environment* environments[3] = {&stages[1], &stages[1], &stages[2]};
+    for (int stage = 0; stage < 3; stage++) {
+        double h = fractions[stage] * timeStep;
+        const double* slopeVX = (stage == 0) ? velocityX : vx;
+        const double* slopeVY = (stage == 0) ? velocityY : vy;
+        const double* slopeVZ = (stage == 0) ? velocityZ : vz;
+        for (size_t i = 0; i < count; i++) {
+            px[i] = x[i] + h * slopeVX[i];
+            py[i] = y[i] + h * slopeVY[i];
+            pz[i] = z[i] + h * slopeVZ[i];
+        }
+        for (size_t i = 0; i < count; i++) {
+            vx[i] = velocityX[i] + h * ax[i];
+            vy[i] = velocityY[i] + h * ay[i];
+            vz[i] = velocityZ[i] + h * az[i];
+        }
+
+        accelerate(*environments[stage], px, py, pz, areaToMass, ax, ay, az, count, forceScratch);
+
+        double w = weights[stage];
+        for (size_t i = 0; i < count; i++) {
+            sumPX[i] += w * vx[i];
+            sumPY[i] += w * vy[i];
+            sumPZ[i] += w * vz[i];
+            sumVX[i] += w * ax[i];
+            sumVY[i] += w * ay[i];
+            sumVZ[i] += w * az[i];
+        }
+    }
+
+    double sixth = timeStep / 6.0;
+    for (size_t i = 0; i < count; i++) {
+        x[i] += sixth * sumPX[i];
+        y[i] += sixth * sumPY[i];
+        z[i] += sixth * sumPZ[i];
+        velocityX[i] += sixth * sumVX[i];
+        velocityY[i] += sixth * sumVY[i];
+        velocityZ[i] += sixth * sumVZ[i];
+    }
+}
+
+void CowellPropagator::step(CartesianStateBatch& state, const double* reflectivityAreaToMass, double ttDays,
+                            double timeStep) {
+    // Copies, since looking up a stage may replace a cached environment
+    Environment stages[3] = {
+        getEnvironment(ttDays),
+        getEnvironment(ttDays + 0.5 * timeStep / SECONDS_PER_DAY),
+        getEnvironment(ttDays + timeStep / SECONDS_PER_DAY),
+    };
+
+    size_t threadCount = (m_pool != nullptr) ? m_pool->getThreadCount() : 1;
+    size_t size = scratchSize();
+    m_scratch.resize(size * threadCount);
+
+    size_t chunkCount = (state.count + CHUNK - 1) / CHUNK;
+    auto runChunk = [&](size_t chunk, size_t worker) {
+        size_t first = chunk * CHUNK;
+        size_t count = std::min(CHUNK, state.count - first);
+        stepChunk(stages, state, reflectivityAreaToMass, first, count, timeStep, m_scratch.data() + worker * size);
+    };
+
+    if (m_pool == nullptr || threadCount == 1 || chunkCount == 1) {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            runChunk(chunk, 0);
+        }
+    } else {
+        m_pool->parallelFor(chunkCount, runChunk);
+    }
+}
+
+void CowellPropagator::propagate(CartesianStateBatch& state, const double* reflectivityAreaToMass, double ttDays,
+                                 double timeStep, size_t stepCount) {
+    // The next epoch is computed exactly as step() computes the end of its step, so the
+    // environment there is found in the cache
+    double epoch = ttDays;
+    for (size_t k = 0; k < stepCount; k++) {
+        step(state, reflectivityAreaToMass, epoch, timeStep);
+        epoch = epoch + timeStep / SECONDS_PER_DAY;
+    }
+}
+
+void CowellPropagator::computeAcceleration(double ttDays, const double* x, const double* y, const double* z,
+                                           const double* reflectivityAreaToMass, double* accelerationX,
+                                           double* accelerationY, double* accelerationZ, size_t count) {
+    const Environment environment = getEnvironment(ttDays);
+    size_t size = scratchSize();
+    m_scratch.resize(std::max(m_scratch.size(), size));
+
+    for (size_t first = 0; first < count; first += CHUNK) {
+        size_t chunkSize = std::min(CHUNK, count - first);
+        accelerate(environment, x + first, y + first, z + first,
+                   (reflectivityAreaToMass != nullptr) ? reflectivityAreaToMass + first : nullptr,
+                   accelerationX + first, accelerationY + first, accelerationZ + first, chunkSize,
+                   m_scratch.data() + STAGE_ARRAYS * CHUNK);
+    }
+}
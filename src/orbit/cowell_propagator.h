@@ -0,0 +1,147 @@
+#pragma once
+
+#include "orbit/force_models.h"
+#include "orbit/reference_frames.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GravityField;
+class ThreadPool;
+
+/**
+ * Cartesian states of a batch of objects, structure-of-arrays, GCRF, meters and m/s.
+ */
+struct CartesianStateBatch {
+    double* x;
+    double* y;
+    double* z;
+    double* vx;
+    double* vy;
+    double* vz;
+    size_t count;
+};
+
+/**
+ * Forces included in numerical propagation. The scalar type is double throughout:
+ * perturbations are many orders of magnitude below the central term.
+ */
+struct ForceModelConfig {
+    // Central gravitational parameter, used when gravity is not set
+    double mu = 3.986004415e14;
+
+    // Earth gravity field, evaluated in ITRF; replaces the point mass when set
+    const GravityField* gravity = nullptr;
+
+    // UT1 - TT in seconds, for the Earth rotation applied to the gravity field
+    double ut1MinusTt = -69.2;
+
+    bool sun = true;
+    bool moon = true;
+    bool solarRadiationPressure = true;
+};
+
+/**
+ * Numerical propagation of Cartesian states (Cowell's method) with a fixed-step RK4
+ * integrator, for perturbations the analytic propagators cannot represent.
+ *
+ * Everything that depends only on time is evaluated once per stage epoch for the whole
+ * batch: the Sun and Moon positions and, with a gravity field, the GCRF to ITRF
+ * rotation. A step starts at the epoch the previous one ended on, so a run costs two
+ * evaluations per step however many objects it holds. Objects are processed in chunks
+ * of CHUNK that run every stage back to back while their state is in L1, spread over a
+ * thread pool.
+ */
+class CowellPropagator {
+public:
+    // Objects per chunk; a chunk's scratch takes about 40 KB, plus the gravity kernel's
+    static constexpr size_t CHUNK = 256;
+
+    /**
+     * @param config Forces to include
+     * @param pool Threads to spread chunks over, or nullptr to run on the calling thread
+     */
+    explicit CowellPropagator(const ForceModelConfig& config, ThreadPool* pool = nullptr);
+
+    /**
+     * Advances a batch by one step.
+     *
+     * @param state States at ttDays, replaced by the states at ttDays + timeStep
+     * @param reflectivityAreaToMass Per object Cr A / m in m^2/kg; may be nullptr when
+     *                               solar radiation pressure is off
+     * @param ttDays TT days since J2000.0 at the start of the step
+     * @param timeStep Step in seconds, negative to propagate backwards
+     */
+    void step(CartesianStateBatch& state, const double* reflectivityAreaToMass, double ttDays, double timeStep);
+
+    /**
+     * Advances a batch by a number of equal steps.
+     *
+     * @param state States at ttDays, replaced by the final states
+     * @param reflectivityAreaToMass Per object Cr A / m, or nullptr
+     * @param ttDays TT days since J2000.0 at the start
+     * @param timeStep Step in seconds
+     * @param stepCount Number of steps
+     */
+    void propagate(CartesianStateBatch& state, const double* reflectivityAreaToMass, double ttDays,
+                   double timeStep, size_t stepCount);
+
+    /**
+     * Evaluates the total acceleration at one epoch, e.g. for variational equations.
+     *
+     * @param ttDays TT days since J2000.0
+     * @param x Position x
+     * @param y Position y
+     * @param z Position z
+     * @param reflectivityAreaToMass Per object Cr A / m, or nullptr
+     * @param accelerationX Output x acceleration
+     * @param accelerationY Output y acceleration
+     * @param accelerationZ Output z acceleration
+     * @param count Number of objects
+     */
+    void computeAcceleration(double ttDays, const double* x, const double* y, const double* z,
+                             const double* reflectivityAreaToMass, double* accelerationX, double* accelerationY,
+                             double* accelerationZ, size_t count);
+
+    /**
+     * Gets how many times the time-dependent environment (Sun, Moon, Earth rotation) has
+     * been evaluated, for benchmarks.
+     *
+     * @return Evaluation count
+     */
+    uint64_t getEnvironmentEvaluations() const { return m_environmentEvaluations; }
+
+    const ForceModelConfig& getConfig() const { return m_config; }
+
+private:
+    // Everything the forces need that depends only on time
+    struct Environment {
+        double ttDays;
+        SolarSystemBodies bodies;
+        RotationMatrix toItrf;
+    };
+
+    const Environment& getEnvironment(double ttDays);
+
+    // Acceleration of one chunk; scratch holds scratchSize() doubles
+    void accelerate(const Environment& environment, const double* x, const double* y, const double* z,
+                    const double* reflectivityAreaToMass, double* accelerationX, double* accelerationY,
+                    double* accelerationZ, size_t count, double* scratch) const;
+
+    // One RK4 step of one chunk, with the environments at the start, middle and end
+    void stepChunk(const Environment stages[3], CartesianStateBatch& state, const double* reflectivityAreaToMass,
+                   size_t first, size_t count, double timeStep, double* scratch) const;
+
+    size_t scratchSize() const;
+
+    ForceModelConfig m_config;
+    ThreadPool* m_pool;
+    FrameRotationCache m_frames;
+
+    // Most recent environments; a step reuses the one its predecessor ended on
+    Environment m_environments[3];
+    size_t m_nextEnvironment;
+    uint64_t m_environmentEvaluations;
+
+    std::vector<double> m_scratch;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * Earth constants in simulation units: distances in 1000 km, with the gravitational
+ * parameter chosen so that orbits advance visibly in real time (see OrbitalMechanics).
+ * All values are constexpr so policies and kernels fold them at compile time.
+ *
+ * @tparam T Scalar type
+ */
+template <typename T>
+struct EarthConstants {
+    // Gravitational parameter
+    static constexpr T MU = T(398600.0);
+
+    // Equatorial radius
+    static constexpr T RADIUS = T(6.371);
+
+    // Second zonal harmonic (oblateness), dimensionless
+    static constexpr T J2 = T(1.08262668e-3);
+
+    // J2 R^2, the factor every J2 term carries
+    static constexpr T J2_RADIUS_SQUARED = J2 * RADIUS * RADIUS;
+};
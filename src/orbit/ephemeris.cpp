@@ -0,0 +1,159 @@
+#include "orbit/ephemeris.h"
+#include "orbit/orbit_kernels.h"
+#include "orbit/vector_math.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr size_t OBJECT_TILE = EphemerisGenerator::OBJECT_TILE;
+constexpr size_t EPOCH_TILE = EphemerisGenerator::EPOCH_TILE;
+constexpr double TWO_PI = 2.0 * vmath::Constants<double>::PI;
+
+/**
+ * Per-object constants of an object tile, derived once and reused for every epoch.
+ */
+struct ObjectTile {
+    size_t first;
+    size_t count;
+    float meanMotion[OBJECT_TILE];
+    double preciseMeanMotion[OBJECT_TILE];     // For the mean anomaly, which grows without bound
+    float semiminorAxis[OBJECT_TILE];
+    float orientation[6][OBJECT_TILE];
+};
+
+/**
+ * Scratch memory of one worker.
+ */
+struct TileScratch {
+    float meanAnomaly[OBJECT_TILE];
+    float eccentricAnomaly[OBJECT_TILE];
+    float cosE[OBJECT_TILE];
+    float sinE[OBJECT_TILE];
+    float planeX[OBJECT_TILE];
+    float planeY[OBJECT_TILE];
+    float velocityX[OBJECT_TILE];
+    float velocityY[OBJECT_TILE];
+
+    // Object-major output of one tile, [axis][object][epoch], written out row by row
+    float track[3][OBJECT_TILE][EPOCH_TILE];
+};
+
+void prepareObjectTile(const OrbitElementsBatch<float>& elements, size_t first, ObjectTile& tile) {
+    tile.first = first;
+    tile.count = std::min(OBJECT_TILE, elements.count - first);
+
+    for (size_t i = 0; i < tile.count; i++) {
+        float a = elements.semimajorAxis[first + i];
+        float e = elements.eccentricity[first + i];
+        double precise = static_cast<double>(a);
+        tile.preciseMeanMotion[i] = std::sqrt(EarthConstants<double>::MU / (precise * precise * precise));
+        tile.meanMotion[i] = static_cast<float>(tile.preciseMeanMotion[i]);
+        tile.semiminorAxis[i] = a * std::sqrt(1.0f - e * e);
+    }
+
+    float* orientation[6];
+    for (int k = 0; k < 6; k++) {
+        orientation[k] = tile.orientation[k];
+    }
+    computeOrientation(elements.inclination + first, elements.argumentOfPeriapsis + first,
+                       elements.longitudeOfAscendingNode + first, orientation, tile.count);
+}
+
+} // namespace
+
+EphemerisGenerator::EphemerisGenerator(ThreadPool* pool)
+    : m_pool(pool) {
+}
+
+void EphemerisGenerator::generate(const OrbitElementsBatch<float>& elements, double startTime, double timeStep,
+                                  size_t epochCount, EphemerisLayout layout, PositionBatch<float>& positions) {
+    const OrbitKernels& kernels = getOrbitKernels();
+    size_t objectCount = elements.count;
+    size_t objectTiles = (objectCount + OBJECT_TILE - 1) / OBJECT_TILE;
+    size_t epochTiles = (epochCount + EPOCH_TILE - 1) / EPOCH_TILE;
+    if (objectTiles == 0 || epochTiles == 0) {
+        return;
+    }
+
+    size_t threadCount = (m_pool != nullptr) ? m_pool->getThreadCount() : 1;
+    std::vector<TileScratch> scratch(threadCount);
+
+    // A task is one object tile over a run of epoch tiles, deriving the object constants
+    // once. Runs are as long as possible while still giving every thread a few tasks.
+    size_t epochRuns = std::min(epochTiles, std::max<size_t>(1, (4 * threadCount + objectTiles - 1) / objectTiles));
+    size_t tilesPerRun = (epochTiles + epochRuns - 1) / epochRuns;
+
+    auto runTask = [&](size_t task, size_t worker) {
+        TileScratch& s = scratch[worker];
+        ObjectTile tile;
+        prepareObjectTile(elements, (task / epochRuns) * OBJECT_TILE, tile);
+        size_t firstTile = (task % epochRuns) * tilesPerRun;
+        size_t lastTile = std::min(epochTiles, firstTile + tilesPerRun);
+
+        const float* a = elements.semimajorAxis + tile.first;
+        const float* e = elements.eccentricity + tile.first;
+        const float* M0 = elements.meanAnomaly + tile.first;
+        const float* orientation[6];
+        for (int k = 0; k < 6; k++) {
+            orientation[k] = tile.orientation[k];
+        }
+
+        for (size_t epochTile = firstTile; epochTile < lastTile; epochTile++) {
+            size_t firstEpoch = epochTile * EPOCH_TILE;
+            size_t tileEpochs = std::min(EPOCH_TILE, epochCount - firstEpoch);
+
+            for (size_t k = 0; k < tileEpochs; k++) {
+                size_t epoch = firstEpoch + k;
+                double time = startTime + timeStep * static_cast<double>(epoch);
+
+                // n t is formed and wrapped into [0, 2pi) in double: in float its relative
+                // error of ~6e-8 is already 0.04 rad of anomaly after 1e5 orbits
+                for (size_t i = 0; i < tile.count; i++) {
+                    double M = static_cast<double>(M0[i]) + tile.preciseMeanMotion[i] * time;
+                    s.meanAnomaly[i] = static_cast<float>(M - TWO_PI * vmath::floor(M * (1.0 / TWO_PI)));
+                }
+                kernels.solveKepler(s.meanAnomaly, e, s.eccentricAnomaly, s.cosE, s.sinE, tile.count);
+                kernels.perifocalState(s.cosE, s.sinE, e, a, tile.semiminorAxis, tile.meanMotion,
+                                       s.planeX, s.planeY, s.velocityX, s.velocityY, tile.count);
+
+                if (layout == EphemerisLayout::TimeMajor) {
+                    // A snapshot row is contiguous in the output
+                    size_t offset = epoch * objectCount + tile.first;
+                    kernels.rotateToReference(s.planeX, s.planeY, orientation, positions.x + offset,
+                                              positions.y + offset, positions.z + offset, tile.count);
+                } else {
+                    float x[OBJECT_TILE], y[OBJECT_TILE], z[OBJECT_TILE];
+                    kernels.rotateToReference(s.planeX, s.planeY, orientation, x, y, z, tile.count);
+                    for (size_t i = 0; i < tile.count; i++) {
+                        s.track[0][i][k] = x[i];
+                        s.track[1][i][k] = y[i];
+                        s.track[2][i][k] = z[i];
+                    }
+                }
+            }
+
+            if (layout == EphemerisLayout::ObjectMajor) {
+                // Each object's run of epochs is contiguous in the output
+                float* outputs[3] = {positions.x, positions.y, positions.z};
+                for (int axis = 0; axis < 3; axis++) {
+                    for (size_t i = 0; i < tile.count; i++) {
+                        float* row = outputs[axis] + (tile.first + i) * epochCount + firstEpoch;
+                        std::copy(s.track[axis][i], s.track[axis][i] + tileEpochs, row);
+                    }
+                }
+            }
+        }
+    };
+
+    size_t taskCount = objectTiles * epochRuns;
+    if (m_pool != nullptr) {
+        m_pool->parallelFor(taskCount, runTask);
+    } else {
+        for (size_t task = 0; task < taskCount; task++) {
+            runTask(task, 0);
+        }
+    }
+}
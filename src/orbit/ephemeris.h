@@ -0,0 +1,53 @@
+#pragma once
+
+#include "orbit/propagator.h"
+#include <cstddef>
+
+class ThreadPool;
+
+/**
+ * Order of samples in a generated ephemeris.
+ */
+enum class EphemerisLayout {
+    ObjectMajor,    // sample (object, epoch) at object * epochCount + epoch: one track per object
+    TimeMajor       // sample (object, epoch) at epoch * objectCount + object: one snapshot per epoch
+};
+
+/**
+ * Dense two-body ephemerides: positions of every object at every epoch of a uniform
+ * time grid, in the reference frame.
+ *
+ * Work is cut into tiles of OBJECT_TILE objects by EPOCH_TILE epochs. Per-object
+ * constants (mean motion, semi-minor axis, orientation) are derived once per tile and
+ * stay in L1 while the tile's epochs run through the dispatched orbit kernels. Tiles
+ * are spread over a thread pool.
+ */
+class EphemerisGenerator {
+public:
+    // Objects per tile; the per-object constants of a tile take about 10 KB
+    static constexpr size_t OBJECT_TILE = 256;
+
+    // Epochs per tile; an object-major tile buffer takes OBJECT_TILE * EPOCH_TILE * 12 bytes
+    static constexpr size_t EPOCH_TILE = 32;
+
+    /**
+     * @param pool Threads to spread tiles over, or nullptr to run on the calling thread
+     */
+    explicit EphemerisGenerator(ThreadPool* pool = nullptr);
+
+    /**
+     * Generates positions for every object at epochs startTime + k * timeStep.
+     *
+     * @param elements Elements at epoch t = 0
+     * @param startTime Time of the first epoch
+     * @param timeStep Time between epochs
+     * @param epochCount Number of epochs
+     * @param layout Output sample order
+     * @param positions Output arrays of elements.count * epochCount samples each
+     */
+    void generate(const OrbitElementsBatch<float>& elements, double startTime, double timeStep,
+                  size_t epochCount, EphemerisLayout layout, PositionBatch<float>& positions);
+
+private:
+    ThreadPool* m_pool;
+};
@@ -0,0 +1,154 @@
+#include "orbit/force_models.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEGREES = PI / 180.0;
+constexpr double ARCSECONDS = DEGREES / 3600.0;
+
+// Obliquity of the ecliptic at J2000 (IAU 2006)
+constexpr double OBLIQUITY_J2000 = 84381.406 * ARCSECONDS;
+
+/**
+ * Converts ecliptic longitude, latitude and distance to equatorial coordinates.
+ */
+void eclipticToEquatorial(double longitude, double latitude, double distance, double out[3]) {
+    double x = distance * std::cos(latitude) * std::cos(longitude);
+    double y = distance * std::cos(latitude) * std::sin(longitude);
+    double z = distance * std::sin(latitude);
+    double cosE = std::cos(OBLIQUITY_J2000);
+    double sinE = std::sin(OBLIQUITY_J2000);
+    out[0] = x;
+    out[1] = cosE * y - sinE * z;
+    out[2] = sinE * y + cosE * z;
+}
+
+} // namespace
+
+SolarSystemBodies computeSolarSystemBodies(double ttDays) {
+    SolarSystemBodies bodies;
+    double T = ttDays / 36525.0;
+
+    // Sun: Keplerian orbit of the Earth-Moon barycenter with the equation of center; the
+    // perihelion advances 0.3226 degrees per century against the J2000 equinox
+    double M = (357.5256 + 35999.049 * T) * DEGREES;
+    double sunLongitude = (282.94 + 0.3226 * T) * DEGREES + M + 6892.0 * ARCSECONDS * std::sin(M) +
+                          72.0 * ARCSECONDS * std::sin(2.0 * M);
+    double sunDistance = (149.619 - 2.499 * std::cos(M) - 0.021 * std::cos(2.0 * M)) * 1e9;
+    eclipticToEquatorial(sunLongitude, 0.0, sunDistance, bodies.sun);
+
+    // Moon: mean longitude and the largest periodic terms; the 1.3972 degree per century
+    // term removes general precession so the angles refer to the J2000 equinox
+    double L0 = (218.31617 + 481267.88088 * T - 1.3972 * T) * DEGREES;
+    double l = (134.96292 + 477198.86753 * T) * DEGREES;
+    double lp = (357.52543 + 35999.04944 * T) * DEGREES;
+    double F = (93.27283 + 483202.01873 * T) * DEGREES;
+    double D = (297.85027 + 445267.11135 * T) * DEGREES;
+
+    double moonLongitude = L0 + ARCSECONDS * (22640.0 * std::sin(l) + 769.0 * std::sin(2.0 * l) -
+                                              4586.0 * std::sin(l - 2.0 * D) + 2370.0 * std::sin(2.0 * D) -
+                                              668.0 * std::sin(lp) - 412.0 * std::sin(2.0 * F) -
+                                              212.0 * std::sin(2.0 * l - 2.0 * D) -
+                                              206.0 * std::sin(l + lp - 2.0 * D) + 192.0 * std::sin(l + 2.0 * D) -
+                                              165.0 * std::sin(lp - 2.0 * D) + 148.0 * std::sin(l - lp) -
+                                              125.0 * std::sin(D) - 110.0 * std::sin(l + lp) -
+                                              55.0 * std::sin(2.0 * F - 2.0 * D));
+    double moonLatitude = ARCSECONDS * (18520.0 * std::sin(F + moonLongitude - L0 +
+                                                           ARCSECONDS * (412.0 * std::sin(2.0 * F) +
+                                                                         541.0 * std::sin(lp))) -
+                                        526.0 * std::sin(F - 2.0 * D) + 44.0 * std::sin(l + F - 2.0 * D) -
+                                        31.0 * std::sin(-l + F - 2.0 * D) - 25.0 * std::sin(-2.0 * l + F) -
+                                        23.0 * std::sin(lp + F - 2.0 * D) + 21.0 * std::sin(-l + F) +
+                                        11.0 * std::sin(-lp + F - 2.0 * D));
+    double moonDistance = (385000.0 - 20905.0 * std::cos(l) - 3699.0 * std::cos(2.0 * D - l) -
+                           2956.0 * std::cos(2.0 * D) - 570.0 * std::cos(2.0 * l) +
+                           246.0 * std::cos(2.0 * l - 2.0 * D) - 205.0 * std::cos(lp - 2.0 * D) -
+                           171.0 * std::cos(l + 2.0 * D) - 152.0 * std::cos(l + lp - 2.0 * D)) * 1e3;
+    eclipticToEquatorial(moonLongitude, moonLatitude, moonDistance, bodies.moon);
+
+    return bodies;
+}
+
+void addThirdBodyAcceleration(const double body[3], double mu, const double* x, const double* y, const double* z,
+                              double* accelerationX, double* accelerationY, double* accelerationZ, size_t count) {
+    const double bx = body[0], by = body[1], bz = body[2];
+    double bodyDistance = std::sqrt(bx * bx + by * by + bz * bz);
+    double indirect = mu / (bodyDistance * bodyDistance * bodyDistance);
+
+    for (size_t i = 0; i < count; i++) {
+        double dx = bx - x[i];
+        double dy = by - y[i];
+        double dz = bz - z[i];
+        double inverseDistance = 1.0 / std::sqrt(dx * dx + dy * dy + dz * dz);
+        double direct = mu * inverseDistance * inverseDistance * inverseDistance;
+        accelerationX[i] += direct * dx - indirect * bx;
+        accelerationY[i] += direct * dy - indirect * by;
+        accelerationZ[i] += direct * dz - indirect * bz;
+    }
+}
+
+double shadowFraction(const double position[3], const double sun[3]) {
+    double dx = sun[0] - position[0];
+    double dy = sun[1] - position[1];
+    double dz = sun[2] - position[2];
+    double sunDistance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    double distance = std::sqrt(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+
+    // Apparent radii of the Sun and Earth and the angle between their centers
+    double a = std::asin(std::min(1.0, SUN_RADIUS / sunDistance));
+    double b = std::asin(std::min(1.0, EARTH_SHADOW_RADIUS / distance));
+    double cosC = -(position[0] * dx + position[1] * dy + position[2] * dz) / (distance * sunDistance);
+    double c = std::acos(std::clamp(cosC, -1.0, 1.0));
+
+    if (c >= a + b) {
+        return 1.0;
+    }
+    if (c <= b - a) {
+        return 0.0;
+    }
+    if (c <= a - b) {
+        return 1.0 - (b * b) / (a * a);
+    }
+
+    // Overlap of two discs
+    double chord = (c * c + a * a - b * b) / (2.0 * c);
+    double height = std::sqrt(std::max(0.0, a * a - chord * chord));
+    double overlap = a * a * std::acos(std::clamp(chord / a, -1.0, 1.0)) +
+                     b * b * std::acos(std::clamp((c - chord) / b, -1.0, 1.0)) - c * height;
+    return 1.0 - overlap / (PI * a * a);
+}
+
+void addSolarRadiationPressure(const double sun[3], const double* reflectivityAreaToMass, const double* x,
+                               const double* y, const double* z, double* accelerationX, double* accelerationY,
+                               double* accelerationZ, size_t count) {
+    const double sx = sun[0], sy = sun[1], sz = sun[2];
+    const double pressureScale = SOLAR_PRESSURE * ASTRONOMICAL_UNIT * ASTRONOMICAL_UNIT;
+    const double inverseSunDistance = 1.0 / std::sqrt(sx * sx + sy * sy + sz * sz);
+
+    for (size_t i = 0; i < count; i++) {
+        double dx = x[i] - sx;
+        double dy = y[i] - sy;
+        double dz = z[i] - sz;
+        double inverseDistance = 1.0 / std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        // Only objects behind the Earth and near the Sun-Earth axis can be shadowed: the
+        // penumbra widens by less than 0.005 per unit of distance behind the Earth, so a
+        // cone widening by 0.01 bounds it and the exact test runs for few objects
+        double along = (x[i] * sx + y[i] * sy + z[i] * sz) * inverseSunDistance;
+        double across2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] - along * along;
+        double bound = EARTH_SHADOW_RADIUS - 0.01 * along;
+        double visible = 1.0;
+        if (along < 0.0 && across2 < bound * bound) {
+            const double position[3] = {x[i], y[i], z[i]};
+            visible = shadowFraction(position, sun);
+        }
+
+        double k = visible * pressureScale * reflectivityAreaToMass[i] * inverseDistance * inverseDistance *
+                   inverseDistance;
+        accelerationX[i] += k * dx;
+        accelerationY[i] += k * dy;
+        accelerationZ[i] += k * dz;
+    }
+}
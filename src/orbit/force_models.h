@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Batched perturbing forces for numerical integration, in SI units (meters, seconds)
+ * and GCRF coordinates, like GravityField.
+ *
+ * The perturbing bodies move slowly compared with a time step, so their positions are
+ * evaluated once per epoch with computeSolarSystemBodies() and shared by every object;
+ * the per-object work is a few multiply-adds and one square root per body.
+ */
+
+// Gravitational parameters, m^3/s^2 (DE440)
+constexpr double SUN_MU = 1.32712440041e20;
+constexpr double MOON_MU = 4.902800118e12;
+
+// Radii for the shadow cone, meters
+constexpr double SUN_RADIUS = 6.957e8;
+constexpr double EARTH_SHADOW_RADIUS = 6378136.3;
+
+// Astronomical unit, meters
+constexpr double ASTRONOMICAL_UNIT = 1.495978707e11;
+
+// Solar radiation pressure at 1 AU on an absorbing surface, N/m^2
+constexpr double SOLAR_PRESSURE = 4.56e-6;
+
+/**
+ * Geocentric positions of the Sun and Moon at one epoch, GCRF, meters.
+ */
+struct SolarSystemBodies {
+    double sun[3];
+    double moon[3];
+};
+
+/**
+ * Evaluates low-precision analytic series for the Sun and Moon (Montenbruck and Gill,
+ * Satellite Orbits 3.3.2), referred to the mean ecliptic and equinox of J2000 and
+ * rotated to the equator. Good to about 0.01 degrees for the Sun and 0.1 degrees for
+ * the Moon, which puts the error of the perturbations well below their size.
+ *
+ * @param ttDays TT days since J2000.0
+ * @return Body positions
+ */
+SolarSystemBodies computeSolarSystemBodies(double ttDays);
+
+/**
+ * Adds the tidal acceleration of a third body: its pull on the object minus its pull
+ * on the Earth.
+ *
+ * @param body Geocentric position of the body
+ * @param mu Gravitational parameter of the body
+ * @param x Object x
+ * @param y Object y
+ * @param z Object z
+ * @param accelerationX Acceleration x, added to
+ * @param accelerationY Acceleration y, added to
+ * @param accelerationZ Acceleration z, added to
+ * @param count Number of objects
+ */
+void addThirdBodyAcceleration(const double body[3], double mu, const double* x, const double* y, const double* z,
+                              double* accelerationX, double* accelerationY, double* accelerationZ, size_t count);
+
+/**
+ * Gets the fraction of the solar disc visible from a position, with the Earth as a sphere
+ * and the Sun as a disc (conical shadow model): 1 in sunlight, 0 in the umbra, partial in
+ * the penumbra or during an annular eclipse.
+ *
+ * @param position Geocentric position of the object
+ * @param sun Geocentric position of the Sun
+ * @return Visible fraction in [0, 1]
+ */
+double shadowFraction(const double position[3], const double sun[3]);
+
+/**
+ * Adds the cannonball solar radiation pressure acceleration, directed away from the Sun,
+ * falling off with the square of the distance and scaled by shadowFraction().
+ *
+ * @param sun Geocentric position of the Sun
+ * @param reflectivityAreaToMass Per object reflectivity coefficient times area over mass
+ *                               (Cr A / m), m^2/kg
+ * @param x Object x
+ * @param y Object y
+ * @param z Object z
+ * @param accelerationX Acceleration x, added to
+ * @param accelerationY Acceleration y, added to
+ * @param accelerationZ Acceleration z, added to
+ * @param count Number of objects
+ */
+void addSolarRadiationPressure(const double sun[3], const double* reflectivityAreaToMass, const double* x,
+                               const double* y, const double* z, double* accelerationX, double* accelerationY,
+                               double* accelerationZ, size_t count);
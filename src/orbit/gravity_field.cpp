@@ -0,0 +1,206 @@
+#include "orbit/gravity_field.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// EGM2008 constants, SI units
+constexpr double EGM_MU = 3.986004415e14;
+constexpr double EGM_RADIUS = 6378136.3;
+
+// Objects per parallel task; a multiple of GRAVITY_BLOCK
+constexpr size_t GRAVITY_TASK = 32 * GRAVITY_BLOCK;
+
+size_t triangularIndex(size_t n, size_t m) {
+    return n * (n + 1) / 2 + m;
+}
+
+/**
+ * Parses a number that may use a Fortran exponent (1.0D-06).
+ */
+double parseNumber(std::string token) {
+    std::replace(token.begin(), token.end(), 'D', 'E');
+    std::replace(token.begin(), token.end(), 'd', 'e');
+    return std::stod(token);
+}
+
+} // namespace
+
+GravityField::GravityField()
+    : m_loadedDegree(0), m_degree(0), m_mu(EGM_MU), m_radius(EGM_RADIUS), m_cosine(1, 1.0), m_sine(1, 0.0),
+      m_terms{} {
+    prepare();
+}
+
+void GravityField::load(const std::string& path, uint32_t maxDegree) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open gravity field file: " + path);
+    }
+
+    double mu = EGM_MU;
+    double radius = EGM_RADIUS;
+    uint32_t degree = 0;
+    size_t size = triangularIndex(maxDegree, maxDegree) + 1;
+    std::vector<double> cosine(size, 0.0), sine(size, 0.0);
+    cosine[0] = 1.0;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first)) {
+            continue;
+        }
+
+        // ICGEM header keys, ignored in plain tables
+        if (first == "earth_gravity_constant" || first == "radius") {
+            std::string value;
+            if (fields >> value) {
+                (first == "radius" ? radius : mu) = parseNumber(value);
+            }
+            continue;
+        }
+
+        // Coefficient lines: "gfc n m C S" in ICGEM files, "n m C S" in plain tables;
+        // any other line is a header line or comment
+        bool keyed = (first == "gfc" || first == "gfct");
+        if (!keyed && !std::isdigit(static_cast<unsigned char>(first[0]))) {
+            continue;
+        }
+        std::string tokens[4];
+        tokens[0] = first;
+        for (size_t k = keyed ? 0 : 1; k < 4; k++) {
+            if (!(fields >> tokens[k])) {
+                throw std::runtime_error("Failed to parse gravity field file: " + path);
+            }
+        }
+
+        uint32_t n = static_cast<uint32_t>(std::stoul(tokens[0]));
+        uint32_t m = static_cast<uint32_t>(std::stoul(tokens[1]));
+        if (m > n) {
+            throw std::runtime_error("Failed to parse gravity field file: " + path);
+        }
+        if (n > maxDegree) {
+            continue;
+        }
+        cosine[triangularIndex(n, m)] = parseNumber(tokens[2]);
+        sine[triangularIndex(n, m)] = parseNumber(tokens[3]);
+        degree = std::max(degree, n);
+    }
+
+    if (degree == 0) {
+        throw std::runtime_error("Failed to parse gravity field file: " + path);
+    }
+    cosine.resize(triangularIndex(degree, degree) + 1);
+    sine.resize(cosine.size());
+    setCoefficients(degree, mu, radius, cosine, sine);
+}
+
+void GravityField::setCoefficients(uint32_t degree, double mu, double radius,
+                                   const std::vector<double>& cosineCoefficients,
+                                   const std::vector<double>& sineCoefficients) {
+    size_t size = triangularIndex(degree, degree) + 1;
+    if (cosineCoefficients.size() < size || sineCoefficients.size() < size) {
+        throw std::runtime_error("Failed to set gravity coefficients: arrays are shorter than the degree!");
+    }
+    m_cosine.assign(cosineCoefficients.begin(), cosineCoefficients.begin() + size);
+    m_sine.assign(sineCoefficients.begin(), sineCoefficients.begin() + size);
+    m_mu = mu;
+    m_radius = radius;
+    m_loadedDegree = degree;
+    m_degree = degree;
+    prepare();
+}
+
+void GravityField::setDegree(uint32_t degree) {
+    m_degree = std::min(degree, m_loadedDegree);
+    prepare();
+}
+
+void GravityField::prepare() {
+    size_t N = m_degree;
+
+    // Recursion factors of the normalized V/W functions up to degree N + 1
+    m_alpha.assign(triangularIndex(N + 1, N + 1) + 1, 0.0);
+    m_beta.assign(m_alpha.size(), 0.0);
+    m_diagonal.assign(N + 2, 0.0);
+    for (size_t n = 1; n <= N + 1; n++) {
+        for (size_t m = 0; m < n; m++) {
+            double nn = static_cast<double>(n);
+            double mm = static_cast<double>(m);
+            m_alpha[triangularIndex(n, m)] = std::sqrt((2.0 * nn + 1.0) * (2.0 * nn - 1.0) / ((nn - mm) * (nn + mm)));
+            if (n >= m + 2) {
+                m_beta[triangularIndex(n, m)] = std::sqrt((2.0 * nn + 1.0) * (nn + mm - 1.0) * (nn - mm - 1.0) /
+                                                          ((2.0 * nn - 3.0) * (nn + mm) * (nn - mm)));
+            }
+        }
+    }
+    for (size_t m = 1; m <= N + 1; m++) {
+        double mm = static_cast<double>(m);
+        m_diagonal[m] = (m == 1) ? std::sqrt(3.0) : std::sqrt((2.0 * mm + 1.0) / (2.0 * mm));
+    }
+
+    // Coefficients times the ratios of normalization factors between the (n, m) term and
+    // the degree n + 1 functions it is evaluated with
+    m_coefficients.assign(6 * (triangularIndex(N, N) + 1), 0.0);
+    for (size_t n = 0; n <= N; n++) {
+        double nn = static_cast<double>(n);
+        double degreeRatio = (2.0 * nn + 1.0) / (2.0 * nn + 3.0);
+        for (size_t m = 0; m <= n; m++) {
+            double mm = static_cast<double>(m);
+            double C = m_cosine[triangularIndex(n, m)];
+            double S = m_sine[triangularIndex(n, m)];
+            double* c = &m_coefficients[6 * triangularIndex(n, m)];
+
+            // x/y terms of order m + 1 and m - 1 carry a factor 1/2 except at m = 0
+            double up = std::sqrt(((m == 0) ? 0.5 : 1.0) * degreeRatio * (nn + mm + 1.0) * (nn + mm + 2.0));
+            double half = (m == 0) ? 1.0 : 0.5;
+            c[0] = half * up * C;
+            c[1] = half * up * S;
+            if (m > 0) {
+                double down = std::sqrt(((m == 1) ? 2.0 : 1.0) * degreeRatio * (nn - mm + 1.0) * (nn - mm + 2.0));
+                c[2] = 0.5 * down * C;
+                c[3] = 0.5 * down * S;
+            }
+            double along = std::sqrt(degreeRatio * (nn + mm + 1.0) * (nn - mm + 1.0));
+            c[4] = along * C;
+            c[5] = along * S;
+        }
+    }
+
+    m_terms.degree = m_degree;
+    m_terms.radius = m_radius;
+    m_terms.scale = m_mu / (m_radius * m_radius);
+    m_terms.alpha = m_alpha.data();
+    m_terms.beta = m_beta.data();
+    m_terms.diagonal = m_diagonal.data();
+    m_terms.coefficients = m_coefficients.data();
+}
+
+void GravityField::evaluate(const double* x, const double* y, const double* z, double* accelerationX,
+                            double* accelerationY, double* accelerationZ, size_t count, ThreadPool* pool) const {
+    const OrbitKernels& kernels = getOrbitKernels();
+    size_t scratchSize = gravityScratchSize(m_degree);
+
+    if (pool == nullptr || pool->getThreadCount() == 1 || count <= GRAVITY_TASK) {
+        std::vector<double> scratch(scratchSize);
+        kernels.gravityAcceleration(m_terms, x, y, z, accelerationX, accelerationY, accelerationZ, count,
+                                    scratch.data());
+        return;
+    }
+
+    std::vector<double> scratch(scratchSize * pool->getThreadCount());
+    size_t taskCount = (count + GRAVITY_TASK - 1) / GRAVITY_TASK;
+    pool->parallelFor(taskCount, [&](size_t task, size_t worker) {
+        size_t first = task * GRAVITY_TASK;
+        size_t taskSize = std::min(GRAVITY_TASK, count - first);
+        kernels.gravityAcceleration(m_terms, x + first, y + first, z + first, accelerationX + first,
+                                    accelerationY + first, accelerationZ + first, taskSize,
+                                    scratch.data() + worker * scratchSize);
+    });
+}
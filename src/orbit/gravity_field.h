@@ -0,0 +1,104 @@
+#pragma once
+
+#include "orbit/orbit_kernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Earth gravity field as fully normalized spherical harmonic coefficients, EGM style.
+ *
+ * Coefficients are loaded up to some degree once; setDegree() then picks the degree
+ * actually evaluated, so one loaded model serves quick and precise runs. The field is
+ * Earth-fixed: positions must be in ITRF (see frameRotation()) and accelerations come
+ * back in ITRF. Lengths are in the unit of the field's radius (meters for ICGEM and
+ * EGM files); the result includes the central term.
+ */
+class GravityField {
+public:
+    /**
+     * Creates a point-mass field with the EGM2008 constants, in meters and seconds.
+     */
+    GravityField();
+
+    /**
+     * Loads coefficients from an ICGEM .gfc file (header keys earth_gravity_constant and
+     * radius, then "gfc n m C S ..." lines) or a plain EGM table ("n m C S ..." per line,
+     * Fortran D exponents allowed, EGM2008 constants). Coefficients above maxDegree are
+     * skipped. The evaluated degree is set to the loaded one.
+     *
+     * @param path File path
+     * @param maxDegree Highest degree to keep
+     */
+    void load(const std::string& path, uint32_t maxDegree);
+
+    /**
+     * Replaces the coefficients.
+     *
+     * @param degree Maximum degree
+     * @param mu Gravitational parameter GM
+     * @param radius Reference radius
+     * @param cosineCoefficients Normalized C(n, m), triangular, index n (n + 1) / 2 + m
+     * @param sineCoefficients Normalized S(n, m), same layout
+     */
+    void setCoefficients(uint32_t degree, double mu, double radius, const std::vector<double>& cosineCoefficients,
+                         const std::vector<double>& sineCoefficients);
+
+    /**
+     * Sets the degree (and order) evaluated, up to the degree loaded.
+     *
+     * @param degree Degree, 0 for a point mass
+     */
+    void setDegree(uint32_t degree);
+
+    /**
+     * Evaluates the acceleration at a batch of Earth-fixed positions with the dispatched
+     * gravity kernel, split across the pool's threads.
+     *
+     * @param x Position x
+     * @param y Position y
+     * @param z Position z
+     * @param accelerationX Output x acceleration
+     * @param accelerationY Output y acceleration
+     * @param accelerationZ Output z acceleration
+     * @param count Number of positions
+     * @param pool Threads to use, or nullptr to run on the calling thread
+     */
+    void evaluate(const double* x, const double* y, const double* z, double* accelerationX,
+                  double* accelerationY, double* accelerationZ, size_t count, ThreadPool* pool = nullptr) const;
+
+    /**
+     * Gets the prepared terms for calling OrbitKernels::gravityAcceleration() directly.
+     *
+     * @return Terms valid until the field changes
+     */
+    const GravityTerms& getTerms() const { return m_terms; }
+
+    uint32_t getDegree() const { return m_degree; }
+    uint32_t getLoadedDegree() const { return m_loadedDegree; }
+    double getMu() const { return m_mu; }
+    double getRadius() const { return m_radius; }
+
+private:
+    /**
+     * Rebuilds the recursion factors and scaled coefficients for the current degree.
+     */
+    void prepare();
+
+    uint32_t m_loadedDegree;
+    uint32_t m_degree;
+    double m_mu;
+    double m_radius;
+    std::vector<double> m_cosine;
+    std::vector<double> m_sine;
+
+    // Arrays behind m_terms
+    std::vector<double> m_alpha;
+    std::vector<double> m_beta;
+    std::vector<double> m_diagonal;
+    std::vector<double> m_coefficients;
+    GravityTerms m_terms;
+};
@@ -0,0 +1,104 @@
+#include "orbit/gravity_grid.h"
+#include "orbit/gravity_field.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+} // namespace
+
+GravityGrid::GravityGrid()
+    : m_layout{}, m_mu(0.0), m_radialStep(0.0), m_latitudeStep(0.0), m_longitudeStep(0.0) {}
+
+void GravityGrid::build(const GravityField& field, const Layout& layout, ThreadPool* pool) {
+    if (layout.radialCount < 2 || layout.latitudeCount < 2 || layout.longitudeCount < 3 ||
+        !(layout.minRadius > 0.0) || !(layout.maxRadius > layout.minRadius)) {
+        throw std::runtime_error("Failed to build gravity grid: invalid layout!");
+    }
+
+    m_layout = layout;
+    m_mu = field.getMu();
+    m_radialStep = (layout.maxRadius - layout.minRadius) / (layout.radialCount - 1);
+    m_latitudeStep = PI / (layout.latitudeCount - 1);
+    m_longitudeStep = 2.0 * PI / layout.longitudeCount;
+
+    // One shell of nodes at a time keeps the double precision buffers small
+    size_t shellSize = static_cast<size_t>(layout.latitudeCount) * layout.longitudeCount;
+    std::vector<double> x(shellSize), y(shellSize), z(shellSize);
+    std::vector<double> ax(shellSize), ay(shellSize), az(shellSize);
+    m_nodes.assign(3 * shellSize * layout.radialCount, 0.0f);
+
+    for (uint32_t shell = 0; shell < layout.radialCount; shell++) {
+        double r = layout.minRadius + shell * m_radialStep;
+        for (uint32_t i = 0; i < layout.latitudeCount; i++) {
+            double latitude = -0.5 * PI + i * m_latitudeStep;
+            for (uint32_t j = 0; j < layout.longitudeCount; j++) {
+                double longitude = -PI + j * m_longitudeStep;
+                size_t node = static_cast<size_t>(i) * layout.longitudeCount + j;
+                x[node] = r * std::cos(latitude) * std::cos(longitude);
+                y[node] = r * std::cos(latitude) * std::sin(longitude);
+                z[node] = r * std::sin(latitude);
+            }
+        }
+
+        field.evaluate(x.data(), y.data(), z.data(), ax.data(), ay.data(), az.data(), shellSize, pool);
+
+        float* nodes = m_nodes.data() + 3 * shellSize * shell;
+        double central = m_mu / (r * r * r);
+        for (size_t node = 0; node < shellSize; node++) {
+            nodes[3 * node + 0] = static_cast<float>(ax[node] + central * x[node]);
+            nodes[3 * node + 1] = static_cast<float>(ay[node] + central * y[node]);
+            nodes[3 * node + 2] = static_cast<float>(az[node] + central * z[node]);
+        }
+    }
+}
+
+void GravityGrid::evaluate(const double* x, const double* y, const double* z, double* accelerationX,
+                           double* accelerationY, double* accelerationZ, size_t count) const {
+    if (m_nodes.empty()) {
+        throw std::runtime_error("Failed to evaluate gravity grid: grid is not built!");
+    }
+
+    const size_t longitudeCount = m_layout.longitudeCount;
+    const size_t shellSize = m_layout.latitudeCount * longitudeCount;
+    const double maxShell = static_cast<double>(m_layout.radialCount - 1);
+    const double maxLatitude = static_cast<double>(m_layout.latitudeCount - 1);
+
+    for (size_t i = 0; i < count; i++) {
+        double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+        // Cell and fractions; radius and latitude clamp to the grid, longitude wraps
+        double u = std::clamp((r - m_layout.minRadius) / m_radialStep, 0.0, maxShell);
+        double v = std::clamp((std::asin(z[i] / r) + 0.5 * PI) / m_latitudeStep, 0.0, maxLatitude);
+        double w = (std::atan2(y[i], x[i]) + PI) / m_longitudeStep;
+        size_t shell = std::min<size_t>(static_cast<size_t>(u), m_layout.radialCount - 2);
+        size_t row = std::min<size_t>(static_cast<size_t>(v), m_layout.latitudeCount - 2);
+        size_t column = std::min(static_cast<size_t>(w), longitudeCount - 1);
+        size_t nextColumn = (column + 1 == longitudeCount) ? 0 : column + 1;
+        double fu = u - shell;
+        double fv = v - row;
+        double fw = w - column;
+
+        double sum[3] = {0.0, 0.0, 0.0};
+        for (size_t corner = 0; corner < 8; corner++) {
+            size_t cornerShell = shell + (corner & 1);
+            size_t cornerRow = row + ((corner >> 1) & 1);
+            size_t cornerColumn = (corner & 4) ? nextColumn : column;
+            double weight = ((corner & 1) ? fu : 1.0 - fu) * (((corner >> 1) & 1) ? fv : 1.0 - fv) *
+                            ((corner & 4) ? fw : 1.0 - fw);
+            const float* node = m_nodes.data() + 3 * (cornerShell * shellSize + cornerRow * longitudeCount +
+                                                      cornerColumn);
+            sum[0] += weight * node[0];
+            sum[1] += weight * node[1];
+            sum[2] += weight * node[2];
+        }
+
+        double central = m_mu / (r * r * r);
+        accelerationX[i] = sum[0] - central * x[i];
+        accelerationY[i] = sum[1] - central * y[i];
+        accelerationZ[i] = sum[2] - central * z[i];
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GravityField;
+class ThreadPool;
+
+/**
+ * Precomputed 3D table of a gravity field's acceleration, for catalogs where evaluating
+ * the full field per object and step costs too much.
+ *
+ * The table covers a spherical shell on a regular (radius, latitude, longitude) grid and
+ * stores the field minus its central term, as float Earth-fixed components per node. A
+ * lookup interpolates that perturbation trilinearly and adds the exact central term, so
+ * the error is a fraction of the perturbation, not of the total. The grid has to resolve
+ * the shortest wavelength of interest: at degree n that is about 40000 / n km, so 1 degree
+ * spacing suits fields up to degree 20 to 30. Positions outside the shell take the
+ * perturbation of the nearest shell radius.
+ */
+class GravityGrid {
+public:
+    /**
+     * Grid extent and resolution.
+     */
+    struct Layout {
+        double minRadius;           // in the unit of the field's radius
+        double maxRadius;
+        uint32_t radialCount;       // nodes from minRadius to maxRadius, at least 2
+        uint32_t latitudeCount;     // nodes from pole to pole, at least 2
+        uint32_t longitudeCount;    // nodes around the equator, at least 3
+    };
+
+    GravityGrid();
+
+    /**
+     * Evaluates a field at every node. Takes a while for fine grids and high degrees;
+     * rebuild only when the field or layout changes.
+     *
+     * @param field Field to tabulate, at its current degree
+     * @param layout Grid extent and resolution
+     * @param pool Threads to use, or nullptr to run on the calling thread
+     */
+    void build(const GravityField& field, const Layout& layout, ThreadPool* pool = nullptr);
+
+    /**
+     * Looks up the acceleration at a batch of Earth-fixed positions.
+     *
+     * @param x Position x
+     * @param y Position y
+     * @param z Position z
+     * @param accelerationX Output x acceleration
+     * @param accelerationY Output y acceleration
+     * @param accelerationZ Output z acceleration
+     * @param count Number of positions
+     */
+    void evaluate(const double* x, const double* y, const double* z, double* accelerationX,
+                  double* accelerationY, double* accelerationZ, size_t count) const;
+
+    /**
+     * Gets the memory held by the table.
+     *
+     * @return Size in bytes
+     */
+    size_t getBytes() const { return m_nodes.size() * sizeof(float); }
+
+    bool isBuilt() const { return !m_nodes.empty(); }
+    const Layout& getLayout() const { return m_layout; }
+
+private:
+    Layout m_layout;
+    double m_mu;
+    double m_radialStep;
+    double m_latitudeStep;
+    double m_longitudeStep;
+
+    // Three components per node; longitude varies fastest, then latitude, then radius
+    std::vector<float> m_nodes;
+};
@@ -0,0 +1,72 @@
+#include "orbit/kepler_buckets.h"
+
+KeplerBuckets::KeplerBuckets() {
+    for (size_t& start : m_regimeStart) {
+        start = 0;
+    }
+}
+
+void KeplerBuckets::assign(const float* eccentricity, size_t count) {
+    // Counting sort, stable so objects keep their relative order within a regime
+    size_t counts[KEPLER_REGIME_COUNT] = {};
+    for (size_t i = 0; i < count; i++) {
+        counts[static_cast<size_t>(keplerRegime(eccentricity[i]))]++;
+    }
+
+    m_regimeStart[0] = 0;
+    for (size_t r = 0; r < KEPLER_REGIME_COUNT; r++) {
+        m_regimeStart[r + 1] = m_regimeStart[r] + counts[r];
+    }
+
+    size_t next[KEPLER_REGIME_COUNT];
+    for (size_t r = 0; r < KEPLER_REGIME_COUNT; r++) {
+        next[r] = m_regimeStart[r];
+    }
+
+    m_permutation.resize(count);
+    m_eccentricity.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        size_t position = next[static_cast<size_t>(keplerRegime(eccentricity[i]))]++;
+        m_permutation[position] = static_cast<uint32_t>(i);
+        m_eccentricity[position] = eccentricity[i];
+    }
+
+    m_meanAnomaly.resize(count);
+    m_eccentricAnomaly.resize(count);
+    m_cosE.resize(count);
+    m_sinE.resize(count);
+}
+
+void KeplerBuckets::solve(const OrbitKernels& kernels, const float* meanAnomaly,
+                          float* eccentricAnomaly, float* cosE, float* sinE) {
+    size_t count = m_permutation.size();
+    const uint32_t* permutation = m_permutation.data();
+
+    for (size_t i = 0; i < count; i++) {
+        m_meanAnomaly[i] = meanAnomaly[permutation[i]];
+    }
+
+    for (size_t r = 0; r < KEPLER_REGIME_COUNT; r++) {
+        size_t first = m_regimeStart[r];
+        size_t regimeCount = m_regimeStart[r + 1] - first;
+        if (regimeCount == 0) {
+            continue;
+        }
+
+        kernels.solveKeplerRegime[r](m_meanAnomaly.data() + first, m_eccentricity.data() + first,
+                                     m_eccentricAnomaly.data() + first, m_cosE.data() + first,
+                                     m_sinE.data() + first, regimeCount);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = permutation[i];
+        eccentricAnomaly[index] = m_eccentricAnomaly[i];
+        cosE[index] = m_cosE[i];
+        sinE[index] = m_sinE[i];
+    }
+}
+
+size_t KeplerBuckets::getCount(KeplerRegime regime) const {
+    size_t r = static_cast<size_t>(regime);
+    return m_regimeStart[r + 1] - m_regimeStart[r];
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "orbit/orbit_kernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Groups a catalog by Kepler solver regime (see KeplerRegime) so each group runs the
+ * solver specialized for it, instead of every object paying for the most eccentric
+ * orbit in its vector.
+ *
+ * The grouping is a stable permutation of the catalog, rebuilt only when eccentricities
+ * change. solve() gathers the inputs into grouped order and scatters the results back,
+ * so callers keep their original object order.
+ */
+class KeplerBuckets {
+public:
+    KeplerBuckets();
+
+    /**
+     * Sorts the objects into regimes. Only needs to run when eccentricities change.
+     *
+     * @param eccentricity Eccentricities
+     * @param count Number of objects
+     */
+    void assign(const float* eccentricity, size_t count);
+
+    /**
+     * Solves Kepler's equation for the assigned objects, like OrbitKernels::solveKepler.
+     * Outputs are in the original object order.
+     *
+     * @param kernels Kernel table to solve with
+     * @param meanAnomaly Mean anomalies, in original order
+     * @param eccentricAnomaly Output eccentric anomalies
+     * @param cosE Output cosines of the eccentric anomalies
+     * @param sinE Output sines of the eccentric anomalies
+     */
+    void solve(const OrbitKernels& kernels, const float* meanAnomaly,
+               float* eccentricAnomaly, float* cosE, float* sinE);
+
+    /**
+     * Gets the permutation from grouped position to original object index.
+     *
+     * @return Original index of each grouped object
+     */
+    const std::vector<uint32_t>& getPermutation() const { return m_permutation; }
+
+    /**
+     * Gets the number of objects in a regime.
+     *
+     * @param regime Solver regime
+     * @return Object count
+     */
+    size_t getCount(KeplerRegime regime) const;
+
+    size_t getObjectCount() const { return m_permutation.size(); }
+
+private:
+    // Grouped position -> original index
+    std::vector<uint32_t> m_permutation;
+
+    // First grouped position of each regime, plus the total count
+    size_t m_regimeStart[KEPLER_REGIME_COUNT + 1];
+
+    // Per-object data in grouped order
+    std::vector<float> m_eccentricity;
+    std::vector<float> m_meanAnomaly;
+    std::vector<float> m_eccentricAnomaly;
+    std::vector<float> m_cosE;
+    std::vector<float> m_sinE;
+};
@@ -0,0 +1,843 @@
+#include "orbit/object_tracker.h"
+#include "orbit/spatial_order.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+constexpr int STATE_SIZE = 6;
+constexpr int SIGMA_COUNT = 2 * STATE_SIZE + 1;
+
+// Most measurements processed together; larger groups at one time are split
+constexpr int MAX_MEASUREMENTS = 6;
+
+// Nearest objects within the gate radius considered for each detection
+constexpr int MAX_CANDIDATES = 4;
+
+// Bound on the speed of any Earth orbiting object, m/s
+constexpr double MAX_ORBITAL_SPEED = 11.2e3;
+
+// Grid cell coordinates are offset by this so they fit the unsigned 21-bit Morton input
+constexpr int64_t GRID_OFFSET = int64_t(1) << 20;
+constexpr int64_t GRID_LIMIT = (int64_t(1) << 21) - 1;
+
+// Unscented transform with alpha = 1, beta = 2, kappa = 0: sigma points sqrt(6) standard
+// deviations out, the centre weighted only in the covariance
+constexpr double SIGMA_SPREAD = 2.449489742783178;
+constexpr double CENTER_COVARIANCE_WEIGHT = 2.0;
+constexpr double SIGMA_WEIGHT = 1.0 / (2.0 * STATE_SIZE);
+
+constexpr uint32_t UNASSOCIATED = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Filter state predicted to a measurement time.
+ */
+struct Prediction {
+    double state[STATE_SIZE];
+    double covariance[STATE_SIZE][STATE_SIZE];
+
+    // Propagated sigma points, unscented filter only
+    double sigmaPoints[SIGMA_COUNT][STATE_SIZE];
+};
+
+/**
+ * Measurements of one object at one time.
+ */
+struct MeasurementSet {
+    MeasurementType type[MAX_MEASUREMENTS];
+    double value[MAX_MEASUREMENTS];
+    double sigma[MAX_MEASUREMENTS];
+    const SiteGeometry* site[MAX_MEASUREMENTS];
+    int count;
+};
+
+/**
+ * Innovation of a measurement set against a prediction, with what the update needs.
+ */
+struct Innovation {
+    double residual[MAX_MEASUREMENTS];
+    double crossCovariance[STATE_SIZE][MAX_MEASUREMENTS];   // P H^T
+    double factor[MAX_MEASUREMENTS][MAX_MEASUREMENTS];      // Cholesky factor of S
+    double normalizedSquared;                               // residual^T S^-1 residual
+};
+
+/**
+ * The best candidate of one detection, predicted and ready to update, plus every gated
+ * candidate for the assignment.
+ */
+struct DetectionCandidates {
+    Prediction prediction;
+    Innovation innovation;
+    uint32_t bestObject;
+    uint32_t objects[MAX_CANDIDATES];
+    double normalizedSquared[MAX_CANDIDATES];
+    int count;
+};
+
+constexpr int triangleIndex(int i, int j) {
+    return i * STATE_SIZE - i * (i - 1) / 2 + (j - i);
+}
+
+double dot(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/**
+ * Cholesky factorization of a symmetric positive definite matrix in place (lower
+ * triangle).
+ *
+ * @return False if the matrix is not positive definite
+ */
+bool choleskyFactor(double m[][STATE_SIZE], int size) {
+    for (int j = 0; j < size; j++) {
+        double diagonal = m[j][j];
+        for (int k = 0; k < j; k++) {
+            diagonal -= m[j][k] * m[j][k];
+        }
+        if (!(diagonal > 0.0)) {
+            return false;
+        }
+        m[j][j] = std::sqrt(diagonal);
+        for (int i = j + 1; i < size; i++) {
+            double value = m[i][j];
+            for (int k = 0; k < j; k++) {
+                value -= m[i][k] * m[j][k];
+            }
+            m[i][j] = value / m[j][j];
+        }
+    }
+    return true;
+}
+
+void forwardSubstitute(const double factor[][STATE_SIZE], int size, const double b[], double y[]) {
+    for (int i = 0; i < size; i++) {
+        double value = b[i];
+        for (int k = 0; k < i; k++) {
+            value -= factor[i][k] * y[k];
+        }
+        y[i] = value / factor[i][i];
+    }
+}
+
+void choleskySolve(const double factor[][STATE_SIZE], int size, const double b[], double x[]) {
+    double y[STATE_SIZE];
+    forwardSubstitute(factor, size, b, y);
+    for (int i = size - 1; i >= 0; i--) {
+        double value = y[i];
+        for (int k = i + 1; k < size; k++) {
+            value -= factor[k][i] * x[k];
+        }
+        x[i] = value / factor[i][i];
+    }
+}
+
+static_assert(MAX_MEASUREMENTS == STATE_SIZE, "Cholesky helpers share one row stride");
+
+/**
+ * Two-body plus J2 acceleration.
+ */
+void acceleration(const TrackerSettings& settings, const double r[3], double a[3]) {
+    double inverseR2 = 1.0 / dot(r, r);
+    double inverseR = std::sqrt(inverseR2);
+    double central = -settings.mu * inverseR2 * inverseR;
+    double z2 = r[2] * r[2] * inverseR2;
+    double j2 = 1.5 * settings.j2 * settings.mu * settings.earthRadius * settings.earthRadius * inverseR2 *
+                inverseR2 * inverseR;
+    a[0] = r[0] * (central - j2 * (1.0 - 5.0 * z2));
+    a[1] = r[1] * (central - j2 * (1.0 - 5.0 * z2));
+    a[2] = r[2] * (central - j2 * (3.0 - 5.0 * z2));
+}
+
+void rk4Step(const TrackerSettings& settings, double state[STATE_SIZE], double h) {
+    double k[4][STATE_SIZE];
+    double stage[STATE_SIZE];
+    const double fractions[4] = {0.0, 0.5, 0.5, 1.0};
+    for (int s = 0; s < 4; s++) {
+        for (int i = 0; i < STATE_SIZE; i++) {
+            stage[i] = (s == 0) ? state[i] : state[i] + fractions[s] * h * k[s - 1][i];
+        }
+        k[s][0] = stage[3];
+        k[s][1] = stage[4];
+        k[s][2] = stage[5];
+        acceleration(settings, stage, &k[s][3]);
+    }
+    for (int i = 0; i < STATE_SIZE; i++) {
+        state[i] += h / 6.0 * (k[0][i] + 2.0 * k[1][i] + 2.0 * k[2][i] + k[3][i]);
+    }
+}
+
+/**
+ * Derivative of the state and the state transition matrix. The matrix uses the central
+ * gravity gradient only; J2 changes it by about 0.1%, well below the covariance's own
+ * accuracy.
+ */
+void transitionDerivative(const TrackerSettings& settings, const double state[STATE_SIZE],
+                          const double transition[STATE_SIZE][STATE_SIZE], double stateRate[STATE_SIZE],
+                          double transitionRate[STATE_SIZE][STATE_SIZE]) {
+    stateRate[0] = state[3];
+    stateRate[1] = state[4];
+    stateRate[2] = state[5];
+    acceleration(settings, state, &stateRate[3]);
+
+    // G = mu / r^3 (3 u u^T - I)
+    double inverseR2 = 1.0 / dot(state, state);
+    double scale = settings.mu * inverseR2 * std::sqrt(inverseR2);
+    double gradient[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            gradient[i][j] = scale * (3.0 * state[i] * state[j] * inverseR2 - (i == j ? 1.0 : 0.0));
+        }
+    }
+    for (int j = 0; j < STATE_SIZE; j++) {
+        for (int i = 0; i < 3; i++) {
+            transitionRate[i][j] = transition[i + 3][j];
+            transitionRate[i + 3][j] = gradient[i][0] * transition[0][j] + gradient[i][1] * transition[1][j] +
+                                       gradient[i][2] * transition[2][j];
+        }
+    }
+}
+
+/**
+ * Propagates a state with its state transition matrix, which starts as identity.
+ */
+void propagateWithTransition(const TrackerSettings& settings, double state[STATE_SIZE], double dt,
+                             double transition[STATE_SIZE][STATE_SIZE]) {
+    for (int i = 0; i < STATE_SIZE; i++) {
+        for (int j = 0; j < STATE_SIZE; j++) {
+            transition[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+    if (dt == 0.0) {
+        return;
+    }
+
+    int steps = std::max(1, static_cast<int>(std::ceil(std::abs(dt) / settings.maxStep)));
+    double h = dt / steps;
+    double k[4][STATE_SIZE], kTransition[4][STATE_SIZE][STATE_SIZE];
+    double stage[STATE_SIZE], stageTransition[STATE_SIZE][STATE_SIZE];
+    const double fractions[4] = {0.0, 0.5, 0.5, 1.0};
+    for (int step = 0; step < steps; step++) {
+        for (int s = 0; s < 4; s++) {
+            double f = fractions[s] * h;
+            for (int i = 0; i < STATE_SIZE; i++) {
+                stage[i] = (s == 0) ? state[i] : state[i] + f * k[s - 1][i];
+                for (int j = 0; j < STATE_SIZE; j++) {
+                    stageTransition[i][j] = (s == 0) ? transition[i][j]
+                                                     : transition[i][j] + f * kTransition[s - 1][i][j];
+                }
+            }
+            transitionDerivative(settings, stage, stageTransition, k[s], kTransition[s]);
+        }
+        for (int i = 0; i < STATE_SIZE; i++) {
+            state[i] += h / 6.0 * (k[0][i] + 2.0 * k[1][i] + 2.0 * k[2][i] + k[3][i]);
+            for (int j = 0; j < STATE_SIZE; j++) {
+                transition[i][j] += h / 6.0 * (kTransition[0][i][j] + 2.0 * kTransition[1][i][j] +
+                                               2.0 * kTransition[2][i][j] + kTransition[3][i][j]);
+            }
+        }
+    }
+}
+
+/**
+ * Adds white acceleration noise accumulated over an interval to a covariance.
+ */
+void addProcessNoise(double covariance[STATE_SIZE][STATE_SIZE], double spectralDensity, double dt) {
+    dt = std::abs(dt);
+    double positionNoise = spectralDensity * dt * dt * dt / 3.0;
+    double crossNoise = spectralDensity * dt * dt / 2.0;
+    double velocityNoise = spectralDensity * dt;
+    for (int k = 0; k < 3; k++) {
+        covariance[k][k] += positionNoise;
+        covariance[k][k + 3] += crossNoise;
+        covariance[k + 3][k] += crossNoise;
+        covariance[k + 3][k + 3] += velocityNoise;
+    }
+}
+
+/**
+ * Predicts a filter state over an interval.
+ *
+ * @return False if the covariance is not positive definite
+ */
+bool predict(const TrackerSettings& settings, const double state[STATE_SIZE],
+             const double covariance[STATE_SIZE][STATE_SIZE], double dt, Prediction& prediction) {
+    if (settings.filter == TrackingFilter::Extended) {
+        double transition[STATE_SIZE][STATE_SIZE];
+        std::copy(state, state + STATE_SIZE, prediction.state);
+        propagateWithTransition(settings, prediction.state, dt, transition);
+
+        // P = F P F^T
+        double product[STATE_SIZE][STATE_SIZE];
+        for (int i = 0; i < STATE_SIZE; i++) {
+            for (int j = 0; j < STATE_SIZE; j++) {
+                double value = 0.0;
+                for (int k = 0; k < STATE_SIZE; k++) {
+                    value += transition[i][k] * covariance[k][j];
+                }
+                product[i][j] = value;
+            }
+        }
+        for (int i = 0; i < STATE_SIZE; i++) {
+            for (int j = i; j < STATE_SIZE; j++) {
+                double value = 0.0;
+                for (int k = 0; k < STATE_SIZE; k++) {
+                    value += product[i][k] * transition[j][k];
+                }
+                prediction.covariance[i][j] = value;
+                prediction.covariance[j][i] = value;
+            }
+        }
+    } else {
+        double factor[STATE_SIZE][STATE_SIZE];
+        std::copy(&covariance[0][0], &covariance[0][0] + STATE_SIZE * STATE_SIZE, &factor[0][0]);
+        if (!choleskyFactor(factor, STATE_SIZE)) {
+            return false;
+        }
+
+        std::copy(state, state + STATE_SIZE, prediction.sigmaPoints[0]);
+        for (int j = 0; j < STATE_SIZE; j++) {
+            for (int i = 0; i < STATE_SIZE; i++) {
+                double offset = (i >= j) ? SIGMA_SPREAD * factor[i][j] : 0.0;
+                prediction.sigmaPoints[1 + j][i] = state[i] + offset;
+                prediction.sigmaPoints[1 + STATE_SIZE + j][i] = state[i] - offset;
+            }
+        }
+        for (int s = 0; s < SIGMA_COUNT; s++) {
+            propagateTrackedState(settings, prediction.sigmaPoints[s], dt);
+        }
+
+        // The centre has no mean weight, so the mean is that of the symmetric points
+        for (int i = 0; i < STATE_SIZE; i++) {
+            double sum = 0.0;
+            for (int s = 1; s < SIGMA_COUNT; s++) {
+                sum += prediction.sigmaPoints[s][i];
+            }
+            prediction.state[i] = sum * SIGMA_WEIGHT;
+        }
+        for (int i = 0; i < STATE_SIZE; i++) {
+            for (int j = i; j < STATE_SIZE; j++) {
+                double value = CENTER_COVARIANCE_WEIGHT * (prediction.sigmaPoints[0][i] - prediction.state[i]) *
+                               (prediction.sigmaPoints[0][j] - prediction.state[j]);
+                for (int s = 1; s < SIGMA_COUNT; s++) {
+                    value += SIGMA_WEIGHT * (prediction.sigmaPoints[s][i] - prediction.state[i]) *
+                             (prediction.sigmaPoints[s][j] - prediction.state[j]);
+                }
+                prediction.covariance[i][j] = value;
+                prediction.covariance[j][i] = value;
+            }
+        }
+    }
+
+    addProcessNoise(prediction.covariance, settings.processNoise, dt);
+    return true;
+}
+
+/**
+ * Computes the innovation of a measurement set and its covariance S.
+ *
+ * @return False if S is not positive definite
+ */
+bool computeInnovation(const TrackerSettings& settings, const Prediction& prediction,
+                       const MeasurementSet& measurements, Innovation& innovation) {
+    int m = measurements.count;
+    double S[MAX_MEASUREMENTS][STATE_SIZE] = {};
+
+    if (settings.filter == TrackingFilter::Extended) {
+        double H[MAX_MEASUREMENTS][3];
+        for (int k = 0; k < m; k++) {
+            double predicted = predictMeasurement(measurements.type[k], *measurements.site[k], prediction.state,
+                                                  H[k]);
+            innovation.residual[k] = measurementResidual(measurements.type[k], measurements.value[k], predicted);
+        }
+
+        // P H^T, with H zero in the velocity columns
+        for (int i = 0; i < STATE_SIZE; i++) {
+            for (int k = 0; k < m; k++) {
+                innovation.crossCovariance[i][k] = prediction.covariance[i][0] * H[k][0] +
+                                                   prediction.covariance[i][1] * H[k][1] +
+                                                   prediction.covariance[i][2] * H[k][2];
+            }
+        }
+        for (int k = 0; k < m; k++) {
+            for (int l = 0; l < m; l++) {
+                S[k][l] = H[k][0] * innovation.crossCovariance[0][l] + H[k][1] * innovation.crossCovariance[1][l] +
+                          H[k][2] * innovation.crossCovariance[2][l];
+            }
+        }
+    } else {
+        double Z[SIGMA_COUNT][MAX_MEASUREMENTS];
+        double mean[MAX_MEASUREMENTS];
+        for (int k = 0; k < m; k++) {
+            for (int s = 0; s < SIGMA_COUNT; s++) {
+                Z[s][k] = predictMeasurement(measurements.type[k], *measurements.site[k],
+                                             prediction.sigmaPoints[s], nullptr);
+            }
+
+            // Averaged as offsets from the centre so angles do not average across 2 pi
+            double sum = 0.0;
+            for (int s = 1; s < SIGMA_COUNT; s++) {
+                sum += measurementResidual(measurements.type[k], Z[s][k], Z[0][k]);
+            }
+            mean[k] = Z[0][k] + sum * SIGMA_WEIGHT;
+            for (int s = 0; s < SIGMA_COUNT; s++) {
+                Z[s][k] = measurementResidual(measurements.type[k], Z[s][k], mean[k]);
+            }
+            innovation.residual[k] = measurementResidual(measurements.type[k], measurements.value[k], mean[k]);
+        }
+
+        for (int s = 0; s < SIGMA_COUNT; s++) {
+            double weight = (s == 0) ? CENTER_COVARIANCE_WEIGHT : SIGMA_WEIGHT;
+            for (int k = 0; k < m; k++) {
+                for (int l = 0; l < m; l++) {
+                    S[k][l] += weight * Z[s][k] * Z[s][l];
+                }
+            }
+        }
+        for (int i = 0; i < STATE_SIZE; i++) {
+            for (int k = 0; k < m; k++) {
+                double value = 0.0;
+                for (int s = 0; s < SIGMA_COUNT; s++) {
+                    double weight = (s == 0) ? CENTER_COVARIANCE_WEIGHT : SIGMA_WEIGHT;
+                    value += weight * (prediction.sigmaPoints[s][i] - prediction.state[i]) * Z[s][k];
+                }
+                innovation.crossCovariance[i][k] = value;
+            }
+        }
+    }
+
+    for (int k = 0; k < m; k++) {
+        S[k][k] += measurements.sigma[k] * measurements.sigma[k];
+    }
+    std::copy(&S[0][0], &S[0][0] + MAX_MEASUREMENTS * STATE_SIZE, &innovation.factor[0][0]);
+    if (!choleskyFactor(innovation.factor, m)) {
+        return false;
+    }
+
+    double whitened[MAX_MEASUREMENTS];
+    forwardSubstitute(innovation.factor, m, innovation.residual, whitened);
+    innovation.normalizedSquared = 0.0;
+    for (int k = 0; k < m; k++) {
+        innovation.normalizedSquared += whitened[k] * whitened[k];
+    }
+    return true;
+}
+
+/**
+ * Applies a measurement update to a prediction in place: K = C S^-1, x += K r,
+ * P -= K C^T.
+ */
+void applyUpdate(Prediction& prediction, const Innovation& innovation, int m) {
+    double gain[STATE_SIZE][MAX_MEASUREMENTS];
+    for (int i = 0; i < STATE_SIZE; i++) {
+        choleskySolve(innovation.factor, m, innovation.crossCovariance[i], gain[i]);
+    }
+    for (int i = 0; i < STATE_SIZE; i++) {
+        for (int k = 0; k < m; k++) {
+            prediction.state[i] += gain[i][k] * innovation.residual[k];
+        }
+    }
+    for (int i = 0; i < STATE_SIZE; i++) {
+        for (int j = i; j < STATE_SIZE; j++) {
+            double value = 0.0;
+            for (int k = 0; k < m; k++) {
+                value += 0.5 * (gain[i][k] * innovation.crossCovariance[j][k] +
+                                gain[j][k] * innovation.crossCovariance[i][k]);
+            }
+            prediction.covariance[i][j] -= value;
+            prediction.covariance[j][i] = prediction.covariance[i][j];
+        }
+    }
+}
+
+/**
+ * Gets the three measurements of a radar detection.
+ */
+MeasurementSet detectionMeasurements(const RadarDetection& detection, const SiteGeometry* geometries) {
+    MeasurementSet measurements;
+    measurements.count = 3;
+    measurements.type[0] = MeasurementType::Range;
+    measurements.type[1] = MeasurementType::Azimuth;
+    measurements.type[2] = MeasurementType::Elevation;
+    measurements.value[0] = detection.range;
+    measurements.value[1] = detection.azimuth;
+    measurements.value[2] = detection.elevation;
+    measurements.sigma[0] = detection.rangeSigma;
+    measurements.sigma[1] = detection.angleSigma;
+    measurements.sigma[2] = detection.angleSigma;
+    for (int k = 0; k < 3; k++) {
+        measurements.site[k] = &geometries[detection.geometry];
+    }
+    return measurements;
+}
+
+int64_t cellCoordinate(double value, double inverseCellSize) {
+    int64_t cell = static_cast<int64_t>(std::floor(value * inverseCellSize)) + GRID_OFFSET;
+    return std::clamp<int64_t>(cell, 0, GRID_LIMIT);
+}
+
+uint64_t cellKey(int64_t x, int64_t y, int64_t z) {
+    return mortonCode(static_cast<uint32_t>(x), static_cast<uint32_t>(y), static_cast<uint32_t>(z));
+}
+
+template <typename Function>
+void forEach(ThreadPool* pool, size_t count, const Function& function) {
+    if (pool != nullptr) {
+        pool->parallelFor(count, [&](size_t index, size_t) { function(index); });
+    } else {
+        for (size_t index = 0; index < count; index++) {
+            function(index);
+        }
+    }
+}
+
+} // namespace
+
+void propagateTrackedState(const TrackerSettings& settings, double state[6], double dt) {
+    if (dt == 0.0) {
+        return;
+    }
+    int steps = std::max(1, static_cast<int>(std::ceil(std::abs(dt) / settings.maxStep)));
+    double h = dt / steps;
+    for (int step = 0; step < steps; step++) {
+        rk4Step(settings, state, h);
+    }
+}
+
+ObjectTracker::ObjectTracker(const TrackerSettings& settings)
+    : m_settings(settings),
+      m_cellSize(0.0),
+      m_updateCount(0) {
+}
+
+uint32_t ObjectTracker::addObject(const double state[6], const double covariance[6][6], double epoch) {
+    uint32_t id = static_cast<uint32_t>(m_epoch.size());
+    for (auto& component : m_state) {
+        component.push_back(0.0);
+    }
+    for (auto& component : m_covariance) {
+        component.push_back(0.0);
+    }
+    for (auto& component : m_gridState) {
+        component.push_back(0.0);
+    }
+    m_epoch.push_back(0.0);
+    m_gridEpoch.push_back(0.0);
+    storeState(id, state, covariance, epoch);
+    return id;
+}
+
+void ObjectTracker::loadState(uint32_t id, double state[6], double covariance[6][6]) const {
+    for (int i = 0; i < STATE_SIZE; i++) {
+        state[i] = m_state[i][id];
+        for (int j = i; j < STATE_SIZE; j++) {
+            covariance[i][j] = m_covariance[triangleIndex(i, j)][id];
+            covariance[j][i] = covariance[i][j];
+        }
+    }
+}
+
+void ObjectTracker::storeState(uint32_t id, const double state[6], const double covariance[6][6], double epoch) {
+    for (int i = 0; i < STATE_SIZE; i++) {
+        m_state[i][id] = state[i];
+        m_gridState[i][id] = state[i];
+        for (int j = i; j < STATE_SIZE; j++) {
+            m_covariance[triangleIndex(i, j)][id] = covariance[i][j];
+        }
+    }
+    m_epoch[id] = epoch;
+    m_gridEpoch[id] = epoch;
+}
+
+void ObjectTracker::getState(uint32_t id, double state[6]) const {
+    for (int i = 0; i < STATE_SIZE; i++) {
+        state[i] = m_state[i][id];
+    }
+}
+
+void ObjectTracker::getCovariance(uint32_t id, double covariance[6][6]) const {
+    double state[STATE_SIZE];
+    loadState(id, state, covariance);
+}
+
+void ObjectTracker::buildGrid(double time, double cellSize, ThreadPool* pool) {
+    size_t count = getCount();
+    double inverseCellSize = 1.0 / cellSize;
+    m_cells.resize(count);
+
+    auto advance = [&](size_t begin, size_t end) {
+        for (size_t id = begin; id < end; id++) {
+            double state[STATE_SIZE];
+            for (int i = 0; i < STATE_SIZE; i++) {
+                state[i] = m_gridState[i][id];
+            }
+            propagateTrackedState(m_settings, state, time - m_gridEpoch[id]);
+            for (int i = 0; i < STATE_SIZE; i++) {
+                m_gridState[i][id] = state[i];
+            }
+            m_gridEpoch[id] = time;
+            m_cells[id] = {cellKey(cellCoordinate(state[0], inverseCellSize),
+                                   cellCoordinate(state[1], inverseCellSize),
+                                   cellCoordinate(state[2], inverseCellSize)),
+                           static_cast<uint32_t>(id)};
+        }
+    };
+    if (pool != nullptr) {
+        pool->parallelRanges(count, [&](size_t begin, size_t end, size_t) { advance(begin, end); });
+    } else {
+        advance(0, count);
+    }
+
+    std::sort(m_cells.begin(), m_cells.end());
+    m_cellSize = cellSize;
+}
+
+size_t ObjectTracker::processDetections(const RadarDetection* detections, size_t count,
+                                        const SiteGeometry* geometries, uint32_t* objectIds, ThreadPool* pool) {
+    if (objectIds != nullptr) {
+        std::fill(objectIds, objectIds + count, UNASSOCIATED);
+    }
+    if (count == 0 || getCount() == 0) {
+        return 0;
+    }
+
+    double firstTime = detections[0].time, lastTime = detections[0].time;
+    for (size_t d = 1; d < count; d++) {
+        firstTime = std::min(firstTime, detections[d].time);
+        lastTime = std::max(lastTime, detections[d].time);
+    }
+    double referenceTime = 0.5 * (firstTime + lastTime);
+
+    // Cells wide enough that an object within the gate of a detection, having moved
+    // since the reference time, is in one of the 27 cells around the detection
+    double cellSize = m_settings.gateRadius + MAX_ORBITAL_SPEED * 0.5 * (lastTime - firstTime);
+    buildGrid(referenceTime, cellSize, pool);
+
+    std::vector<DetectionCandidates> candidates(count);
+    forEach(pool, count, [&](size_t d) {
+        const RadarDetection& detection = detections[d];
+        const SiteGeometry& site = geometries[detection.geometry];
+        DetectionCandidates& result = candidates[d];
+        result.count = 0;
+        result.bestObject = UNASSOCIATED;
+
+        double cosElevation = std::cos(detection.elevation);
+        double east = cosElevation * std::sin(detection.azimuth);
+        double north = cosElevation * std::cos(detection.azimuth);
+        double up = std::sin(detection.elevation);
+        double position[3];
+        for (int k = 0; k < 3; k++) {
+            position[k] = site.position[k] +
+                          detection.range * (east * site.east[k] + north * site.north[k] + up * site.up[k]);
+        }
+
+        // Nearest objects within the gate radius, closest first
+        uint32_t nearest[MAX_CANDIDATES];
+        double nearestDistance2[MAX_CANDIDATES];
+        int nearestCount = 0;
+        double gateRadius2 = m_settings.gateRadius * m_settings.gateRadius;
+        double dt = detection.time - referenceTime;
+        double inverseCellSize = 1.0 / m_cellSize;
+        int64_t cell[3];
+        for (int k = 0; k < 3; k++) {
+            cell[k] = cellCoordinate(position[k], inverseCellSize);
+        }
+        for (int64_t dx = -1; dx <= 1; dx++) {
+            for (int64_t dy = -1; dy <= 1; dy++) {
+                for (int64_t dz = -1; dz <= 1; dz++) {
+                    int64_t x = cell[0] + dx, y = cell[1] + dy, z = cell[2] + dz;
+                    if (x < 0 || y < 0 || z < 0 || x > GRID_LIMIT || y > GRID_LIMIT || z > GRID_LIMIT) {
+                        continue;
+                    }
+                    uint64_t key = cellKey(x, y, z);
+                    auto entry = std::lower_bound(m_cells.begin(), m_cells.end(), key,
+                                                  [](const std::pair<uint64_t, uint32_t>& cellEntry,
+                                                     uint64_t value) { return cellEntry.first < value; });
+                    for (; entry != m_cells.end() && entry->first == key; ++entry) {
+                        uint32_t id = entry->second;
+                        double distance2 = 0.0;
+                        for (int k = 0; k < 3; k++) {
+                            double offset = m_gridState[k][id] + m_gridState[k + 3][id] * dt - position[k];
+                            distance2 += offset * offset;
+                        }
+                        if (distance2 >= gateRadius2) {
+                            continue;
+                        }
+                        int slot = nearestCount;
+                        while (slot > 0 && nearestDistance2[slot - 1] > distance2) {
+                            if (slot < MAX_CANDIDATES) {
+                                nearest[slot] = nearest[slot - 1];
+                                nearestDistance2[slot] = nearestDistance2[slot - 1];
+                            }
+                            slot--;
+                        }
+                        if (slot < MAX_CANDIDATES) {
+                            nearest[slot] = id;
+                            nearestDistance2[slot] = distance2;
+                            nearestCount = std::min(nearestCount + 1, MAX_CANDIDATES);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Filter prediction and chi-square gate; the best candidate's prediction is kept
+        MeasurementSet measurements = detectionMeasurements(detection, geometries);
+        double best = std::numeric_limits<double>::infinity();
+        for (int c = 0; c < nearestCount; c++) {
+            uint32_t id = nearest[c];
+            double state[STATE_SIZE], covariance[STATE_SIZE][STATE_SIZE];
+            loadState(id, state, covariance);
+            Prediction prediction;
+            Innovation innovation;
+            if (!predict(m_settings, state, covariance, detection.time - m_epoch[id], prediction) ||
+                !computeInnovation(m_settings, prediction, measurements, innovation) ||
+                innovation.normalizedSquared > m_settings.gateThreshold) {
+                continue;
+            }
+            result.objects[result.count] = id;
+            result.normalizedSquared[result.count] = innovation.normalizedSquared;
+            result.count++;
+            if (innovation.normalizedSquared < best) {
+                best = innovation.normalizedSquared;
+                result.bestObject = id;
+                result.prediction = prediction;
+                result.innovation = innovation;
+            }
+        }
+    });
+
+    // Greedy assignment, most likely pairs first; ties go to the lower detection index
+    struct Pair {
+        double normalizedSquared;
+        uint32_t detection;
+        uint32_t object;
+    };
+    std::vector<Pair> pairs;
+    for (size_t d = 0; d < count; d++) {
+        for (int c = 0; c < candidates[d].count; c++) {
+            pairs.push_back({candidates[d].normalizedSquared[c], static_cast<uint32_t>(d), candidates[d].objects[c]});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) {
+        return (a.normalizedSquared != b.normalizedSquared) ? a.normalizedSquared < b.normalizedSquared
+                                                            : a.detection < b.detection;
+    });
+
+    std::vector<uint32_t> assignment(count, UNASSOCIATED);
+    std::vector<bool> objectUsed(getCount(), false);
+    std::vector<uint32_t> assigned;
+    for (const Pair& pair : pairs) {
+        if (assignment[pair.detection] == UNASSOCIATED && !objectUsed[pair.object]) {
+            assignment[pair.detection] = pair.object;
+            objectUsed[pair.object] = true;
+            assigned.push_back(pair.detection);
+        }
+    }
+
+    // Each object appears once, so the updates are independent
+    std::vector<uint8_t> updated(assigned.size(), 0);
+    forEach(pool, assigned.size(), [&](size_t index) {
+        uint32_t d = assigned[index];
+        uint32_t id = assignment[d];
+        const RadarDetection& detection = detections[d];
+        DetectionCandidates& result = candidates[d];
+
+        MeasurementSet measurements = detectionMeasurements(detection, geometries);
+        // Lost its best candidate to a closer detection: predict the one it got. A
+        // prediction that fails leaves the object as it was and the detection unassociated.
+        if (result.bestObject != id) {
+            double state[STATE_SIZE], covariance[STATE_SIZE][STATE_SIZE];
+            loadState(id, state, covariance);
+            if (!predict(m_settings, state, covariance, detection.time - m_epoch[id], result.prediction) ||
+                !computeInnovation(m_settings, result.prediction, measurements, result.innovation)) {
+                assignment[d] = UNASSOCIATED;
+                return;
+            }
+        }
+        applyUpdate(result.prediction, result.innovation, measurements.count);
+        storeState(id, result.prediction.state, result.prediction.covariance, detection.time);
+        updated[index] = 1;
+    });
+
+    if (objectIds != nullptr) {
+        std::copy(assignment.begin(), assignment.end(), objectIds);
+    }
+    size_t updateCount = static_cast<size_t>(std::count(updated.begin(), updated.end(), 1));
+    m_updateCount += updateCount;
+    return updateCount;
+}
+
+void ObjectTracker::update(const Observation* observations, size_t count, const SiteGeometry* geometries,
+                           ThreadPool* pool) {
+    for (size_t index = 0; index < count; index++) {
+        if (observations[index].objectId >= getCount()) {
+            throw std::runtime_error("Failed to update tracker: unknown object ID!");
+        }
+    }
+
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [observations](uint32_t a, uint32_t b) {
+        const Observation& first = observations[a];
+        const Observation& second = observations[b];
+        return (first.objectId != second.objectId) ? first.objectId < second.objectId : first.time < second.time;
+    });
+
+    // Runs of one object, and the number of distinct times across them
+    std::vector<size_t> runs;
+    size_t updates = 0;
+    for (size_t index = 0; index < count; index++) {
+        const Observation& observation = observations[order[index]];
+        if (index == 0 || observation.objectId != observations[order[index - 1]].objectId) {
+            runs.push_back(index);
+            updates++;
+        } else if (observation.time != observations[order[index - 1]].time) {
+            updates++;
+        }
+    }
+    runs.push_back(count);
+
+    forEach(pool, runs.size() - 1, [&](size_t run) {
+        uint32_t id = observations[order[runs[run]]].objectId;
+        double state[STATE_SIZE], covariance[STATE_SIZE][STATE_SIZE];
+        loadState(id, state, covariance);
+        double epoch = m_epoch[id];
+
+        size_t index = runs[run];
+        while (index < runs[run + 1]) {
+            // Measurements sharing a time, up to MAX_MEASUREMENTS at once
+            MeasurementSet measurements;
+            measurements.count = 0;
+            double time = observations[order[index]].time;
+            while (index < runs[run + 1] && measurements.count < MAX_MEASUREMENTS &&
+                   observations[order[index]].time == time) {
+                const Observation& observation = observations[order[index]];
+                measurements.type[measurements.count] = observation.type;
+                measurements.value[measurements.count] = observation.value;
+                measurements.sigma[measurements.count] = observation.sigma;
+                measurements.site[measurements.count] = &geometries[observation.geometry];
+                measurements.count++;
+                index++;
+            }
+
+            Prediction prediction;
+            Innovation innovation;
+            if (!predict(m_settings, state, covariance, time - epoch, prediction) ||
+                !computeInnovation(m_settings, prediction, measurements, innovation)) {
+                continue;
+            }
+            applyUpdate(prediction, innovation, measurements.count);
+            std::copy(prediction.state, prediction.state + STATE_SIZE, state);
+            std::copy(&prediction.covariance[0][0], &prediction.covariance[0][0] + STATE_SIZE * STATE_SIZE,
+                      &covariance[0][0]);
+            epoch = time;
+        }
+        storeState(id, state, covariance, epoch);
+    });
+
+    m_updateCount += updates;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "orbit/observations.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Sequential estimator an ObjectTracker runs for every object.
+ */
+enum class TrackingFilter : uint32_t {
+    Extended,   // linearized: covariance through the state transition matrix
+    Unscented   // 13 sigma points through the full dynamics
+};
+
+/**
+ * Settings of an ObjectTracker.
+ */
+struct TrackerSettings {
+    TrackingFilter filter = TrackingFilter::Extended;
+
+    // Dynamics: two-body gravity plus the J2 zonal term, EGM2008 values
+    double mu = 3.986004415e14;
+    double earthRadius = 6378136.3;
+    double j2 = 1.0826267e-3;
+
+    // Longest RK4 step when predicting, seconds
+    double maxStep = 20.0;
+
+    // Spectral density of the white acceleration noise that covers unmodeled forces,
+    // m^2/s^3
+    double processNoise = 1e-9;
+
+    // Detections farther than this from an object's predicted position are not
+    // considered for it, meters
+    double gateRadius = 50e3;
+
+    // Largest normalized innovation squared (chi-square, 3 degrees of freedom) of an
+    // accepted detection; 16.27 rejects 0.1% of correct detections
+    double gateThreshold = 16.27;
+};
+
+/**
+ * One radar detection of an unknown object: range, azimuth and elevation measured
+ * together.
+ */
+struct RadarDetection {
+    double time;            // seconds since the tracker epoch
+    double range;           // meters
+    double azimuth;         // radians
+    double elevation;       // radians
+    double rangeSigma;      // meters
+    double angleSigma;      // radians
+    uint32_t geometry;      // row in the SiteGeometry table
+};
+
+/**
+ * Propagates a GCRF state under the tracker's dynamics with RK4 steps of at most
+ * settings.maxStep.
+ *
+ * @param settings Dynamics and step size
+ * @param state Position and velocity, meters and m/s, updated in place
+ * @param dt Seconds to propagate; may be negative
+ */
+void propagateTrackedState(const TrackerSettings& settings, double state[6], double dt);
+
+/**
+ * Sequential state estimation for many objects as measurements arrive.
+ *
+ * Each object's GCRF position and velocity and their covariance are kept in
+ * structure-of-arrays form (6 state arrays and the 21 upper-triangle covariance arrays)
+ * at the epoch of the object's last update. Prediction is lazy: an object is propagated
+ * only when a measurement of it is processed.
+ *
+ * Measurements are processed one sensor batch at a time, in time order. Within a batch,
+ * objects are independent and are updated in parallel across the pool.
+ */
+class ObjectTracker {
+public:
+    /**
+     * @param settings Filter, dynamics and association settings
+     */
+    explicit ObjectTracker(const TrackerSettings& settings = {});
+
+    /**
+     * Starts tracking an object.
+     *
+     * @param state Position and velocity at the epoch, meters and m/s
+     * @param covariance Covariance of the state
+     * @param epoch Seconds since the tracker epoch
+     * @return ID of the object, its index in insertion order
+     */
+    uint32_t addObject(const double state[6], const double covariance[6][6], double epoch);
+
+    /**
+     * Associates one sensor's detections with tracked objects and updates each
+     * associated object.
+     *
+     * Predicted positions of all objects at the middle of the batch are indexed in a
+     * uniform grid of cells at least gateRadius wide, so each detection is compared
+     * only with the objects in its 27 neighbouring cells. Candidates within the gate
+     * radius are predicted to the detection time by the filter and kept if their
+     * normalized innovation squared passes the chi-square gate. Pairs are then assigned
+     * greedily, best first, so each object and each detection is used at most once.
+     *
+     * @param detections Detections of one sensor, times within a few seconds
+     * @param count Number of detections
+     * @param geometries Site geometry table the detections refer to
+     * @param objectIds Output ID each detection was associated with, or UINT32_MAX
+     *                  for detections of no tracked object; may be nullptr
+     * @param pool Threads to spread the work over, or nullptr
+     * @return Number of associated detections
+     */
+    size_t processDetections(const RadarDetection* detections, size_t count, const SiteGeometry* geometries,
+                             uint32_t* objectIds, ThreadPool* pool = nullptr);
+
+    /**
+     * Updates objects with measurements already tagged with their object, e.g. tasked
+     * optical observations. Measurements of one object are processed in time order;
+     * those sharing a time are processed together.
+     *
+     * @param observations Measurements of one sensor; objectId selects the object
+     * @param count Number of measurements
+     * @param geometries Site geometry table the measurements refer to
+     * @param pool Threads to spread objects over, or nullptr
+     */
+    void update(const Observation* observations, size_t count, const SiteGeometry* geometries,
+                ThreadPool* pool = nullptr);
+
+    /**
+     * Gets an object's state at its epoch.
+     *
+     * @param id Object ID
+     * @param state Output position and velocity
+     */
+    void getState(uint32_t id, double state[6]) const;
+
+    /**
+     * Gets an object's covariance at its epoch.
+     *
+     * @param id Object ID
+     * @param covariance Output covariance
+     */
+    void getCovariance(uint32_t id, double covariance[6][6]) const;
+
+    double getEpoch(uint32_t id) const { return m_epoch[id]; }
+
+    /**
+     * Gets the number of measurement updates applied since construction; measurements
+     * of one object at one time, such as a radar detection, count as one.
+     *
+     * @return Number of updates
+     */
+    size_t getUpdateCount() const { return m_updateCount; }
+
+    size_t getCount() const { return m_epoch.size(); }
+    const TrackerSettings& getSettings() const { return m_settings; }
+
+private:
+    /**
+     * Advances the cached association state of every object to a time and rebuilds the
+     * grid over the predicted positions.
+     *
+     * @param time Seconds since the tracker epoch
+     * @param cellSize Cell edge, meters
+     * @param pool Threads to spread objects over, or nullptr
+     */
+    void buildGrid(double time, double cellSize, ThreadPool* pool);
+
+    void loadState(uint32_t id, double state[6], double covariance[6][6]) const;
+    void storeState(uint32_t id, const double state[6], const double covariance[6][6], double epoch);
+
+    TrackerSettings m_settings;
+
+    // Filter state at each object's epoch
+    std::array<std::vector<double>, 6> m_state;
+    std::array<std::vector<double>, 21> m_covariance;
+    std::vector<double> m_epoch;
+
+    // Mean state carried forward for association, so each batch advances objects only
+    // by the time since the previous batch
+    std::array<std::vector<double>, 6> m_gridState;
+    std::vector<double> m_gridEpoch;
+
+    // Grid cells as (cell key, object ID), sorted by key
+    std::vector<std::pair<uint64_t, uint32_t>> m_cells;
+    double m_cellSize;
+
+    size_t m_updateCount;
+};
@@ -0,0 +1,380 @@
+#include "orbit/observation_generator.h"
+#include "orbit/force_models.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double TWO_PI = 2.0 * PI;
+constexpr double SECONDS_PER_DAY = 86400.0;
+
+// WGS84 ellipsoid
+constexpr double WGS84_RADIUS = 6378137.0;
+constexpr double WGS84_FLATTENING = 1.0 / 298.257223563;
+
+// Objects per position task
+constexpr size_t OBJECT_CHUNK = 1024;
+
+// Bytes the writer collects before writing them out
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+/**
+ * Solves Kepler's equation to double precision.
+ */
+double solveKepler(double meanAnomaly, double eccentricity) {
+    double M = meanAnomaly - TWO_PI * std::floor(meanAnomaly / TWO_PI);
+    double E = (eccentricity < 0.8) ? M + eccentricity * std::sin(M) : PI;
+    for (int iteration = 0; iteration < 20; iteration++) {
+        double correction = (E - eccentricity * std::sin(E) - M) / (1.0 - eccentricity * std::cos(E));
+        E -= correction;
+        if (std::abs(correction) < 1e-13) {
+            break;
+        }
+    }
+    return E;
+}
+
+void rotate(const RotationMatrix& rotation, const double* in, double out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = rotation.m[i][0] * in[0] + rotation.m[i][1] * in[1] + rotation.m[i][2] * in[2];
+    }
+}
+
+/**
+ * Seeds the noise stream of one look from the generator seed, the sensor and the look
+ * number (splitmix64 finalizer).
+ */
+uint64_t lookSeed(uint64_t seed, uint32_t sensor, int64_t look) {
+    uint64_t x = seed + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(sensor) + 1) +
+                 0xBF58476D1CE4E5B9ull * static_cast<uint64_t>(look);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+double wrapAngle(double angle) {
+    return angle - TWO_PI * std::floor(angle / TWO_PI);
+}
+
+} // namespace
+
+ObservationGenerator::ObservationGenerator(const std::vector<SensorSite>& sensors,
+                                           const ObservationGeneratorSettings& settings)
+    : m_sensors(sensors),
+      m_settings(settings),
+      m_observationCount(0) {
+    prepareSensors();
+}
+
+void ObservationGenerator::prepareSensors() {
+    m_sensorFrames.resize(m_sensors.size());
+    double eccentricity2 = WGS84_FLATTENING * (2.0 - WGS84_FLATTENING);
+    for (size_t s = 0; s < m_sensors.size(); s++) {
+        const SensorSite& sensor = m_sensors[s];
+        double sinLat = std::sin(sensor.latitude), cosLat = std::cos(sensor.latitude);
+        double sinLon = std::sin(sensor.longitude), cosLon = std::cos(sensor.longitude);
+        double normal = WGS84_RADIUS / std::sqrt(1.0 - eccentricity2 * sinLat * sinLat);
+
+        std::array<double, 15>& frame = m_sensorFrames[s];
+        frame[0] = (normal + sensor.altitude) * cosLat * cosLon;
+        frame[1] = (normal + sensor.altitude) * cosLat * sinLon;
+        frame[2] = (normal * (1.0 - eccentricity2) + sensor.altitude) * sinLat;
+
+        const double east[3] = {-sinLon, cosLon, 0.0};
+        const double north[3] = {-sinLat * cosLon, -sinLat * sinLon, cosLat};
+        const double up[3] = {cosLat * cosLon, cosLat * sinLon, sinLat};
+        double boresightEast = std::cos(sensor.boresightElevation) * std::sin(sensor.boresightAzimuth);
+        double boresightNorth = std::cos(sensor.boresightElevation) * std::cos(sensor.boresightAzimuth);
+        double boresightUp = std::sin(sensor.boresightElevation);
+        for (int k = 0; k < 3; k++) {
+            frame[3 + k] = east[k];
+            frame[6 + k] = north[k];
+            frame[9 + k] = up[k];
+            frame[12 + k] = boresightEast * east[k] + boresightNorth * north[k] + boresightUp * up[k];
+        }
+    }
+}
+
+void ObservationGenerator::setObjects(const KeplerianElements* elements, size_t count) {
+    for (int k = 0; k < 3; k++) {
+        m_periapsis[k].resize(count);
+        m_normal[k].resize(count);
+    }
+    m_semimajorAxis.resize(count);
+    m_semiminorAxis.resize(count);
+    m_eccentricity.resize(count);
+    m_meanMotion.resize(count);
+    m_meanAnomaly.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const KeplerianElements& orbit = elements[i];
+        if (!(orbit.eccentricity >= 0.0 && orbit.eccentricity < 1.0 && orbit.semimajorAxis > 0.0)) {
+            throw std::runtime_error("Failed to set observed objects: orbits must be elliptic!");
+        }
+        double sinI = std::sin(orbit.inclination), cosI = std::cos(orbit.inclination);
+        double sinW = std::sin(orbit.argumentOfPeriapsis), cosW = std::cos(orbit.argumentOfPeriapsis);
+        double sinO = std::sin(orbit.longitudeOfAscendingNode), cosO = std::cos(orbit.longitudeOfAscendingNode);
+        m_periapsis[0][i] = cosO * cosW - sinO * sinW * cosI;
+        m_periapsis[1][i] = sinO * cosW + cosO * sinW * cosI;
+        m_periapsis[2][i] = sinW * sinI;
+        m_normal[0][i] = -cosO * sinW - sinO * cosW * cosI;
+        m_normal[1][i] = -sinO * sinW + cosO * cosW * cosI;
+        m_normal[2][i] = cosW * sinI;
+
+        double a = orbit.semimajorAxis;
+        m_semimajorAxis[i] = a;
+        m_semiminorAxis[i] = a * std::sqrt(1.0 - orbit.eccentricity * orbit.eccentricity);
+        m_eccentricity[i] = orbit.eccentricity;
+        m_meanMotion[i] = std::sqrt(m_settings.mu / (a * a * a));
+        m_meanAnomaly[i] = orbit.meanAnomaly;
+    }
+}
+
+void ObservationGenerator::prepareWindow(double startTime, double endTime, ThreadPool* pool) {
+    m_looks.clear();
+    m_lookTimes.clear();
+
+    // Looks of each sensor in time order; sensors stay contiguous for the merge
+    for (uint32_t s = 0; s < m_sensors.size(); s++) {
+        const SensorSite& sensor = m_sensors[s];
+        const std::array<double, 15>& frame = m_sensorFrames[s];
+        int64_t look = static_cast<int64_t>(std::ceil((startTime - sensor.timeOffset) / sensor.cadence));
+        for (;; look++) {
+            double time = sensor.timeOffset + static_cast<double>(look) * sensor.cadence;
+            if (time >= endTime) {
+                break;
+            }
+            if (time < startTime) {
+                continue;
+            }
+
+            double ttDays = m_settings.epochTtDays + time / SECONDS_PER_DAY;
+            double ut1Days = ttDays + m_settings.ut1MinusTt / SECONDS_PER_DAY;
+            const RotationMatrix& rotation = m_frames.getRotation(CoordinateFrame::Itrf, CoordinateFrame::Gcrf,
+                                                                  ttDays, ut1Days);
+            SiteGeometry geometry;
+            rotate(rotation, &frame[0], geometry.position);
+            rotate(rotation, &frame[3], geometry.east);
+            rotate(rotation, &frame[6], geometry.north);
+            rotate(rotation, &frame[9], geometry.up);
+
+            Look entry;
+            entry.time = time;
+            entry.sensor = s;
+            entry.index = look;
+            rotate(rotation, &frame[12], entry.boresight);
+
+            // Optical sensors need the Sun below the horizon, and for sunlit targets
+            if (sensor.type == SensorType::Optical) {
+                SolarSystemBodies bodies = computeSolarSystemBodies(ttDays);
+                std::copy(bodies.sun, bodies.sun + 3, entry.sun);
+                double sunDistance = std::sqrt(bodies.sun[0] * bodies.sun[0] + bodies.sun[1] * bodies.sun[1] +
+                                               bodies.sun[2] * bodies.sun[2]);
+                double sunUp = (bodies.sun[0] * geometry.up[0] + bodies.sun[1] * geometry.up[1] +
+                                bodies.sun[2] * geometry.up[2]) / sunDistance;
+                if (sunUp > std::sin(m_settings.maxSunElevation)) {
+                    continue;
+                }
+            }
+
+            entry.geometry = static_cast<uint32_t>(m_geometries.size());
+            m_geometries.push_back(geometry);
+            m_geometrySensors.push_back(s);
+            m_looks.push_back(entry);
+            m_lookTimes.push_back(time);
+        }
+    }
+
+    std::sort(m_lookTimes.begin(), m_lookTimes.end());
+    m_lookTimes.erase(std::unique(m_lookTimes.begin(), m_lookTimes.end()), m_lookTimes.end());
+    for (Look& look : m_looks) {
+        look.timeIndex = static_cast<uint32_t>(
+            std::lower_bound(m_lookTimes.begin(), m_lookTimes.end(), look.time) - m_lookTimes.begin());
+    }
+
+    // Positions of every object at every distinct look time
+    size_t objectCount = m_semimajorAxis.size();
+    size_t chunkCount = (objectCount + OBJECT_CHUNK - 1) / OBJECT_CHUNK;
+    for (int k = 0; k < 3; k++) {
+        m_positions[k].resize(m_lookTimes.size() * objectCount);
+    }
+    auto computePositions = [&](size_t task, size_t) {
+        size_t timeIndex = task / chunkCount;
+        size_t begin = (task % chunkCount) * OBJECT_CHUNK;
+        size_t end = std::min(begin + OBJECT_CHUNK, objectCount);
+        double time = m_lookTimes[timeIndex];
+        double* x = m_positions[0].data() + timeIndex * objectCount;
+        double* y = m_positions[1].data() + timeIndex * objectCount;
+        double* z = m_positions[2].data() + timeIndex * objectCount;
+        for (size_t i = begin; i < end; i++) {
+            double E = solveKepler(m_meanAnomaly[i] + m_meanMotion[i] * time, m_eccentricity[i]);
+            double planeX = m_semimajorAxis[i] * (std::cos(E) - m_eccentricity[i]);
+            double planeY = m_semiminorAxis[i] * std::sin(E);
+            x[i] = planeX * m_periapsis[0][i] + planeY * m_normal[0][i];
+            y[i] = planeX * m_periapsis[1][i] + planeY * m_normal[1][i];
+            z[i] = planeX * m_periapsis[2][i] + planeY * m_normal[2][i];
+        }
+    };
+    size_t taskCount = m_lookTimes.size() * chunkCount;
+    if (pool != nullptr) {
+        pool->parallelFor(taskCount, computePositions);
+    } else {
+        for (size_t task = 0; task < taskCount; task++) {
+            computePositions(task, 0);
+        }
+    }
+}
+
+void ObservationGenerator::observe(size_t lookIndex, std::vector<uint32_t>& visible) {
+    const Look& look = m_looks[lookIndex];
+    const SensorSite& sensor = m_sensors[look.sensor];
+    const SiteGeometry& site = m_geometries[look.geometry];
+    std::vector<Observation>& observations = m_lookObservations[lookIndex];
+    observations.clear();
+
+    size_t objectCount = m_semimajorAxis.size();
+    const double* x = m_positions[0].data() + look.timeIndex * objectCount;
+    const double* y = m_positions[1].data() + look.timeIndex * objectCount;
+    const double* z = m_positions[2].data() + look.timeIndex * objectCount;
+
+    // One branch-free pass over the catalog: range, elevation mask and field of view
+    visible.resize(objectCount);
+    double maxRange2 = sensor.maxRange * sensor.maxRange;
+    double sinMinElevation = std::sin(sensor.minElevation);
+    double cosFieldOfView = std::cos(sensor.fieldOfView);
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < objectCount; i++) {
+        double dx = x[i] - site.position[0];
+        double dy = y[i] - site.position[1];
+        double dz = z[i] - site.position[2];
+        double range2 = dx * dx + dy * dy + dz * dz;
+        double range = std::sqrt(range2);
+        double up = dx * site.up[0] + dy * site.up[1] + dz * site.up[2];
+        double along = dx * look.boresight[0] + dy * look.boresight[1] + dz * look.boresight[2];
+        bool seen = (range2 <= maxRange2) & (up >= sinMinElevation * range) & (along >= cosFieldOfView * range);
+        visible[visibleCount] = static_cast<uint32_t>(i);
+        visibleCount += seen ? 1 : 0;
+    }
+
+    std::mt19937_64 rng(lookSeed(m_settings.seed, look.sensor, look.index));
+    std::normal_distribution<double> noise;
+    auto emit = [&](uint32_t object, const double position[3], MeasurementType type, double sigma) {
+        double value = predictMeasurement(type, site, position, nullptr) + sigma * noise(rng);
+        if (type == MeasurementType::Azimuth || type == MeasurementType::RightAscension) {
+            value = wrapAngle(value);
+        }
+        observations.push_back({look.time, value, sigma, object, look.geometry, type});
+    };
+
+    for (size_t v = 0; v < visibleCount; v++) {
+        uint32_t object = visible[v];
+        const double position[3] = {x[object], y[object], z[object]};
+        if (sensor.type == SensorType::Radar) {
+            emit(object, position, MeasurementType::Range, sensor.rangeSigma);
+            emit(object, position, MeasurementType::Azimuth, sensor.angleSigma);
+            emit(object, position, MeasurementType::Elevation, sensor.angleSigma);
+        } else if (shadowFraction(position, look.sun) > 0.0) {
+            emit(object, position, MeasurementType::RightAscension, sensor.angleSigma);
+            emit(object, position, MeasurementType::Declination, sensor.angleSigma);
+        }
+    }
+}
+
+void ObservationGenerator::merge() {
+    m_merged.clear();
+
+    // Cursor per sensor over its contiguous run of looks
+    struct Cursor {
+        size_t look;
+        size_t end;
+    };
+    std::vector<Cursor> cursors;
+    for (size_t begin = 0; begin < m_looks.size();) {
+        size_t end = begin;
+        while (end < m_looks.size() && m_looks[end].sensor == m_looks[begin].sensor) {
+            end++;
+        }
+        cursors.push_back({begin, end});
+        begin = end;
+    }
+
+    // Earliest look first; at equal times the lower sensor index
+    auto later = [&](size_t a, size_t b) {
+        const Look& first = m_looks[cursors[a].look];
+        const Look& second = m_looks[cursors[b].look];
+        return (first.time != second.time) ? first.time > second.time : first.sensor > second.sensor;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t c = 0; c < cursors.size(); c++) {
+        heap.push(c);
+    }
+    while (!heap.empty()) {
+        size_t c = heap.top();
+        heap.pop();
+        const std::vector<Observation>& observations = m_lookObservations[cursors[c].look];
+        m_merged.insert(m_merged.end(), observations.begin(), observations.end());
+        if (++cursors[c].look < cursors[c].end) {
+            heap.push(c);
+        }
+    }
+}
+
+void ObservationGenerator::generate(double startTime, double endTime, const Output& output, ThreadPool* pool) {
+    size_t threadCount = (pool != nullptr) ? pool->getThreadCount() : 1;
+    std::vector<std::vector<uint32_t>> visible(threadCount);
+
+    for (double windowStart = startTime; windowStart < endTime; windowStart += m_settings.windowSeconds) {
+        double windowEnd = std::min(windowStart + m_settings.windowSeconds, endTime);
+        prepareWindow(windowStart, windowEnd, pool);
+
+        m_lookObservations.resize(m_looks.size());
+        if (pool != nullptr) {
+            pool->parallelFor(m_looks.size(), [&](size_t look, size_t worker) { observe(look, visible[worker]); });
+        } else {
+            for (size_t look = 0; look < m_looks.size(); look++) {
+                observe(look, visible[0]);
+            }
+        }
+
+        merge();
+        m_observationCount += m_merged.size();
+        output(m_merged.data(), m_merged.size());
+    }
+}
+
+ObservationWriter::ObservationWriter(const std::string& path)
+    : m_file(path, std::ios::binary),
+      m_path(path) {
+    if (!m_file) {
+        throw std::runtime_error("Failed to open observation file: " + path);
+    }
+    static const char HEADER[] = "time,object,sensor,measurement,value,sigma\n";
+    m_file.write(HEADER, sizeof(HEADER) - 1);
+    m_buffer.reserve(WRITE_BUFFER_SIZE + 256);
+}
+
+void ObservationWriter::write(const Observation* observations, size_t count, const ObservationGenerator& generator) {
+    char line[256];
+    for (size_t i = 0; i < count; i++) {
+        const Observation& observation = observations[i];
+        int length = std::snprintf(line, sizeof(line), "%.3f,%u,%u,%s,%.12g,%.6g\n", observation.time,
+                                   observation.objectId, generator.getGeometrySensor(observation.geometry),
+                                   measurementTypeName(observation.type), observation.value, observation.sigma);
+        m_buffer.insert(m_buffer.end(), line, line + length);
+        if (m_buffer.size() >= WRITE_BUFFER_SIZE) {
+            m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
+        }
+    }
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+    if (!m_file) {
+        throw std::runtime_error("Failed to write observation file: " + m_path);
+    }
+}
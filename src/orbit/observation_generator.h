@@ -0,0 +1,231 @@
+#pragma once
+
+#include "orbit/observations.h"
+#include "orbit/orbit_determination.h"
+#include "orbit/reference_frames.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * What a ground sensor measures.
+ */
+enum class SensorType : uint32_t {
+    Radar,      // range, azimuth and elevation
+    Optical     // right ascension and declination, at night, of sunlit objects
+};
+
+/**
+ * A ground sensor: where it is, where it looks, how often and how precisely.
+ */
+struct SensorSite {
+    SensorType type = SensorType::Radar;
+
+    // Geodetic position on the WGS84 ellipsoid, radians and meters
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double altitude = 0.0;
+
+    // Field of view: a cone around the boresight; a half angle of pi sees the whole sky
+    // above the elevation mask
+    double boresightAzimuth = 0.0;
+    double boresightElevation = 1.5707963267948966;
+    double fieldOfView = 3.141592653589793;
+
+    double minElevation = 0.17453292519943295;  // radians
+    double maxRange = 3000e3;                   // meters
+
+    // Looks happen at timeOffset + k cadence seconds
+    double cadence = 10.0;
+    double timeOffset = 0.0;
+
+    // Measurement noise, one standard deviation
+    double rangeSigma = 20.0;                   // meters
+    double angleSigma = 3.4906585039886593e-4;  // radians
+};
+
+/**
+ * Settings of an ObservationGenerator.
+ */
+struct ObservationGeneratorSettings {
+    // TT days since J2000.0 of observation time zero, the reference epoch of the orbits
+    double epochTtDays = 0.0;
+
+    // UT1 - TT in seconds, for the site rotation
+    double ut1MinusTt = -69.2;
+
+    double mu = 3.986004415e14;
+
+    // Highest Sun elevation at which optical sensors observe, radians (nautical twilight)
+    double maxSunElevation = -0.20943951023931953;
+
+    // Time span generated, merged and passed to the output at once, seconds
+    double windowSeconds = 300.0;
+
+    // Noise seed; each look draws from its own stream, so output does not depend on
+    // the thread count
+    uint64_t seed = 1;
+};
+
+/**
+ * Generates time-ordered synthetic observations of a catalog from a set of ground
+ * sensors, for testing tracking and orbit determination.
+ *
+ * Objects follow two-body orbits from their elements. Time is cut into windows; in each,
+ * the positions of every object are computed once per distinct look time, each look
+ * checks visibility of the whole catalog in one pass over the position arrays (range,
+ * elevation mask, field of view, then sunlight for optical sensors), and noisy
+ * measurements of the visible objects are drawn. Looks run in parallel. The per-sensor
+ * streams, each in time order, are then merged through a heap into one stream that is
+ * passed to the output window by window, so memory stays bounded however long the run.
+ */
+class ObservationGenerator {
+public:
+    /**
+     * Receives merged observations in time order, one window at a time. Observations
+     * sharing a time are ordered by sensor, object and measurement.
+     */
+    using Output = std::function<void(const Observation* observations, size_t count)>;
+
+    /**
+     * @param sensors Ground sensors
+     * @param settings Epoch, dynamics and noise settings
+     */
+    ObservationGenerator(const std::vector<SensorSite>& sensors, const ObservationGeneratorSettings& settings);
+
+    /**
+     * Sets the catalog observed.
+     *
+     * @param elements Elements of each object at observation time zero; object IDs are
+     *                 indices into this array
+     * @param count Number of objects
+     */
+    void setObjects(const KeplerianElements* elements, size_t count);
+
+    /**
+     * Generates the observations of a time span. Successive calls may continue where
+     * the last one ended; geometry rows accumulate across calls.
+     *
+     * @param startTime Seconds since the epoch
+     * @param endTime Seconds since the epoch, exclusive
+     * @param output Receives the merged stream
+     * @param pool Threads to spread looks and objects over, or nullptr
+     */
+    void generate(double startTime, double endTime, const Output& output, ThreadPool* pool = nullptr);
+
+    /**
+     * Gets the site geometry table the generated observations refer to, one row per
+     * look.
+     *
+     * @return Geometry rows
+     */
+    const std::vector<SiteGeometry>& getGeometries() const { return m_geometries; }
+
+    /**
+     * Gets the sensor that made a look.
+     *
+     * @param geometry Geometry row of the look
+     * @return Index into the sensors
+     */
+    uint32_t getGeometrySensor(uint32_t geometry) const { return m_geometrySensors[geometry]; }
+
+    uint64_t getObservationCount() const { return m_observationCount; }
+    size_t getSensorCount() const { return m_sensors.size(); }
+
+private:
+    struct Look {
+        double time;
+        uint32_t sensor;
+        uint32_t geometry;
+        uint32_t timeIndex;     // row in the window's position arrays
+        int64_t index;          // look number of the sensor, seeds its noise
+        double boresight[3];    // GCRF
+        double sun[3];          // GCRF, for optical sensors
+    };
+
+    /**
+     * Computes each sensor's terrestrial position and local axes.
+     */
+    void prepareSensors();
+
+    /**
+     * Finds the looks of a window, appends their geometry rows and computes the object
+     * positions at each distinct look time.
+     */
+    void prepareWindow(double startTime, double endTime, ThreadPool* pool);
+
+    /**
+     * Draws the observations of one look.
+     *
+     * @param lookIndex Look in the window
+     * @param visible Scratch for the indices of visible objects
+     */
+    void observe(size_t lookIndex, std::vector<uint32_t>& visible);
+
+    /**
+     * Merges the per-look observations of the window, each sensor's looks already in
+     * time order, into m_merged.
+     */
+    void merge();
+
+    std::vector<SensorSite> m_sensors;
+    ObservationGeneratorSettings m_settings;
+    FrameRotationCache m_frames;
+
+    // Per sensor: ITRF position, east/north/up axes and boresight
+    std::vector<std::array<double, 15>> m_sensorFrames;
+
+    // Per object: constants of the two-body orbit, structure of arrays
+    std::vector<double> m_periapsis[3];
+    std::vector<double> m_normal[3];       // in-plane, 90 degrees ahead of periapsis
+    std::vector<double> m_semimajorAxis;
+    std::vector<double> m_semiminorAxis;
+    std::vector<double> m_eccentricity;
+    std::vector<double> m_meanMotion;
+    std::vector<double> m_meanAnomaly;
+
+    // Window state
+    std::vector<Look> m_looks;
+    std::vector<double> m_lookTimes;       // distinct look times
+    std::vector<double> m_positions[3];    // object positions per distinct time
+    std::vector<std::vector<Observation>> m_lookObservations;
+    std::vector<Observation> m_merged;
+
+    std::vector<SiteGeometry> m_geometries;
+    std::vector<uint32_t> m_geometrySensors;
+    uint64_t m_observationCount;
+};
+
+/**
+ * Writes generated observations to a CSV file, one line per observation:
+ * time,object,sensor,measurement,value,sigma.
+ */
+class ObservationWriter {
+public:
+    /**
+     * Opens the file and writes the header line.
+     *
+     * @param path File path
+     */
+    explicit ObservationWriter(const std::string& path);
+
+    /**
+     * Appends observations.
+     *
+     * @param observations Observations, e.g. one window of ObservationGenerator output
+     * @param count Number of observations
+     * @param generator Generator whose geometry rows the observations refer to
+     */
+    void write(const Observation* observations, size_t count, const ObservationGenerator& generator);
+
+private:
+    std::ofstream m_file;
+    std::string m_path;
+    std::vector<char> m_buffer;
+};
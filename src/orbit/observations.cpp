@@ -0,0 +1,106 @@
+#include "orbit/observations.h"
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+double dot(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+} // namespace
+
+double predictMeasurement(MeasurementType type, const SiteGeometry& site, const double position[3],
+                          double gradient[3]) {
+    const double lineOfSight[3] = {
+        position[0] - site.position[0],
+        position[1] - site.position[1],
+        position[2] - site.position[2],
+    };
+    double range2 = dot(lineOfSight, lineOfSight);
+    double range = std::sqrt(range2);
+    double value = 0.0;
+    double g[3] = {0.0, 0.0, 0.0};
+
+    switch (type) {
+        case MeasurementType::Range:
+            value = range;
+            for (int k = 0; k < 3; k++) {
+                g[k] = lineOfSight[k] / range;
+            }
+            break;
+
+        case MeasurementType::Azimuth:
+        case MeasurementType::Elevation: {
+            double e = dot(lineOfSight, site.east);
+            double n = dot(lineOfSight, site.north);
+            double u = dot(lineOfSight, site.up);
+            double horizontal2 = e * e + n * n;
+            double horizontal = std::sqrt(horizontal2);
+            if (type == MeasurementType::Azimuth) {
+                value = std::atan2(e, n);
+                if (value < 0.0) {
+                    value += 2.0 * PI;
+                }
+                for (int k = 0; k < 3; k++) {
+                    g[k] = (n * site.east[k] - e * site.north[k]) / horizontal2;
+                }
+            } else {
+                value = std::atan2(u, horizontal);
+                for (int k = 0; k < 3; k++) {
+                    double horizontalGradient = (e * site.east[k] + n * site.north[k]) / horizontal;
+                    g[k] = (horizontal * site.up[k] - u * horizontalGradient) / range2;
+                }
+            }
+            break;
+        }
+
+        case MeasurementType::RightAscension: {
+            double xy2 = lineOfSight[0] * lineOfSight[0] + lineOfSight[1] * lineOfSight[1];
+            value = std::atan2(lineOfSight[1], lineOfSight[0]);
+            if (value < 0.0) {
+                value += 2.0 * PI;
+            }
+            g[0] = -lineOfSight[1] / xy2;
+            g[1] = lineOfSight[0] / xy2;
+            break;
+        }
+
+        case MeasurementType::Declination: {
+            double xy2 = lineOfSight[0] * lineOfSight[0] + lineOfSight[1] * lineOfSight[1];
+            double xy = std::sqrt(xy2);
+            value = std::atan2(lineOfSight[2], xy);
+            g[0] = -lineOfSight[2] * lineOfSight[0] / (range2 * xy);
+            g[1] = -lineOfSight[2] * lineOfSight[1] / (range2 * xy);
+            g[2] = xy / range2;
+            break;
+        }
+    }
+
+    if (gradient != nullptr) {
+        gradient[0] = g[0];
+        gradient[1] = g[1];
+        gradient[2] = g[2];
+    }
+    return value;
+}
+
+double measurementResidual(MeasurementType type, double measured, double predicted) {
+    double residual = measured - predicted;
+    if (type == MeasurementType::Azimuth || type == MeasurementType::RightAscension) {
+        residual -= 2.0 * PI * std::floor((residual + PI) / (2.0 * PI));
+    }
+    return residual;
+}
+
+const char* measurementTypeName(MeasurementType type) {
+    switch (type) {
+        case MeasurementType::Range:          return "range";
+        case MeasurementType::Azimuth:        return "azimuth";
+        case MeasurementType::Elevation:      return "elevation";
+        case MeasurementType::RightAscension: return "right ascension";
+        case MeasurementType::Declination:    return "declination";
+        default:                              return "unknown";
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Quantities a ground sensor measures. Each observation holds one, so a radar pass
+ * that measures range, azimuth and elevation together is three observations sharing
+ * a time and geometry.
+ */
+enum class MeasurementType : uint32_t {
+    Range,              // distance from the site, meters
+    Azimuth,            // from north through east, radians
+    Elevation,          // above the local horizon, radians
+    RightAscension,     // topocentric, radians
+    Declination         // topocentric, radians
+};
+
+/**
+ * Position and local east/north/up axes of a sensor site at one epoch, in the inertial
+ * frame the orbit is expressed in (GCRF), meters. Observations made by one sensor at
+ * one epoch share a row.
+ */
+struct SiteGeometry {
+    double position[3];
+    double east[3];
+    double north[3];
+    double up[3];
+};
+
+/**
+ * One scalar measurement of one object.
+ */
+struct Observation {
+    double time;                // seconds since the reference epoch of the orbit
+    double value;               // meters or radians
+    double sigma;               // one standard deviation, same unit
+    uint32_t objectId;
+    uint32_t geometry;          // row in the SiteGeometry table
+    MeasurementType type;
+};
+
+/**
+ * Evaluates a measurement of an object and its gradient with respect to the object's
+ * position.
+ *
+ * @param type Measured quantity
+ * @param site Site geometry at the observation epoch
+ * @param position Object position, same frame as the site
+ * @param gradient Output d(measurement) / d(position); may be nullptr
+ * @return Predicted measurement, meters or radians
+ */
+double predictMeasurement(MeasurementType type, const SiteGeometry& site, const double position[3],
+                          double gradient[3]);
+
+/**
+ * Gets a measured value minus a predicted one, with azimuth and right ascension
+ * differences wrapped to [-pi, pi].
+ *
+ * @param type Measured quantity
+ * @param measured Measured value
+ * @param predicted Predicted value
+ * @return Residual
+ */
+double measurementResidual(MeasurementType type, double measured, double predicted);
+
+/**
+ * Gets a display name for a measurement type, e.g. "range".
+ *
+ * @param type Measured quantity
+ * @return Name
+ */
+const char* measurementTypeName(MeasurementType type);
@@ -0,0 +1,450 @@
+#include "orbit/orbit_determination.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double TWO_PI = 2.0 * PI;
+
+// Observations per task when one fit is spread over the pool
+constexpr size_t OBSERVATION_CHUNK = 512;
+
+// Highest eccentricity a fit may step to
+constexpr double MAX_ECCENTRICITY = 0.999;
+
+// Damping beyond which a fit stops trying to improve
+constexpr double MAX_DAMPING = 1e12;
+
+/**
+ * Orientation and shape of an orbit, derived once per set of elements.
+ */
+struct OrbitGeometry {
+    double P[3];        // towards periapsis
+    double Q[3];        // 90 degrees ahead in the orbit plane
+    double W[3];        // orbit normal
+    double node[3];     // towards the ascending node
+    double meanMotion;
+    double semiminorRatio;  // sqrt(1 - e^2)
+};
+
+OrbitGeometry computeGeometry(const KeplerianElements& elements, double mu) {
+    double sinI = std::sin(elements.inclination), cosI = std::cos(elements.inclination);
+    double sinW = std::sin(elements.argumentOfPeriapsis), cosW = std::cos(elements.argumentOfPeriapsis);
+    double sinO = std::sin(elements.longitudeOfAscendingNode), cosO = std::cos(elements.longitudeOfAscendingNode);
+    double a = elements.semimajorAxis;
+
+    OrbitGeometry geometry;
+    geometry.P[0] = cosO * cosW - sinO * sinW * cosI;
+    geometry.P[1] = sinO * cosW + cosO * sinW * cosI;
+    geometry.P[2] = sinW * sinI;
+    geometry.Q[0] = -cosO * sinW - sinO * cosW * cosI;
+    geometry.Q[1] = -sinO * sinW + cosO * cosW * cosI;
+    geometry.Q[2] = cosW * sinI;
+    geometry.W[0] = sinO * sinI;
+    geometry.W[1] = -cosO * sinI;
+    geometry.W[2] = cosI;
+    geometry.node[0] = cosO;
+    geometry.node[1] = sinO;
+    geometry.node[2] = 0.0;
+    geometry.meanMotion = std::sqrt(mu / (a * a * a));
+    geometry.semiminorRatio = std::sqrt(1.0 - elements.eccentricity * elements.eccentricity);
+    return geometry;
+}
+
+/**
+ * Solves Kepler's equation to double precision.
+ */
+double solveKepler(double meanAnomaly, double eccentricity) {
+    double M = meanAnomaly - TWO_PI * std::floor(meanAnomaly / TWO_PI);
+    double E = (eccentricity < 0.8) ? M : PI;
+    for (int iteration = 0; iteration < 30; iteration++) {
+        double correction = (E - eccentricity * std::sin(E) - M) / (1.0 - eccentricity * std::cos(E));
+        E -= correction;
+        if (std::abs(correction) < 1e-15) {
+            break;
+        }
+    }
+    return E;
+}
+
+void cross(const double a[3], const double b[3], double out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+double dot(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/**
+ * Position at a time and its partial derivatives with respect to the elements, in
+ * KeplerianElements order.
+ */
+void positionPartials(const KeplerianElements& elements, const OrbitGeometry& geometry, double time,
+                      double position[3], double partials[6][3]) {
+    double a = elements.semimajorAxis;
+    double e = elements.eccentricity;
+    double E = solveKepler(elements.meanAnomaly + geometry.meanMotion * time, e);
+    double sinE = std::sin(E), cosE = std::cos(E);
+
+    double X = a * (cosE - e);
+    double Y = a * geometry.semiminorRatio * sinE;
+    double dEdM = 1.0 / (1.0 - e * cosE);
+    double dXdE = -a * sinE;
+    double dYdE = a * geometry.semiminorRatio * cosE;
+
+    double alongOrbit[3];
+    for (int k = 0; k < 3; k++) {
+        position[k] = X * geometry.P[k] + Y * geometry.Q[k];
+        alongOrbit[k] = (dXdE * geometry.P[k] + dYdE * geometry.Q[k]) * dEdM;
+    }
+
+    // Semi-major axis: scales the ellipse and slows the mean motion
+    double dMda = -1.5 * geometry.meanMotion / a * time;
+    // Eccentricity: changes the shape at fixed E and moves E at fixed M
+    double dYde = -a * e / geometry.semiminorRatio * sinE;
+    double dEde = sinE * dEdM;
+    for (int k = 0; k < 3; k++) {
+        partials[0][k] = position[k] / a + alongOrbit[k] * dMda;
+        partials[1][k] = -a * geometry.P[k] + dYde * geometry.Q[k] +
+                         (dXdE * geometry.P[k] + dYdE * geometry.Q[k]) * dEde;
+        partials[5][k] = alongOrbit[k];
+    }
+
+    // Angles rotate the position about the line of nodes, the orbit normal and the pole
+    cross(geometry.node, position, partials[2]);
+    cross(geometry.W, position, partials[3]);
+    partials[4][0] = -position[1];
+    partials[4][1] = position[0];
+    partials[4][2] = 0.0;
+}
+
+/**
+ * Weighted cost and normal equations of a set of observations.
+ */
+struct NormalEquations {
+    double matrix[6][6];
+    double rightHandSide[6];
+    double cost;
+
+    void clear() {
+        std::fill(&matrix[0][0], &matrix[0][0] + 36, 0.0);
+        std::fill(rightHandSide, rightHandSide + 6, 0.0);
+        cost = 0.0;
+    }
+
+    void add(const NormalEquations& other) {
+        for (int row = 0; row < 6; row++) {
+            for (int column = 0; column < 6; column++) {
+                matrix[row][column] += other.matrix[row][column];
+            }
+            rightHandSide[row] += other.rightHandSide[row];
+        }
+        cost += other.cost;
+    }
+};
+
+void accumulate(const KeplerianElements& elements, const OrbitGeometry& geometry, const Observation* observations,
+                size_t count, const SiteGeometry* geometries, NormalEquations& equations) {
+    equations.clear();
+    for (size_t i = 0; i < count; i++) {
+        const Observation& observation = observations[i];
+        double position[3], partials[6][3], gradient[3];
+        positionPartials(elements, geometry, observation.time, position, partials);
+        double predicted = predictMeasurement(observation.type, geometries[observation.geometry], position, gradient);
+        double residual = measurementResidual(observation.type, observation.value, predicted);
+        double weight = 1.0 / (observation.sigma * observation.sigma);
+
+        double row[6];
+        for (int k = 0; k < 6; k++) {
+            row[k] = dot(gradient, partials[k]);
+        }
+        for (int r = 0; r < 6; r++) {
+            double weighted = weight * row[r];
+            for (int c = 0; c <= r; c++) {
+                equations.matrix[r][c] += weighted * row[c];
+            }
+            equations.rightHandSide[r] += weighted * residual;
+        }
+        equations.cost += weight * residual * residual;
+    }
+
+    for (int r = 0; r < 6; r++) {
+        for (int c = r + 1; c < 6; c++) {
+            equations.matrix[r][c] = equations.matrix[c][r];
+        }
+    }
+}
+
+/**
+ * Evaluates the normal equations, in chunks across the pool when there are enough
+ * observations. Chunks are summed in order, so the result is the same for any pool.
+ */
+void evaluate(const KeplerianElements& elements, double mu, const Observation* observations, size_t count,
+              const SiteGeometry* geometries, ThreadPool* pool, std::vector<NormalEquations>& chunks,
+              NormalEquations& equations) {
+    OrbitGeometry geometry = computeGeometry(elements, mu);
+    size_t chunkCount = (count + OBSERVATION_CHUNK - 1) / OBSERVATION_CHUNK;
+    chunks.resize(chunkCount);
+
+    auto runChunk = [&](size_t chunk, size_t) {
+        size_t first = chunk * OBSERVATION_CHUNK;
+        size_t chunkSize = std::min(OBSERVATION_CHUNK, count - first);
+        accumulate(elements, geometry, observations + first, chunkSize, geometries, chunks[chunk]);
+    };
+    if (pool != nullptr && chunkCount > 1) {
+        pool->parallelFor(chunkCount, runChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+            runChunk(chunk, 0);
+        }
+    }
+
+    equations.clear();
+    for (const NormalEquations& chunk : chunks) {
+        equations.add(chunk);
+    }
+}
+
+/**
+ * Cholesky factorization of a symmetric positive definite 6x6 matrix in place (lower
+ * triangle).
+ *
+ * @return False if the matrix is not positive definite
+ */
+bool choleskyFactor(double m[6][6]) {
+    for (int j = 0; j < 6; j++) {
+        double diagonal = m[j][j];
+        for (int k = 0; k < j; k++) {
+            diagonal -= m[j][k] * m[j][k];
+        }
+        if (!(diagonal > 0.0)) {
+            return false;
+        }
+        m[j][j] = std::sqrt(diagonal);
+        for (int i = j + 1; i < 6; i++) {
+            double value = m[i][j];
+            for (int k = 0; k < j; k++) {
+                value -= m[i][k] * m[j][k];
+            }
+            m[i][j] = value / m[j][j];
+        }
+    }
+    return true;
+}
+
+void choleskySolve(const double factor[6][6], const double b[6], double x[6]) {
+    double y[6];
+    for (int i = 0; i < 6; i++) {
+        double value = b[i];
+        for (int k = 0; k < i; k++) {
+            value -= factor[i][k] * y[k];
+        }
+        y[i] = value / factor[i][i];
+    }
+    for (int i = 5; i >= 0; i--) {
+        double value = y[i];
+        for (int k = i + 1; k < 6; k++) {
+            value -= factor[k][i] * x[k];
+        }
+        x[i] = value / factor[i][i];
+    }
+}
+
+/**
+ * Applies a correction, keeping the elements in their valid ranges. A negative
+ * eccentricity is the same ellipse with periapsis half a turn away.
+ */
+KeplerianElements applyCorrection(const KeplerianElements& elements, const double correction[6]) {
+    KeplerianElements result = elements;
+    result.semimajorAxis = std::max(elements.semimajorAxis + correction[0], 0.1 * elements.semimajorAxis);
+    result.eccentricity = elements.eccentricity + correction[1];
+    result.inclination = elements.inclination + correction[2];
+    result.argumentOfPeriapsis = elements.argumentOfPeriapsis + correction[3];
+    result.longitudeOfAscendingNode = elements.longitudeOfAscendingNode + correction[4];
+    result.meanAnomaly = elements.meanAnomaly + correction[5];
+
+    if (result.eccentricity < 0.0) {
+        result.eccentricity = -result.eccentricity;
+        result.argumentOfPeriapsis += PI;
+        result.meanAnomaly += PI;
+    }
+    result.eccentricity = std::min(result.eccentricity, MAX_ECCENTRICITY);
+
+    auto wrap = [](double angle) { return angle - TWO_PI * std::floor(angle / TWO_PI); };
+    result.argumentOfPeriapsis = wrap(result.argumentOfPeriapsis);
+    result.longitudeOfAscendingNode = wrap(result.longitudeOfAscendingNode);
+    result.meanAnomaly = wrap(result.meanAnomaly);
+    return result;
+}
+
+void fillCovariance(const NormalEquations& equations, double covariance[6][6]) {
+    double factor[6][6];
+    std::copy(&equations.matrix[0][0], &equations.matrix[0][0] + 36, &factor[0][0]);
+    if (!choleskyFactor(factor)) {
+        std::fill(&covariance[0][0], &covariance[0][0] + 36, std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    for (int column = 0; column < 6; column++) {
+        double unit[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        double solution[6];
+        unit[column] = 1.0;
+        choleskySolve(factor, unit, solution);
+        for (int row = 0; row < 6; row++) {
+            covariance[row][column] = solution[row];
+        }
+    }
+}
+
+} // namespace
+
+void keplerianToCartesian(const KeplerianElements& elements, double mu, double time, double position[3],
+                          double velocity[3]) {
+    OrbitGeometry geometry = computeGeometry(elements, mu);
+    double a = elements.semimajorAxis;
+    double e = elements.eccentricity;
+    double E = solveKepler(elements.meanAnomaly + geometry.meanMotion * time, e);
+    double sinE = std::sin(E), cosE = std::cos(E);
+
+    double X = a * (cosE - e);
+    double Y = a * geometry.semiminorRatio * sinE;
+    double rate = geometry.meanMotion / (1.0 - e * cosE);
+    for (int k = 0; k < 3; k++) {
+        position[k] = X * geometry.P[k] + Y * geometry.Q[k];
+        if (velocity != nullptr) {
+            velocity[k] = (-a * sinE * geometry.P[k] + a * geometry.semiminorRatio * cosE * geometry.Q[k]) * rate;
+        }
+    }
+}
+
+KeplerianElements cartesianToKeplerian(const double position[3], const double velocity[3], double mu) {
+    constexpr double SMALL = 1e-11;
+
+    double h[3], vh[3];
+    cross(position, velocity, h);
+    cross(velocity, h, vh);
+    double r = std::sqrt(dot(position, position));
+    double hNorm = std::sqrt(dot(h, h));
+
+    double eccentricityVector[3];
+    for (int k = 0; k < 3; k++) {
+        eccentricityVector[k] = vh[k] / mu - position[k] / r;
+    }
+
+    KeplerianElements elements;
+    elements.semimajorAxis = 1.0 / (2.0 / r - dot(velocity, velocity) / mu);
+    elements.eccentricity = std::sqrt(dot(eccentricityVector, eccentricityVector));
+    elements.inclination = std::acos(std::clamp(h[2] / hNorm, -1.0, 1.0));
+
+    // Line of nodes, or the x axis for equatorial orbits
+    double node[3] = {-h[1], h[0], 0.0};
+    double nodeNorm = std::sqrt(node[0] * node[0] + node[1] * node[1]);
+    if (nodeNorm < SMALL * hNorm) {
+        node[0] = 1.0;
+        node[1] = 0.0;
+        nodeNorm = 1.0;
+    }
+    for (double& component : node) {
+        component /= nodeNorm;
+    }
+    elements.longitudeOfAscendingNode = std::atan2(node[1], node[0]);
+
+    // Angles in the orbit plane, measured about the angular momentum
+    double normal[3] = {h[0] / hNorm, h[1] / hNorm, h[2] / hNorm};
+    auto planeAngle = [&](const double from[3], const double to[3]) {
+        double c[3];
+        cross(from, to, c);
+        return std::atan2(dot(c, normal), dot(from, to));
+    };
+
+    double periapsis[3] = {node[0], node[1], node[2]};
+    elements.argumentOfPeriapsis = 0.0;
+    if (elements.eccentricity > SMALL) {
+        for (int k = 0; k < 3; k++) {
+            periapsis[k] = eccentricityVector[k] / elements.eccentricity;
+        }
+        elements.argumentOfPeriapsis = planeAngle(node, periapsis);
+    }
+
+    double e = elements.eccentricity;
+    double trueAnomaly = planeAngle(periapsis, position);
+    double E = std::atan2(std::sqrt(1.0 - e * e) * std::sin(trueAnomaly), e + std::cos(trueAnomaly));
+    elements.meanAnomaly = E - e * std::sin(E);
+
+    auto wrap = [](double angle) { return angle - TWO_PI * std::floor(angle / TWO_PI); };
+    elements.argumentOfPeriapsis = wrap(elements.argumentOfPeriapsis);
+    elements.longitudeOfAscendingNode = wrap(elements.longitudeOfAscendingNode);
+    elements.meanAnomaly = wrap(elements.meanAnomaly);
+    return elements;
+}
+
+OrbitFitResult fitOrbit(const KeplerianElements& initialGuess, const Observation* observations,
+                        size_t observationCount, const SiteGeometry* geometries, const OrbitFitSettings& settings,
+                        ThreadPool* pool) {
+    OrbitFitResult result = {};
+    result.elements = initialGuess;
+
+    std::vector<NormalEquations> chunks;
+    NormalEquations equations, candidateEquations;
+    evaluate(result.elements, settings.mu, observations, observationCount, geometries, pool, chunks, equations);
+
+    double damping = settings.initialDamping;
+    while (result.iterations < settings.maxIterations && damping < MAX_DAMPING) {
+        result.iterations++;
+
+        // Damped normal equations: N + lambda diag(N)
+        double factor[6][6];
+        std::copy(&equations.matrix[0][0], &equations.matrix[0][0] + 36, &factor[0][0]);
+        for (int k = 0; k < 6; k++) {
+            factor[k][k] *= 1.0 + damping;
+        }
+        if (!choleskyFactor(factor)) {
+            damping *= 10.0;
+            continue;
+        }
+        double correction[6];
+        choleskySolve(factor, equations.rightHandSide, correction);
+
+        KeplerianElements candidate = applyCorrection(result.elements, correction);
+        evaluate(candidate, settings.mu, observations, observationCount, geometries, pool, chunks,
+                 candidateEquations);
+
+        double change = equations.cost - candidateEquations.cost;
+        if (change >= 0.0) {
+            result.elements = candidate;
+            equations = candidateEquations;
+            damping = std::max(damping * 0.1, 1e-12);
+        } else {
+            damping *= 10.0;
+        }
+        if (std::abs(change) <= settings.tolerance * equations.cost) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    fillCovariance(equations, result.covariance);
+    size_t degreesOfFreedom = std::max<size_t>(observationCount, 1);
+    result.weightedRms = std::sqrt(equations.cost / static_cast<double>(degreesOfFreedom));
+    return result;
+}
+
+void fitOrbits(const OrbitFitProblem* problems, OrbitFitResult* results, size_t count,
+               const SiteGeometry* geometries, const OrbitFitSettings& settings, ThreadPool* pool) {
+    auto fitOne = [&](size_t index, size_t) {
+        const OrbitFitProblem& problem = problems[index];
+        results[index] = fitOrbit(problem.initialGuess, problem.observations, problem.observationCount, geometries,
+                                  settings, nullptr);
+    };
+    if (pool != nullptr) {
+        pool->parallelFor(count, fitOne);
+    } else {
+        for (size_t index = 0; index < count; index++) {
+            fitOne(index, 0);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "orbit/observations.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * The six elements OrbitalMechanics exposes plus the mean anomaly that places the object,
+ * at the reference epoch, in SI units and radians (OrbitalMechanics uses degrees and
+ * simulation units).
+ */
+struct KeplerianElements {
+    double semimajorAxis;
+    double eccentricity;
+    double inclination;
+    double argumentOfPeriapsis;
+    double longitudeOfAscendingNode;
+    double meanAnomaly;
+};
+
+/**
+ * Gets the position and velocity of a two-body orbit at a time after its epoch.
+ *
+ * @param elements Elements at the epoch
+ * @param mu Gravitational parameter
+ * @param time Seconds since the epoch
+ * @param position Output position
+ * @param velocity Output velocity; may be nullptr
+ */
+void keplerianToCartesian(const KeplerianElements& elements, double mu, double time, double position[3],
+                          double velocity[3]);
+
+/**
+ * Gets the osculating elements of a Cartesian state, e.g. to start a fit from a state
+ * vector. Undefined angles of circular or equatorial orbits are set to zero.
+ *
+ * @param position Position
+ * @param velocity Velocity
+ * @param mu Gravitational parameter
+ * @return Elements, with the state's epoch as reference epoch
+ */
+KeplerianElements cartesianToKeplerian(const double position[3], const double velocity[3], double mu);
+
+/**
+ * Settings of a least-squares orbit fit.
+ */
+struct OrbitFitSettings {
+    double mu = 3.986004415e14;
+    uint32_t maxIterations = 30;
+
+    // Converged when the weighted cost improves by less than this fraction
+    double tolerance = 1e-10;
+
+    // Initial Levenberg-Marquardt damping, relative to the diagonal of the normal matrix
+    double initialDamping = 1e-3;
+};
+
+/**
+ * Result of a least-squares orbit fit.
+ */
+struct OrbitFitResult {
+    KeplerianElements elements;
+
+    // Formal covariance of the elements, in KeplerianElements order
+    double covariance[6][6];
+
+    // Root mean square of the residuals divided by their sigmas; near 1 for a good fit
+    double weightedRms;
+
+    uint32_t iterations;
+    bool converged;
+};
+
+/**
+ * Observations of one object for fitOrbits().
+ */
+struct OrbitFitProblem {
+    KeplerianElements initialGuess;
+    const Observation* observations;
+    size_t observationCount;
+};
+
+/**
+ * Fits two-body elements to the observations of one object by Levenberg-Marquardt
+ * (Gauss-Newton with adaptive damping) on the weighted least-squares cost.
+ *
+ * Partials are analytic: the measurement gradient from predictMeasurement() chained with
+ * the derivatives of the position with respect to each element. Residuals and the normal
+ * equations are accumulated per chunk of observations, spread over the pool when it is
+ * given, and summed in chunk order so results do not depend on the thread count.
+ *
+ * Near-circular orbits determine the argument of periapsis and the mean anomaly only in
+ * sum; the damping keeps the fit stable there, and the covariance shows the correlation.
+ *
+ * @param initialGuess Starting elements, e.g. from cartesianToKeplerian()
+ * @param observations Observations of the object
+ * @param observationCount Number of observations, at least 6
+ * @param geometries Site geometry table the observations refer to
+ * @param settings Fit settings
+ * @param pool Threads to spread observations over, or nullptr
+ * @return Fitted elements and statistics
+ */
+OrbitFitResult fitOrbit(const KeplerianElements& initialGuess, const Observation* observations,
+                        size_t observationCount, const SiteGeometry* geometries, const OrbitFitSettings& settings,
+                        ThreadPool* pool = nullptr);
+
+/**
+ * Fits many objects independently, one object per task across the pool, which scales
+ * better than splitting each object's observations when there are more objects than
+ * threads.
+ *
+ * @param problems Observations and initial guess of each object
+ * @param results Output result of each object
+ * @param count Number of objects
+ * @param geometries Site geometry table shared by all observations
+ * @param settings Fit settings
+ * @param pool Threads to use, or nullptr to run on the calling thread
+ */
+void fitOrbits(const OrbitFitProblem* problems, OrbitFitResult* results, size_t count,
+               const SiteGeometry* geometries, const OrbitFitSettings& settings, ThreadPool* pool = nullptr);
@@ -0,0 +1,58 @@
+#include "orbit/orbit_kernels.h"
+#include <cmath>
+
+// Variant tables, defined in orbit_kernels_<isa>.cpp
+namespace orbit_kernels_baseline { extern const OrbitKernels KERNELS; }
+#if defined(ORBIT_SIM_X86_KERNELS)
+namespace orbit_kernels_avx2 { extern const OrbitKernels KERNELS; }
+namespace orbit_kernels_avx512 { extern const OrbitKernels KERNELS; }
+#endif
+
+const OrbitKernels* getOrbitKernels(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::Baseline:
+            return &orbit_kernels_baseline::KERNELS;
+#if defined(ORBIT_SIM_X86_KERNELS)
+        case CpuIsa::AVX2:
+            return &orbit_kernels_avx2::KERNELS;
+        case CpuIsa::AVX512:
+            return &orbit_kernels_avx512::KERNELS;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const OrbitKernels& getOrbitKernels() {
+    // Selected once; fall back level by level to a variant that was compiled in
+    static const OrbitKernels& selected = []() -> const OrbitKernels& {
+        uint32_t level = static_cast<uint32_t>(selectCpuIsa());
+        const OrbitKernels* kernels = getOrbitKernels(static_cast<CpuIsa>(level));
+        while (kernels == nullptr && level > 0) {
+            kernels = getOrbitKernels(static_cast<CpuIsa>(--level));
+        }
+        return *kernels;
+    }();
+    
+    return selected;
+}
+
+void computeOrientation(const float* inclination, const float* argumentOfPeriapsis,
+                        const float* longitudeOfAscendingNode, float* const orientation[6], size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float cosI = std::cos(inclination[i]);
+        float sinI = std::sin(inclination[i]);
+        float cosW = std::cos(argumentOfPeriapsis[i]);
+        float sinW = std::sin(argumentOfPeriapsis[i]);
+        float cosO = std::cos(longitudeOfAscendingNode[i]);
+        float sinO = std::sin(longitudeOfAscendingNode[i]);
+        
+        // Columns of Rz(node) * Rx(inclination) * Rz(periapsis) that multiply perifocal x and y
+        orientation[0][i] = cosO * cosW - sinO * sinW * cosI;
+        orientation[1][i] = sinO * cosW + cosO * sinW * cosI;
+        orientation[2][i] = sinW * sinI;
+        orientation[3][i] = -cosO * sinW - sinO * cosW * cosI;
+        orientation[4][i] = -sinO * sinW + cosO * cosW * cosI;
+        orientation[5][i] = cosW * sinI;
+    }
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "platform/cpu_features.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Eccentricity ranges with their own specialized Kepler solver. Newton needs 2
+ * iterations near circular orbits but 7 close to e = 1, so a lane-parallel solve
+ * over a mixed catalog pays for the worst object in every vector.
+ */
+enum class KeplerRegime : uint32_t {
+    NearCircular = 0,   // e < 0.1
+    Low,                // e < 0.5
+    Moderate,           // e < 0.8
+    High,               // e < 1
+    Count
+};
+
+constexpr size_t KEPLER_REGIME_COUNT = static_cast<size_t>(KeplerRegime::Count);
+
+/**
+ * Gets the solver regime of an eccentricity.
+ *
+ * @param eccentricity Eccentricity in [0, 1)
+ * @return Regime
+ */
+inline KeplerRegime keplerRegime(float eccentricity) {
+    if (eccentricity < 0.1f) return KeplerRegime::NearCircular;
+    if (eccentricity < 0.5f) return KeplerRegime::Low;
+    if (eccentricity < 0.8f) return KeplerRegime::Moderate;
+    return KeplerRegime::High;
+}
+
+// Objects evaluated together by OrbitKernels::gravityAcceleration(), one AVX-512 vector of doubles
+constexpr size_t GRAVITY_BLOCK = 8;
+
+/**
+ * Spherical harmonic gravity field prepared for OrbitKernels::gravityAcceleration()
+ * (see GravityField, which builds and owns the arrays). Per-(n, m) arrays are
+ * triangular, indexed n (n + 1) / 2 + m.
+ */
+struct GravityTerms {
+    // Maximum degree N
+    uint32_t degree;
+
+    // Reference radius R of the coefficients
+    double radius;
+
+    // GM / R^2, the factor of every acceleration term
+    double scale;
+
+    // Recursion of the normalized V/W functions up the degrees of one order, for n <= N + 1:
+    // V(n, m) = alpha (z R / r^2) V(n - 1, m) - beta (R / r)^2 V(n - 2, m)
+    const double* alpha;
+    const double* beta;
+
+    // Diagonal steps V(m, m) from V(m - 1, m - 1), for m <= N + 1
+    const double* diagonal;
+
+    // Six per (n, m), n <= N: coefficients C and S times the normalization ratios of the
+    // x/y terms of order m + 1, the x/y terms of order m - 1, and the z term of order m
+    const double* coefficients;
+};
+
+/**
+ * Gets the scratch size gravityAcceleration() needs for a field.
+ *
+ * @param degree Maximum degree of the field
+ * @return Number of doubles
+ */
+inline size_t gravityScratchSize(uint32_t degree) {
+    return 6 * (static_cast<size_t>(degree) + 2) * GRAVITY_BLOCK;
+}
+
+/**
+ * Batch numeric kernels for orbit propagation, operating on structure-of-arrays data.
+ *
+ * Every kernel is compiled once per instruction set level (see CpuIsa) from the
+ * same source, orbit_kernels_impl.h, and the variant matching the CPU is selected
+ * once at startup. Angles are in radians. Output arrays must not alias inputs.
+ */
+struct OrbitKernels {
+    // Level the kernels in this table were compiled for
+    CpuIsa isa;
+
+    /**
+     * Solves Kepler's equation M = E - e sin(E) for the eccentric anomaly.
+     * Runs a fixed number of Newton iterations so the loop vectorizes; converges
+     * to float precision for eccentricities below 0.99. Also returns cos E and
+     * sin E, which is all perifocalState() needs.
+     *
+     * @param meanAnomaly Mean anomalies
+     * @param eccentricity Eccentricities
+     * @param eccentricAnomaly Output eccentric anomalies
+     * @param cosE Output cosines of the eccentric anomalies
+     * @param sinE Output sines of the eccentric anomalies
+     * @param count Number of objects
+     */
+    void (*solveKepler)(const float* meanAnomaly, const float* eccentricity,
+                        float* eccentricAnomaly, float* cosE, float* sinE, size_t count);
+
+    /**
+     * Kepler solvers specialized per eccentricity regime, with the iteration count and
+     * starting guess fixed at compile time; same arguments and accuracy as solveKepler.
+     * Every object passed to solveKeplerRegime[r] must satisfy keplerRegime(e) <= r
+     * (see KeplerBuckets for sorting a catalog that way).
+     */
+    void (*solveKeplerRegime[KEPLER_REGIME_COUNT])(const float* meanAnomaly, const float* eccentricity,
+                                                   float* eccentricAnomaly, float* cosE, float* sinE,
+                                                   size_t count);
+
+    /**
+     * Evaluates position and velocity in the orbital (perifocal) plane, x towards
+     * periapsis, directly from cos E and sin E. No true anomaly is formed, so no
+     * transcendental functions are called.
+     *
+     * @param cosE Cosines of the eccentric anomalies
+     * @param sinE Sines of the eccentric anomalies
+     * @param eccentricity Eccentricities
+     * @param semimajorAxis Semi-major axes a
+     * @param semiminorAxis Semi-minor axes b = a sqrt(1 - e^2)
+     * @param meanMotion Mean motions n (radians per time unit)
+     * @param planeX Output perifocal x
+     * @param planeY Output perifocal y
+     * @param velocityX Output perifocal x velocity
+     * @param velocityY Output perifocal y velocity
+     * @param count Number of objects
+     */
+    void (*perifocalState)(const float* cosE, const float* sinE, const float* eccentricity,
+                           const float* semimajorAxis, const float* semiminorAxis, const float* meanMotion,
+                           float* planeX, float* planeY, float* velocityX, float* velocityY, size_t count);
+
+    /**
+     * Rotates perifocal positions into the reference frame: r = x P + y Q, where P and Q
+     * are the orbit's periapsis and in-plane normal directions (see computeOrientation()).
+     *
+     * @param planeX Perifocal x
+     * @param planeY Perifocal y
+     * @param orientation Six arrays: P.x, P.y, P.z, Q.x, Q.y, Q.z
+     * @param x Output reference frame x
+     * @param y Output reference frame y
+     * @param z Output reference frame z
+     * @param count Number of objects
+     */
+    void (*rotateToReference)(const float* planeX, const float* planeY, const float* const orientation[6],
+                              float* x, float* y, float* z, size_t count);
+
+    /**
+     * Flags the objects closer to a reference point than a threshold distance.
+     *
+     * @param x Object x
+     * @param y Object y
+     * @param z Object z
+     * @param count Number of objects
+     * @param reference Reference point (x, y, z)
+     * @param threshold Screening distance
+     * @param withinThreshold Output flags, 1 if the object is within the threshold
+     * @return Number of flagged objects
+     */
+    size_t (*screenDistances)(const float* x, const float* y, const float* z, size_t count,
+                              const float reference[3], float threshold, uint8_t* withinThreshold);
+
+    /**
+     * Evaluates the acceleration of a spherical harmonic gravity field, in double precision,
+     * with the normalized Cunningham V/W recursion (stable to high degree, no singularity
+     * at the poles). Objects are processed in blocks of GRAVITY_BLOCK so the recursions run
+     * across objects and vectorize.
+     *
+     * @param terms Prepared field
+     * @param x Earth-fixed x, in the length unit of the field's radius
+     * @param y Earth-fixed y
+     * @param z Earth-fixed z
+     * @param accelerationX Output x acceleration
+     * @param accelerationY Output y acceleration
+     * @param accelerationZ Output z acceleration
+     * @param count Number of objects
+     * @param scratch gravityScratchSize(terms.degree) doubles, private to the caller
+     */
+    void (*gravityAcceleration)(const GravityTerms& terms, const double* x, const double* y, const double* z,
+                                double* accelerationX, double* accelerationY, double* accelerationZ,
+                                size_t count, double* scratch);
+};
+
+/**
+ * Gets the kernels selected for this CPU (see selectCpuIsa()). The selection is made
+ * on the first call and kept for the lifetime of the process.
+ *
+ * @return Kernel table
+ */
+const OrbitKernels& getOrbitKernels();
+
+/**
+ * Gets the kernels compiled for a specific instruction set level, e.g. for benchmarks.
+ * The caller must check that the CPU supports the level.
+ *
+ * @param isa Instruction set level
+ * @return Kernel table, or nullptr if that level was not compiled into this build
+ */
+const OrbitKernels* getOrbitKernels(CpuIsa isa);
+
+/**
+ * Computes the orientation vectors used by rotateToReference() from the angular elements.
+ * Only needs to run when the elements change.
+ *
+ * @param inclination Inclinations
+ * @param argumentOfPeriapsis Arguments of periapsis
+ * @param longitudeOfAscendingNode Longitudes of the ascending node
+ * @param orientation Six output arrays: P.x, P.y, P.z, Q.x, Q.y, Q.z
+ * @param count Number of objects
+ */
+void computeOrientation(const float* inclination, const float* argumentOfPeriapsis,
+                        const float* longitudeOfAscendingNode, float* const orientation[6], size_t count);
@@ -0,0 +1,4 @@
+// Orbit kernels compiled with AVX2 and FMA enabled (see CMakeLists.txt)
+#define ORBIT_KERNELS_NAMESPACE orbit_kernels_avx2
+#define ORBIT_KERNELS_ISA CpuIsa::AVX2
+#include "orbit/orbit_kernels_impl.h"
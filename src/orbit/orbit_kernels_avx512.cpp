@@ -0,0 +1,4 @@
+// Orbit kernels compiled with AVX-512F/VL enabled (see CMakeLists.txt)
+#define ORBIT_KERNELS_NAMESPACE orbit_kernels_avx512
+#define ORBIT_KERNELS_ISA CpuIsa::AVX512
+#include "orbit/orbit_kernels_impl.h"
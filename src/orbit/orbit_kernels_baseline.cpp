@@ -0,0 +1,4 @@
+// Orbit kernels compiled with no extra target flags (see CMakeLists.txt)
+#define ORBIT_KERNELS_NAMESPACE orbit_kernels_baseline
+#define ORBIT_KERNELS_ISA CpuIsa::Baseline
+#include "orbit/orbit_kernels_impl.h"
@@ -1,18 +1,40 @@
 #include "orbit/orbital_mechanics.h"
+#include "orbit/vector_math.h"
+#include "orbit/attitude_dynamics.h"
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cmath>
 
+// Attitude control bandwidth in mean motions: holds nadir to about a degree through
+// the perigee of the default orbit
+static constexpr double ATTITUDE_BANDWIDTH_PER_MEAN_MOTION = 10.0;
+
+// The attitude model takes the orbit as a uniform turn, so it is fed short segments
+static constexpr float ATTITUDE_SEGMENTS_PER_ORBIT = 100.0f;
+
+// Attitude steps per control time constant, for RK4 accuracy
+static constexpr double ATTITUDE_STEPS_PER_TIME_CONSTANT = 10.0;
+
+// Orbits of attitude integrated per update at most. The control time constant is
+// 1 / (2 pi ATTITUDE_BANDWIDTH_PER_MEAN_MOTION) orbits, so the attitude has forgotten
+// its start long before the end of a longer increment, and the work per update stays
+// bounded at any time multiplier.
+static constexpr float MAX_ATTITUDE_ORBITS_PER_UPDATE = 1.0f;
+
 OrbitalMechanics::OrbitalMechanics()
     : m_semimajorAxis(12.0f),         // Default semi-major axis
       m_eccentricity(0.3f),           // Default eccentricity
       m_inclination(30.0f),           // Default inclination in degrees
       m_argumentOfPeriapsis(0.0f),    // Default argument of periapsis
       m_longitudeOfAscendingNode(0.0f), // Default longitude of ascending node
-      m_meanAnomaly(0.0f) {           // Start at periapsis
+      m_meanAnomaly(0.0f),            // Start at periapsis
+      m_attitude{1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},  // Body axes along the reference axes, at rest
+      m_inertia{1.0, 0.4, 0.9} {      // Solar wings along body y
     
     // Calculate orbital period based on initial parameters
     m_period = calculatePeriod();
+    updateSemiminorAxis();
 }
 
 OrbitalMechanics::~OrbitalMechanics() {
@@ -23,8 +45,19 @@ void OrbitalMechanics::update(float deltaTime) {
     // Calculate mean motion (angular velocity)
     float meanMotion = 2.0f * glm::pi<float>() / m_period;
     
-    // Update mean anomaly based on time increment
-    m_meanAnomaly += meanMotion * deltaTime;
+    // Of a long increment only the last orbits move the attitude; skip ahead to them
+    float skipped = std::max(0.0f, deltaTime - MAX_ATTITUDE_ORBITS_PER_UPDATE * m_period);
+    m_meanAnomaly = std::fmod(m_meanAnomaly + meanMotion * skipped, 2.0f * glm::pi<float>());
+    float attitudeTime = deltaTime - skipped;
+    
+    // Update mean anomaly based on time increment, segment by segment so the attitude
+    // follows the orbit from the state at the start of each
+    int segmentCount = std::max(1, static_cast<int>(std::ceil(attitudeTime * ATTITUDE_SEGMENTS_PER_ORBIT / m_period)));
+    float segment = attitudeTime / static_cast<float>(segmentCount);
+    for (int i = 0; i < segmentCount; i++) {
+        updateAttitude(segment);
+        m_meanAnomaly += meanMotion * segment;
+    }
     
     // Keep mean anomaly in the range [0, 2π]
     while (m_meanAnomaly > 2.0f * glm::pi<float>()) {
@@ -36,21 +69,39 @@ glm::vec3 OrbitalMechanics::getSatellitePosition() const {
     // Convert mean anomaly to eccentric anomaly using Kepler's equation
     float eccentricAnomaly = calculateEccentricAnomaly(m_meanAnomaly);
     
-    // Calculate position in orbital plane
-    glm::vec2 position2D = calculateOrbitalPlanePosition(eccentricAnomaly);
+    // Calculate position in orbital plane from one sine/cosine pair
+    float sinE, cosE;
+    vmath::sincos(eccentricAnomaly, sinE, cosE);
+    glm::vec2 position2D = calculateOrbitalPlanePosition(cosE, sinE);
     
     // Transform to reference frame using orbital elements
     return transformToReferenceFrame(position2D);
 }
 
+glm::vec3 OrbitalMechanics::getSatelliteVelocity() const {
+    float eccentricAnomaly = calculateEccentricAnomaly(m_meanAnomaly);
+    float sinE, cosE;
+    vmath::sincos(eccentricAnomaly, sinE, cosE);
+    
+    // The plane-to-space rotation is linear, so it maps velocities too
+    return transformToReferenceFrame(calculateOrbitalPlaneVelocity(cosE, sinE));
+}
+
+glm::vec4 OrbitalMechanics::getSatelliteAttitude() const {
+    return glm::vec4(static_cast<float>(m_attitude[1]), static_cast<float>(m_attitude[2]),
+                     static_cast<float>(m_attitude[3]), static_cast<float>(m_attitude[0]));
+}
+
 void OrbitalMechanics::setSemimajorAxis(float value) {
     m_semimajorAxis = value;
     m_period = calculatePeriod(); // Recalculate period when changing semi-major axis
+    updateSemiminorAxis();
 }
 
 void OrbitalMechanics::setEccentricity(float value) {
     // Clamp eccentricity to valid range [0, 1)
     m_eccentricity = std::max(0.0f, std::min(0.99f, value));
+    updateSemiminorAxis();
 }
 
 void OrbitalMechanics::setInclination(float value) {
@@ -85,8 +136,12 @@ float OrbitalMechanics::calculateEccentricAnomaly(float meanAnomaly) const {
     constexpr float CONVERGENCE_THRESHOLD = 1e-8f;  // Tighter tolerance
     
     for (int i = 0; i < MAX_ITERATIONS; i++) {
-        float funcValue = E - e * std::sin(E) - meanAnomaly;
-        float funcDerivative = 1.0f - e * std::cos(E);
+        // One shared range reduction for both sine and cosine
+        float sinE, cosE;
+        vmath::sincos(E, sinE, cosE);
+        
+        float funcValue = E - e * sinE - meanAnomaly;
+        float funcDerivative = 1.0f - e * cosE;
         
         float correction = funcValue / funcDerivative;
         E -= correction;
@@ -107,27 +162,58 @@ float OrbitalMechanics::calculatePeriod() const {
     );
 }
 
-glm::vec2 OrbitalMechanics::calculateOrbitalPlanePosition(float eccentricAnomaly) const {
-    float cosE = std::cos(eccentricAnomaly);
-    float sinE = std::sin(eccentricAnomaly);
-    
-    // Calculate distance from focus (Earth) to satellite
-    float distance = m_semimajorAxis * (1.0f - m_eccentricity * cosE);
+void OrbitalMechanics::updateSemiminorAxis() {
+    m_semiminorAxis = m_semimajorAxis * std::sqrt(1.0f - m_eccentricity * m_eccentricity);
+}
+
+void OrbitalMechanics::updateAttitude(float deltaTime) {
+    if (deltaTime <= 0.0f) {
+        return;
+    }
     
-    // Calculate true anomaly (angle from periapsis to current position)
-    float trueAnomaly = 2.0f * std::atan2(
-        std::sqrt(1.0f + m_eccentricity) * std::sin(eccentricAnomaly / 2.0f),
-        std::sqrt(1.0f - m_eccentricity) * std::cos(eccentricAnomaly / 2.0f)
-    );
+    // Simulation time is not physical, so the controller is sized by the mean motion;
+    // torque saturates beyond half a radian of error, so large errors are slewed out
+    double meanMotion = 2.0 * glm::pi<double>() / m_period;
+    AttitudeModelConfig config;
+    config.mu = m_earthMu;
+    config.control = AttitudeControlMode::NadirPointing;
+    config.controlBandwidth = ATTITUDE_BANDWIDTH_PER_MEAN_MOTION * meanMotion;
+    config.maxControlTorque = 0.5 * config.controlBandwidth * config.controlBandwidth *
+                              std::max(m_inertia[0], std::max(m_inertia[1], m_inertia[2]));
     
-    // Convert to position in orbital plane
-    // X-axis is towards periapsis, Y-axis is 90 degrees counter-clockwise in orbital plane
-    float cosTheta = std::cos(trueAnomaly);
-    float sinTheta = std::sin(trueAnomaly);
+    // Position and velocity from one Kepler solve
+    float sinE, cosE;
+    vmath::sincos(calculateEccentricAnomaly(m_meanAnomaly), sinE, cosE);
+    glm::vec3 position = transformToReferenceFrame(calculateOrbitalPlanePosition(cosE, sinE));
+    glm::vec3 velocity = transformToReferenceFrame(calculateOrbitalPlaneVelocity(cosE, sinE));
+    double orbit[6] = {position.x, position.y, position.z, velocity.x, velocity.y, velocity.z};
+    CartesianStateBatch orbits = {&orbit[0], &orbit[1], &orbit[2], &orbit[3], &orbit[4], &orbit[5], 1};
+    AttitudeStateBatch state = {&m_attitude[0], &m_attitude[1], &m_attitude[2], &m_attitude[3],
+                                &m_attitude[4], &m_attitude[5], &m_attitude[6], 1};
+    InertiaBatch inertia = {&m_inertia[0], &m_inertia[1], &m_inertia[2]};
     
+    double maxStep = 1.0 / (ATTITUDE_STEPS_PER_TIME_CONSTANT * config.controlBandwidth);
+    size_t stepCount = static_cast<size_t>(std::ceil(deltaTime / maxStep));
+    propagateAttitudes(config, state, inertia, orbits, deltaTime / static_cast<double>(stepCount), stepCount);
+}
+
+glm::vec2 OrbitalMechanics::calculateOrbitalPlanePosition(float cosE, float sinE) const {
+    // Position in orbital plane, X-axis towards periapsis, Y-axis 90 degrees
+    // counter-clockwise. Equal to r (cos nu, sin nu) with r = a (1 - e cos E),
+    // without forming the true anomaly nu.
+    return glm::vec2(
+        m_semimajorAxis * (cosE - m_eccentricity),
+        m_semiminorAxis * sinE
+    );
+}
+
+glm::vec2 OrbitalMechanics::calculateOrbitalPlaneVelocity(float cosE, float sinE) const {
+    // Differentiate x = a (cos E - e), y = b sin E with dE/dt = n / (1 - e cos E)
+    float meanMotion = 2.0f * glm::pi<float>() / m_period;
+    float eccentricAnomalyRate = meanMotion / (1.0f - m_eccentricity * cosE);
     return glm::vec2(
-        distance * cosTheta,
-        distance * sinTheta
+        -m_semimajorAxis * sinE * eccentricAnomalyRate,
+        m_semiminorAxis * cosE * eccentricAnomalyRate
     );
 }
 
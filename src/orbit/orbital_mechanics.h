@@ -1,5 +1,6 @@
 #pragma once
 
+#include "orbit/earth_constants.h"
 #include <glm/glm.hpp>
 
 /**
@@ -35,6 +36,21 @@ public:
      */
     glm::vec3 getSatellitePosition() const;
     
+    /**
+     * Gets the current velocity of the satellite, e.g. to build its local frame.
+     * 
+     * @return Velocity vector in 3D space, simulation units per second
+     */
+    glm::vec3 getSatelliteVelocity() const;
+    
+    /**
+     * Gets the current attitude of the satellite, which a nadir-pointing controller
+     * drives against gravity gradient as the orbit advances.
+     * 
+     * @return Unit quaternion rotating body axes into space, as (x, y, z, w)
+     */
+    glm::vec4 getSatelliteAttitude() const;
+    
     /**
      * Gets the current orbital period.
      * 
@@ -57,9 +73,9 @@ public:
     void setLongitudeOfAscendingNode(float value);
     
 private:
-    // Earth parameters (in arbitrary units)
-    const float m_earthRadius = 6.371f;  // Earth radius
-    const float m_earthMu = 398600.0f;   // Earth gravitational parameter
+    // Earth parameters (in simulation units)
+    static constexpr float m_earthRadius = EarthConstants<float>::RADIUS;  // Earth radius
+    static constexpr float m_earthMu = EarthConstants<float>::MU;          // Earth gravitational parameter
     
     // Orbital parameters (Keplerian elements)
     float m_semimajorAxis;              // Semi-major axis of the elliptical orbit
@@ -67,11 +83,16 @@ private:
     float m_inclination;                // Inclination in degrees
     float m_argumentOfPeriapsis;        // Argument of periapsis in degrees
     float m_longitudeOfAscendingNode;   // Longitude of ascending node in degrees
+    float m_semiminorAxis;              // Semi-minor axis, a * sqrt(1 - e^2), derived
     
     // Current state
     float m_meanAnomaly;    // Current mean anomaly (varies linearly with time)
     float m_period;         // Orbital period
     
+    // Attitude: scalar-first quaternion then body rates, and principal moments of inertia
+    double m_attitude[7];
+    double m_inertia[3];
+    
     // Helper methods
     /**
      * Solves Kepler's equation to find eccentric anomaly.
@@ -88,13 +109,37 @@ private:
      */
     float calculatePeriod() const;
     
+    /**
+     * Recomputes the semi-minor axis after a or e changed.
+     */
+    void updateSemiminorAxis();
+    
+    /**
+     * Advances the attitude over a time increment from the current orbital state,
+     * in sub-steps short enough for the control bandwidth.
+     * 
+     * @param deltaTime Time increment
+     */
+    void updateAttitude(float deltaTime);
+    
     /**
      * Converts eccentric anomaly to position in orbital plane.
+     * Uses x = a (cos E - e), y = b sin E, so no true anomaly is needed.
      * 
-     * @param eccentricAnomaly The eccentric anomaly
+     * @param cosE Cosine of the eccentric anomaly
+     * @param sinE Sine of the eccentric anomaly
      * @return 2D position vector in orbital plane
      */
-    glm::vec2 calculateOrbitalPlanePosition(float eccentricAnomaly) const;
+    glm::vec2 calculateOrbitalPlanePosition(float cosE, float sinE) const;
+    
+    /**
+     * Converts eccentric anomaly to velocity in orbital plane.
+     * 
+     * @param cosE Cosine of the eccentric anomaly
+     * @param sinE Sine of the eccentric anomaly
+     * @return 2D velocity vector in orbital plane
+     */
+    glm::vec2 calculateOrbitalPlaneVelocity(float cosE, float sinE) const;
     
     /**
      * Transforms position from orbital plane to 3D space.
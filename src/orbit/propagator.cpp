@@ -0,0 +1,66 @@
+#include "orbit/propagator.h"
+
+namespace {
+
+template <typename T>
+struct PropagatorEntry {
+    PropagatorConfig config;
+    PropagateFunction<T> function;
+};
+
+using Solver = KeplerSolverKind;
+using Perturbation = PerturbationKind;
+using Frame = OutputFrame;
+
+// Every instantiated combination; a configuration missing here is not available
+template <typename T>
+const PropagatorEntry<T> PROPAGATORS[] = {
+    {{Solver::FixedNewton, Perturbation::TwoBody, Frame::Perifocal},
+     propagateBatch<T, FixedNewtonSolver, TwoBody, PerifocalFrame>},
+    {{Solver::FixedNewton, Perturbation::TwoBody, Frame::Reference},
+     propagateBatch<T, FixedNewtonSolver, TwoBody, ReferenceFrame>},
+    {{Solver::FixedNewton, Perturbation::J2Secular, Frame::Perifocal},
+     propagateBatch<T, FixedNewtonSolver, PerturbationSet<J2Secular>, PerifocalFrame>},
+    {{Solver::FixedNewton, Perturbation::J2Secular, Frame::Reference},
+     propagateBatch<T, FixedNewtonSolver, PerturbationSet<J2Secular>, ReferenceFrame>},
+    {{Solver::ConvergedNewton, Perturbation::TwoBody, Frame::Perifocal},
+     propagateBatch<T, ConvergedNewtonSolver, TwoBody, PerifocalFrame>},
+    {{Solver::ConvergedNewton, Perturbation::TwoBody, Frame::Reference},
+     propagateBatch<T, ConvergedNewtonSolver, TwoBody, ReferenceFrame>},
+    {{Solver::ConvergedNewton, Perturbation::J2Secular, Frame::Perifocal},
+     propagateBatch<T, ConvergedNewtonSolver, PerturbationSet<J2Secular>, PerifocalFrame>},
+    {{Solver::ConvergedNewton, Perturbation::J2Secular, Frame::Reference},
+     propagateBatch<T, ConvergedNewtonSolver, PerturbationSet<J2Secular>, ReferenceFrame>},
+};
+
+const char* const SOLVER_NAMES[] = {"fixed-newton", "converged-newton"};
+const char* const PERTURBATION_NAMES[] = {"two-body", "j2"};
+const char* const FRAME_NAMES[] = {"perifocal", "reference"};
+
+static_assert(sizeof(SOLVER_NAMES) / sizeof(SOLVER_NAMES[0]) == static_cast<size_t>(KeplerSolverKind::Count));
+static_assert(sizeof(PERTURBATION_NAMES) / sizeof(PERTURBATION_NAMES[0]) == static_cast<size_t>(PerturbationKind::Count));
+static_assert(sizeof(FRAME_NAMES) / sizeof(FRAME_NAMES[0]) == static_cast<size_t>(OutputFrame::Count));
+
+} // namespace
+
+template <typename T>
+PropagateFunction<T> findPropagator(const PropagatorConfig& config) {
+    for (const PropagatorEntry<T>& entry : PROPAGATORS<T>) {
+        if (entry.config == config) {
+            return entry.function;
+        }
+    }
+    return nullptr;
+}
+
+template PropagateFunction<float> findPropagator<float>(const PropagatorConfig& config);
+template PropagateFunction<double> findPropagator<double>(const PropagatorConfig& config);
+
+std::string propagatorName(const PropagatorConfig& config) {
+    std::string name = SOLVER_NAMES[static_cast<size_t>(config.solver)];
+    name += '/';
+    name += PERTURBATION_NAMES[static_cast<size_t>(config.perturbations)];
+    name += '/';
+    name += FRAME_NAMES[static_cast<size_t>(config.frame)];
+    return name;
+}
@@ -0,0 +1,385 @@
+#include "orbit/reference_frames.h"
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double TWO_PI = 2.0 * PI;
+
+// Arcseconds to radians
+constexpr double ARCSECONDS = PI / (180.0 * 3600.0);
+
+// Arcseconds in a full turn
+constexpr double TURN_ARCSECONDS = 1296000.0;
+
+// Days per Julian century
+constexpr double DAYS_PER_CENTURY = 36525.0;
+
+/**
+ * One term of the IAU 2000B luni-solar nutation series: multipliers of the Delaunay
+ * arguments (l, l', F, D, Omega) and coefficients in units of 0.1 microarcseconds.
+ */
+struct NutationTerm {
+    int8_t multipliers[5];
+    double longitudeSin;        // dpsi += (longitudeSin + longitudeSinRate t) sin(arg) + longitudeCos cos(arg)
+    double longitudeSinRate;
+    double longitudeCos;
+    double obliquityCos;        // deps += (obliquityCos + obliquityCosRate t) cos(arg) + obliquitySin sin(arg)
+    double obliquityCosRate;
+    double obliquitySin;
+};
+
+// IAU 2000B series (McCarthy & Luzum 2003), largest terms first
+constexpr NutationTerm NUTATION_TERMS[] = {
+    {{ 0,  0,  0,  0,  1}, -172064161, -174666, 33386, 92052331, 9086, 15377},
+    {{ 0,  0,  2, -2,  2}, -13170906, -1675, -13696, 5730336, -3015, -4587},
+    {{ 0,  0,  2,  0,  2}, -2276413, -234, 2796, 978459, -485, 1374},
+    {{ 0,  0,  0,  0,  2}, 2074554, 207, -698, -897492, 470, -291},
+    {{ 0,  1,  0,  0,  0}, 1475877, -3633, 11817, 73871, -184, -1924},
+    {{ 0,  1,  2, -2,  2}, -516821, 1226, -524, 224386, -677, -174},
+    {{ 1,  0,  0,  0,  0}, 711159, 73, -872, -6750, 0, 358},
+    {{ 0,  0,  2,  0,  1}, -387298, -367, 380, 200728, 18, 318},
+    {{ 1,  0,  2,  0,  2}, -301461, -36, 816, 129025, -63, 367},
+    {{ 0, -1,  2, -2,  2}, 215829, -494, 111, -95929, 299, 132},
+    {{ 0,  0,  2, -2,  1}, 128227, 137, 181, -68982, -9, 39},
+    {{-1,  0,  2,  0,  2}, 123457, 11, 19, -53311, 32, -4},
+    {{-1,  0,  0,  2,  0}, 156994, 10, -168, -1235, 0, 82},
+    {{ 1,  0,  0,  0,  1}, 63110, 63, 27, -33228, 0, -9},
+    {{-1,  0,  0,  0,  1}, -57976, -63, -189, 31429, 0, -75},
+    {{-1,  0,  2,  2,  2}, -59641, -11, 149, 25543, -11, 66},
+    {{ 1,  0,  2,  0,  1}, -51613, -42, 129, 26366, 0, 78},
+    {{-2,  0,  2,  0,  1}, 45893, 50, 31, -24236, -10, 20},
+    {{ 0,  0,  0,  2,  0}, 63384, 11, -150, -1220, 0, 29},
+    {{ 0,  0,  2,  2,  2}, -38571, -1, 158, 16452, -11, 68},
+    {{ 0, -2,  2, -2,  2}, 32481, 0, 0, -13870, 0, 0},
+    {{-2,  0,  0,  2,  0}, -47722, 0, -18, 477, 0, -25},
+    {{ 2,  0,  2,  0,  2}, -31046, -1, 131, 13238, -11, 59},
+    {{ 1,  0,  2, -2,  2}, 28593, 0, -1, -12338, 10, -3},
+    {{-1,  0,  2,  0,  1}, 20441, 21, 10, -10758, 0, -3},
+    {{ 2,  0,  0,  0,  0}, 29243, 0, -74, -609, 0, 13},
+    {{ 0,  0,  2,  0,  0}, 25887, 0, -66, -550, 0, 11},
+    {{ 0,  1,  0,  0,  1}, -14053, -25, 79, 8551, -2, -45},
+    {{-1,  0,  0,  2,  1}, 15164, 10, 11, -8001, 0, -1},
+    {{ 0,  2,  2, -2,  2}, -15794, 72, -16, 6850, -42, -5},
+    {{ 0,  0, -2,  2,  0}, 21783, 0, 13, -167, 0, 13},
+    {{ 1,  0,  0, -2,  1}, -12873, -10, -37, 6953, 0, -14},
+    {{ 0, -1,  0,  0,  1}, -12654, 11, 63, 6415, 0, 26},
+    {{-1,  0,  2,  2,  1}, -10204, 0, 25, 5222, 0, 15},
+    {{ 0,  2,  0,  0,  0}, 16707, -85, -10, 168, -1, 10},
+    {{ 1,  0,  2,  2,  2}, -7691, 0, 44, 3268, 0, 19},
+    {{-2,  0,  2,  0,  0}, -11024, 0, -14, 104, 0, 2},
+    {{ 0,  1,  2,  0,  2}, 7566, -21, -11, -3250, 0, -5},
+    {{ 0,  0,  2,  2,  1}, -6637, -11, 25, 3353, 0, 14},
+    {{ 0, -1,  2,  0,  2}, -7141, 21, 8, 3070, 0, 4},
+    {{ 0,  0,  0,  2,  1}, -6302, -11, 2, 3272, 0, 4},
+    {{ 1,  0,  2, -2,  1}, 5800, 10, 2, -3045, 0, -1},
+    {{ 2,  0,  2, -2,  2}, 6443, 0, -7, -2768, 0, -4},
+    {{-2,  0,  0,  2,  1}, -5774, -11, -15, 3041, 0, -5},
+    {{ 2,  0,  2,  0,  1}, -5350, 0, 21, 2695, 0, 12},
+    {{ 0, -1,  2, -2,  1}, -4752, -11, -3, 2719, 0, -3},
+    {{ 0,  0,  0, -2,  1}, -4940, -11, -21, 2720, 0, -9},
+    {{-1, -1,  0,  2,  0}, 7350, 0, -8, -51, 0, 4},
+    {{ 2,  0,  0, -2,  1}, 4065, 0, 6, -2206, 0, 1},
+    {{ 1,  0,  0,  2,  0}, 6579, 0, -24, -199, 0, 2},
+    {{ 0,  1,  2, -2,  1}, 3579, 0, 5, -1900, 0, 1},
+    {{ 1, -1,  0,  0,  0}, 4725, 0, -6, -41, 0, 3},
+    {{-2,  0,  2,  0,  2}, -3075, 0, -2, 1313, 0, -1},
+    {{ 3,  0,  2,  0,  2}, -2904, 0, 15, 1233, 0, 7},
+    {{ 0, -1,  0,  2,  0}, 4348, 0, -10, -81, 0, 2},
+    {{ 1, -1,  2,  0,  2}, -2878, 0, 8, 1232, 0, 4},
+    {{ 0,  0,  0,  1,  0}, -4230, 0, 5, -20, 0, -2},
+    {{-1, -1,  2,  2,  2}, -2819, 0, 7, 1207, 0, 3},
+    {{-1,  0,  2,  0,  0}, -4056, 0, 5, 40, 0, -2},
+    {{ 0, -1,  2,  2,  2}, -2647, 0, 11, 1129, 0, 5},
+    {{-2,  0,  0,  0,  1}, -2294, 0, -10, 1266, 0, -4},
+    {{ 1,  1,  2,  0,  2}, 2481, 0, -7, -1062, 0, -3},
+    {{ 2,  0,  0,  0,  1}, 2179, 0, -2, -1129, 0, -2},
+    {{-1,  1,  0,  1,  0}, 3276, 0, 1, -9, 0, 0},
+    {{ 1,  1,  0,  0,  0}, -3389, 0, 5, 35, 0, -2},
+    {{ 1,  0,  2,  0,  0}, 3339, 0, -13, -107, 0, 1},
+    {{-1,  0,  2, -2,  1}, -1987, 0, -6, 1073, 0, -2},
+    {{ 1,  0,  0,  0,  2}, -1981, 0, 0, 854, 0, 0},
+    {{-1,  0,  0,  1,  0}, 4026, 0, -353, -553, 0, -139},
+    {{ 0,  0,  2,  1,  2}, 1660, 0, -5, -710, 0, -2},
+    {{-1,  0,  2,  4,  2}, -1521, 0, 9, 647, 0, 4},
+    {{-1,  1,  0,  1,  1}, 1314, 0, 0, -700, 0, 0},
+    {{ 0, -2,  2, -2,  1}, -1283, 0, 0, 672, 0, 0},
+    {{ 1,  0,  2,  2,  1}, -1331, 0, 8, 663, 0, 4},
+    {{-2,  0,  2,  2,  2}, 1383, 0, -2, -594, 0, -2},
+    {{-1,  0,  0,  0,  2}, 1405, 0, 4, -610, 0, 2},
+    {{ 1,  1,  2, -2,  2}, 1290, 0, 0, -556, 0, 0}
+};
+
+// Coefficient units of NUTATION_TERMS, 0.1 microarcseconds, in radians
+constexpr double NUTATION_UNIT = ARCSECONDS * 1e-7;
+
+// Fixed offsets standing in for the planetary terms of IAU 2000A
+constexpr double PLANETARY_LONGITUDE = -0.135e-3 * ARCSECONDS;
+constexpr double PLANETARY_OBLIQUITY = 0.388e-3 * ARCSECONDS;
+
+/**
+ * Elementary rotations of the coordinate frame by an angle, as in the IERS conventions.
+ */
+RotationMatrix rotationX(double angle) {
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+    return {{{1.0, 0.0, 0.0}, {0.0, c, s}, {0.0, -s, c}}};
+}
+
+RotationMatrix rotationY(double angle) {
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+    return {{{c, 0.0, -s}, {0.0, 1.0, 0.0}, {s, 0.0, c}}};
+}
+
+RotationMatrix rotationZ(double angle) {
+    double c = std::cos(angle);
+    double s = std::sin(angle);
+    return {{{c, s, 0.0}, {-s, c, 0.0}, {0.0, 0.0, 1.0}}};
+}
+
+RotationMatrix identity() {
+    return {{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}};
+}
+
+/**
+ * Mean obliquity of the ecliptic, IAU 2006.
+ */
+double meanObliquity(double centuries) {
+    double t = centuries;
+    return (84381.406 + (-46.836769 + (-0.0001831 + (0.00200340 + (-0.000000576 - 0.0000000434 * t) * t) * t) * t) * t) *
+           ARCSECONDS;
+}
+
+/**
+ * Rotation from the GCRF to the true equator and equinox of date: IAU 2006 precession
+ * as Fukushima-Williams angles, with frame bias, plus nutation.
+ */
+RotationMatrix precessionNutation(double centuries, const Nutation& nutation) {
+    double t = centuries;
+    double gamma = (-0.052928 + (10.556378 + (0.4932044 + (-0.00031238 + (-0.000002788 + 0.0000000260 * t) * t) * t) * t) * t) *
+                   ARCSECONDS;
+    double phi = (84381.412819 + (-46.811016 + (0.0511268 + (0.00053289 + (-0.000000440 - 0.0000000176 * t) * t) * t) * t) * t) *
+                 ARCSECONDS;
+    double psi = (-0.041775 + (5038.481484 + (1.5584175 + (-0.00018522 + (-0.000026452 - 0.0000000148 * t) * t) * t) * t) * t) *
+                 ARCSECONDS;
+
+    psi += nutation.longitude;
+    double epsilon = meanObliquity(t) + nutation.obliquity;
+
+    return multiply(rotationX(-epsilon), multiply(rotationZ(-psi), multiply(rotationX(phi), rotationZ(gamma))));
+}
+
+/**
+ * Equation of the equinoxes, the offset between the true and the mean equinox along the
+ * true equator, with the two largest complementary terms (the rest stay below 0.02 mas).
+ */
+double equationOfEquinoxes(double centuries, const Nutation& nutation) {
+    double node = std::fmod(450160.398036 - 6962890.5431 * centuries, TURN_ARCSECONDS) * ARCSECONDS;
+    double complementary = (2640.96e-6 * std::sin(node) + 63.52e-6 * std::sin(2.0 * node)) * ARCSECONDS;
+    return nutation.longitude * std::cos(meanObliquity(centuries)) + complementary;
+}
+
+/**
+ * Greenwich apparent sidereal time, IAU 2006.
+ */
+double apparentSiderealTime(double ttDays, double ut1Days, const Nutation& nutation) {
+    double t = ttDays / DAYS_PER_CENTURY;
+    double meanSiderealTime = earthRotationAngle(ut1Days) +
+        (0.014506 + (4612.156534 + (1.3915817 + (-0.00000044 + (-0.000029956 - 0.0000000368 * t) * t) * t) * t) * t) *
+        ARCSECONDS;
+    return meanSiderealTime + equationOfEquinoxes(t, nutation);
+}
+
+/**
+ * Rotation from the GCRF to the given frame.
+ */
+RotationMatrix rotationFromGcrf(CoordinateFrame frame, double ttDays, double ut1Days, const Nutation& nutation,
+                                const PolarMotion& polarMotion) {
+    double t = ttDays / DAYS_PER_CENTURY;
+    switch (frame) {
+        case CoordinateFrame::Gcrf:
+            return identity();
+
+        case CoordinateFrame::Teme:
+            // TEME differs from the true of date frame by the equation of the equinoxes
+            return multiply(rotationZ(equationOfEquinoxes(t, nutation)), precessionNutation(t, nutation));
+
+        case CoordinateFrame::Itrf: {
+            // Polar motion with the TIO locator s' = -47 microarcseconds per century
+            double tioLocator = -47e-6 * ARCSECONDS * t;
+            RotationMatrix polar = multiply(rotationX(-polarMotion.y),
+                                            multiply(rotationY(-polarMotion.x), rotationZ(tioLocator)));
+            RotationMatrix earthRotation = rotationZ(apparentSiderealTime(ttDays, ut1Days, nutation));
+            return multiply(polar, multiply(earthRotation, precessionNutation(t, nutation)));
+        }
+    }
+    return identity();
+}
+
+/**
+ * Cubic Lagrange interpolation through four equally spaced values at -1, 0, 1, 2.
+ */
+double interpolateCubic(double v0, double v1, double v2, double v3, double u) {
+    double w0 = -u * (u - 1.0) * (u - 2.0) / 6.0;
+    double w1 = (u + 1.0) * (u - 1.0) * (u - 2.0) / 2.0;
+    double w2 = -(u + 1.0) * u * (u - 2.0) / 2.0;
+    double w3 = (u + 1.0) * u * (u - 1.0) / 6.0;
+    return w0 * v0 + w1 * v1 + w2 * v2 + w3 * v3;
+}
+
+} // namespace
+
+RotationMatrix multiply(const RotationMatrix& a, const RotationMatrix& b) {
+    RotationMatrix result;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] +
+                                    a.m[row][2] * b.m[2][column];
+        }
+    }
+    return result;
+}
+
+RotationMatrix transpose(const RotationMatrix& rotation) {
+    RotationMatrix result;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            result.m[row][column] = rotation.m[column][row];
+        }
+    }
+    return result;
+}
+
+double earthRotationAngle(double ut1Days) {
+    // The day fraction is added separately so the large daily turn count drops out exactly
+    double turns = std::fmod(ut1Days, 1.0) + 0.7790572732640 + 0.00273781191135448 * ut1Days;
+    return TWO_PI * (turns - std::floor(turns));
+}
+
+Nutation computeNutation(double ttDays) {
+    double t = ttDays / DAYS_PER_CENTURY;
+
+    // Delaunay arguments, linear in time as in IAU 2000B
+    double arguments[5] = {
+        std::fmod(485868.249036 + 1717915923.2178 * t, TURN_ARCSECONDS) * ARCSECONDS,   // l, Moon's mean anomaly
+        std::fmod(1287104.79305 + 129596581.0481 * t, TURN_ARCSECONDS) * ARCSECONDS,    // l', Sun's mean anomaly
+        std::fmod(335779.526232 + 1739527262.8478 * t, TURN_ARCSECONDS) * ARCSECONDS,   // F, Moon's argument of latitude
+        std::fmod(1072260.70369 + 1602961601.2090 * t, TURN_ARCSECONDS) * ARCSECONDS,   // D, Moon's elongation
+        std::fmod(450160.398036 - 6962890.5431 * t, TURN_ARCSECONDS) * ARCSECONDS       // Omega, Moon's node
+    };
+
+    // Sum the smallest terms first
+    double longitude = 0.0;
+    double obliquity = 0.0;
+    for (size_t i = sizeof(NUTATION_TERMS) / sizeof(NUTATION_TERMS[0]); i-- > 0;) {
+        const NutationTerm& term = NUTATION_TERMS[i];
+        double argument = 0.0;
+        for (int k = 0; k < 5; k++) {
+            argument += term.multipliers[k] * arguments[k];
+        }
+        argument = std::fmod(argument, TWO_PI);
+
+        double s = std::sin(argument);
+        double c = std::cos(argument);
+        longitude += (term.longitudeSin + term.longitudeSinRate * t) * s + term.longitudeCos * c;
+        obliquity += (term.obliquityCos + term.obliquityCosRate * t) * c + term.obliquitySin * s;
+    }
+
+    return {longitude * NUTATION_UNIT + PLANETARY_LONGITUDE, obliquity * NUTATION_UNIT + PLANETARY_OBLIQUITY};
+}
+
+RotationMatrix frameRotation(CoordinateFrame from, CoordinateFrame to, double ttDays, double ut1Days,
+                             const Nutation& nutation, const PolarMotion& polarMotion) {
+    if (from == to) {
+        return identity();
+    }
+    RotationMatrix fromGcrf = rotationFromGcrf(from, ttDays, ut1Days, nutation, polarMotion);
+    RotationMatrix toGcrf = rotationFromGcrf(to, ttDays, ut1Days, nutation, polarMotion);
+    return multiply(toGcrf, transpose(fromGcrf));
+}
+
+RotationMatrix frameRotation(CoordinateFrame from, CoordinateFrame to, double ttDays, double ut1Days,
+                             const PolarMotion& polarMotion) {
+    return frameRotation(from, to, ttDays, ut1Days, computeNutation(ttDays), polarMotion);
+}
+
+FrameRotationCache::FrameRotationCache()
+    : m_firstNode(0), m_seriesEvaluations(0), m_hasLast(false), m_lastFrom(CoordinateFrame::Gcrf),
+      m_lastTo(CoordinateFrame::Gcrf), m_lastTt(0.0), m_lastUt1(0.0), m_lastRotation(identity()) {
+}
+
+const RotationMatrix& FrameRotationCache::getRotation(CoordinateFrame from, CoordinateFrame to, double ttDays,
+                                                      double ut1Days, const PolarMotion& polarMotion) {
+    if (m_hasLast && from == m_lastFrom && to == m_lastTo && ttDays == m_lastTt && ut1Days == m_lastUt1 &&
+        polarMotion.x == m_lastPolarMotion.x && polarMotion.y == m_lastPolarMotion.y) {
+        return m_lastRotation;
+    }
+
+    m_lastRotation = frameRotation(from, to, ttDays, ut1Days, getNutation(ttDays), polarMotion);
+    m_lastFrom = from;
+    m_lastTo = to;
+    m_lastTt = ttDays;
+    m_lastUt1 = ut1Days;
+    m_lastPolarMotion = polarMotion;
+    m_hasLast = true;
+    return m_lastRotation;
+}
+
+Nutation FrameRotationCache::getNutation(double ttDays) {
+    // Interpolate between nodes n and n + 1 using n - 1 .. n + 2
+    double position = ttDays / NODE_SPACING;
+    int64_t node = static_cast<int64_t>(std::floor(position));
+    double u = position - static_cast<double>(node);
+
+    if (m_nodes.empty() || node - 1 < m_firstNode ||
+        node + 2 >= m_firstNode + static_cast<int64_t>(m_nodes.size())) {
+        // Centre the new window on the epoch so sweeps in either direction stay inside it
+        fillNodes(node - static_cast<int64_t>(NODE_WINDOW / 2));
+    }
+
+    const Nutation* nodes = &m_nodes[static_cast<size_t>(node - 1 - m_firstNode)];
+    return {interpolateCubic(nodes[0].longitude, nodes[1].longitude, nodes[2].longitude, nodes[3].longitude, u),
+            interpolateCubic(nodes[0].obliquity, nodes[1].obliquity, nodes[2].obliquity, nodes[3].obliquity, u)};
+}
+
+void FrameRotationCache::fillNodes(int64_t firstNode) {
+    // Keep the nodes already computed that fall inside the new window
+    std::vector<Nutation> nodes(NODE_WINDOW);
+    int64_t oldFirst = m_firstNode;
+    int64_t oldEnd = m_firstNode + static_cast<int64_t>(m_nodes.size());
+
+    for (size_t i = 0; i < NODE_WINDOW; i++) {
+        int64_t node = firstNode + static_cast<int64_t>(i);
+        if (node >= oldFirst && node < oldEnd) {
+            nodes[i] = m_nodes[static_cast<size_t>(node - oldFirst)];
+        } else {
+            nodes[i] = computeNutation(static_cast<double>(node) * NODE_SPACING);
+            m_seriesEvaluations++;
+        }
+    }
+
+    m_nodes.swap(nodes);
+    m_firstNode = firstNode;
+}
+
+void rotatePositions(const RotationMatrix& rotation, const float* __restrict x, const float* __restrict y,
+                     const float* __restrict z, float* __restrict outX, float* __restrict outY,
+                     float* __restrict outZ, size_t count) {
+    // Float coefficients keep the loop in single precision vectors
+    float m[3][3];
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            m[row][column] = static_cast<float>(rotation.m[row][column]);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        float px = x[i];
+        float py = y[i];
+        float pz = z[i];
+        outX[i] = m[0][0] * px + m[0][1] * py + m[0][2] * pz;
+        outY[i] = m[1][0] * px + m[1][1] * py + m[1][2] * pz;
+        outZ[i] = m[2][0] * px + m[2][1] * py + m[2][2] * pz;
+    }
+}
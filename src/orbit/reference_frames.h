@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Frames that catalog positions are exchanged in. Epochs are given as days since
+ * J2000.0 (JD 2451545.0) in two time scales: TT for the slowly varying
+ * precession-nutation, UT1 for Earth's rotation.
+ */
+enum class CoordinateFrame {
+    Teme,   // True equator, mean equinox of date, the output frame of SGP4
+    Gcrf,   // Geocentric celestial reference frame, quasi-inertial
+    Itrf    // International terrestrial reference frame, rotating with the Earth
+};
+
+/**
+ * 3x3 rotation, row-major; apply as out = m * in.
+ */
+struct RotationMatrix {
+    double m[3][3];
+};
+
+/**
+ * Pole coordinates from IERS bulletins, in radians.
+ */
+struct PolarMotion {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+/**
+ * Nutation in longitude and obliquity, in radians.
+ */
+struct Nutation {
+    double longitude;
+    double obliquity;
+};
+
+/**
+ * @return Product a * b
+ */
+RotationMatrix multiply(const RotationMatrix& a, const RotationMatrix& b);
+
+/**
+ * @return Transpose, i.e. the inverse rotation
+ */
+RotationMatrix transpose(const RotationMatrix& rotation);
+
+/**
+ * Gets the Earth rotation angle (IAU 2000), the angle between the celestial and
+ * terrestrial intermediate origins.
+ *
+ * @param ut1Days UT1 days since J2000.0
+ * @return Angle in radians, in [0, 2pi)
+ */
+double earthRotationAngle(double ut1Days);
+
+/**
+ * Evaluates the IAU 2000B nutation series (77 luni-solar terms plus a fixed planetary
+ * offset, within 1 mas of IAU 2000A). This is the expensive part of a frame rotation.
+ *
+ * @param ttDays TT days since J2000.0
+ * @return Nutation angles
+ */
+Nutation computeNutation(double ttDays);
+
+/**
+ * Builds the rotation between two frames from the full models: IAU 2006 precession,
+ * the nutation given, Greenwich apparent sidereal time and polar motion.
+ *
+ * @param from Frame of the input coordinates
+ * @param to Frame of the output coordinates
+ * @param ttDays TT days since J2000.0
+ * @param ut1Days UT1 days since J2000.0
+ * @param nutation Nutation at ttDays
+ * @param polarMotion Pole coordinates at the epoch
+ * @return Rotation taking from-coordinates to to-coordinates
+ */
+RotationMatrix frameRotation(CoordinateFrame from, CoordinateFrame to, double ttDays, double ut1Days,
+                             const Nutation& nutation, const PolarMotion& polarMotion = {});
+
+/**
+ * Builds the rotation between two frames, evaluating the nutation series for this epoch.
+ * Costs as much as FrameRotationCache::getRotation() plus a full series evaluation.
+ *
+ * @param from Frame of the input coordinates
+ * @param to Frame of the output coordinates
+ * @param ttDays TT days since J2000.0
+ * @param ut1Days UT1 days since J2000.0
+ * @param polarMotion Pole coordinates at the epoch
+ * @return Rotation taking from-coordinates to to-coordinates
+ */
+RotationMatrix frameRotation(CoordinateFrame from, CoordinateFrame to, double ttDays, double ut1Days,
+                             const PolarMotion& polarMotion = {});
+
+/**
+ * Frame rotations for runs of nearby epochs, e.g. the time steps of an ephemeris.
+ *
+ * Nutation is evaluated only at nodes on a coarse grid (NODE_SPACING days) and
+ * interpolated with cubic Lagrange polynomials; precession, sidereal time and polar
+ * motion are closed-form and evaluated exactly. Converting a catalog then costs one
+ * matrix per time step and a rotatePositions() pass, instead of a model evaluation
+ * per object. The nodes around the last requested epoch are kept, so sweeping forward
+ * or backward through time evaluates the series once per node.
+ */
+class FrameRotationCache {
+public:
+    // Node spacing in days; interpolation error stays around 1 microarcsecond
+    static constexpr double NODE_SPACING = 0.25;
+
+    // Nodes computed when an epoch falls outside the cached window
+    static constexpr size_t NODE_WINDOW = 16;
+
+    FrameRotationCache();
+
+    /**
+     * Gets the rotation between two frames, like frameRotation(). Repeated calls with
+     * the same arguments return the previous result.
+     *
+     * @param from Frame of the input coordinates
+     * @param to Frame of the output coordinates
+     * @param ttDays TT days since J2000.0
+     * @param ut1Days UT1 days since J2000.0
+     * @param polarMotion Pole coordinates at the epoch
+     * @return Rotation taking from-coordinates to to-coordinates
+     */
+    const RotationMatrix& getRotation(CoordinateFrame from, CoordinateFrame to, double ttDays, double ut1Days,
+                                      const PolarMotion& polarMotion = {});
+
+    /**
+     * Gets the nutation at an epoch, interpolated between cached nodes.
+     *
+     * @param ttDays TT days since J2000.0
+     * @return Nutation angles
+     */
+    Nutation getNutation(double ttDays);
+
+    /**
+     * Gets how many times the nutation series has been evaluated, for benchmarks.
+     *
+     * @return Evaluation count
+     */
+    uint64_t getSeriesEvaluations() const { return m_seriesEvaluations; }
+
+private:
+    void fillNodes(int64_t firstNode);
+
+    int64_t m_firstNode;
+    std::vector<Nutation> m_nodes;
+    uint64_t m_seriesEvaluations;
+
+    // Last result
+    bool m_hasLast;
+    CoordinateFrame m_lastFrom;
+    CoordinateFrame m_lastTo;
+    double m_lastTt;
+    double m_lastUt1;
+    PolarMotion m_lastPolarMotion;
+    RotationMatrix m_lastRotation;
+};
+
+/**
+ * Rotates a batch of positions (or velocities of a non-rotating frame pair) by one
+ * matrix. Output arrays must not alias inputs.
+ *
+ * @param rotation Rotation, e.g. from FrameRotationCache::getRotation()
+ * @param x Input x
+ * @param y Input y
+ * @param z Input z
+ * @param outX Output x
+ * @param outY Output y
+ * @param outZ Output z
+ * @param count Number of positions
+ */
+void rotatePositions(const RotationMatrix& rotation, const float* x, const float* y, const float* z,
+                     float* outX, float* outY, float* outZ, size_t count);
@@ -0,0 +1,309 @@
+#include "orbit/relative_motion.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * Chief frame shared by every deputy of a batch: axes as rows and the rotation rate.
+ */
+struct RelativeFrame {
+    double axes[3][3];
+    double rate;
+};
+
+RelativeFrame makeFrame(const double position[3], const double velocity[3]) {
+    RelativeFrame frame;
+    relativeFrameAxes(position, velocity, frame.axes[0], frame.axes[1], frame.axes[2]);
+    double h[3] = {position[1] * velocity[2] - position[2] * velocity[1],
+                   position[2] * velocity[0] - position[0] * velocity[2],
+                   position[0] * velocity[1] - position[1] * velocity[0]};
+    double r2 = position[0] * position[0] + position[1] * position[1] + position[2] * position[2];
+    frame.rate = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]) / r2;
+    return frame;
+}
+
+void runRanges(size_t count, ThreadPool* pool, const std::function<void(size_t, size_t)>& range) {
+    if (pool != nullptr) {
+        pool->parallelRanges(count, [&](size_t begin, size_t end, size_t) { range(begin, end); });
+    } else {
+        range(0, count);
+    }
+}
+
+double trueAnomaly(double meanAnomaly, double eccentricity) {
+    double M = std::remainder(meanAnomaly, 2.0 * 3.14159265358979323846);
+    double E = (eccentricity < 0.8) ? M : 3.14159265358979323846;
+    for (int iteration = 0; iteration < 30; iteration++) {
+        double delta = (E - eccentricity * std::sin(E) - M) / (1.0 - eccentricity * std::cos(E));
+        E -= delta;
+        if (std::abs(delta) < 1e-15) {
+            break;
+        }
+    }
+    // Keep the revolution count of the mean anomaly so theta - theta0 stays continuous
+    double theta = 2.0 * std::atan2(std::sqrt(1.0 + eccentricity) * std::sin(0.5 * E),
+                                    std::sqrt(1.0 - eccentricity) * std::cos(0.5 * E));
+    return theta + (meanAnomaly - M);
+}
+
+/**
+ * Fundamental solution of the Tschauner-Hempel equations in RIC axes: maps the six
+ * integration constants to the scaled state (x, y, z) (1 + e cos theta) and its
+ * derivatives with respect to true anomaly.
+ *
+ * @param e Eccentricity
+ * @param theta True anomaly
+ * @param J Integral of dtheta / (1 + e cos theta)^2 from the start, k^2 (t - t0)
+ * @param F Output matrix
+ */
+void fundamentalSolution(double e, double theta, double J, double F[6][6]) {
+    double sinT = std::sin(theta), cosT = std::cos(theta);
+    double rho = 1.0 + e * cosT;
+    double rhoPrime = -e * sinT;
+    double s = rho * sinT, c = rho * cosT;
+    double sPrime = cosT + e * (cosT * cosT - sinT * sinT);
+    double cPrime = -sinT - 2.0 * e * sinT * cosT;
+    double scale = 1.0 + 1.0 / rho;
+    double rho2 = rho * rho;
+
+    for (int row = 0; row < 6; row++) {
+        std::fill(F[row], F[row] + 6, 0.0);
+    }
+    F[0][1] = -s;
+    F[0][2] = -c;
+    F[0][3] = -(2.0 - 3.0 * e * s * J);
+    F[1][0] = 1.0;
+    F[1][1] = -c * scale;
+    F[1][2] = s * scale;
+    F[1][3] = 3.0 * rho2 * J;
+    F[2][4] = cosT;
+    F[2][5] = sinT;
+    F[3][1] = -sPrime;
+    F[3][2] = -cPrime;
+    F[3][3] = 3.0 * e * (sPrime * J + s / rho2);
+    F[4][1] = -cPrime * scale + c * rhoPrime / rho2;
+    F[4][2] = sPrime * scale - s * rhoPrime / rho2;
+    F[4][3] = 6.0 * rho * rhoPrime * J + 3.0;
+    F[5][4] = -sinT;
+    F[5][5] = cosT;
+}
+
+void invert(const double matrix[6][6], double inverse[6][6]) {
+    double a[6][12];
+    for (int row = 0; row < 6; row++) {
+        for (int column = 0; column < 6; column++) {
+            a[row][column] = matrix[row][column];
+            a[row][column + 6] = (row == column) ? 1.0 : 0.0;
+        }
+    }
+    for (int column = 0; column < 6; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < 6; row++) {
+            if (std::abs(a[row][column]) > std::abs(a[pivot][column])) {
+                pivot = row;
+            }
+        }
+        if (a[pivot][column] == 0.0) {
+            throw std::runtime_error("Failed to invert relative motion fundamental matrix!");
+        }
+        std::swap(a[pivot], a[column]);
+        double scale = 1.0 / a[column][column];
+        for (int k = 0; k < 12; k++) {
+            a[column][k] *= scale;
+        }
+        for (int row = 0; row < 6; row++) {
+            if (row != column) {
+                double factor = a[row][column];
+                for (int k = 0; k < 12; k++) {
+                    a[row][k] -= factor * a[column][k];
+                }
+            }
+        }
+    }
+    for (int row = 0; row < 6; row++) {
+        std::copy(a[row] + 6, a[row] + 12, inverse[row]);
+    }
+}
+
+void multiply(const double a[6][6], const double b[6][6], double product[6][6]) {
+    for (int row = 0; row < 6; row++) {
+        for (int column = 0; column < 6; column++) {
+            double sum = 0.0;
+            for (int k = 0; k < 6; k++) {
+                sum += a[row][k] * b[k][column];
+            }
+            product[row][column] = sum;
+        }
+    }
+}
+
+/**
+ * Matrix taking a physical RIC state to the scaled state and its true anomaly
+ * derivatives: q~ = rho q, q~' = rho' q + qdot / (k^2 rho).
+ */
+void scaledStateTransform(double e, double theta, double k2, bool inverse, double T[6][6]) {
+    double rho = 1.0 + e * std::cos(theta);
+    double rhoPrime = -e * std::sin(theta);
+    for (int row = 0; row < 6; row++) {
+        std::fill(T[row], T[row] + 6, 0.0);
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        if (!inverse) {
+            T[axis][axis] = rho;
+            T[axis + 3][axis] = rhoPrime;
+            T[axis + 3][axis + 3] = 1.0 / (k2 * rho);
+        } else {
+            T[axis][axis] = 1.0 / rho;
+            T[axis + 3][axis] = -k2 * rhoPrime;
+            T[axis + 3][axis + 3] = k2 * rho;
+        }
+    }
+}
+
+} // namespace
+
+void relativeFrameAxes(const double position[3], const double velocity[3], double radial[3], double inTrack[3],
+                       double crossTrack[3]) {
+    double h[3] = {position[1] * velocity[2] - position[2] * velocity[1],
+                   position[2] * velocity[0] - position[0] * velocity[2],
+                   position[0] * velocity[1] - position[1] * velocity[0]};
+    double r = std::sqrt(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+    double hNorm = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+    for (int k = 0; k < 3; k++) {
+        radial[k] = position[k] / r;
+        crossTrack[k] = h[k] / hNorm;
+    }
+    inTrack[0] = crossTrack[1] * radial[2] - crossTrack[2] * radial[1];
+    inTrack[1] = crossTrack[2] * radial[0] - crossTrack[0] * radial[2];
+    inTrack[2] = crossTrack[0] * radial[1] - crossTrack[1] * radial[0];
+}
+
+void inertialToRelative(const double chiefPosition[3], const double chiefVelocity[3],
+                        const CartesianStateBatch& deputies, const CartesianStateBatch& relative, ThreadPool* pool) {
+    const RelativeFrame frame = makeFrame(chiefPosition, chiefVelocity);
+    const double (&m)[3][3] = frame.axes;
+    const double w = frame.rate;
+    const double px = chiefPosition[0], py = chiefPosition[1], pz = chiefPosition[2];
+    const double vx = chiefVelocity[0], vy = chiefVelocity[1], vz = chiefVelocity[2];
+
+    runRanges(deputies.count, pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double dx = deputies.x[i] - px, dy = deputies.y[i] - py, dz = deputies.z[i] - pz;
+            double dvx = deputies.vx[i] - vx, dvy = deputies.vy[i] - vy, dvz = deputies.vz[i] - vz;
+            double rx = m[0][0] * dx + m[0][1] * dy + m[0][2] * dz;
+            double ry = m[1][0] * dx + m[1][1] * dy + m[1][2] * dz;
+            double rz = m[2][0] * dx + m[2][1] * dy + m[2][2] * dz;
+
+            // Remove the frame rotation: rate = R^T dv - omega x rho, omega along cross-track
+            relative.x[i] = rx;
+            relative.y[i] = ry;
+            relative.z[i] = rz;
+            relative.vx[i] = m[0][0] * dvx + m[0][1] * dvy + m[0][2] * dvz + w * ry;
+            relative.vy[i] = m[1][0] * dvx + m[1][1] * dvy + m[1][2] * dvz - w * rx;
+            relative.vz[i] = m[2][0] * dvx + m[2][1] * dvy + m[2][2] * dvz;
+        }
+    });
+}
+
+void relativeToInertial(const double chiefPosition[3], const double chiefVelocity[3],
+                        const CartesianStateBatch& relative, const CartesianStateBatch& deputies, ThreadPool* pool) {
+    const RelativeFrame frame = makeFrame(chiefPosition, chiefVelocity);
+    const double (&m)[3][3] = frame.axes;
+    const double w = frame.rate;
+    const double px = chiefPosition[0], py = chiefPosition[1], pz = chiefPosition[2];
+    const double vx = chiefVelocity[0], vy = chiefVelocity[1], vz = chiefVelocity[2];
+
+    runRanges(relative.count, pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double rx = relative.x[i], ry = relative.y[i], rz = relative.z[i];
+            double ux = relative.vx[i] - w * ry, uy = relative.vy[i] + w * rx, uz = relative.vz[i];
+            deputies.x[i] = px + m[0][0] * rx + m[1][0] * ry + m[2][0] * rz;
+            deputies.y[i] = py + m[0][1] * rx + m[1][1] * ry + m[2][1] * rz;
+            deputies.z[i] = pz + m[0][2] * rx + m[1][2] * ry + m[2][2] * rz;
+            deputies.vx[i] = vx + m[0][0] * ux + m[1][0] * uy + m[2][0] * uz;
+            deputies.vy[i] = vy + m[0][1] * ux + m[1][1] * uy + m[2][1] * uz;
+            deputies.vz[i] = vz + m[0][2] * ux + m[1][2] * uy + m[2][2] * uz;
+        }
+    });
+}
+
+void clohessyWiltshireTransition(double meanMotion, double dt, double transition[6][6]) {
+    const double n = meanMotion;
+    const double nt = n * dt;
+    const double s = std::sin(nt), c = std::cos(nt);
+    const double rows[6][6] = {
+        {4.0 - 3.0 * c, 0.0, 0.0, s / n, 2.0 * (1.0 - c) / n, 0.0},
+        {6.0 * (s - nt), 1.0, 0.0, -2.0 * (1.0 - c) / n, (4.0 * s - 3.0 * nt) / n, 0.0},
+        {0.0, 0.0, c, 0.0, 0.0, s / n},
+        {3.0 * n * s, 0.0, 0.0, c, 2.0 * s, 0.0},
+        {-6.0 * n * (1.0 - c), 0.0, 0.0, -2.0 * s, 4.0 * c - 3.0, 0.0},
+        {0.0, 0.0, -n * s, 0.0, 0.0, c}};
+    for (int row = 0; row < 6; row++) {
+        std::copy(rows[row], rows[row] + 6, transition[row]);
+    }
+}
+
+void yamanakaAnkersenTransition(const KeplerianElements& chief, double mu, double dt, double transition[6][6]) {
+    const double a = chief.semimajorAxis;
+    const double e = chief.eccentricity;
+    const double n = std::sqrt(mu / (a * a * a));
+    const double p = a * (1.0 - e * e);
+    const double k2 = std::sqrt(mu / (p * p * p));
+
+    const double theta0 = trueAnomaly(chief.meanAnomaly, e);
+    const double theta1 = trueAnomaly(chief.meanAnomaly + n * dt, e);
+
+    // Out of plane the scaled motion is harmonic in theta - theta0; in plane the
+    // secular term grows with J, so both ends use the fundamental solution started at
+    // theta0 with J = 0 there
+    double toScaled[6][6], fromScaled[6][6], start[6][6], startInverse[6][6], end[6][6];
+    scaledStateTransform(e, theta0, k2, false, toScaled);
+    scaledStateTransform(e, theta1, k2, true, fromScaled);
+    fundamentalSolution(e, theta0, 0.0, start);
+    fundamentalSolution(e, theta1, k2 * dt, end);
+    invert(start, startInverse);
+
+    double constants[6][6], scaled[6][6], propagated[6][6];
+    multiply(startInverse, toScaled, constants);
+    multiply(end, constants, scaled);
+    multiply(fromScaled, scaled, propagated);
+    for (int row = 0; row < 6; row++) {
+        std::copy(propagated[row], propagated[row] + 6, transition[row]);
+    }
+}
+
+void applyRelativeTransition(const double transition[6][6], const CartesianStateBatch& states, ThreadPool* pool) {
+    double m[6][6];
+    for (int row = 0; row < 6; row++) {
+        std::copy(transition[row], transition[row] + 6, m[row]);
+    }
+    double* const x = states.x;
+    double* const y = states.y;
+    double* const z = states.z;
+    double* const u = states.vx;
+    double* const v = states.vy;
+    double* const w = states.vz;
+
+    runRanges(states.count, pool, [&](size_t begin, size_t end) {
+        // Each deputy's six components are loaded before any is written, so the loop
+        // vectorizes across deputies with the matrix held in registers
+        for (size_t i = begin; i < end; i++) {
+            double s[6] = {x[i], y[i], z[i], u[i], v[i], w[i]};
+            double out[6];
+            for (int row = 0; row < 6; row++) {
+                out[row] = m[row][0] * s[0] + m[row][1] * s[1] + m[row][2] * s[2] + m[row][3] * s[3] +
+                           m[row][4] * s[4] + m[row][5] * s[5];
+            }
+            x[i] = out[0];
+            y[i] = out[1];
+            z[i] = out[2];
+            u[i] = out[3];
+            v[i] = out[4];
+            w[i] = out[5];
+        }
+    });
+}
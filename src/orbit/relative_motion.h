@@ -0,0 +1,85 @@
+#pragma once
+
+#include "orbit/cowell_propagator.h"
+#include "orbit/orbit_determination.h"
+#include <cstddef>
+
+class ThreadPool;
+
+/**
+ * Axes of a chief's RIC frame (also called Hill or LVLH): radial outward, in-track
+ * completing the right-handed set (along the velocity for circular orbits) and
+ * cross-track along the orbit normal.
+ *
+ * @param position Chief position
+ * @param velocity Chief velocity
+ * @param radial Output unit radial axis
+ * @param inTrack Output unit in-track axis
+ * @param crossTrack Output unit cross-track axis
+ */
+void relativeFrameAxes(const double position[3], const double velocity[3], double radial[3], double inTrack[3],
+                       double crossTrack[3]);
+
+/**
+ * Converts inertial states of many deputies to their states relative to a chief, in the
+ * chief's rotating RIC frame. Relative velocities are rates seen in the rotating frame,
+ * as the linearized propagators below expect: the frame turns at h / r^2 about the
+ * cross-track axis, exactly so for a two-body chief.
+ *
+ * @param chiefPosition Chief position
+ * @param chiefVelocity Chief velocity
+ * @param deputies Inertial states of the deputies
+ * @param relative Output relative states, same count; may not alias deputies
+ * @param pool Threads to spread deputies over, or nullptr
+ */
+void inertialToRelative(const double chiefPosition[3], const double chiefVelocity[3],
+                        const CartesianStateBatch& deputies, const CartesianStateBatch& relative,
+                        ThreadPool* pool = nullptr);
+
+/**
+ * Converts relative RIC states of many deputies back to inertial states; the inverse of
+ * inertialToRelative.
+ *
+ * @param chiefPosition Chief position
+ * @param chiefVelocity Chief velocity
+ * @param relative Relative states of the deputies
+ * @param deputies Output inertial states, same count; may not alias relative
+ * @param pool Threads to spread deputies over, or nullptr
+ */
+void relativeToInertial(const double chiefPosition[3], const double chiefVelocity[3],
+                        const CartesianStateBatch& relative, const CartesianStateBatch& deputies,
+                        ThreadPool* pool = nullptr);
+
+/**
+ * Gets the Clohessy-Wiltshire state transition matrix: closed-form linearized relative
+ * motion about a circular chief orbit.
+ *
+ * @param meanMotion Mean motion of the chief, rad/s
+ * @param dt Seconds to propagate; may be negative
+ * @param transition Output matrix taking RIC states at the start to states after dt
+ */
+void clohessyWiltshireTransition(double meanMotion, double dt, double transition[6][6]);
+
+/**
+ * Gets the Yamanaka-Ankersen state transition matrix: the closed-form solution of the
+ * Tschauner-Hempel equations, linearized relative motion about an elliptic chief orbit.
+ * Reduces to Clohessy-Wiltshire for a circular chief.
+ *
+ * @param chief Chief elements; the mean anomaly is at the start
+ * @param mu Gravitational parameter
+ * @param dt Seconds to propagate; may be negative
+ * @param transition Output matrix taking RIC states at the start to states after dt
+ */
+void yamanakaAnkersenTransition(const KeplerianElements& chief, double mu, double dt, double transition[6][6]);
+
+/**
+ * Applies a state transition matrix to many relative states. All deputies of one chief
+ * share the matrix, so it is built once per step and the batch costs one 6x6
+ * matrix-vector product per deputy over the structure-of-arrays state.
+ *
+ * @param transition State transition matrix
+ * @param states Relative states, replaced by the propagated states
+ * @param pool Threads to spread deputies over, or nullptr
+ */
+void applyRelativeTransition(const double transition[6][6], const CartesianStateBatch& states,
+                             ThreadPool* pool = nullptr);
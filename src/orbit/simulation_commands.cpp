@@ -0,0 +1,100 @@
+#include "orbit/simulation_commands.h"
+
+namespace {
+
+/**
+ * Gets the coalescing key of a command: commands with equal keys supersede each other.
+ */
+uint64_t commandKey(uint32_t objectId, SimulationCommandType type) {
+    return (static_cast<uint64_t>(objectId) << 32) | static_cast<uint32_t>(type);
+}
+
+} // namespace
+
+SimulationCommandQueue::SimulationCommandQueue(size_t capacity)
+    : m_queue(capacity), m_appliedCount(0), m_coalescedCount(0) {
+    m_pending.reserve(capacity);
+    m_superseded.reserve(capacity);
+}
+
+size_t SimulationCommandQueue::drain(OrbitalMechanics* const* objects, size_t objectCount) {
+    m_pending.clear();
+    SimulationCommand command;
+    while (m_queue.pop(command)) {
+        m_pending.push_back(command);
+    }
+    if (m_pending.empty()) {
+        return 0;
+    }
+
+    // Walk backwards so each command can see whether a later one replaces it
+    m_superseded.assign(m_pending.size(), 0);
+    m_laterKeys.clear();
+    for (size_t i = m_pending.size(); i-- > 0;) {
+        const SimulationCommand& pending = m_pending[i];
+        uint64_t key = commandKey(pending.objectId, pending.type);
+        uint64_t resetKey = commandKey(pending.objectId, SimulationCommandType::ResetOrbit);
+        if (m_laterKeys.count(key) != 0 || m_laterKeys.count(resetKey) != 0) {
+            m_superseded[i] = 1;
+        } else {
+            m_laterKeys.insert(key);
+        }
+    }
+
+    size_t applied = 0;
+    for (size_t i = 0; i < m_pending.size(); i++) {
+        if (m_superseded[i]) {
+            m_coalescedCount++;
+            continue;
+        }
+        if (m_pending[i].objectId >= objectCount || !objects[m_pending[i].objectId]) {
+            continue;
+        }
+        apply(m_pending[i], *objects[m_pending[i].objectId]);
+        applied++;
+    }
+
+    m_appliedCount += applied;
+    return applied;
+}
+
+void SimulationCommandQueue::apply(const SimulationCommand& command, OrbitalMechanics& object) {
+    switch (command.type) {
+        case SimulationCommandType::SetSemimajorAxis:
+            object.setSemimajorAxis(command.value);
+            break;
+        case SimulationCommandType::SetEccentricity:
+            object.setEccentricity(command.value);
+            break;
+        case SimulationCommandType::SetInclination:
+            object.setInclination(command.value);
+            break;
+        case SimulationCommandType::SetArgumentOfPeriapsis:
+            object.setArgumentOfPeriapsis(command.value);
+            break;
+        case SimulationCommandType::SetLongitudeOfAscendingNode:
+            object.setLongitudeOfAscendingNode(command.value);
+            break;
+        case SimulationCommandType::ResetOrbit:
+            object.setSemimajorAxis(12.0f);
+            object.setEccentricity(0.3f);
+            object.setInclination(30.0f);
+            object.setArgumentOfPeriapsis(0.0f);
+            object.setLongitudeOfAscendingNode(0.0f);
+            break;
+    }
+}
+
+OrbitSnapshot captureSnapshot(const OrbitalMechanics& object) {
+    OrbitSnapshot snapshot;
+    snapshot.semimajorAxis = object.getSemimajorAxis();
+    snapshot.eccentricity = object.getEccentricity();
+    snapshot.inclination = object.getInclination();
+    snapshot.argumentOfPeriapsis = object.getArgumentOfPeriapsis();
+    snapshot.longitudeOfAscendingNode = object.getLongitudeOfAscendingNode();
+    snapshot.period = object.getPeriod();
+    snapshot.position = object.getSatellitePosition();
+    snapshot.velocity = object.getSatelliteVelocity();
+    snapshot.attitude = object.getSatelliteAttitude();
+    return snapshot;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "orbit/orbital_mechanics.h"
+#include "platform/mpsc_queue.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Kind of change a SimulationCommand makes to a simulated object.
+ */
+enum class SimulationCommandType : uint32_t {
+    // Parameter changes, carrying the new value; a later change of the same parameter
+    // of the same object supersedes an earlier one
+    SetSemimajorAxis = 0,
+    SetEccentricity,
+    SetInclination,
+    SetArgumentOfPeriapsis,
+    SetLongitudeOfAscendingNode,
+
+    // Object edits; ResetOrbit supersedes every earlier command for its object
+    ResetOrbit
+};
+
+/**
+ * One change requested by the UI (or any other thread) for the simulation to apply.
+ */
+struct SimulationCommand {
+    SimulationCommandType type;
+    uint32_t objectId;      // index into the objects passed to SimulationCommandQueue::drain()
+    float value;            // new value of a parameter change, unused by object edits
+};
+
+/**
+ * Parameters and state of a simulated object as of the end of a tick. The simulation
+ * publishes one after each tick (see SeqLock) and the UI reads only that copy, so it
+ * never sees an object halfway through a drain or an update.
+ */
+struct OrbitSnapshot {
+    float semimajorAxis;
+    float eccentricity;
+    float inclination;              // degrees
+    float argumentOfPeriapsis;      // degrees
+    float longitudeOfAscendingNode; // degrees
+    float period;
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec4 attitude;             // quaternion, scalar last
+};
+
+/**
+ * Copies an object's parameters and current state. Only the simulation thread may
+ * call this.
+ *
+ * @param object Simulated object
+ * @return Snapshot
+ */
+OrbitSnapshot captureSnapshot(const OrbitalMechanics& object);
+
+/**
+ * Carries parameter changes from the UI to the simulation without sharing state.
+ *
+ * Any thread may push() commands; the simulation thread calls drain() at tick
+ * boundaries, so objects never change in the middle of a tick and the UI never
+ * waits for a tick to finish. Dragging a slider pushes a command every frame,
+ * and drain() coalesces those: only the last value of each parameter is applied.
+ */
+class SimulationCommandQueue {
+public:
+    /**
+     * @param capacity Commands that can be pending between two drains, a power of two
+     */
+    explicit SimulationCommandQueue(size_t capacity = 1024);
+
+    /**
+     * Queues a command. Safe to call from any thread.
+     *
+     * @param command Command
+     * @return False if the queue is full; the caller may retry after the next drain
+     */
+    bool push(const SimulationCommand& command) { return m_queue.push(command); }
+
+    /**
+     * Applies the pending commands to the objects, in push order, skipping commands
+     * superseded by later ones. Commands for unknown object IDs are dropped. Only the
+     * simulation thread may call this.
+     *
+     * @param objects Simulated objects, indexed by object ID
+     * @param objectCount Number of objects
+     * @return Number of commands applied
+     */
+    size_t drain(OrbitalMechanics* const* objects, size_t objectCount);
+
+    /**
+     * Gets the total number of commands applied by drain().
+     *
+     * @return Command count
+     */
+    uint64_t getAppliedCount() const { return m_appliedCount; }
+
+    /**
+     * Gets the total number of commands drain() skipped because a later one superseded them.
+     *
+     * @return Command count
+     */
+    uint64_t getCoalescedCount() const { return m_coalescedCount; }
+
+private:
+    static void apply(const SimulationCommand& command, OrbitalMechanics& object);
+
+    MpscQueue<SimulationCommand> m_queue;
+
+    // Consumer scratch, reused across drains
+    std::vector<SimulationCommand> m_pending;
+    std::vector<uint8_t> m_superseded;
+    std::unordered_set<uint64_t> m_laterKeys;
+
+    uint64_t m_appliedCount;
+    uint64_t m_coalescedCount;
+};
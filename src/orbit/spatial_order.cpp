@@ -0,0 +1,148 @@
+#include "orbit/spatial_order.h"
+#include "platform/thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Bits per axis of the Morton code
+constexpr uint32_t MORTON_BITS = 21;
+
+// Spreads the low 21 bits of v so that there are two zero bits between each
+uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v & 0x1FFFFF;
+    x = (x | (x << 32)) & 0x1F00000000FFFFull;
+    x = (x | (x << 16)) & 0x1F0000FF0000FFull;
+    x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+    x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+}
+
+// Maps a coordinate to [0, 2^21) over the bounding box, clamping rounding overshoot
+uint32_t quantize(float value, float low, float scale) {
+    float cell = std::min((value - low) * scale, static_cast<float>((1u << MORTON_BITS) - 1));
+    return static_cast<uint32_t>(std::max(cell, 0.0f));
+}
+
+// Moves elements as bytes: the arrays hold any type (floats go through the 4-byte
+// case), so typed access would break strict aliasing. A memcpy of a constant size
+// compiles to one load and one store.
+template <size_t SIZE>
+void gather(const void* source, void* destination, const uint32_t* permutation, size_t begin, size_t end) {
+    const unsigned char* from = static_cast<const unsigned char*>(source);
+    unsigned char* to = static_cast<unsigned char*>(destination);
+    for (size_t i = begin; i < end; i++) {
+        std::memcpy(to + i * SIZE, from + static_cast<size_t>(permutation[i]) * SIZE, SIZE);
+    }
+}
+
+} // namespace
+
+uint64_t mortonCode(uint32_t x, uint32_t y, uint32_t z) {
+    return spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+}
+
+ObjectOrder::ObjectOrder(size_t count)
+    : m_slotOfId(count),
+      m_idOfSlot(count) {
+    std::iota(m_slotOfId.begin(), m_slotOfId.end(), 0u);
+    std::iota(m_idOfSlot.begin(), m_idOfSlot.end(), 0u);
+}
+
+void ObjectOrder::sortByPosition(const float* x, const float* y, const float* z) {
+    size_t count = getCount();
+    if (count == 0) {
+        return;
+    }
+
+    float low[3] = {x[0], y[0], z[0]};
+    float high[3] = {x[0], y[0], z[0]};
+    for (size_t i = 1; i < count; i++) {
+        const float p[3] = {x[i], y[i], z[i]};
+        for (int axis = 0; axis < 3; axis++) {
+            low[axis] = std::min(low[axis], p[axis]);
+            high[axis] = std::max(high[axis], p[axis]);
+        }
+    }
+
+    // One scale for all axes keeps cells cubic
+    float extent = std::max({high[0] - low[0], high[1] - low[1], high[2] - low[2], 1e-30f});
+    float scale = static_cast<float>((1u << MORTON_BITS) - 1) / extent;
+
+    std::vector<uint64_t> keys(count);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = mortonCode(quantize(x[i], low[0], scale), quantize(y[i], low[1], scale),
+                             quantize(z[i], low[2], scale));
+    }
+
+    sortByKey(keys.data());
+}
+
+void ObjectOrder::sortByKey(const uint64_t* keys) {
+    m_permutation.resize(getCount());
+    std::iota(m_permutation.begin(), m_permutation.end(), 0u);
+    std::stable_sort(m_permutation.begin(), m_permutation.end(), [keys](uint32_t a, uint32_t b) {
+        return keys[a] < keys[b];
+    });
+}
+
+void ObjectOrder::apply(std::initializer_list<PerObjectArray> arrays, ThreadPool* pool) {
+    size_t count = getCount();
+    if (m_permutation.size() != count) {
+        throw std::runtime_error("Failed to reorder objects: no order computed!");
+    }
+
+    m_staging.resize(arrays.size());
+    for (size_t a = 0; a < arrays.size(); a++) {
+        m_staging[a].resize(count * arrays.begin()[a].elementSize);
+    }
+
+    const uint32_t* permutation = m_permutation.data();
+    auto gatherRange = [&](size_t begin, size_t end) {
+        for (size_t a = 0; a < arrays.size(); a++) {
+            const PerObjectArray& array = arrays.begin()[a];
+            void* staging = m_staging[a].data();
+            switch (array.elementSize) {
+                case 1: gather<1>(array.data, staging, permutation, begin, end); break;
+                case 2: gather<2>(array.data, staging, permutation, begin, end); break;
+                case 4: gather<4>(array.data, staging, permutation, begin, end); break;
+                case 8: gather<8>(array.data, staging, permutation, begin, end); break;
+                default:
+                    for (size_t i = begin; i < end; i++) {
+                        std::memcpy(static_cast<unsigned char*>(staging) + i * array.elementSize,
+                                    static_cast<const unsigned char*>(array.data) + permutation[i] * array.elementSize,
+                                    array.elementSize);
+                    }
+                    break;
+            }
+        }
+    };
+    auto copyBack = [&](size_t begin, size_t end) {
+        for (size_t a = 0; a < arrays.size(); a++) {
+            const PerObjectArray& array = arrays.begin()[a];
+            std::memcpy(static_cast<unsigned char*>(array.data) + begin * array.elementSize,
+                        m_staging[a].data() + begin * array.elementSize, (end - begin) * array.elementSize);
+        }
+    };
+
+    // Every array is gathered before any is written back, since gathers read anywhere
+    if (pool != nullptr) {
+        pool->parallelRanges(count, [&](size_t begin, size_t end, size_t) { gatherRange(begin, end); });
+        pool->parallelRanges(count, [&](size_t begin, size_t end, size_t) { copyBack(begin, end); });
+    } else {
+        gatherRange(0, count);
+        copyBack(0, count);
+    }
+
+    std::vector<uint32_t> idOfSlot(count);
+    for (size_t slot = 0; slot < count; slot++) {
+        idOfSlot[slot] = m_idOfSlot[permutation[slot]];
+        m_slotOfId[idOfSlot[slot]] = static_cast<uint32_t>(slot);
+    }
+    m_idOfSlot.swap(idOfSlot);
+    m_permutation.clear();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Interleaves the bits of three 21-bit coordinates into a 63-bit Morton (Z-order) code.
+ *
+ * @param x Quantized x, below 2^21
+ * @param y Quantized y, below 2^21
+ * @param z Quantized z, below 2^21
+ * @return Morton code
+ */
+uint64_t mortonCode(uint32_t x, uint32_t y, uint32_t z);
+
+/**
+ * One per-object array taking part in a reorder: element i belongs to the object in
+ * storage slot i.
+ */
+struct PerObjectArray {
+    void* data;
+    size_t elementSize;
+
+    template <typename T>
+    PerObjectArray(std::vector<T>& array) : data(array.data()), elementSize(sizeof(T)) {}
+
+    template <typename T>
+    PerObjectArray(T* array) : data(array), elementSize(sizeof(T)) {}
+};
+
+/**
+ * Storage order of a catalog's per-object arrays.
+ *
+ * Objects keep a stable external ID (their insertion index) while their storage slot
+ * changes: a periodic reorder sorts the slots along a space-filling curve so objects
+ * that are close in space are close in memory, which helps neighbour searches, culling
+ * and picking. getSlot() and getId() translate between the two.
+ */
+class ObjectOrder {
+public:
+    /**
+     * @param count Number of objects; initially slot == ID
+     */
+    explicit ObjectOrder(size_t count = 0);
+
+    /**
+     * Computes a storage order by Morton code of position, quantized over the bounding
+     * box of the current positions. Ties keep their current relative order.
+     *
+     * @param x Positions x, in storage order
+     * @param y Positions y, in storage order
+     * @param z Positions z, in storage order
+     */
+    void sortByPosition(const float* x, const float* y, const float* z);
+
+    /**
+     * Computes a storage order by arbitrary keys, e.g. an orbital plane or regime index.
+     * Ties keep their current relative order.
+     *
+     * @param keys One key per object, in storage order
+     */
+    void sortByKey(const uint64_t* keys);
+
+    /**
+     * Moves every per-object array into the order computed by the last sort, in one
+     * parallel pass over all arrays, and updates the ID mapping. Every array holding
+     * per-object data must be passed, or it falls out of step.
+     *
+     * @param arrays All per-object arrays, each getCount() elements long
+     * @param pool Threads to spread the copy over, or nullptr
+     */
+    void apply(std::initializer_list<PerObjectArray> arrays, ThreadPool* pool);
+
+    /**
+     * Gets the storage slot of an object.
+     *
+     * @param id External ID
+     * @return Current storage slot
+     */
+    uint32_t getSlot(uint32_t id) const { return m_slotOfId[id]; }
+
+    /**
+     * Gets the object stored in a slot.
+     *
+     * @param slot Storage slot
+     * @return External ID
+     */
+    uint32_t getId(uint32_t slot) const { return m_idOfSlot[slot]; }
+
+    size_t getCount() const { return m_idOfSlot.size(); }
+
+private:
+    std::vector<uint32_t> m_slotOfId;
+    std::vector<uint32_t> m_idOfSlot;
+
+    // Pending order from the last sort: new slot -> current slot
+    std::vector<uint32_t> m_permutation;
+
+    // Staging for apply(), kept between reorders
+    std::vector<std::vector<unsigned char>> m_staging;
+};
@@ -0,0 +1,325 @@
+#include "orbit/time_scales.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// TT - TAI, exact by definition
+constexpr int64_t TT_MINUS_TAI = 32184000000;
+
+// Days from 1970-01-01 to 2000-01-01
+constexpr int64_t UNIX_DAYS_AT_J2000 = 10957;
+
+constexpr double ARCSECONDS = 3.14159265358979323846 / (180.0 * 3600.0);
+
+// TAI - UTC since 1972 (earlier, UTC ran at a different rate and is not modelled)
+constexpr struct {
+    int year;
+    int month;
+    int offset;
+} BUILT_IN_LEAP_SECONDS[] = {
+    {1972, 1, 10}, {1972, 7, 11}, {1973, 1, 12}, {1974, 1, 13}, {1975, 1, 14}, {1976, 1, 15},
+    {1977, 1, 16}, {1978, 1, 17}, {1979, 1, 18}, {1980, 1, 19}, {1981, 7, 20}, {1982, 7, 21},
+    {1983, 7, 22}, {1985, 7, 23}, {1988, 1, 24}, {1990, 1, 25}, {1991, 1, 26}, {1992, 7, 27},
+    {1993, 7, 28}, {1994, 7, 29}, {1996, 1, 30}, {1997, 7, 31}, {1999, 1, 32}, {2006, 1, 33},
+    {2009, 1, 34}, {2012, 7, 35}, {2015, 7, 36}, {2017, 1, 37},
+};
+
+/**
+ * Days from 1970-01-01 to a Gregorian date (H. Hinnant's days_from_civil).
+ */
+int64_t daysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= (month <= 2) ? 1 : 0;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Parses a fixed-width field of a line (1-based inclusive columns, as in IERS readmes).
+ *
+ * @return False if the field is missing, blank or not a number
+ */
+bool parseColumns(const std::string& line, size_t first, size_t last, double& value) {
+    if (line.size() < last) {
+        return false;
+    }
+    std::string field = line.substr(first - 1, last - first + 1);
+    char* end = nullptr;
+    value = std::strtod(field.c_str(), &end);
+    return end != field.c_str();
+}
+
+} // namespace
+
+Epoch epochFromCalendar(int year, int month, int day, int hour, int minute, double second) {
+    int64_t days = daysFromCivil(year, month, day) - UNIX_DAYS_AT_J2000;
+    int64_t seconds = days * 86400 + hour * 3600 + minute * 60 - 43200;
+    return seconds * NANOSECONDS_PER_SECOND + std::llround(second * 1e9);
+}
+
+Epoch epochFromUnixSeconds(double unixSeconds) {
+    // Split whole seconds off first so the fraction keeps nanosecond resolution
+    double wholeSeconds = std::floor(unixSeconds);
+    int64_t seconds = static_cast<int64_t>(wholeSeconds) - (UNIX_DAYS_AT_J2000 * 86400 + 43200);
+    return seconds * NANOSECONDS_PER_SECOND + std::llround((unixSeconds - wholeSeconds) * 1e9);
+}
+
+Epoch epochFromModifiedJulianDate(double modifiedJulianDate) {
+    double wholeDays = std::floor(modifiedJulianDate);
+    int64_t days = static_cast<int64_t>(wholeDays) - 51544;
+    return days * NANOSECONDS_PER_DAY - NANOSECONDS_PER_DAY / 2 +
+           std::llround((modifiedJulianDate - wholeDays) * 86400e9);
+}
+
+TimeScales::TimeScales() {
+    std::vector<LeapSecond> leapSeconds;
+    for (const auto& entry : BUILT_IN_LEAP_SECONDS) {
+        leapSeconds.push_back({epochFromCalendar(entry.year, entry.month, 1), entry.offset * NANOSECONDS_PER_SECOND});
+    }
+    setLeapSeconds(leapSeconds);
+}
+
+void TimeScales::loadLeapSeconds(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open leap second file: " + path);
+    }
+
+    std::vector<LeapSecond> leapSeconds;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line);
+        double modifiedJulianDate;
+        int day, month, year;
+        double offset;
+        if (!(fields >> modifiedJulianDate >> day >> month >> year >> offset)) {
+            throw std::runtime_error("Failed to parse leap second file: " + path);
+        }
+        leapSeconds.push_back({epochFromModifiedJulianDate(modifiedJulianDate),
+                               std::llround(offset * 1e9)});
+    }
+
+    if (leapSeconds.empty()) {
+        throw std::runtime_error("Failed to parse leap second file: " + path);
+    }
+    setLeapSeconds(leapSeconds);
+}
+
+void TimeScales::loadEarthOrientation(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open Earth orientation file: " + path);
+    }
+
+    // finals2000A columns: MJD 8-15, PM-x 19-27 and PM-y 38-46 (arcseconds), UT1-UTC 59-68 (seconds).
+    // Days beyond the predictions have blank fields and end the usable table.
+    std::vector<EarthOrientation> records;
+    std::string line;
+    while (std::getline(file, line)) {
+        double modifiedJulianDate, polarX, polarY, ut1MinusUtc;
+        if (!parseColumns(line, 8, 15, modifiedJulianDate) || !parseColumns(line, 59, 68, ut1MinusUtc)) {
+            continue;
+        }
+        if (!parseColumns(line, 19, 27, polarX) || !parseColumns(line, 38, 46, polarY)) {
+            polarX = 0.0;
+            polarY = 0.0;
+        }
+        records.push_back({epochFromModifiedJulianDate(modifiedJulianDate), ut1MinusUtc,
+                           {polarX * ARCSECONDS, polarY * ARCSECONDS}});
+    }
+
+    if (records.empty()) {
+        throw std::runtime_error("Failed to parse Earth orientation file: " + path);
+    }
+    setEarthOrientation(records);
+}
+
+void TimeScales::setLeapSeconds(const std::vector<LeapSecond>& leapSeconds) {
+    if (leapSeconds.empty()) {
+        throw std::runtime_error("Failed to set leap seconds: the table is empty!");
+    }
+
+    m_leapSeconds.clear();
+    for (const LeapSecond& leapSecond : leapSeconds) {
+        m_leapSeconds.push_back({leapSecond.utcStart, leapSecond.utcStart + leapSecond.offset, leapSecond.offset});
+    }
+    std::sort(m_leapSeconds.begin(), m_leapSeconds.end(), [](const LeapSegment& a, const LeapSegment& b) {
+        return a.utcStart < b.utcStart;
+    });
+}
+
+void TimeScales::setEarthOrientation(const std::vector<EarthOrientation>& records) {
+    std::vector<EarthOrientation> sorted = records;
+    std::sort(sorted.begin(), sorted.end(), [](const EarthOrientation& a, const EarthOrientation& b) {
+        return a.utc < b.utc;
+    });
+
+    m_earthOrientation.clear();
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const EarthOrientation& record = sorted[i];
+        OrientationSegment segment = {record.utc, record.ut1MinusUtc, 0.0, record.polarMotion.x, 0.0,
+                                      record.polarMotion.y, 0.0};
+
+        // The last record is held constant
+        if (i + 1 < sorted.size()) {
+            const EarthOrientation& next = sorted[i + 1];
+            double span = static_cast<double>(next.utc - record.utc);
+            double ut1Step = next.ut1MinusUtc - record.ut1MinusUtc;
+
+            // A leap second inside the interval shows up as a 1 s jump in UT1 - UTC; it
+            // happens at the end of the day, so interpolate without it
+            ut1Step -= std::round(ut1Step);
+            segment.ut1Rate = ut1Step / span;
+            segment.polarXRate = (next.polarMotion.x - record.polarMotion.x) / span;
+            segment.polarYRate = (next.polarMotion.y - record.polarMotion.y) / span;
+        }
+        m_earthOrientation.push_back(segment);
+    }
+}
+
+size_t TimeScales::findLeapSegment(Epoch epoch, bool tai, size_t hint) const {
+    auto start = [tai](const LeapSegment& segment) { return tai ? segment.taiStart : segment.utcStart; };
+
+    // Same or next segment as the previous epoch of a batch
+    size_t count = m_leapSeconds.size();
+    if (hint < count && start(m_leapSeconds[hint]) <= epoch) {
+        if (hint + 1 == count || epoch < start(m_leapSeconds[hint + 1])) {
+            return hint;
+        }
+        if (hint + 2 == count || epoch < start(m_leapSeconds[hint + 2])) {
+            return hint + 1;
+        }
+    }
+
+    // Last segment starting at or before the epoch; epochs before the table use the first
+    auto next = std::upper_bound(m_leapSeconds.begin(), m_leapSeconds.end(), epoch,
+                                 [&start](Epoch value, const LeapSegment& segment) { return value < start(segment); });
+    return (next == m_leapSeconds.begin()) ? 0 : static_cast<size_t>(next - m_leapSeconds.begin()) - 1;
+}
+
+size_t TimeScales::findOrientationSegment(Epoch utc, size_t hint) const {
+    size_t count = m_earthOrientation.size();
+    if (hint < count && m_earthOrientation[hint].utcStart <= utc &&
+        (hint + 1 == count || utc < m_earthOrientation[hint + 1].utcStart)) {
+        return hint;
+    }
+    if (hint + 1 < count && m_earthOrientation[hint + 1].utcStart <= utc &&
+        (hint + 2 == count || utc < m_earthOrientation[hint + 2].utcStart)) {
+        return hint + 1;
+    }
+
+    auto next = std::upper_bound(m_earthOrientation.begin(), m_earthOrientation.end(), utc,
+                                 [](Epoch value, const OrientationSegment& segment) { return value < segment.utcStart; });
+    return (next == m_earthOrientation.begin()) ? 0 : static_cast<size_t>(next - m_earthOrientation.begin()) - 1;
+}
+
+double TimeScales::ut1MinusUtc(Epoch utc, size_t& hint) const {
+    if (m_earthOrientation.empty()) {
+        return 0.0;
+    }
+    hint = findOrientationSegment(utc, hint);
+    const OrientationSegment& segment = m_earthOrientation[hint];
+
+    // Held constant before the table as well as after it
+    double elapsed = static_cast<double>(std::max<Epoch>(utc - segment.utcStart, 0));
+    return segment.ut1MinusUtc + segment.ut1Rate * elapsed;
+}
+
+Epoch TimeScales::toTai(Epoch epoch, TimeScale from, size_t& leapHint, size_t& orientationHint) const {
+    switch (from) {
+        case TimeScale::Tai:
+            return epoch;
+        case TimeScale::Tt:
+            return epoch - TT_MINUS_TAI;
+        case TimeScale::Utc:
+            leapHint = findLeapSegment(epoch, false, leapHint);
+            return epoch + m_leapSeconds[leapHint].offset;
+        case TimeScale::Ut1: {
+            // UTC = UT1 - dUT1(UTC); dUT1 changes by milliseconds per day, so evaluating
+            // it at UT1 and correcting once is exact to well below a nanosecond
+            double offset = ut1MinusUtc(epoch, orientationHint);
+            Epoch utc = epoch - std::llround(offset * 1e9);
+            offset = ut1MinusUtc(utc, orientationHint);
+            utc = epoch - std::llround(offset * 1e9);
+            leapHint = findLeapSegment(utc, false, leapHint);
+            return utc + m_leapSeconds[leapHint].offset;
+        }
+    }
+    return epoch;
+}
+
+Epoch TimeScales::fromTai(Epoch tai, TimeScale to, size_t& leapHint, size_t& orientationHint) const {
+    switch (to) {
+        case TimeScale::Tai:
+            return tai;
+        case TimeScale::Tt:
+            return tai + TT_MINUS_TAI;
+        case TimeScale::Utc:
+            leapHint = findLeapSegment(tai, true, leapHint);
+            return tai - m_leapSeconds[leapHint].offset;
+        case TimeScale::Ut1: {
+            leapHint = findLeapSegment(tai, true, leapHint);
+            Epoch utc = tai - m_leapSeconds[leapHint].offset;
+            return utc + std::llround(ut1MinusUtc(utc, orientationHint) * 1e9);
+        }
+    }
+    return tai;
+}
+
+Epoch TimeScales::convert(Epoch epoch, TimeScale from, TimeScale to) const {
+    Epoch converted;
+    convert(&epoch, &converted, 1, from, to);
+    return converted;
+}
+
+void TimeScales::convert(const Epoch* epochs, Epoch* converted, size_t count, TimeScale from, TimeScale to) const {
+    if (from == to) {
+        std::copy(epochs, epochs + count, converted);
+        return;
+    }
+
+    // TT and TAI differ by a constant, which needs no lookups
+    if ((from == TimeScale::Tai || from == TimeScale::Tt) && (to == TimeScale::Tai || to == TimeScale::Tt)) {
+        int64_t offset = (to == TimeScale::Tt) ? TT_MINUS_TAI : -TT_MINUS_TAI;
+        for (size_t i = 0; i < count; i++) {
+            converted[i] = epochs[i] + offset;
+        }
+        return;
+    }
+
+    // Hints carry the segments of the previous epoch to the next one
+    size_t leapHints[2] = {0, 0};
+    size_t orientationHints[2] = {0, 0};
+    for (size_t i = 0; i < count; i++) {
+        Epoch tai = toTai(epochs[i], from, leapHints[0], orientationHints[0]);
+        converted[i] = fromTai(tai, to, leapHints[1], orientationHints[1]);
+    }
+}
+
+int64_t TimeScales::getTaiMinusUtc(Epoch utc) const {
+    return m_leapSeconds[findLeapSegment(utc, false, 0)].offset;
+}
+
+double TimeScales::getUt1MinusUtc(Epoch utc) const {
+    size_t hint = 0;
+    return ut1MinusUtc(utc, hint);
+}
+
+PolarMotion TimeScales::getPolarMotion(Epoch utc) const {
+    if (m_earthOrientation.empty()) {
+        return {};
+    }
+    const OrientationSegment& segment = m_earthOrientation[findOrientationSegment(utc, 0)];
+    double elapsed = static_cast<double>(std::max<Epoch>(utc - segment.utcStart, 0));
+    return {segment.polarX + segment.polarXRate * elapsed, segment.polarY + segment.polarYRate * elapsed};
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "orbit/reference_frames.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Time scales an epoch can be expressed in.
+ */
+enum class TimeScale {
+    Utc,    // Civil time, TAI minus a whole number of leap seconds
+    Tai,    // International atomic time
+    Tt,     // Terrestrial time, TAI + 32.184 s; the argument of precession-nutation
+    Ut1     // Earth rotation time, UTC + dUT1 from IERS bulletins
+};
+
+/**
+ * Epochs are signed nanoseconds since J2000.0 (2000-01-01 12:00:00) counted in one
+ * time scale, which covers 1708 to 2292 exactly. In UTC the count skips leap seconds,
+ * like POSIX time, so 23:59:60 is not representable and shares its count with the
+ * following second.
+ */
+using Epoch = int64_t;
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+constexpr int64_t NANOSECONDS_PER_DAY = 86400 * NANOSECONDS_PER_SECOND;
+
+/**
+ * Converts calendar date and time to an epoch, in whatever scale the date is read in.
+ *
+ * @param year Gregorian year
+ * @param month Month, 1 to 12
+ * @param day Day of the month
+ * @param hour Hour
+ * @param minute Minute
+ * @param second Seconds, may be fractional
+ * @return Nanoseconds since J2000.0
+ */
+Epoch epochFromCalendar(int year, int month, int day, int hour = 0, int minute = 0, double second = 0.0);
+
+/**
+ * Converts POSIX time (e.g. from the system clock) to a UTC epoch.
+ *
+ * @param unixSeconds Seconds since 1970-01-01 00:00:00 UTC, without leap seconds
+ * @return UTC nanoseconds since J2000.0
+ */
+Epoch epochFromUnixSeconds(double unixSeconds);
+
+/**
+ * Converts a modified Julian date to an epoch in the same scale.
+ *
+ * @param modifiedJulianDate MJD, where J2000.0 is 51544.5
+ * @return Nanoseconds since J2000.0
+ */
+Epoch epochFromModifiedJulianDate(double modifiedJulianDate);
+
+/**
+ * Gets an epoch as days since J2000.0, the argument of the reference frame functions.
+ * Keeps better than a microsecond of precision within a few centuries of J2000.
+ *
+ * @param epoch Nanoseconds since J2000.0
+ * @return Days since J2000.0 in the same scale
+ */
+inline double epochDays(Epoch epoch) {
+    // Whole days are converted exactly, only the remainder is rounded
+    return static_cast<double>(epoch / NANOSECONDS_PER_DAY) +
+           static_cast<double>(epoch % NANOSECONDS_PER_DAY) / static_cast<double>(NANOSECONDS_PER_DAY);
+}
+
+/**
+ * Leap second and Earth orientation tables, with conversions between time scales.
+ *
+ * Both tables are sorted arrays of segments with everything a conversion needs
+ * precomputed: a leap second segment holds its start in UTC and in TAI and the
+ * offset, an Earth orientation segment holds the linear interpolation of dUT1 and
+ * polar motion to the next daily value. Converting an epoch is a segment lookup and
+ * an add (or one multiply-add for UT1). The batch conversion remembers the segment
+ * of the previous epoch, so a time-ordered batch, such as the epochs of an ephemeris,
+ * only steps to the next segment when it crosses a boundary.
+ *
+ * The leap seconds known up to 2017 are built in; load an IERS file to extend them.
+ * Without Earth orientation data, dUT1 and polar motion are zero.
+ */
+class TimeScales {
+public:
+    /**
+     * One step of TAI - UTC.
+     */
+    struct LeapSecond {
+        Epoch utcStart;         // first UTC epoch with this offset
+        int64_t offset;         // TAI - UTC in nanoseconds
+    };
+
+    /**
+     * Earth orientation parameters at one epoch.
+     */
+    struct EarthOrientation {
+        Epoch utc;
+        double ut1MinusUtc;     // seconds
+        PolarMotion polarMotion;
+    };
+
+    TimeScales();
+
+    /**
+     * Loads leap seconds from an IERS Leap_Second.dat file: comment lines starting with
+     * '#', then "MJD day month year TAI-UTC" per line. Replaces the current table.
+     *
+     * @param path File path
+     */
+    void loadLeapSeconds(const std::string& path);
+
+    /**
+     * Loads dUT1 and polar motion from an IERS finals2000A file (Bulletin A columns,
+     * daily values including predictions). Replaces the current table.
+     *
+     * @param path File path
+     */
+    void loadEarthOrientation(const std::string& path);
+
+    /**
+     * Replaces the leap second table, which must not be empty.
+     *
+     * @param leapSeconds Steps of TAI - UTC, in increasing UTC order
+     */
+    void setLeapSeconds(const std::vector<LeapSecond>& leapSeconds);
+
+    /**
+     * Replaces the Earth orientation table.
+     *
+     * @param records Parameters at increasing UTC epochs
+     */
+    void setEarthOrientation(const std::vector<EarthOrientation>& records);
+
+    /**
+     * Converts one epoch between scales.
+     *
+     * @param epoch Epoch in the from scale
+     * @param from Scale of the input
+     * @param to Scale of the output
+     * @return Epoch in the to scale
+     */
+    Epoch convert(Epoch epoch, TimeScale from, TimeScale to) const;
+
+    /**
+     * Converts a batch of epochs between scales. Fastest when the epochs are in time order.
+     *
+     * @param epochs Epochs in the from scale
+     * @param converted Output epochs in the to scale; may be the same array as epochs
+     * @param count Number of epochs
+     * @param from Scale of the inputs
+     * @param to Scale of the outputs
+     */
+    void convert(const Epoch* epochs, Epoch* converted, size_t count, TimeScale from, TimeScale to) const;
+
+    /**
+     * Gets TAI - UTC at a UTC epoch.
+     *
+     * @param utc UTC epoch
+     * @return Offset in nanoseconds
+     */
+    int64_t getTaiMinusUtc(Epoch utc) const;
+
+    /**
+     * Gets UT1 - UTC at a UTC epoch, interpolated linearly between daily values and held
+     * constant beyond the table.
+     *
+     * @param utc UTC epoch
+     * @return Offset in seconds
+     */
+    double getUt1MinusUtc(Epoch utc) const;
+
+    /**
+     * Gets the pole coordinates at a UTC epoch, interpolated like getUt1MinusUtc().
+     *
+     * @param utc UTC epoch
+     * @return Polar motion for frameRotation()
+     */
+    PolarMotion getPolarMotion(Epoch utc) const;
+
+    /**
+     * Gets the number of leap second steps in the table.
+     *
+     * @return Step count
+     */
+    size_t getLeapSecondCount() const { return m_leapSeconds.size(); }
+
+    /**
+     * Gets the number of daily Earth orientation values in the table.
+     *
+     * @return Record count
+     */
+    size_t getEarthOrientationCount() const { return m_earthOrientation.size(); }
+
+private:
+    struct LeapSegment {
+        Epoch utcStart;
+        Epoch taiStart;
+        int64_t offset;
+    };
+
+    struct OrientationSegment {
+        Epoch utcStart;
+        double ut1MinusUtc;     // at utcStart, seconds
+        double ut1Rate;         // seconds per nanosecond until the next segment
+        double polarX;
+        double polarXRate;
+        double polarY;
+        double polarYRate;
+    };
+
+    // Segment containing an epoch, starting the search at a hint
+    size_t findLeapSegment(Epoch epoch, bool tai, size_t hint) const;
+    size_t findOrientationSegment(Epoch utc, size_t hint) const;
+
+    // Conversions through TAI, the hub scale
+    Epoch toTai(Epoch epoch, TimeScale from, size_t& leapHint, size_t& orientationHint) const;
+    Epoch fromTai(Epoch tai, TimeScale to, size_t& leapHint, size_t& orientationHint) const;
+    double ut1MinusUtc(Epoch utc, size_t& hint) const;
+
+    std::vector<LeapSegment> m_leapSeconds;
+    std::vector<OrientationSegment> m_earthOrientation;
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>
+#include <math.h>
+
+/**
+ * Branch-free elementary functions for the orbit kernels, in float and double.
+ *
+ * Unlike libm calls, these inline into the caller, so loops over arrays that use
+ * them auto-vectorize; called once they are ordinary scalar functions. Every
+ * branch is a select and the range reduction uses plain arithmetic.
+ *
+ * Accuracy, measured against a higher-precision reference by OrbitMathBench
+ * (ULP = unit in the last place of the result type):
+ *
+ *   function   float                        double
+ *   sincos     <= 2.5 ULP, |x| <= 4096      <= 2 ULP, |x| <= 1e6
+ *   atan2      <= 3.5 ULP                   <= 3 ULP
+ *   rsqrt      <= 1.5 ULP                   <= 1.5 ULP
+ *
+ * Outside the stated sincos ranges the error grows with |x| (the reduction loses
+ * bits) but stays bounded by 1 in magnitude. Infinite and NaN inputs are not
+ * handled specially. Functions have internal linkage so that copies compiled with
+ * different instruction set flags (see orbit_kernels_impl.h) never get merged.
+ */
+
+#if defined(_MSC_VER)
+#define VMATH_INLINE static __forceinline
+#else
+#define VMATH_INLINE static inline __attribute__((always_inline))
+#endif
+
+namespace vmath {
+
+template <typename T> struct Constants;
+
+template <> struct Constants<float> {
+    static constexpr float TWO_OVER_PI = 0.636619772367581f;
+    // pi/2 split in four parts; q times each of the first three is exact for |q| < 2^12 (|x| < 6400)
+    static constexpr float PIO2_A = 1.5703125f;
+    static constexpr float PIO2_B = 4.8351287841796875e-4f;
+    static constexpr float PIO2_C = 3.13855707645416259765625e-7f;
+    static constexpr float PIO2_D = 6.07710050650619224932e-11f;
+    static constexpr float PI = 3.14159265358979f;
+    static constexpr float PI_2 = 1.57079632679490f;
+    static constexpr float PI_4 = 0.785398163397448f;
+    static constexpr float TAN_PI_8 = 0.414213562373095f;
+    // Adding and subtracting this rounds to the nearest integer (|x| < 2^22)
+    static constexpr float ROUNDER = 12582912.0f;
+};
+
+template <> struct Constants<double> {
+    static constexpr double TWO_OVER_PI = 0.63661977236758134308;
+    // pi/2 split in three parts
+    static constexpr double PIO2_A = 1.57079625129699707031;
+    static constexpr double PIO2_B = 7.54978941586159635335e-8;
+    static constexpr double PIO2_C = 5.39030285815811905290e-15;
+    static constexpr double PI = 3.14159265358979323846;
+    static constexpr double PI_2 = 1.57079632679489661923;
+    static constexpr double PI_4 = 0.78539816339744830962;
+    static constexpr double TAN_PI_8 = 0.41421356237309504880;
+    static constexpr double ROUNDER = 6755399441055744.0;
+};
+
+VMATH_INLINE float absolute(float x) { return fabsf(x); }
+VMATH_INLINE double absolute(double x) { return fabs(x); }
+
+/**
+ * Cody-Waite reduction: x - q pi/2 with the extra precision of the split constants.
+ */
+VMATH_INLINE float reduceQuadrant(float x, float q) {
+    using K = Constants<float>;
+    float r = x - q * K::PIO2_A;
+    r = r - q * K::PIO2_B;
+    r = r - q * K::PIO2_C;
+    return r - q * K::PIO2_D;
+}
+
+VMATH_INLINE double reduceQuadrant(double x, double q) {
+    using K = Constants<double>;
+    double r = x - q * K::PIO2_A;
+    r = r - q * K::PIO2_B;
+    return r - q * K::PIO2_C;
+}
+
+/**
+ * Sine and cosine polynomials on [-pi/4, pi/4].
+ */
+VMATH_INLINE float sinPoly(float r, float z) {
+    return r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+}
+
+VMATH_INLINE float cosPoly(float z) {
+    return 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+}
+
+VMATH_INLINE double sinPoly(double r, double z) {
+    double p = 1.58962301576546568060e-10;
+    p = p * z - 2.50507477628578072866e-8;
+    p = p * z + 2.75573136213857245213e-6;
+    p = p * z - 1.98412698295895385996e-4;
+    p = p * z + 8.33333333332211858878e-3;
+    p = p * z - 1.66666666666666307295e-1;
+    return r + r * z * p;
+}
+
+VMATH_INLINE double cosPoly(double z) {
+    double p = -1.13585365213876817300e-11;
+    p = p * z + 2.08757008419747316778e-9;
+    p = p * z - 2.75573141792967388112e-7;
+    p = p * z + 2.48015872888517045348e-5;
+    p = p * z - 1.38888888888730564116e-3;
+    p = p * z + 4.16666666666665929218e-2;
+    return 1.0 - 0.5 * z + z * z * p;
+}
+
+/**
+ * Computes sine and cosine of the same angle.
+ *
+ * @param x Angle in radians
+ * @param s Output sine
+ * @param c Output cosine
+ */
+template <typename T>
+VMATH_INLINE void sincos(T x, T& s, T& c) {
+    using K = Constants<T>;
+
+    // Reduce to r in [-pi/4, pi/4] and quadrant q: x = q pi/2 + r
+    T q = (x * K::TWO_OVER_PI + K::ROUNDER) - K::ROUNDER;
+    T r = reduceQuadrant(x, q);
+    int32_t quadrant = static_cast<int32_t>(q);
+
+    T z = r * r;
+    T sr = sinPoly(r, z);
+    T cr = cosPoly(z);
+
+    // Quadrant 1 and 3 swap sine and cosine; 1, 2 negate the sine; 2, 3 negate the cosine
+    bool swap = (quadrant & 1) != 0;
+    T sinValue = swap ? cr : sr;
+    T cosValue = swap ? sr : cr;
+    s = ((quadrant + 0) & 2) ? -sinValue : sinValue;
+    c = ((quadrant + 1) & 2) ? -cosValue : cosValue;
+}
+
+/**
+ * Arctangent on [-tan(pi/8), tan(pi/8)].
+ */
+VMATH_INLINE float atanPoly(float t) {
+    float z = t * t;
+    return t + t * z * (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f);
+}
+
+VMATH_INLINE double atanPoly(double t) {
+    double z = t * t;
+    double p = -8.750608600031904122785e-1;
+    p = p * z - 1.615753718733365076637e1;
+    p = p * z - 7.500855792314704667340e1;
+    p = p * z - 1.228866684490136173410e2;
+    p = p * z - 6.485021904942025371773e1;
+    double q = z + 2.485846490142306297962e1;
+    q = q * z + 1.650270098316988542046e2;
+    q = q * z + 4.328810604912902668951e2;
+    q = q * z + 4.853903996359136964868e2;
+    q = q * z + 1.945506571482613964425e2;
+    return t + t * z * p / q;
+}
+
+/**
+ * Four-quadrant arctangent of y / x, like std::atan2 (returns 0 for x = y = 0).
+ *
+ * @param y Y coordinate
+ * @param x X coordinate
+ * @return Angle in [-pi, pi]
+ */
+template <typename T>
+VMATH_INLINE T atan2(T y, T x) {
+    using K = Constants<T>;
+
+    T ax = absolute(x);
+    T ay = absolute(y);
+    T hi = (ax > ay) ? ax : ay;
+    T lo = (ax > ay) ? ay : ax;
+
+    // a = tan of the angle folded into [0, pi/4], then t = tan of the angle minus 0 or pi/4
+    T a = (hi > T(0)) ? lo / hi : T(0);
+    bool upper = a > K::TAN_PI_8;
+    T t = upper ? (a - T(1)) / (a + T(1)) : a;
+    T angle = atanPoly(t) + (upper ? K::PI_4 : T(0));
+
+    // Unfold the octant, then the half plane, then the sign
+    angle = (ay > ax) ? K::PI_2 - angle : angle;
+    angle = (x < T(0)) ? K::PI - angle : angle;
+    return (y < T(0)) ? -angle : angle;
+}
+
+/**
+ * Rounds down to an integer, like floor() but inlined; libm's floor only vectorizes
+ * from SSE4.1 on. Valid for |x| < 2^22 (float) and |x| < 2^51 (double).
+ *
+ * @param x Value
+ * @return Largest integer not greater than x
+ */
+template <typename T>
+VMATH_INLINE T floor(T x) {
+    T nearest = (x + Constants<T>::ROUNDER) - Constants<T>::ROUNDER;
+    return (nearest > x) ? nearest - T(1) : nearest;
+}
+
+/**
+ * Reciprocal square root, 1 / sqrt(x), from a correctly rounded sqrt and divide
+ * (vectorizes to sqrtps/divps when the kernels are built with -fno-math-errno).
+ *
+ * @param x Positive value
+ * @return 1 / sqrt(x)
+ */
+VMATH_INLINE float rsqrt(float x) {
+    return 1.0f / sqrtf(x);
+}
+
+VMATH_INLINE double rsqrt(double x) {
+    return 1.0 / sqrt(x);
+}
+
+} // namespace vmath
@@ -0,0 +1,134 @@
+#include "platform/cpu_features.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ORBIT_SIM_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(ORBIT_SIM_X86)
+namespace {
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) {
+        regs[i] = static_cast<uint32_t>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+} // namespace
+#endif
+
+CpuIsa detectCpuIsa() {
+#if defined(ORBIT_SIM_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+    if (maxLeaf < 7) {
+        return CpuIsa::Baseline;
+    }
+
+    cpuid(1, 0, regs);
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool fma = (regs[2] & (1u << 12)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx) {
+        return CpuIsa::Baseline;
+    }
+
+    // XCR0 tells which register state the OS saves: SSE+AVX (bits 1, 2), plus opmask and ZMM (5-7)
+    uint64_t xcr0 = readXcr0();
+    bool osAvx = (xcr0 & 0x6) == 0x6;
+    bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, regs);
+    bool avx2 = (regs[1] & (1u << 5)) != 0;
+    bool avx512f = (regs[1] & (1u << 16)) != 0;
+    bool avx512vl = (regs[1] & (1u << 31)) != 0;
+
+    if (osAvx512 && avx2 && fma && avx512f && avx512vl) {
+        return CpuIsa::AVX512;
+    }
+    if (osAvx && avx2 && fma) {
+        return CpuIsa::AVX2;
+    }
+#endif
+    return CpuIsa::Baseline;
+}
+
+CpuIsa selectCpuIsa() {
+    CpuIsa detected = detectCpuIsa();
+
+    const char* forced = std::getenv("ORBIT_SIM_ISA");
+    if (forced == nullptr || forced[0] == '\0') {
+        return detected;
+    }
+
+    CpuIsa requested;
+    if (!parseCpuIsa(forced, requested)) {
+        std::cerr << "Ignoring unknown ORBIT_SIM_ISA value '" << forced << "'" << std::endl;
+        return detected;
+    }
+
+    if (requested > detected) {
+        std::cerr << "ORBIT_SIM_ISA=" << forced << " is not supported by this CPU, using "
+                  << cpuIsaName(detected) << std::endl;
+        return detected;
+    }
+
+    return requested;
+}
+
+const char* cpuIsaName(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::Baseline: return "baseline";
+        case CpuIsa::AVX2:     return "avx2";
+        case CpuIsa::AVX512:   return "avx512";
+        default:               return "unknown";
+    }
+}
+
+bool parseCpuIsa(const char* name, CpuIsa& isa) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(CpuIsa::Count); i++) {
+        const char* candidate = cpuIsaName(static_cast<CpuIsa>(i));
+
+        size_t length = std::strlen(candidate);
+        if (std::strlen(name) != length) {
+            continue;
+        }
+
+        bool match = true;
+        for (size_t c = 0; c < length && match; c++) {
+            match = std::tolower(static_cast<unsigned char>(name[c])) == candidate[c];
+        }
+
+        if (match) {
+            isa = static_cast<CpuIsa>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Instruction set levels the numeric kernels are compiled for, in increasing order.
+ * Baseline is the build's default target (SSE2 on x86-64).
+ */
+enum class CpuIsa : uint32_t {
+    Baseline = 0,
+    AVX2,       // AVX2 + FMA
+    AVX512,     // AVX-512F + AVX-512VL
+    Count
+};
+
+/**
+ * Detects the highest kernel instruction set level supported by the CPU and the OS
+ * (the OS must save the wider vector registers on context switches).
+ *
+ * @return Highest usable level; Baseline on non-x86 builds
+ */
+CpuIsa detectCpuIsa();
+
+/**
+ * Selects the instruction set level used for kernel dispatch: the detected level,
+ * lowered by the ORBIT_SIM_ISA environment variable if set (baseline, avx2, avx512).
+ * A forced level above what the CPU supports is clamped to the detected one.
+ *
+ * @return Level to dispatch to
+ */
+CpuIsa selectCpuIsa();
+
+/**
+ * Gets the display name of an instruction set level.
+ *
+ * @param isa Instruction set level
+ * @return Lowercase name, as accepted by parseCpuIsa()
+ */
+const char* cpuIsaName(CpuIsa isa);
+
+/**
+ * Parses an instruction set level name (case-insensitive).
+ *
+ * @param name Level name
+ * @param isa Output level
+ * @return True if the name was recognized
+ */
+bool parseCpuIsa(const char* name, CpuIsa& isa);
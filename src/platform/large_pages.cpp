@@ -0,0 +1,140 @@
+#include "platform/large_pages.h"
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
+namespace {
+
+// Huge page size on x86-64 and most arm64 kernels
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#if defined(__linux__)
+/**
+ * Checks whether the kernel backs madvise(MADV_HUGEPAGE) ranges with huge pages.
+ * madvise() succeeds even with transparent huge pages switched off, so the setting is
+ * read from sysfs ("always [madvise] never", the selection in brackets); a kernel
+ * without the file has no transparent huge pages.
+ */
+bool transparentHugePagesEnabled() {
+    static const bool enabled = []() {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string setting;
+        std::getline(file, setting);
+        return setting.find('[') != std::string::npos && setting.find("[never]") == std::string::npos;
+    }();
+    return enabled;
+}
+#endif
+
+} // namespace
+
+void* allocateLargePages(size_t bytes, PageMode mode, PageMode* obtained) {
+    if (obtained != nullptr) {
+        *obtained = PageMode::Default;
+    }
+    if (bytes == 0) {
+        return nullptr;
+    }
+
+#if defined(_WIN32)
+    // Large pages need SeLockMemoryPrivilege, which is rarely granted; use regular pages
+    (void)mode;
+    return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+    if (mode == PageMode::Explicit) {
+        void* data = mmap(nullptr, roundUp(bytes, HUGE_PAGE_SIZE), PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data != MAP_FAILED) {
+            if (obtained != nullptr) {
+                *obtained = PageMode::Explicit;
+            }
+            return data;
+        }
+        mode = PageMode::Transparent;
+    }
+
+    if (mode == PageMode::Transparent) {
+        // Over-allocate by one huge page and trim, so the range is 2 MB aligned and the
+        // kernel can back all of it with huge pages
+        size_t mappedBytes = roundUp(bytes, HUGE_PAGE_SIZE) + HUGE_PAGE_SIZE;
+        void* mapping = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+        uintptr_t aligned = roundUp(start, HUGE_PAGE_SIZE);
+        size_t usedBytes = roundUp(bytes, HUGE_PAGE_SIZE);
+        if (aligned > start) {
+            munmap(mapping, aligned - start);
+        }
+        size_t tail = (start + mappedBytes) - (aligned + usedBytes);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + usedBytes), tail);
+        }
+
+        void* data = reinterpret_cast<void*>(aligned);
+        if (madvise(data, usedBytes, MADV_HUGEPAGE) == 0 && transparentHugePagesEnabled() && obtained != nullptr) {
+            *obtained = PageMode::Transparent;
+        }
+        return data;
+    }
+
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (data != MAP_FAILED) ? data : nullptr;
+#elif defined(__unix__) || defined(__APPLE__)
+    (void)mode;
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (data != MAP_FAILED) ? data : nullptr;
+#else
+    (void)mode;
+    return std::aligned_alloc(4096, roundUp(bytes, 4096));
+#endif
+}
+
+void freeLargePages(void* data, size_t bytes, PageMode mode) {
+    if (data == nullptr) {
+        return;
+    }
+
+#if !defined(__linux__)
+    (void)mode;
+#endif
+
+#if defined(_WIN32)
+    (void)bytes;
+    VirtualFree(data, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    // Huge page requests were rounded up to whole huge pages, whether or not they got them
+    munmap(data, (mode != PageMode::Default) ? roundUp(bytes, HUGE_PAGE_SIZE) : bytes);
+#elif defined(__unix__) || defined(__APPLE__)
+    munmap(data, bytes);
+#else
+    (void)bytes;
+    std::free(data);
+#endif
+}
+
+const char* pageModeName(PageMode mode) {
+    switch (mode) {
+        case PageMode::Default:     return "default";
+        case PageMode::Transparent: return "transparent";
+        case PageMode::Explicit:    return "explicit";
+        default:                    return "unknown";
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "platform/thread_pool.h"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Page size requested for a large allocation.
+ */
+enum class PageMode {
+    Default,        // Regular pages
+    Transparent,    // Regular mapping, 2 MB aligned, advised for transparent huge pages
+    Explicit        // Reserved huge pages (hugetlbfs); falls back to Transparent
+};
+
+/**
+ * Maps memory directly from the OS for large arrays, page aligned. The memory is not
+ * touched, so physical pages are placed on the NUMA node of the thread that first
+ * writes them.
+ *
+ * @param bytes Size in bytes
+ * @param mode Requested page size
+ * @param obtained Optional output: the mode actually obtained
+ * @return Memory, or nullptr on failure
+ */
+void* allocateLargePages(size_t bytes, PageMode mode, PageMode* obtained = nullptr);
+
+/**
+ * Releases memory from allocateLargePages().
+ *
+ * @param data Memory
+ * @param bytes Size passed to allocateLargePages()
+ * @param mode Mode passed to allocateLargePages() (the requested one, not the obtained one)
+ */
+void freeLargePages(void* data, size_t bytes, PageMode mode);
+
+/**
+ * Gets the display name of a page mode.
+ *
+ * @param mode Page mode
+ * @return Lowercase name
+ */
+const char* pageModeName(PageMode mode);
+
+/**
+ * Fixed-size array of trivially constructible elements in large pages, for the
+ * structure-of-arrays state of big catalogs where TLB misses become visible.
+ *
+ * Elements start out uninitialized and untouched. firstTouch() zeroes them from the
+ * workers of a thread pool using parallelRanges(), so each worker's slice is placed
+ * on that worker's NUMA node; loops over the array should then use parallelRanges()
+ * with the same pool and count to stay node-local.
+ */
+template <typename T>
+class LargeArray {
+    static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                  "LargeArray holds plain data only");
+
+public:
+    LargeArray()
+        : m_data(nullptr), m_size(0), m_bytes(0), m_requestedMode(PageMode::Default), m_mode(PageMode::Default) {}
+
+    /**
+     * @param size Number of elements
+     * @param mode Requested page size; see getPageMode() for what was obtained
+     */
+    LargeArray(size_t size, PageMode mode)
+        : m_data(nullptr), m_size(size), m_bytes(size * sizeof(T)), m_requestedMode(mode), m_mode(PageMode::Default) {
+        if (m_bytes > 0) {
+            m_data = static_cast<T*>(allocateLargePages(m_bytes, mode, &m_mode));
+            if (m_data == nullptr) {
+                throw std::runtime_error("Failed to allocate large page array!");
+            }
+        }
+    }
+
+    ~LargeArray() {
+        if (m_data != nullptr) {
+            freeLargePages(m_data, m_bytes, m_requestedMode);
+        }
+    }
+
+    LargeArray(const LargeArray&) = delete;
+    LargeArray& operator=(const LargeArray&) = delete;
+
+    LargeArray(LargeArray&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+          m_bytes(std::exchange(other.m_bytes, 0)), m_requestedMode(other.m_requestedMode), m_mode(other.m_mode) {}
+
+    LargeArray& operator=(LargeArray&& other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_bytes, other.m_bytes);
+        std::swap(m_requestedMode, other.m_requestedMode);
+        std::swap(m_mode, other.m_mode);
+        return *this;
+    }
+
+    /**
+     * Zeroes the array, each worker of the pool writing its parallelRanges() slice.
+     *
+     * @param pool Pool whose workers will process the array, or nullptr for the calling thread
+     */
+    void firstTouch(ThreadPool* pool) {
+        if (pool == nullptr) {
+            std::memset(static_cast<void*>(m_data), 0, m_bytes);
+            return;
+        }
+        pool->parallelRanges(m_size, [this](size_t begin, size_t end, size_t) {
+            std::memset(static_cast<void*>(m_data + begin), 0, (end - begin) * sizeof(T));
+        });
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+    // Page size actually obtained
+    PageMode getPageMode() const { return m_mode; }
+
+private:
+    T* m_data;
+    size_t m_size;
+    size_t m_bytes;
+    PageMode m_requestedMode;
+    PageMode m_mode;
+};
@@ -0,0 +1,110 @@
+#include "platform/mapped_file.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) : m_data(nullptr), m_size(0), m_handle(nullptr) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get size of " + path + "!");
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // An empty file cannot be mapped; it is simply empty
+    if (m_size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (view == nullptr) {
+            if (mapping != nullptr) {
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map " + path + "!");
+        }
+        m_data = static_cast<const uint8_t*>(view);
+        m_handle = mapping;
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(file);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Failed to open file " + path + "!");
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("Failed to get size of " + path + "!");
+    }
+    m_size = static_cast<size_t>(status.st_size);
+
+    // An empty file cannot be mapped; it is simply empty
+    if (m_size > 0) {
+        void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (view == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("Failed to map " + path + "!");
+        }
+        m_data = static_cast<const uint8_t*>(view);
+
+        // The whole file is read front to back once
+        madvise(view, m_size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping keeps the file open
+    close(file);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+      m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+    if (m_data == nullptr) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_handle = nullptr;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file. Pages are loaded by the OS on first
+ * access, so data can be copied straight from the file to its destination (e.g. a
+ * GPU staging buffer) without an intermediate read buffer. Move-only.
+ */
+class MappedFile {
+public:
+    MappedFile() : m_data(nullptr), m_size(0), m_handle(nullptr) {}
+
+    /**
+     * Maps a file. Throws if it cannot be opened or mapped.
+     *
+     * @param path File to map
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Gets the mapped bytes.
+     *
+     * @return First byte, or nullptr for an empty or unmapped file
+     */
+    const uint8_t* data() const { return m_data; }
+
+    /**
+     * Gets the file size.
+     *
+     * @return Size in bytes
+     */
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    void* m_handle;     // File mapping object on Windows, unused elsewhere
+
+    void release();
+};
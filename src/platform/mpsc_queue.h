@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * Bounded lock-free queue for many producer threads and a single consumer thread.
+ *
+ * A ring of slots, each with a sequence number that tells whether it is free for the
+ * producer at a given position or filled for the consumer (D. Vyukov's bounded queue).
+ * Producers claim positions with one compare-exchange and never wait for each other;
+ * the consumer needs no atomic read-modify-write at all. Neither side blocks, so a
+ * full queue is reported to the producer instead.
+ */
+template <typename T>
+class MpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "MpscQueue holds plain data only");
+
+public:
+    /**
+     * Allocates the ring.
+     *
+     * @param capacity Number of slots, a power of two
+     */
+    explicit MpscQueue(size_t capacity)
+        : m_slots(new Slot[capacity]), m_mask(capacity - 1), m_enqueuePosition(0), m_dequeuePosition(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::runtime_error("Failed to create queue: capacity must be a power of two!");
+        }
+        for (size_t i = 0; i < capacity; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Appends an item. Safe to call from any number of threads.
+     *
+     * @param item Item to append
+     * @return False if the queue is full
+     */
+    bool push(const T& item) {
+        size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[position & m_mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                // Slot is free at this position; claim it
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // Consumer has not freed the slot a full lap ago
+                return false;
+            } else {
+                // Another producer took this position
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest item. Only the consumer thread may call this.
+     *
+     * @param item Output item
+     * @return False if the queue is empty (or the oldest push has not completed yet)
+     */
+    bool pop(T& item) {
+        Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeuePosition + 1) {
+            return false;
+        }
+
+        item = slot.item;
+        slot.sequence.store(m_dequeuePosition + m_mask + 1, std::memory_order_release);
+        m_dequeuePosition++;
+        return true;
+    }
+
+    /**
+     * Gets the number of slots.
+     *
+     * @return Capacity
+     */
+    size_t getCapacity() const { return m_mask + 1; }
+
+private:
+    // Keeps the producer and consumer positions on separate cache lines
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> m_enqueuePosition;
+    alignas(CACHE_LINE) size_t m_dequeuePosition;    // consumer only
+};
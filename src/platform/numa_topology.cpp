@@ -0,0 +1,79 @@
+#include "platform/numa_topology.h"
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+NumaTopology detectTopology() {
+    NumaTopology topology;
+
+#if defined(__linux__)
+    // Nodes can be sparse after hotplug, so probe a range rather than stopping at a gap
+    constexpr int MAX_NODES = 64;
+    for (int node = 0; node < MAX_NODES; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) {
+            continue;
+        }
+
+        std::vector<uint32_t> cpus = parseCpuList(list.c_str());
+        if (!cpus.empty()) {
+            topology.nodeCpus.push_back(cpus);
+        }
+    }
+#endif
+
+    if (topology.nodeCpus.empty()) {
+        uint32_t cpuCount = std::thread::hardware_concurrency();
+        std::vector<uint32_t> cpus;
+        for (uint32_t cpu = 0; cpu < (cpuCount > 0 ? cpuCount : 1); cpu++) {
+            cpus.push_back(cpu);
+        }
+        topology.nodeCpus.push_back(cpus);
+    }
+
+    return topology;
+}
+
+} // namespace
+
+const NumaTopology& getNumaTopology() {
+    static const NumaTopology topology = detectTopology();
+    return topology;
+}
+
+std::vector<uint32_t> parseCpuList(const char* list) {
+    std::vector<uint32_t> cpus;
+    const char* cursor = list;
+
+    while (*cursor != '\0' && *cursor != '\n') {
+        char* end = nullptr;
+        unsigned long first = std::strtoul(cursor, &end, 10);
+        if (end == cursor) {
+            return {};
+        }
+
+        unsigned long last = first;
+        cursor = end;
+        if (*cursor == '-') {
+            last = std::strtoul(cursor + 1, &end, 10);
+            if (end == cursor + 1 || last < first) {
+                return {};
+            }
+            cursor = end;
+        }
+
+        for (unsigned long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<uint32_t>(cpu));
+        }
+
+        if (*cursor == ',') {
+            cursor++;
+        }
+    }
+
+    return cpus;
+}
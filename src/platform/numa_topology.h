@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * CPUs of each NUMA node. Single-socket machines, and platforms where the topology
+ * is not read, report one node holding every hardware thread.
+ */
+struct NumaTopology {
+    // Logical CPU numbers of each node, in ascending order
+    std::vector<std::vector<uint32_t>> nodeCpus;
+
+    size_t getNodeCount() const { return nodeCpus.size(); }
+};
+
+/**
+ * Gets the NUMA topology, read once from /sys/devices/system/node on Linux.
+ *
+ * @return Topology with at least one node
+ */
+const NumaTopology& getNumaTopology();
+
+/**
+ * Parses a Linux CPU list such as "0-3,8,10-11".
+ *
+ * @param list CPU list text
+ * @return CPU numbers in the order listed; empty if the text is malformed
+ */
+std::vector<uint32_t> parseCpuList(const char* list);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Latest value of a small plain struct, written by one thread and read by any.
+ *
+ * A sequence lock: the writer makes the sequence odd, stores the value and makes it
+ * even again, and a reader retries when the sequence was odd or changed during its
+ * copy. The writer never waits, so the simulation can publish state every tick no
+ * matter how often the UI reads it. The value is kept in atomic words so the racing
+ * copy is well defined.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock holds plain data only");
+
+public:
+    /**
+     * @param value Initial value
+     */
+    explicit SeqLock(const T& value = T{}) : m_sequence(0) {
+        uint32_t words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Publishes a new value. Only one thread may call this.
+     *
+     * @param value Value
+     */
+    void store(const T& value) {
+        uint32_t words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Gets the last published value. Safe to call from any thread.
+     *
+     * @return Value
+     */
+    T load() const {
+        uint32_t words[WORD_COUNT];
+        uint32_t before, after;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORD_COUNT; i++) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> m_sequence;
+    std::atomic<uint32_t> m_words[WORD_COUNT];
+};
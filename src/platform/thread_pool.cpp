@@ -0,0 +1,170 @@
+#include "platform/thread_pool.h"
+#include "platform/numa_topology.h"
+#include <utility>
+
+ThreadPool::ThreadPool(size_t threadCount, bool pinWorkers)
+    : m_task(nullptr),
+      m_count(0),
+      m_generation(0),
+      m_busyWorkers(0),
+      m_perWorker(false),
+      m_stopping(false),
+      m_nextIndex(0) {
+#if defined(__linux__)
+    m_callerPinned = false;
+#endif
+
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    for (size_t worker = 1; worker < threadCount; worker++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+
+    placeWorkers(pinWorkers);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+
+#if defined(__linux__)
+    if (m_callerPinned) {
+        pthread_setaffinity_np(pthread_self(), sizeof(m_callerAffinity), &m_callerAffinity);
+    }
+#endif
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    if (m_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    dispatch(task, count, false);
+}
+
+void ThreadPool::parallelRanges(size_t count, const std::function<void(size_t begin, size_t end, size_t worker)>& task) {
+    size_t threadCount = getThreadCount();
+    auto runRange = [&](size_t worker, size_t) {
+        task(count * worker / threadCount, count * (worker + 1) / threadCount, worker);
+    };
+
+    if (m_workers.empty()) {
+        runRange(0, 0);
+        return;
+    }
+
+    dispatch(runRange, threadCount, true);
+}
+
+void ThreadPool::dispatch(const std::function<void(size_t, size_t)>& task, size_t count, bool perWorker) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_perWorker = perWorker;
+        m_nextIndex.store(0, std::memory_order_relaxed);
+        m_busyWorkers = m_workers.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    runTasks(0);
+
+    // Workers still hold a pointer to the task until they check out
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_busyWorkers == 0; });
+    m_task = nullptr;
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        runTasks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers--;
+        }
+        m_finished.notify_one();
+    }
+}
+
+void ThreadPool::runTasks(size_t worker) {
+    const std::function<void(size_t, size_t)>& task = *m_task;
+    size_t count = m_count;
+
+    if (m_perWorker) {
+        if (worker < count) {
+            task(worker, worker);
+        }
+        return;
+    }
+
+    for (size_t i = m_nextIndex.fetch_add(1, std::memory_order_relaxed); i < count;
+         i = m_nextIndex.fetch_add(1, std::memory_order_relaxed)) {
+        task(i, worker);
+    }
+}
+
+void ThreadPool::placeWorkers(bool pin) {
+    m_workerNodes.assign(getThreadCount(), 0);
+    if (!pin) {
+        return;
+    }
+
+    // Fill nodes in order: with two nodes and 2n threads, workers [0, n) land on node 0
+    const NumaTopology& topology = getNumaTopology();
+    std::vector<std::pair<uint32_t, uint32_t>> slots;
+    for (size_t node = 0; node < topology.getNodeCount(); node++) {
+        for (uint32_t cpu : topology.nodeCpus[node]) {
+            slots.emplace_back(static_cast<uint32_t>(node), cpu);
+        }
+    }
+
+    for (size_t worker = 0; worker < getThreadCount(); worker++) {
+        // Spread over every slot when there are fewer workers than CPUs
+        const auto& slot = slots[worker * slots.size() / getThreadCount()];
+        m_workerNodes[worker] = slot.first;
+
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(slot.second, &cpus);
+        if (worker > 0) {
+            pthread_setaffinity_np(m_workers[worker - 1].native_handle(), sizeof(cpus), &cpus);
+        } else if (pthread_getaffinity_np(pthread_self(), sizeof(m_callerAffinity), &m_callerAffinity) == 0) {
+            // Worker 0 is the caller: its slices of parallelRanges() must stay on its node too
+            m_callerPinned = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+        }
+#endif
+    }
+}
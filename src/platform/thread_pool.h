@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * Fixed set of worker threads for data-parallel loops over CPU kernels.
+ *
+ * parallelFor() hands out indices dynamically, so uneven tiles balance themselves.
+ * parallelRanges() instead gives every worker the same contiguous slice each time,
+ * which keeps first-touch NUMA placement (see LargeArray) valid across loops. The
+ * calling thread takes part as worker 0, and a pool of one thread runs everything
+ * inline.
+ */
+class ThreadPool {
+public:
+    /**
+     * Starts the workers.
+     *
+     * @param threadCount Total threads including the caller; 0 uses one per hardware thread
+     * @param pinWorkers Pin each worker to one CPU, filling NUMA nodes in order so that
+     *                   consecutive workers share a node (Linux only; ignored elsewhere).
+     *                   The calling thread is pinned as worker 0 until the pool is
+     *                   destroyed, which restores its previous affinity.
+     */
+    explicit ThreadPool(size_t threadCount = 0, bool pinWorkers = false);
+
+    /**
+     * Stops and joins the workers. Must run on the thread that created the pool when
+     * workers are pinned.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Runs task(index, worker) for every index in [0, count) and waits for all of them.
+     * Not reentrant: tasks must not call parallelFor() on the same pool.
+     *
+     * @param count Number of indices
+     * @param task Work for one index; worker is in [0, getThreadCount()) and identifies
+     *             the calling thread, e.g. to pick per-thread scratch memory
+     */
+    void parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task);
+
+    /**
+     * Splits [0, count) into one contiguous range per worker, the same split for the same
+     * count every call, runs task(begin, end, worker) on each worker and waits.
+     *
+     * @param count Number of items
+     * @param task Work for one worker's range; may be called with an empty range
+     */
+    void parallelRanges(size_t count, const std::function<void(size_t begin, size_t end, size_t worker)>& task);
+
+    /**
+     * Gets the NUMA node a worker was placed on (0 when workers are not pinned).
+     *
+     * @param worker Worker index
+     * @return Node index into getNumaTopology()
+     */
+    uint32_t getWorkerNode(size_t worker) const { return m_workerNodes[worker]; }
+
+    /**
+     * Gets the number of threads that run tasks, including the caller.
+     *
+     * @return Thread count
+     */
+    size_t getThreadCount() const { return m_workers.size() + 1; }
+
+private:
+    void workerLoop(size_t worker);
+    void runTasks(size_t worker);
+    void dispatch(const std::function<void(size_t, size_t)>& task, size_t count, bool perWorker);
+    void placeWorkers(bool pin);
+
+    std::vector<std::thread> m_workers;
+    std::vector<uint32_t> m_workerNodes;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+
+    // Current loop, published under m_mutex
+    const std::function<void(size_t, size_t)>* m_task;
+    size_t m_count;
+    uint64_t m_generation;
+    size_t m_busyWorkers;
+    bool m_perWorker;       // index i runs on worker i instead of being handed out
+    bool m_stopping;
+
+    std::atomic<size_t> m_nextIndex;
+
+#if defined(__linux__)
+    // Affinity of the calling thread before it was pinned as worker 0
+    bool m_callerPinned;
+    cpu_set_t m_callerAffinity;
+#endif
+};
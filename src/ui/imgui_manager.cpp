@@ -50,7 +50,29 @@ ImGuiManager::ImGuiManager(GLFWwindow* window, Renderer* renderer)
     
     // Setup Platform/Renderer backends
     ImGui_ImplGlfw_InitForVulkan(m_window, true);
+    initVulkanBackend();
+}
+
+ImGuiManager::~ImGuiManager() {
+    // Cleanup ImGui
+    vkDeviceWaitIdle(m_renderer->getDevice());
     
+    ImGui_ImplVulkan_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    
+    // Destroy descriptor pool
+    vkDestroyDescriptorPool(m_renderer->getDevice(), m_descriptorPool, nullptr);
+}
+
+void ImGuiManager::recreateVulkanBackend() {
+    // The backend pipeline is tied to the render pass (or attachment formats), so rebuild it (and the font texture)
+    vkDeviceWaitIdle(m_renderer->getDevice());
+    ImGui_ImplVulkan_Shutdown();
+    initVulkanBackend();
+}
+
+void ImGuiManager::initVulkanBackend() {
     // Create ImGui Vulkan implementation
     ImGui_ImplVulkan_InitInfo initInfo = {};
     initInfo.Instance = m_renderer->getInstance();
@@ -63,10 +85,14 @@ ImGuiManager::ImGuiManager(GLFWwindow* window, Renderer* renderer)
     initInfo.Subpass = 0;
     initInfo.MinImageCount = 2;
     initInfo.ImageCount = 2;
-    initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+    initInfo.MSAASamples = m_renderer->getMsaaSamples();
     initInfo.Allocator = nullptr;
     initInfo.CheckVkResultFn = nullptr;
     
+    // Without a render pass the backend builds its pipeline for the color format instead
+    initInfo.UseDynamicRendering = m_renderer->usesDynamicRendering();
+    initInfo.ColorAttachmentFormat = m_renderer->getColorFormat();
+    
     ImGui_ImplVulkan_Init(&initInfo, m_renderer->getRenderPass());
     
     // Upload fonts
@@ -78,18 +104,6 @@ ImGuiManager::ImGuiManager(GLFWwindow* window, Renderer* renderer)
     ImGui_ImplVulkan_DestroyFontUploadObjects();
 }
 
-ImGuiManager::~ImGuiManager() {
-    // Cleanup ImGui
-    vkDeviceWaitIdle(m_renderer->getDevice());
-    
-    ImGui_ImplVulkan_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
-    
-    // Destroy descriptor pool
-    vkDestroyDescriptorPool(m_renderer->getDevice(), m_descriptorPool, nullptr);
-}
-
 void ImGuiManager::beginFrame() {
     // Start a new ImGui frame
     ImGui_ImplVulkan_NewFrame();
@@ -101,6 +115,7 @@ void ImGuiManager::endFrame() {
     // Render ImGui
     ImGui::Render();
     
-    // Record ImGui draw commands to the current command buffer
+    // Record ImGui draw commands to the current command buffer, in the overlay pass
+    m_renderer->beginOverlayPass();
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), m_renderer->getCurrentCommandBuffer());
 }
@@ -36,10 +36,21 @@ public:
      */
     void endFrame();
     
+    /**
+     * Recreates the Vulkan backend after the renderer's render pass changed
+     * (e.g. a new MSAA sample count). Must be called between frames.
+     */
+    void recreateVulkanBackend();
+    
 private:
     GLFWwindow* m_window;
     Renderer* m_renderer;
     
     // ImGui Vulkan resources
     VkDescriptorPool m_descriptorPool;
+    
+    /**
+     * Initializes the ImGui Vulkan backend for the renderer's current render pass.
+     */
+    void initVulkanBackend();
 };
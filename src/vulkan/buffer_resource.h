@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+/**
+ * Buffer with its memory. Host-visible buffers that stay mapped keep the pointer in
+ * mapped, which is null otherwise.
+ */
+struct BufferResource {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    void* mapped = nullptr;
+};
@@ -0,0 +1,684 @@
+#include "vulkan/gltf_model.h"
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+// GLB container: 12-byte header, then chunks of (length, type, data) padded to 4 bytes
+constexpr uint32_t GLB_MAGIC = 0x46546C67;       // "glTF"
+constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;   // "BIN\0"
+
+// Accessor component types
+constexpr uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+constexpr uint32_t COMPONENT_UNSIGNED_INT = 5125;
+constexpr uint32_t COMPONENT_FLOAT = 5126;
+
+// Primitive topology of triangle lists, the default
+constexpr uint32_t MODE_TRIANGLES = 4;
+
+// Largest byteStride the specification allows
+constexpr uint64_t MAX_STRIDE = 252;
+
+// Nesting limit for JSON values and the node hierarchy, against malicious files
+constexpr int MAX_DEPTH = 64;
+
+/**
+ * Parsed JSON value. Objects keep their members in file order.
+ */
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> elements;    // Array elements or object member values
+    std::vector<std::string> keys;      // Object member names
+
+    const JsonValue* find(std::string_view key) const {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) {
+                return &elements[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * Recursive-descent parser for the JSON chunk of a glTF file.
+ */
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : m_text(text), m_position(0) {}
+
+    JsonValue parse() {
+        JsonValue value = parseValue(0);
+        skipWhitespace();
+        if (m_position != m_text.size()) {
+            fail();
+        }
+        return value;
+    }
+
+private:
+    std::string_view m_text;
+    size_t m_position;
+
+    [[noreturn]] void fail() const {
+        throw std::runtime_error("Failed to parse glTF JSON at offset " + std::to_string(m_position) + "!");
+    }
+
+    void skipWhitespace() {
+        while (m_position < m_text.size() &&
+               (m_text[m_position] == ' ' || m_text[m_position] == '\t' ||
+                m_text[m_position] == '\n' || m_text[m_position] == '\r')) {
+            m_position++;
+        }
+    }
+
+    char next() {
+        if (m_position >= m_text.size()) {
+            fail();
+        }
+        return m_text[m_position++];
+    }
+
+    void expect(std::string_view literal) {
+        if (m_text.substr(m_position, literal.size()) != literal) {
+            fail();
+        }
+        m_position += literal.size();
+    }
+
+    JsonValue parseValue(int depth) {
+        if (depth > MAX_DEPTH) {
+            fail();
+        }
+        skipWhitespace();
+        if (m_position >= m_text.size()) {
+            fail();
+        }
+
+        JsonValue value;
+        char c = m_text[m_position];
+        if (c == '{') {
+            value.type = JsonValue::Type::Object;
+            m_position++;
+            skipWhitespace();
+            if (m_position < m_text.size() && m_text[m_position] == '}') {
+                m_position++;
+                return value;
+            }
+            while (true) {
+                skipWhitespace();
+                if (next() != '"') {
+                    fail();
+                }
+                value.keys.push_back(parseString());
+                skipWhitespace();
+                if (next() != ':') {
+                    fail();
+                }
+                value.elements.push_back(parseValue(depth + 1));
+                skipWhitespace();
+                char separator = next();
+                if (separator == '}') {
+                    return value;
+                }
+                if (separator != ',') {
+                    fail();
+                }
+            }
+        }
+        if (c == '[') {
+            value.type = JsonValue::Type::Array;
+            m_position++;
+            skipWhitespace();
+            if (m_position < m_text.size() && m_text[m_position] == ']') {
+                m_position++;
+                return value;
+            }
+            while (true) {
+                value.elements.push_back(parseValue(depth + 1));
+                skipWhitespace();
+                char separator = next();
+                if (separator == ']') {
+                    return value;
+                }
+                if (separator != ',') {
+                    fail();
+                }
+            }
+        }
+        if (c == '"') {
+            m_position++;
+            value.type = JsonValue::Type::String;
+            value.string = parseString();
+            return value;
+        }
+        if (c == 't' || c == 'f') {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = (c == 't');
+            expect(value.boolean ? "true" : "false");
+            return value;
+        }
+        if (c == 'n') {
+            expect("null");
+            return value;
+        }
+
+        // Number; from_chars is locale independent
+        value.type = JsonValue::Type::Number;
+        const char* begin = m_text.data() + m_position;
+        const char* end = m_text.data() + m_text.size();
+        auto [stop, error] = std::from_chars(begin, end, value.number);
+        if (error != std::errc() || stop == begin) {
+            fail();
+        }
+        m_position += static_cast<size_t>(stop - begin);
+        return value;
+    }
+
+    // Parses the rest of a string whose opening quote was consumed
+    std::string parseString() {
+        std::string result;
+        while (true) {
+            char c = next();
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+
+            char escape = next();
+            switch (escape) {
+            case '"': case '\\': case '/': result.push_back(escape); break;
+            case 'b': result.push_back('\b'); break;
+            case 'f': result.push_back('\f'); break;
+            case 'n': result.push_back('\n'); break;
+            case 'r': result.push_back('\r'); break;
+            case 't': result.push_back('\t'); break;
+            case 'u': {
+                // Basic multilingual plane only, encoded as UTF-8 (names are not used anyway)
+                uint32_t code = 0;
+                for (int i = 0; i < 4; i++) {
+                    char digit = next();
+                    code <<= 4;
+                    if (digit >= '0' && digit <= '9') code |= digit - '0';
+                    else if (digit >= 'a' && digit <= 'f') code |= digit - 'a' + 10;
+                    else if (digit >= 'A' && digit <= 'F') code |= digit - 'A' + 10;
+                    else fail();
+                }
+                if (code < 0x80) {
+                    result.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                fail();
+            }
+        }
+    }
+};
+
+[[noreturn]] void invalidModel(const std::string& path, const std::string& reason) {
+    throw std::runtime_error("Failed to load model " + path + ": " + reason + "!");
+}
+
+uint32_t readUint32(const uint8_t* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * Reads glTF members with the defaults and checks of the specification.
+ */
+class GltfReader {
+public:
+    GltfReader(const std::string& path, const JsonValue& document) : m_path(path), m_document(document) {}
+
+    const JsonValue& array(const char* key) const {
+        static const JsonValue EMPTY_ARRAY = [] {
+            JsonValue empty;
+            empty.type = JsonValue::Type::Array;
+            return empty;
+        }();
+        const JsonValue* value = m_document.find(key);
+        if (value == nullptr) {
+            return EMPTY_ARRAY;
+        }
+        if (value->type != JsonValue::Type::Array) {
+            invalidModel(m_path, std::string(key) + " is not an array");
+        }
+        return *value;
+    }
+
+    const JsonValue& element(const char* arrayKey, double index) const {
+        const JsonValue& values = array(arrayKey);
+        if (index < 0.0 || index >= static_cast<double>(values.elements.size()) || index != std::floor(index)) {
+            invalidModel(m_path, std::string(arrayKey) + " index out of range");
+        }
+        return values.elements[static_cast<size_t>(index)];
+    }
+
+    double number(const JsonValue& object, const char* key) const {
+        const JsonValue* value = object.find(key);
+        if (value == nullptr || value->type != JsonValue::Type::Number) {
+            invalidModel(m_path, std::string("missing number ") + key);
+        }
+        return value->number;
+    }
+
+    double number(const JsonValue& object, const char* key, double fallback) const {
+        const JsonValue* value = object.find(key);
+        return (value != nullptr && value->type == JsonValue::Type::Number) ? value->number : fallback;
+    }
+
+    uint64_t size(const JsonValue& object, const char* key, double fallback) const {
+        double value = number(object, key, fallback);
+        if (value < 0.0 || value > 9.0e15 || value != std::floor(value)) {
+            invalidModel(m_path, std::string("bad ") + key);
+        }
+        return static_cast<uint64_t>(value);
+    }
+
+    // Fills up to count numbers of an array member, e.g. a color or matrix
+    bool numbers(const JsonValue& object, const char* key, float* values, size_t count) const {
+        const JsonValue* value = object.find(key);
+        if (value == nullptr) {
+            return false;
+        }
+        if (value->type != JsonValue::Type::Array || value->elements.size() != count) {
+            invalidModel(m_path, std::string("bad ") + key);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (value->elements[i].type != JsonValue::Type::Number) {
+                invalidModel(m_path, std::string("bad ") + key);
+            }
+            values[i] = static_cast<float>(value->elements[i].number);
+        }
+        return true;
+    }
+
+private:
+    const std::string& m_path;
+    const JsonValue& m_document;
+};
+
+/**
+ * Builds the model from the parsed document: resolves accessors into the used
+ * buffer views and walks the node hierarchy of the default scene.
+ */
+class ModelBuilder {
+public:
+    ModelBuilder(const std::string& path, const JsonValue& document, const std::vector<ModelBufferView>& buffers,
+                 ModelData& model)
+        : m_path(path), m_reader(path, document), m_document(document), m_buffers(buffers), m_model(model),
+          m_viewSlots(document.find("bufferViews") ? m_reader.array("bufferViews").elements.size() : 0, -1) {}
+
+    void build() {
+        const JsonValue& scenes = m_reader.array("scenes");
+        if (scenes.elements.empty()) {
+            // No scene: every mesh once, untransformed
+            const JsonValue& meshes = m_reader.array("meshes");
+            for (size_t mesh = 0; mesh < meshes.elements.size(); mesh++) {
+                addMesh(meshes.elements[mesh], glm::mat4(1.0f));
+            }
+            return;
+        }
+
+        const JsonValue& scene = m_reader.element("scenes", m_reader.number(m_document, "scene", 0.0));
+        const JsonValue* roots = scene.find("nodes");
+        if (roots == nullptr) {
+            return;
+        }
+        for (const JsonValue& root : roots->elements) {
+            if (root.type != JsonValue::Type::Number) {
+                invalidModel(m_path, "bad scene node");
+            }
+            addNode(root.number, glm::mat4(1.0f), 0);
+        }
+    }
+
+private:
+    const std::string& m_path;
+    GltfReader m_reader;
+    const JsonValue& m_document;
+    const std::vector<ModelBufferView>& m_buffers;
+    ModelData& m_model;
+    std::vector<int> m_viewSlots;   // Index in m_model.views of each used glTF buffer view
+
+    void addNode(double index, const glm::mat4& parent, int depth) {
+        if (depth > MAX_DEPTH) {
+            invalidModel(m_path, "node hierarchy too deep or cyclic");
+        }
+        const JsonValue& node = m_reader.element("nodes", index);
+
+        // Either a column-major matrix or translation, rotation (x, y, z, w) and scale
+        glm::mat4 local(1.0f);
+        float matrix[16];
+        if (m_reader.numbers(node, "matrix", matrix, 16)) {
+            memcpy(&local[0][0], matrix, sizeof(matrix));
+        } else {
+            float translation[3] = {0.0f, 0.0f, 0.0f};
+            float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            float scale[3] = {1.0f, 1.0f, 1.0f};
+            m_reader.numbers(node, "translation", translation, 3);
+            m_reader.numbers(node, "rotation", rotation, 4);
+            m_reader.numbers(node, "scale", scale, 3);
+            local = glm::translate(glm::mat4(1.0f), glm::vec3(translation[0], translation[1], translation[2])) *
+                    glm::mat4_cast(glm::quat(rotation[3], rotation[0], rotation[1], rotation[2])) *
+                    glm::scale(glm::mat4(1.0f), glm::vec3(scale[0], scale[1], scale[2]));
+        }
+        glm::mat4 transform = parent * local;
+
+        if (const JsonValue* mesh = node.find("mesh")) {
+            if (mesh->type != JsonValue::Type::Number) {
+                invalidModel(m_path, "bad node mesh");
+            }
+            addMesh(m_reader.element("meshes", mesh->number), transform);
+        }
+        if (const JsonValue* children = node.find("children")) {
+            for (const JsonValue& child : children->elements) {
+                if (child.type != JsonValue::Type::Number) {
+                    invalidModel(m_path, "bad node child");
+                }
+                addNode(child.number, transform, depth + 1);
+            }
+        }
+    }
+
+    void addMesh(const JsonValue& mesh, const glm::mat4& transform) {
+        const JsonValue* primitives = mesh.find("primitives");
+        if (primitives == nullptr || primitives->type != JsonValue::Type::Array) {
+            invalidModel(m_path, "mesh without primitives");
+        }
+
+        for (const JsonValue& source : primitives->elements) {
+            // Lines and points carry no surface to shade
+            if (m_reader.number(source, "mode", MODE_TRIANGLES) != MODE_TRIANGLES) {
+                continue;
+            }
+
+            const JsonValue* attributes = source.find("attributes");
+            const JsonValue* position = attributes ? attributes->find("POSITION") : nullptr;
+            const JsonValue* normal = attributes ? attributes->find("NORMAL") : nullptr;
+            if (position == nullptr || normal == nullptr ||
+                position->type != JsonValue::Type::Number || normal->type != JsonValue::Type::Number) {
+                invalidModel(m_path, "primitive without POSITION and NORMAL");
+            }
+
+            ModelPrimitive primitive{};
+            uint32_t componentType;
+            primitive.position = resolveAccessor(position->number, "VEC3", componentType);
+            if (componentType != COMPONENT_FLOAT) {
+                invalidModel(m_path, "POSITION is not float");
+            }
+            primitive.normal = resolveAccessor(normal->number, "VEC3", componentType);
+            if (componentType != COMPONENT_FLOAT || primitive.normal.count != primitive.position.count) {
+                invalidModel(m_path, "bad NORMAL");
+            }
+
+            primitive.indexSize = 4;
+            if (const JsonValue* indices = source.find("indices")) {
+                if (indices->type != JsonValue::Type::Number) {
+                    invalidModel(m_path, "bad indices");
+                }
+                primitive.indices = resolveAccessor(indices->number, "SCALAR", componentType);
+                if (componentType == COMPONENT_UNSIGNED_SHORT) {
+                    primitive.indexSize = 2;
+                } else if (componentType != COMPONENT_UNSIGNED_INT) {
+                    invalidModel(m_path, "indices must be 16 or 32 bits");
+                }
+                // Index buffers are read tightly packed
+                if (primitive.indices.stride != primitive.indexSize) {
+                    invalidModel(m_path, "indices are not tightly packed");
+                }
+                checkIndices(primitive);
+            }
+
+            float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            if (const JsonValue* material = source.find("material")) {
+                if (material->type != JsonValue::Type::Number) {
+                    invalidModel(m_path, "bad material");
+                }
+                const JsonValue& materialValue = m_reader.element("materials", material->number);
+                if (const JsonValue* pbr = materialValue.find("pbrMetallicRoughness")) {
+                    m_reader.numbers(*pbr, "baseColorFactor", color, 4);
+                }
+            }
+            primitive.baseColor = glm::vec4(color[0], color[1], color[2], color[3]);
+            primitive.transform = transform;
+            m_model.primitives.push_back(primitive);
+        }
+    }
+
+    // Vertices are fetched by index from one shared buffer, so an index past the
+    // primitive's vertices would read another primitive's data or beyond the buffer
+    void checkIndices(const ModelPrimitive& primitive) const {
+        const uint8_t* data = m_model.views[primitive.indices.view].data + primitive.indices.offset;
+        uint32_t maxIndex = 0;
+        for (uint32_t i = 0; i < primitive.indices.count; i++) {
+            uint32_t index = 0;
+            memcpy(&index, data + static_cast<size_t>(i) * primitive.indexSize, primitive.indexSize);
+            maxIndex = std::max(maxIndex, index);
+        }
+        if (maxIndex >= primitive.position.count) {
+            invalidModel(m_path, "index out of range");
+        }
+    }
+
+    ModelAccessor resolveAccessor(double index, const char* type, uint32_t& componentType) {
+        const JsonValue& accessor = m_reader.element("accessors", index);
+        const JsonValue* typeValue = accessor.find("type");
+        if (typeValue == nullptr || typeValue->string != type) {
+            invalidModel(m_path, std::string("accessor is not ") + type);
+        }
+        if (accessor.find("sparse") != nullptr || accessor.find("bufferView") == nullptr) {
+            invalidModel(m_path, "sparse accessors are not supported");
+        }
+
+        componentType = static_cast<uint32_t>(m_reader.size(accessor, "componentType", 0.0));
+        uint32_t componentSize = (componentType == COMPONENT_UNSIGNED_SHORT) ? 2 : 4;
+        uint32_t elementSize = componentSize * (std::string_view(type) == "VEC3" ? 3 : 1);
+
+        double viewIndex = m_reader.number(accessor, "bufferView");
+        const JsonValue& view = m_reader.element("bufferViews", viewIndex);
+        uint64_t viewOffset = m_reader.size(view, "byteOffset", 0.0);
+        uint64_t viewLength = m_reader.size(view, "byteLength", -1.0);
+        uint64_t stride = m_reader.size(view, "byteStride", elementSize);
+        uint64_t bufferIndex = m_reader.size(view, "buffer", -1.0);
+        if (bufferIndex >= m_buffers.size()) {
+            invalidModel(m_path, "buffer index out of range");
+        }
+        const ModelBufferView& buffer = m_buffers[bufferIndex];
+        if (viewOffset + viewLength > buffer.size) {
+            invalidModel(m_path, "buffer view out of range");
+        }
+
+        // Everything the accessor reads must lie inside its view, aligned for 32-bit loads
+        ModelAccessor result;
+        uint64_t offset = m_reader.size(accessor, "byteOffset", 0.0);
+        uint64_t count = m_reader.size(accessor, "count", -1.0);
+        bool aligned = offset % componentSize == 0 && stride % componentSize == 0 &&
+                       (viewOffset + offset) % componentSize == 0;
+        if (!aligned || count == 0 || stride < elementSize || stride > MAX_STRIDE ||
+            offset + (count - 1) * stride + elementSize > viewLength) {
+            invalidModel(m_path, "accessor out of range or misaligned");
+        }
+
+        size_t viewSlot = static_cast<size_t>(viewIndex);
+        if (m_viewSlots[viewSlot] < 0) {
+            m_viewSlots[viewSlot] = static_cast<int>(m_model.views.size());
+            m_model.views.push_back({buffer.data + viewOffset, static_cast<size_t>(viewLength)});
+        }
+        result.view = static_cast<uint32_t>(m_viewSlots[viewSlot]);
+        result.offset = static_cast<uint32_t>(offset);
+        result.stride = static_cast<uint32_t>(stride);
+        result.count = static_cast<uint32_t>(count);
+        return result;
+    }
+};
+
+// 64-bit multiply-xorshift hash, eight bytes per step
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+    constexpr uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ull;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes + i, size - i);
+    hash = (hash ^ tail ^ (static_cast<uint64_t>(size) << 56)) * MULTIPLIER;
+    return hash ^ (hash >> 29);
+}
+
+} // namespace
+
+ModelData loadGltfModel(const std::string& path) {
+    ModelData model;
+    model.files.push_back(MappedFile(path));
+    const MappedFile& file = model.files.front();
+
+    // A .glb starts with its header; anything else is taken as .gltf JSON
+    std::string_view json;
+    ModelBufferView binaryChunk{nullptr, 0};
+    if (file.size() >= 12 && readUint32(file.data()) == GLB_MAGIC) {
+        if (readUint32(file.data() + 4) != 2 || readUint32(file.data() + 8) > file.size()) {
+            invalidModel(path, "bad GLB header");
+        }
+        size_t length = readUint32(file.data() + 8);
+        size_t offset = 12;
+        while (offset + 8 <= length) {
+            size_t chunkLength = readUint32(file.data() + offset);
+            uint32_t chunkType = readUint32(file.data() + offset + 4);
+            const uint8_t* chunk = file.data() + offset + 8;
+            if (chunkLength > length - offset - 8) {
+                invalidModel(path, "GLB chunk out of range");
+            }
+            if (chunkType == GLB_CHUNK_JSON && json.empty()) {
+                json = std::string_view(reinterpret_cast<const char*>(chunk), chunkLength);
+            } else if (chunkType == GLB_CHUNK_BIN && binaryChunk.data == nullptr) {
+                binaryChunk = {chunk, chunkLength};
+            }
+            offset += 8 + (chunkLength + 3) / 4 * 4;
+        }
+        if (json.empty()) {
+            invalidModel(path, "GLB without JSON chunk");
+        }
+    } else {
+        json = std::string_view(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+    JsonValue document = JsonParser(json).parse();
+    if (document.type != JsonValue::Type::Object) {
+        invalidModel(path, "JSON is not an object");
+    }
+    const JsonValue* asset = document.find("asset");
+    const JsonValue* version = asset ? asset->find("version") : nullptr;
+    if (version == nullptr || version->string.empty() || version->string[0] != '2') {
+        invalidModel(path, "not glTF 2.0");
+    }
+
+    // Buffers: the GLB binary chunk, or external files next to the model; the
+    // mappings stay in the model so the views remain valid
+    GltfReader reader(path, document);
+    std::vector<ModelBufferView> buffers;
+    for (const JsonValue& buffer : reader.array("buffers").elements) {
+        uint64_t byteLength = reader.size(buffer, "byteLength", -1.0);
+        const JsonValue* uri = buffer.find("uri");
+        ModelBufferView data{nullptr, 0};
+        if (uri == nullptr) {
+            if (!buffers.empty() || binaryChunk.data == nullptr) {
+                invalidModel(path, "buffer without uri outside a GLB");
+            }
+            data = binaryChunk;
+        } else if (uri->string.rfind("data:", 0) == 0) {
+            invalidModel(path, "embedded data URIs are not supported");
+        } else {
+            std::filesystem::path bufferPath = std::filesystem::path(path).parent_path() / uri->string;
+            model.files.push_back(MappedFile(bufferPath.string()));
+            data = {model.files.back().data(), model.files.back().size()};
+        }
+        if (data.size < byteLength) {
+            invalidModel(path, "buffer shorter than its byteLength");
+        }
+        buffers.push_back({data.data, static_cast<size_t>(byteLength)});
+    }
+
+    ModelBuilder(path, document, buffers, model).build();
+    if (model.primitives.empty()) {
+        invalidModel(path, "no triangle primitives");
+    }
+
+    return model;
+}
+
+uint64_t hashModelData(const ModelData& model) {
+    uint64_t hash = 0x243F6A8885A308D3ull;
+    for (const ModelBufferView& view : model.views) {
+        hash = hashBytes(view.data, view.size, hash);
+    }
+
+    // Field by field, so padding never enters the hash
+    for (const ModelPrimitive& primitive : model.primitives) {
+        for (const ModelAccessor* accessor : {&primitive.position, &primitive.normal, &primitive.indices}) {
+            uint32_t fields[4] = {accessor->view, accessor->offset, accessor->stride, accessor->count};
+            hash = hashBytes(fields, sizeof(fields), hash);
+        }
+        hash = hashBytes(&primitive.indexSize, sizeof(primitive.indexSize), hash);
+        hash = hashBytes(&primitive.baseColor[0], sizeof(float) * 4, hash);
+        for (int column = 0; column < 4; column++) {
+            hash = hashBytes(&primitive.transform[column][0], sizeof(float) * 4, hash);
+        }
+    }
+    return hash;
+}
+
+bool sameModelData(const ModelData& a, const ModelData& b) {
+    if (a.views.size() != b.views.size() || a.primitives.size() != b.primitives.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.views.size(); i++) {
+        if (a.views[i].size != b.views[i].size || memcmp(a.views[i].data, b.views[i].data, a.views[i].size) != 0) {
+            return false;
+        }
+    }
+
+    auto sameAccessor = [](const ModelAccessor& x, const ModelAccessor& y) {
+        return x.view == y.view && x.offset == y.offset && x.stride == y.stride && x.count == y.count;
+    };
+    for (size_t i = 0; i < a.primitives.size(); i++) {
+        const ModelPrimitive& x = a.primitives[i];
+        const ModelPrimitive& y = b.primitives[i];
+        if (!sameAccessor(x.position, y.position) || !sameAccessor(x.normal, y.normal) ||
+            !sameAccessor(x.indices, y.indices) || x.indexSize != y.indexSize ||
+            x.baseColor != y.baseColor || x.transform != y.transform) {
+            return false;
+        }
+    }
+    return true;
+}
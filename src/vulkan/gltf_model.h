@@ -0,0 +1,88 @@
+#pragma once
+
+#include "platform/mapped_file.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Byte range of model data, usually pointing into a memory-mapped file.
+ */
+struct ModelBufferView {
+    const uint8_t* data;
+    size_t size;
+};
+
+/**
+ * Array of vertex attributes or indices inside one buffer view.
+ */
+struct ModelAccessor {
+    uint32_t view;      // Index into ModelData::views
+    uint32_t offset;    // Byte offset of the first element within the view
+    uint32_t stride;    // Bytes from one element to the next
+    uint32_t count;     // Number of elements
+};
+
+/**
+ * One drawable triangle list of a model, placed by the node that references it.
+ */
+struct ModelPrimitive {
+    ModelAccessor position;     // float3
+    ModelAccessor normal;       // float3
+    ModelAccessor indices;      // count is 0 for non-indexed primitives
+    uint32_t indexSize;         // 2 or 4 bytes
+    glm::vec4 baseColor;        // Linear RGBA
+    glm::mat4 transform;        // Node to model space
+};
+
+/**
+ * Geometry of a model as views into its source data, ready to be uploaded without
+ * being copied first. The views point into the mappings in files or, for models
+ * built in memory, into buffers; both move with the model and keep the views valid.
+ */
+struct ModelData {
+    std::vector<MappedFile> files;
+    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<ModelBufferView> views;     // Only the views the primitives use
+    std::vector<ModelPrimitive> primitives;
+    uint64_t hash = 0;                      // See hashModelData(); 0 until computed
+};
+
+/**
+ * Loads the triangle geometry of a glTF 2.0 model: a binary .glb, or a .gltf with
+ * external .bin buffers. Files are memory-mapped and the returned views point into
+ * the mappings, so no vertex data is read or copied here; only indices are scanned
+ * once to check that they stay within their primitive's vertices. The hash is left
+ * at 0, so a caller that already knows the model never pays for hashing it.
+ *
+ * Primitives of the default scene are listed once per node that instances them.
+ * Each needs float3 POSITION and NORMAL attributes and 16- or 32-bit indices (or
+ * none); its material contributes the base color factor. Textures, skins, morph
+ * targets and sparse accessors are not supported. Throws on malformed or
+ * unsupported files.
+ *
+ * @param path Model file
+ * @return Model geometry
+ */
+ModelData loadGltfModel(const std::string& path);
+
+/**
+ * Hashes the content of a model: the bytes of its views and the description of its
+ * primitives. Reads every byte of every view. Equal models have equal hashes
+ * whatever file they came from; equal hashes are confirmed with sameModelData().
+ *
+ * @param model Model to hash
+ * @return 64-bit content hash
+ */
+uint64_t hashModelData(const ModelData& model);
+
+/**
+ * Compares the content of two models byte for byte, as hashModelData() hashes it.
+ *
+ * @param a First model
+ * @param b Second model
+ * @return True if both have the same view bytes and primitives
+ */
+bool sameModelData(const ModelData& a, const ModelData& b);
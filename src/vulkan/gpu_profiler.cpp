@@ -0,0 +1,115 @@
+#include "vulkan/gpu_profiler.h"
+#include <stdexcept>
+#include <algorithm>
+
+// Weight of the newest sample in the smoothed scope times
+static const float SMOOTHING_FACTOR = 0.1f;
+
+GpuProfiler::GpuProfiler(VkPhysicalDevice physicalDevice, VkDevice device,
+                         const std::vector<std::string>& scopeNames)
+    : m_device(device), m_queryPool(VK_NULL_HANDLE), m_supported(false),
+      m_timestampPeriod(1.0f), m_timestampMask(~0ull),
+      m_scopeNames(scopeNames), m_scopeTimes(scopeNames.size(), 0.0f) {
+
+    for (auto& recorded : m_scopeRecorded) {
+        recorded.assign(scopeNames.size(), false);
+    }
+
+    // Timestamps must work on both the graphics and the compute queue
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    m_supported = properties.limits.timestampComputeAndGraphics == VK_TRUE && !scopeNames.empty();
+    m_timestampPeriod = properties.limits.timestampPeriod;
+
+    if (!m_supported) {
+        return;
+    }
+
+    // Use the narrowest timestamp width of any queue family so wrap-around is handled everywhere
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = 64;
+    for (const auto& family : queueFamilies) {
+        if (family.timestampValidBits > 0) {
+            validBits = std::min(validBits, family.timestampValidBits);
+        }
+    }
+    m_timestampMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1);
+
+    // Two queries (begin, end) per scope per frame in flight
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = Renderer::MAX_FRAMES_IN_FLIGHT * getScopeCount() * 2;
+
+    if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool!");
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (m_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+    }
+}
+
+void GpuProfiler::collect(uint32_t frameIndex) {
+    if (!m_supported) {
+        return;
+    }
+
+    std::vector<bool>& recorded = m_scopeRecorded[frameIndex];
+    for (uint32_t scope = 0; scope < getScopeCount(); scope++) {
+        float milliseconds = 0.0f;
+
+        if (recorded[scope]) {
+            uint64_t timestamps[2] = {0, 0};
+            VkResult result = vkGetQueryPoolResults(
+                m_device, m_queryPool, queryIndex(frameIndex, scope), 2,
+                sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            // The frame's fence has signaled, so the results are normally available
+            if (result != VK_SUCCESS) {
+                continue;
+            }
+
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & m_timestampMask;
+            milliseconds = static_cast<float>(ticks) * m_timestampPeriod * 1e-6f;
+            recorded[scope] = false;
+        }
+
+        // Scopes that did not run decay towards zero
+        m_scopeTimes[scope] += (milliseconds - m_scopeTimes[scope]) * SMOOTHING_FACTOR;
+    }
+}
+
+void GpuProfiler::resetScopes(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                              uint32_t firstScope, uint32_t scopeCount) {
+    if (!m_supported) {
+        return;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, queryIndex(frameIndex, firstScope), scopeCount * 2);
+}
+
+void GpuProfiler::beginScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t scope) {
+    if (!m_supported) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool,
+                        queryIndex(frameIndex, scope));
+}
+
+void GpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t scope) {
+    if (!m_supported) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool,
+                        queryIndex(frameIndex, scope) + 1);
+    m_scopeRecorded[frameIndex][scope] = true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "vulkan/renderer.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <string>
+#include <array>
+
+/**
+ * Measures GPU execution time of named scopes with timestamp queries.
+ *
+ * Each frame in flight owns its own range of queries, so results are read
+ * back without stalling once that frame's fence has been waited on. Scope
+ * times are smoothed over recent frames for display.
+ */
+class GpuProfiler {
+public:
+    /**
+     * Constructor creates the timestamp query pool.
+     *
+     * @param physicalDevice Physical device (for timestamp support and period)
+     * @param device Logical device
+     * @param scopeNames Display name of every scope, indexed by scope id
+     */
+    GpuProfiler(VkPhysicalDevice physicalDevice, VkDevice device,
+                const std::vector<std::string>& scopeNames);
+
+    /**
+     * Destructor destroys the query pool.
+     */
+    ~GpuProfiler();
+
+    /**
+     * Reads back the scopes recorded the last time this frame slot was used.
+     * Must be called after the frame's fence has been waited on.
+     *
+     * @param frameIndex Index of the frame in flight
+     */
+    void collect(uint32_t frameIndex);
+
+    /**
+     * Resets the queries of a range of scopes before they are written again.
+     * Must be recorded outside of a render pass, before beginScope().
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     * @param firstScope First scope id to reset
+     * @param scopeCount Number of consecutive scopes to reset
+     */
+    void resetScopes(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t firstScope, uint32_t scopeCount);
+
+    /**
+     * Starts timing a scope. May be recorded inside a render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     * @param scope Scope id
+     */
+    void beginScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t scope);
+
+    /**
+     * Stops timing a scope.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     * @param scope Scope id
+     */
+    void endScope(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t scope);
+
+    /**
+     * Gets the smoothed GPU time of a scope.
+     *
+     * @param scope Scope id
+     * @return Time in milliseconds, 0 if the scope has not run recently
+     */
+    float getScopeTime(uint32_t scope) const { return m_scopeTimes[scope]; }
+
+    /**
+     * Gets the display name of a scope.
+     *
+     * @param scope Scope id
+     * @return Scope name
+     */
+    const std::string& getScopeName(uint32_t scope) const { return m_scopeNames[scope]; }
+
+    /**
+     * Gets the number of scopes.
+     *
+     * @return Scope count
+     */
+    uint32_t getScopeCount() const { return static_cast<uint32_t>(m_scopeNames.size()); }
+
+    /**
+     * Checks whether the device supports timestamps on graphics and compute queues.
+     *
+     * @return True if scope times are measured
+     */
+    bool isSupported() const { return m_supported; }
+
+private:
+    VkDevice m_device;
+    VkQueryPool m_queryPool;
+    bool m_supported;
+    float m_timestampPeriod;   // Nanoseconds per timestamp tick
+    uint64_t m_timestampMask;  // Valid timestamp bits
+
+    std::vector<std::string> m_scopeNames;
+    std::vector<float> m_scopeTimes;
+
+    // Scopes that were recorded in each frame slot and await readback
+    std::array<std::vector<bool>, Renderer::MAX_FRAMES_IN_FLIGHT> m_scopeRecorded;
+
+    /**
+     * Gets the first query of a scope in a frame slot (begin, end follows).
+     */
+    uint32_t queryIndex(uint32_t frameIndex, uint32_t scope) const {
+        return (frameIndex * getScopeCount() + scope) * 2;
+    }
+};
@@ -52,7 +52,8 @@ void DestroyDebugUtilsMessengerEXT(
     }
 }
 
-VulkanInstance::VulkanInstance(GLFWwindow* window) : m_physicalDevice(VK_NULL_HANDLE) {
+VulkanInstance::VulkanInstance(GLFWwindow* window)
+    : m_physicalDevice(VK_NULL_HANDLE), m_cmdBeginRendering(nullptr), m_cmdEndRendering(nullptr) {
     createInstance();
     
     if (m_enableValidationLayers) {
@@ -260,6 +261,16 @@ VulkanInstance::QueueFamilyIndices VulkanInstance::findQueueFamilies(VkPhysicalD
         }
     }
     
+    // Look for a compute family without graphics support (async compute)
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+            !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.computeFamily = i;
+            indices.computeFamilyHasValue = true;
+            break;
+        }
+    }
+    
     return indices;
 }
 
@@ -283,15 +294,49 @@ bool VulkanInstance::checkDeviceExtensionSupport(VkPhysicalDevice device) {
     return requiredExtensions.empty();
 }
 
+bool VulkanInstance::checkDynamicRenderingSupport(VkPhysicalDevice device) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+    
+    bool extensionFound = false;
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) == 0) {
+            extensionFound = true;
+            break;
+        }
+    }
+    
+    if (!extensionFound) {
+        return false;
+    }
+    
+    // The extension may be exposed with the feature itself disabled
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &dynamicRenderingFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+    
+    return dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+}
+
 void VulkanInstance::createLogicalDevice() {
     // Find queue families
     QueueFamilyIndices indices = findQueueFamilies(m_physicalDevice);
     m_graphicsQueueFamily = indices.graphicsFamily;
     m_presentQueueFamily = indices.presentFamily;
     
+    // Fall back to the graphics queue for compute work (graphics families always support compute)
+    m_computeQueueFamily = indices.computeFamilyHasValue ? indices.computeFamily : indices.graphicsFamily;
+    
     // Create a set of unique queue families needed
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+    std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily, m_computeQueueFamily};
     
     // Set queue priorities
     float queuePriority = 1.0f;
@@ -310,16 +355,30 @@ void VulkanInstance::createLogicalDevice() {
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;  // Anisotropic filtering
     
+    // Dynamic rendering is optional; without it the renderer falls back to render pass objects.
+    // Its dependencies (depth_stencil_resolve, create_renderpass2) are core in Vulkan 1.2.
+    std::vector<const char*> enabledExtensions = m_deviceExtensions;
+    bool dynamicRendering = checkDynamicRenderingSupport(m_physicalDevice);
+    
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+    
+    if (dynamicRendering) {
+        enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    }
+    
     // Create the logical device
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = dynamicRendering ? &dynamicRenderingFeatures : nullptr;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
     
-    // Enable device extensions (swapchain)
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    // Enable device extensions (swapchain, dynamic rendering)
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
     
     // For compatibility with older Vulkan implementations, set device layers too
     if (m_enableValidationLayers) {
@@ -337,6 +396,24 @@ void VulkanInstance::createLogicalDevice() {
     // Get queue handles
     vkGetDeviceQueue(m_device, indices.graphicsFamily, 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily, 0, &m_presentQueue);
+    vkGetDeviceQueue(m_device, m_computeQueueFamily, 0, &m_computeQueue);
+    
+    std::cout << (hasAsyncCompute() ? "Async compute queue family: " : "No async compute queue, using graphics family: ")
+              << m_computeQueueFamily << std::endl;
+    
+    if (dynamicRendering) {
+        m_cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+            vkGetDeviceProcAddr(m_device, "vkCmdBeginRenderingKHR"));
+        m_cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+            vkGetDeviceProcAddr(m_device, "vkCmdEndRenderingKHR"));
+        
+        if (m_cmdBeginRendering == nullptr || m_cmdEndRendering == nullptr) {
+            throw std::runtime_error("Failed to load dynamic rendering functions!");
+        }
+    }
+    
+    std::cout << (hasDynamicRendering() ? "Using dynamic rendering" : "Dynamic rendering unavailable, using render passes")
+              << std::endl;
 }
 
 bool VulkanInstance::checkValidationLayerSupport() {
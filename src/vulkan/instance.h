@@ -33,6 +33,48 @@ public:
     uint32_t getGraphicsQueueFamily() const { return m_graphicsQueueFamily; }
     uint32_t getPresentQueueFamily() const { return m_presentQueueFamily; }
     
+    /**
+     * Gets the queue used for compute work. When the device has no separate
+     * compute-capable queue family this is the graphics queue.
+     */
+    VkQueue getComputeQueue() const { return m_computeQueue; }
+    uint32_t getComputeQueueFamily() const { return m_computeQueueFamily; }
+    
+    /**
+     * Checks whether compute work can run on its own queue family,
+     * concurrently with the graphics queue.
+     * 
+     * @return True if a dedicated compute queue was created
+     */
+    bool hasAsyncCompute() const { return m_computeQueueFamily != m_graphicsQueueFamily; }
+    
+    /**
+     * Checks whether render passes can be recorded without VkRenderPass and
+     * framebuffer objects (VK_KHR_dynamic_rendering, core in Vulkan 1.3).
+     * 
+     * @return True if dynamic rendering was enabled on the device
+     */
+    bool hasDynamicRendering() const { return m_cmdBeginRendering != nullptr; }
+    
+    /**
+     * Begins a dynamic render pass instance. Only valid if hasDynamicRendering().
+     * 
+     * @param commandBuffer Command buffer to record into
+     * @param renderingInfo Attachments and render area
+     */
+    void cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR* renderingInfo) const {
+        m_cmdBeginRendering(commandBuffer, renderingInfo);
+    }
+    
+    /**
+     * Ends the current dynamic render pass instance. Only valid if hasDynamicRendering().
+     * 
+     * @param commandBuffer Command buffer to record into
+     */
+    void cmdEndRendering(VkCommandBuffer commandBuffer) const {
+        m_cmdEndRendering(commandBuffer);
+    }
+    
 private:
     VkInstance m_instance;
     VkDebugUtilsMessengerEXT m_debugMessenger;
@@ -43,8 +85,14 @@ private:
     
     uint32_t m_graphicsQueueFamily;
     uint32_t m_presentQueueFamily;
+    uint32_t m_computeQueueFamily;
     VkQueue m_graphicsQueue;
     VkQueue m_presentQueue;
+    VkQueue m_computeQueue;
+    
+    // Dynamic rendering entry points, null when the device does not support it
+    PFN_vkCmdBeginRenderingKHR m_cmdBeginRendering;
+    PFN_vkCmdEndRenderingKHR m_cmdEndRendering;
     
     /**
      * Creates the Vulkan instance with validation layers if enabled.
@@ -90,8 +138,10 @@ private:
     struct QueueFamilyIndices {
         uint32_t graphicsFamily;
         uint32_t presentFamily;
+        uint32_t computeFamily;
         bool graphicsFamilyHasValue = false;
         bool presentFamilyHasValue = false;
+        bool computeFamilyHasValue = false;  // Only set for a family without graphics support
         bool isComplete() const { return graphicsFamilyHasValue && presentFamilyHasValue; }
     };
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
@@ -104,6 +154,15 @@ private:
      */
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
     
+    /**
+     * Checks if a device supports VK_KHR_dynamic_rendering. The instance targets
+     * Vulkan 1.2, so the extension is used even where the feature is core.
+     * 
+     * @param device Physical device to check
+     * @return True if dynamic rendering can be enabled
+     */
+    bool checkDynamicRenderingSupport(VkPhysicalDevice device);
+    
     /**
      * Queries which validation layers are available.
      * 
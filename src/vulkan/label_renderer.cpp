@@ -0,0 +1,752 @@
+#include "vulkan/label_renderer.h"
+#include "vulkan/renderer.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+// Font rasterization size and distance field spread, both in atlas pixels
+static constexpr float FONT_SIZE_PIXELS = 32.0f;
+static constexpr int SDF_SPREAD = 4;
+
+// On-screen size of the labels relative to the rasterized font
+static constexpr float LABEL_PIXEL_SCALE = 0.5f;
+
+// Declutter cell size in label line heights (roughly one short name per cell)
+static constexpr float CELL_WIDTH_IN_LINES = 6.0f;
+static constexpr float CELL_HEIGHT_IN_LINES = 1.25f;
+
+// Pen positions are stored in quarter pixels next to the glyph code
+static constexpr float PEN_FIXED_POINT_SCALE = 4.0f;
+
+LabelRenderer::LabelRenderer(Renderer* renderer)
+    : m_renderer(renderer),
+      m_atlasImage(VK_NULL_HANDLE), m_atlasMemory(VK_NULL_HANDLE),
+      m_atlasView(VK_NULL_HANDLE), m_atlasSampler(VK_NULL_HANDLE),
+      m_glyphs{}, m_glyphAdvance{}, m_fontSize(FONT_SIZE_PIXELS),
+      m_labelCount(0), m_labelCapacity(0), m_stringCapacity(0),
+      m_descriptorSets{}, m_pushConstants{}, m_gridCapacity(0), m_gridWidth(1), m_gridHeight(1),
+      m_descriptorSetLayout(VK_NULL_HANDLE), m_descriptorPool(VK_NULL_HANDLE),
+      m_pipelineLayout(VK_NULL_HANDLE), m_claimPipeline(VK_NULL_HANDLE),
+      m_resolvePipeline(VK_NULL_HANDLE), m_drawPipeline(VK_NULL_HANDLE) {
+
+    // Build the SDF glyph atlas and its metrics table
+    createGlyphAtlas();
+
+    // Create descriptor layout, pool and per-frame sets
+    createDescriptorResources();
+
+    // Create declutter and billboard pipelines
+    createPipelines();
+
+    // Allocate initial buffers so the descriptor sets are always valid
+    ensureCapacity(64, 64 * MAX_LABEL_CHARS);
+    ensureGridCapacity(1024);
+}
+
+LabelRenderer::~LabelRenderer() {
+    VkDevice device = m_renderer->getDevice();
+
+    // Clean up pipelines
+    vkDestroyPipeline(device, m_drawPipeline, nullptr);
+    vkDestroyPipeline(device, m_resolvePipeline, nullptr);
+    vkDestroyPipeline(device, m_claimPipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+
+    // Clean up descriptor resources
+    vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+
+    // Clean up per-frame and static buffers
+    for (uint32_t i = 0; i < Renderer::MAX_FRAMES_IN_FLIGHT; i++) {
+        destroyBuffer(m_anchorBuffers[i]);
+        destroyBuffer(m_visibilityBuffers[i]);
+        destroyBuffer(m_gridBuffers[i]);
+    }
+    destroyBuffer(m_stringBuffer);
+    destroyBuffer(m_labelBuffer);
+    destroyBuffer(m_glyphBuffer);
+
+    // Clean up the glyph atlas
+    vkDestroySampler(device, m_atlasSampler, nullptr);
+    vkDestroyImageView(device, m_atlasView, nullptr);
+    vkDestroyImage(device, m_atlasImage, nullptr);
+    vkFreeMemory(device, m_atlasMemory, nullptr);
+}
+
+void LabelRenderer::setLabels(const std::vector<std::string>& names) {
+    // Count the glyphs we need to store
+    uint32_t stringLength = 0;
+    for (const auto& name : names) {
+        stringLength += static_cast<uint32_t>(std::min<size_t>(name.size(), MAX_LABEL_CHARS));
+    }
+
+    ensureCapacity(static_cast<uint32_t>(names.size()), std::max(stringLength, 1u));
+
+    // The label and string buffers are shared by all frames in flight
+    vkDeviceWaitIdle(m_renderer->getDevice());
+
+    auto* labels = static_cast<LabelInstance*>(m_labelBuffer.mapped);
+    auto* glyphString = static_cast<uint32_t*>(m_stringBuffer.mapped);
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < names.size(); i++) {
+        const std::string& name = names[i];
+        uint32_t length = static_cast<uint32_t>(std::min<size_t>(name.size(), MAX_LABEL_CHARS));
+
+        labels[i].anchorIndex = static_cast<uint32_t>(i);
+        labels[i].stringOffset = offset;
+        labels[i].length = length;
+        labels[i].padding = 0;
+
+        // Lay the label out once on the CPU so the vertex shader never walks the string
+        float penX = 0.0f;
+        for (uint32_t c = 0; c < length; c++) {
+            uint32_t code = static_cast<unsigned char>(name[c]);
+            if (code >= m_glyphs.size()) {
+                code = '?';
+            }
+
+            uint32_t pen = static_cast<uint32_t>(std::lround(penX * PEN_FIXED_POINT_SCALE));
+            glyphString[offset + c] = code | (std::min(pen, 0xFFFFu) << 16);
+            penX += m_glyphAdvance[code];
+        }
+
+        offset += length;
+    }
+
+    m_labelCount = static_cast<uint32_t>(names.size());
+}
+
+void LabelRenderer::setAnchors(const std::vector<glm::vec3>& positions) {
+    m_pendingAnchors.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        m_pendingAnchors[i] = glm::vec4(positions[i], 1.0f);
+    }
+}
+
+void LabelRenderer::resize(VkExtent2D extent) {
+    float lineHeight = m_fontSize * LABEL_PIXEL_SCALE;
+    m_gridWidth = std::max(static_cast<uint32_t>(std::ceil(extent.width / (lineHeight * CELL_WIDTH_IN_LINES))), 1u);
+    m_gridHeight = std::max(static_cast<uint32_t>(std::ceil(extent.height / (lineHeight * CELL_HEIGHT_IN_LINES))), 1u);
+    ensureGridCapacity(m_gridWidth * m_gridHeight);
+}
+
+void LabelRenderer::recordDeclutter(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                    const glm::mat4& viewProjection, VkExtent2D extent,
+                                    bool asyncCompute) {
+    if (m_labelCount == 0) {
+        return;
+    }
+
+    // The grid was sized for this render target by resize(), between frames
+    float lineHeight = m_fontSize * LABEL_PIXEL_SCALE;
+    glm::vec2 cellSize(lineHeight * CELL_WIDTH_IN_LINES, lineHeight * CELL_HEIGHT_IN_LINES);
+    uint32_t gridWidth = m_gridWidth;
+    uint32_t gridHeight = m_gridHeight;
+
+    // Upload this frame's anchors (the fence for this frame has already been waited on)
+    uint32_t anchorCount = std::min(static_cast<uint32_t>(m_pendingAnchors.size()), m_labelCount);
+    if (anchorCount > 0) {
+        memcpy(m_anchorBuffers[frameIndex].mapped, m_pendingAnchors.data(), anchorCount * sizeof(glm::vec4));
+    }
+
+    PushConstants& pushConstants = m_pushConstants[frameIndex];
+    pushConstants.viewProjection = viewProjection;
+    pushConstants.viewportSize = glm::vec2(static_cast<float>(extent.width), static_cast<float>(extent.height));
+    pushConstants.cellSize = cellSize;
+    pushConstants.labelCount = anchorCount;
+    pushConstants.gridWidth = gridWidth;
+    pushConstants.gridHeight = gridHeight;
+    pushConstants.pixelScale = LABEL_PIXEL_SCALE;
+
+    if (anchorCount == 0) {
+        return;
+    }
+
+    // Reset every grid cell to "unclaimed"
+    vkCmdFillBuffer(commandBuffer, m_gridBuffers[frameIndex].buffer, 0,
+                    static_cast<VkDeviceSize>(gridWidth) * gridHeight * sizeof(uint32_t), 0xFFFFFFFFu);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout,
+                            0, 1, &m_descriptorSets[frameIndex], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT,
+                       0, sizeof(PushConstants), &pushConstants);
+
+    uint32_t groupCount = (anchorCount + 63) / 64;
+
+    // Pass 1: every on-screen label tries to claim its cell, the nearest one wins
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_claimPipeline);
+    vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // Pass 2: labels that own their cell are marked visible
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_resolvePipeline);
+    vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+
+    // Make the visibility flags available to the billboard vertex shader
+    // (a compute-only queue has no vertex stage; the semaphore wait covers it there)
+    if (asyncCompute) {
+        return;
+    }
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void LabelRenderer::draw(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    const PushConstants& pushConstants = m_pushConstants[frameIndex];
+    if (pushConstants.labelCount == 0) {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_drawPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout,
+                            0, 1, &m_descriptorSets[frameIndex], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT,
+                       0, sizeof(PushConstants), &pushConstants);
+
+    // One instance per label, six vertices per glyph slot; unused slots are culled in the vertex shader
+    vkCmdDraw(commandBuffer, MAX_LABEL_CHARS * 6, pushConstants.labelCount, 0, 0);
+}
+
+void LabelRenderer::recreatePipelines() {
+    VkDevice device = m_renderer->getDevice();
+
+    vkDestroyPipeline(device, m_drawPipeline, nullptr);
+    vkDestroyPipeline(device, m_resolvePipeline, nullptr);
+    vkDestroyPipeline(device, m_claimPipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+
+    createPipelines();
+}
+
+void LabelRenderer::createGlyphAtlas() {
+    VkDevice device = m_renderer->getDevice();
+
+    // Rasterize the built-in ImGui font with enough padding around each glyph for the distance field
+    static const ImWchar asciiRange[] = { 0x0020, 0x007E, 0 };
+
+    ImFontAtlas fontAtlas;
+    fontAtlas.Flags |= ImFontAtlasFlags_NoMouseCursors | ImFontAtlasFlags_NoBakedLines;
+    fontAtlas.TexGlyphPadding = SDF_SPREAD + 1;
+
+    ImFontConfig fontConfig;
+    fontConfig.SizePixels = FONT_SIZE_PIXELS;
+    fontConfig.OversampleH = 1;
+    fontConfig.OversampleV = 1;
+    fontConfig.PixelSnapH = true;
+    fontConfig.GlyphRanges = asciiRange;
+    ImFont* font = fontAtlas.AddFontDefault(&fontConfig);
+
+    unsigned char* coverage = nullptr;
+    int width = 0;
+    int height = 0;
+    fontAtlas.GetTexDataAsAlpha8(&coverage, &width, &height);
+
+    if (!font || !coverage) {
+        throw std::runtime_error("Failed to rasterize label font!");
+    }
+
+    // Convert coverage to a signed distance field. A brute-force search over the
+    // spread window is fine here: the atlas is small and this runs once at startup.
+    std::vector<uint8_t> distanceField(static_cast<size_t>(width) * height);
+    const float maxDistance = static_cast<float>(SDF_SPREAD);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool inside = coverage[y * width + x] >= 128;
+            float nearest = maxDistance;
+
+            for (int dy = -SDF_SPREAD; dy <= SDF_SPREAD; dy++) {
+                int sy = y + dy;
+                if (sy < 0 || sy >= height) continue;
+
+                for (int dx = -SDF_SPREAD; dx <= SDF_SPREAD; dx++) {
+                    int sx = x + dx;
+                    if (sx < 0 || sx >= width) continue;
+
+                    if ((coverage[sy * width + sx] >= 128) != inside) {
+                        nearest = std::min(nearest, std::sqrt(static_cast<float>(dx * dx + dy * dy)));
+                    }
+                }
+            }
+
+            // 0.5 is the glyph edge, larger values are inside
+            float signedDistance = inside ? nearest : -nearest;
+            float encoded = 0.5f + 0.5f * signedDistance / maxDistance;
+            distanceField[y * width + x] = static_cast<uint8_t>(std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    // Extract glyph metrics, growing each quad by the spread so the outline fits
+    const float padU = maxDistance / static_cast<float>(width);
+    const float padV = maxDistance / static_cast<float>(height);
+    const float halfLine = 0.5f * m_fontSize;
+
+    for (uint32_t code = 0; code < m_glyphs.size(); code++) {
+        const ImFontGlyph* glyph = (code >= 0x20 && code <= 0x7E)
+            ? font->FindGlyphNoFallback(static_cast<ImWchar>(code))
+            : nullptr;
+
+        if (!glyph) {
+            m_glyphs[code] = GlyphInfo{glm::vec4(0.0f), glm::vec4(0.0f)};
+            m_glyphAdvance[code] = 0.0f;
+            continue;
+        }
+
+        m_glyphs[code].uvRect = glm::vec4(glyph->U0 - padU, glyph->V0 - padV, glyph->U1 + padU, glyph->V1 + padV);
+        m_glyphs[code].quad = glm::vec4(glyph->X0 - maxDistance, glyph->Y0 - maxDistance - halfLine,
+                                        glyph->X1 + maxDistance, glyph->Y1 + maxDistance - halfLine);
+        m_glyphAdvance[code] = glyph->AdvanceX;
+    }
+
+    // Upload the glyph metrics (read-only after this point)
+    m_glyphBuffer = createMappedBuffer(sizeof(GlyphInfo) * m_glyphs.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    memcpy(m_glyphBuffer.mapped, m_glyphs.data(), sizeof(GlyphInfo) * m_glyphs.size());
+
+    // Create the atlas image
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = static_cast<uint32_t>(width);
+    imageInfo.extent.height = static_cast<uint32_t>(height);
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R8_UNORM;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &m_atlasImage) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label atlas image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, m_atlasImage, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = m_renderer->findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &m_atlasMemory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate label atlas memory!");
+    }
+    vkBindImageMemory(device, m_atlasImage, m_atlasMemory, 0);
+
+    // Copy the distance field through a staging buffer
+    BufferResource staging = createMappedBuffer(distanceField.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    memcpy(staging.mapped, distanceField.data(), distanceField.size());
+
+    VkCommandBuffer commandBuffer = m_renderer->beginSingleTimeCommands();
+
+    VkImageMemoryBarrier imageBarrier{};
+    imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = m_atlasImage;
+    imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.layerCount = 1;
+    imageBarrier.srcAccessMask = 0;
+    imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = imageInfo.extent;
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, m_atlasImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+    m_renderer->endSingleTimeCommands(commandBuffer);
+    destroyBuffer(staging);
+
+    // Create the atlas view and sampler
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_atlasImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8_UNORM;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &m_atlasView) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label atlas view!");
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 0.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_atlasSampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label atlas sampler!");
+    }
+}
+
+void LabelRenderer::createDescriptorResources() {
+    VkDevice device = m_renderer->getDevice();
+
+    // Bindings match shaders/label_common.hlsli
+    std::array<VkDescriptorSetLayoutBinding, 8> bindings{};
+    const VkShaderStageFlags computeAndVertex = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+    bindings[0] = {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, computeAndVertex, nullptr};                 // Anchors
+    bindings[1] = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, computeAndVertex, nullptr};                 // Labels
+    bindings[2] = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr};       // Glyph string
+    bindings[3] = {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr};       // Glyph metrics
+    bindings[4] = {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, computeAndVertex, nullptr};                 // Visibility
+    bindings[5] = {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};      // Declutter grid
+    bindings[6] = {6, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};      // Atlas
+    bindings[7] = {7, VK_DESCRIPTOR_TYPE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};            // Atlas sampler
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label descriptor set layout!");
+    }
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6 * Renderer::MAX_FRAMES_IN_FLIGHT};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, Renderer::MAX_FRAMES_IN_FLIGHT};
+    poolSizes[2] = {VK_DESCRIPTOR_TYPE_SAMPLER, Renderer::MAX_FRAMES_IN_FLIGHT};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = Renderer::MAX_FRAMES_IN_FLIGHT;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, Renderer::MAX_FRAMES_IN_FLIGHT> layouts;
+    layouts.fill(m_descriptorSetLayout);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = Renderer::MAX_FRAMES_IN_FLIGHT;
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate label descriptor sets!");
+    }
+}
+
+void LabelRenderer::createPipelines() {
+    VkDevice device = m_renderer->getDevice();
+
+    // One layout shared by the compute and graphics pipelines
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label pipeline layout!");
+    }
+
+    // Declutter compute pipelines
+    VkShaderModule claimShaderModule = m_renderer->createShaderModule("shaders/label_declutter_claim.spv");
+    VkShaderModule resolveShaderModule = m_renderer->createShaderModule("shaders/label_declutter_resolve.spv");
+
+    std::array<VkComputePipelineCreateInfo, 2> computePipelineInfos{};
+    for (auto& info : computePipelineInfos) {
+        info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        info.layout = m_pipelineLayout;
+    }
+    computePipelineInfos[0].stage.module = claimShaderModule;
+    computePipelineInfos[0].stage.pName = "CSClaim";
+    computePipelineInfos[1].stage.module = resolveShaderModule;
+    computePipelineInfos[1].stage.pName = "CSResolve";
+
+    std::array<VkPipeline, 2> computePipelines{};
+    if (vkCreateComputePipelines(device, VK_NULL_HANDLE, static_cast<uint32_t>(computePipelineInfos.size()),
+                                 computePipelineInfos.data(), nullptr, computePipelines.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label declutter pipelines!");
+    }
+    m_claimPipeline = computePipelines[0];
+    m_resolvePipeline = computePipelines[1];
+
+    vkDestroyShaderModule(device, claimShaderModule, nullptr);
+    vkDestroyShaderModule(device, resolveShaderModule, nullptr);
+
+    // Billboard graphics pipeline
+    VkShaderModule vertShaderModule = m_renderer->createShaderModule("shaders/label_vert.spv");
+    VkShaderModule fragShaderModule = m_renderer->createShaderModule("shaders/label_frag.spv");
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "VSMain";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "PSMain";
+
+    // All vertex data comes from storage buffers
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are dynamic
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = m_renderer->getMsaaSamples();
+
+    // Labels are hidden behind the Earth but never write depth themselves
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    m_renderer->setPipelineRenderTarget(pipelineInfo);
+
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_drawPipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create label pipeline!");
+    }
+
+    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+}
+
+void LabelRenderer::ensureCapacity(uint32_t labelCount, uint32_t stringLength) {
+    if (labelCount <= m_labelCapacity && stringLength <= m_stringCapacity) {
+        return;
+    }
+
+    // Grow geometrically so repeated catalog loads do not reallocate every time
+    vkDeviceWaitIdle(m_renderer->getDevice());
+
+    if (labelCount > m_labelCapacity) {
+        m_labelCapacity = std::max(labelCount, m_labelCapacity * 2);
+
+        destroyBuffer(m_labelBuffer);
+        m_labelBuffer = createMappedBuffer(sizeof(LabelInstance) * m_labelCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+        for (uint32_t i = 0; i < Renderer::MAX_FRAMES_IN_FLIGHT; i++) {
+            destroyBuffer(m_anchorBuffers[i]);
+            m_anchorBuffers[i] = createMappedBuffer(sizeof(glm::vec4) * m_labelCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+            destroyBuffer(m_visibilityBuffers[i]);
+            m_renderer->createBuffer(
+                sizeof(uint32_t) * m_labelCapacity,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                m_visibilityBuffers[i].buffer,
+                m_visibilityBuffers[i].memory,
+                true
+            );
+        }
+    }
+
+    if (stringLength > m_stringCapacity) {
+        m_stringCapacity = std::max(stringLength, m_stringCapacity * 2);
+
+        destroyBuffer(m_stringBuffer);
+        m_stringBuffer = createMappedBuffer(sizeof(uint32_t) * m_stringCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    }
+
+    updateDescriptorSets();
+}
+
+void LabelRenderer::ensureGridCapacity(uint32_t cellCount) {
+    if (cellCount <= m_gridCapacity) {
+        return;
+    }
+
+    vkDeviceWaitIdle(m_renderer->getDevice());
+
+    m_gridCapacity = std::max(cellCount, m_gridCapacity * 2);
+
+    for (uint32_t i = 0; i < Renderer::MAX_FRAMES_IN_FLIGHT; i++) {
+        destroyBuffer(m_gridBuffers[i]);
+        m_renderer->createBuffer(
+            sizeof(uint32_t) * m_gridCapacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_gridBuffers[i].buffer,
+            m_gridBuffers[i].memory
+        );
+    }
+
+    updateDescriptorSets();
+}
+
+void LabelRenderer::updateDescriptorSets() {
+    // Wait until every buffer exists (the constructor grows labels and grid separately)
+    if (m_labelBuffer.buffer == VK_NULL_HANDLE || m_gridBuffers[0].buffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < Renderer::MAX_FRAMES_IN_FLIGHT; i++) {
+        std::array<VkDescriptorBufferInfo, 6> bufferInfos{};
+        bufferInfos[0] = {m_anchorBuffers[i].buffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[1] = {m_labelBuffer.buffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[2] = {m_stringBuffer.buffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[3] = {m_glyphBuffer.buffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[4] = {m_visibilityBuffers[i].buffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[5] = {m_gridBuffers[i].buffer, 0, VK_WHOLE_SIZE};
+
+        VkDescriptorImageInfo atlasInfo{};
+        atlasInfo.imageView = m_atlasView;
+        atlasInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkDescriptorImageInfo samplerInfo{};
+        samplerInfo.sampler = m_atlasSampler;
+
+        std::array<VkWriteDescriptorSet, 8> writes{};
+        for (uint32_t binding = 0; binding < writes.size(); binding++) {
+            writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[binding].dstSet = m_descriptorSets[i];
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+
+            if (binding < bufferInfos.size()) {
+                writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[binding].pBufferInfo = &bufferInfos[binding];
+            }
+        }
+        writes[6].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        writes[6].pImageInfo = &atlasInfo;
+        writes[7].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        writes[7].pImageInfo = &samplerInfo;
+
+        vkUpdateDescriptorSets(m_renderer->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+BufferResource LabelRenderer::createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+    BufferResource resource;
+    m_renderer->createBuffer(
+        size,
+        usage,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        resource.buffer,
+        resource.memory,
+        true
+    );
+
+    vkMapMemory(m_renderer->getDevice(), resource.memory, 0, size, 0, &resource.mapped);
+    return resource;
+}
+
+void LabelRenderer::destroyBuffer(BufferResource& resource) {
+    if (resource.buffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkDevice device = m_renderer->getDevice();
+    if (resource.mapped) {
+        vkUnmapMemory(device, resource.memory);
+    }
+    vkDestroyBuffer(device, resource.buffer, nullptr);
+    vkFreeMemory(device, resource.memory, nullptr);
+    resource = BufferResource{};
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "vulkan/buffer_resource.h"
+#include "vulkan/renderer.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <array>
+
+/**
+ * Draws object name labels as camera-facing SDF text billboards.
+ *
+ * All labels are drawn with a single instanced draw call: each instance is one
+ * label and each group of six vertices is one glyph quad. Glyph indices and pen
+ * offsets for every label live in a storage buffer, addressed by a per-instance
+ * string offset and length. Before the draw, a compute pass projects the label
+ * anchors to the screen and declutters them on a coarse screen-space grid so
+ * that only the nearest label in each cell is drawn.
+ */
+class LabelRenderer {
+public:
+    /**
+     * Constructor builds the glyph atlas and creates the label pipelines.
+     *
+     * @param renderer Renderer that owns the device and render pass
+     */
+    LabelRenderer(Renderer* renderer);
+
+    /**
+     * Destructor cleans up Vulkan resources.
+     */
+    ~LabelRenderer();
+
+    /**
+     * Sets the label text, one entry per object.
+     * Text is only re-uploaded when this is called, not every frame.
+     *
+     * @param names Object names, indexed the same way as the anchor positions
+     */
+    void setLabels(const std::vector<std::string>& names);
+
+    /**
+     * Sets the world-space anchor positions for the labels of this frame.
+     * The positions are uploaded when the declutter pass is recorded.
+     *
+     * @param positions Object positions, one per label
+     */
+    void setAnchors(const std::vector<glm::vec3>& positions);
+
+    /**
+     * Sizes the declutter grid for the render target.
+     * Must be called between frames whenever the swapchain is created or recreated.
+     *
+     * @param extent Size of the render target in pixels
+     */
+    void resize(VkExtent2D extent);
+
+    /**
+     * Records the screen-space declutter compute pass.
+     * Must be recorded outside of a render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     * @param viewProjection Combined view-projection matrix
+     * @param extent Size of the render target in pixels, as last passed to resize()
+     * @param asyncCompute True if recorded for the compute queue; the caller's semaphore
+     *                     then replaces the final barrier to the vertex shader
+     */
+    void recordDeclutter(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                         const glm::mat4& viewProjection, VkExtent2D extent,
+                         bool asyncCompute);
+
+    /**
+     * Records the instanced label draw.
+     * Must be recorded inside the main render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     */
+    void draw(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    /**
+     * Rebuilds the pipelines after the main render pass changed (e.g. its sample count).
+     */
+    void recreatePipelines();
+
+    /**
+     * Gets the number of labels currently submitted.
+     *
+     * @return Label count
+     */
+    uint32_t getLabelCount() const { return m_labelCount; }
+
+    // Maximum number of characters drawn per label
+    static constexpr uint32_t MAX_LABEL_CHARS = 24;
+
+private:
+    Renderer* m_renderer;
+
+    // Per-glyph metrics as laid out in the glyph storage buffer
+    struct GlyphInfo {
+        glm::vec4 uvRect;    // u0, v0, u1, v1 in the atlas
+        glm::vec4 quad;      // x0, y0, x1, y1 in font pixels relative to the pen
+    };
+
+    // Per-label instance data as laid out in the label storage buffer
+    struct LabelInstance {
+        uint32_t anchorIndex;   // Index into the anchor buffer
+        uint32_t stringOffset;  // First entry in the glyph string buffer
+        uint32_t length;        // Number of glyphs in the label
+        uint32_t padding;
+    };
+
+    // Push constants shared by the compute and graphics stages
+    struct PushConstants {
+        glm::mat4 viewProjection;
+        glm::vec2 viewportSize;
+        glm::vec2 cellSize;
+        uint32_t labelCount;
+        uint32_t gridWidth;
+        uint32_t gridHeight;
+        float pixelScale;
+    };
+
+    // Glyph atlas (single-channel signed distance field)
+    VkImage m_atlasImage;
+    VkDeviceMemory m_atlasMemory;
+    VkImageView m_atlasView;
+    VkSampler m_atlasSampler;
+    std::array<GlyphInfo, 128> m_glyphs;
+    std::array<float, 128> m_glyphAdvance;
+    float m_fontSize;
+
+    // Static label data, rebuilt by setLabels()
+    BufferResource m_glyphBuffer;
+    BufferResource m_labelBuffer;
+    BufferResource m_stringBuffer;
+    uint32_t m_labelCount;
+    uint32_t m_labelCapacity;
+    uint32_t m_stringCapacity;
+
+    // Per-frame data
+    std::array<BufferResource, Renderer::MAX_FRAMES_IN_FLIGHT> m_anchorBuffers;
+    std::array<BufferResource, Renderer::MAX_FRAMES_IN_FLIGHT> m_visibilityBuffers;
+    std::array<BufferResource, Renderer::MAX_FRAMES_IN_FLIGHT> m_gridBuffers;
+    std::array<VkDescriptorSet, Renderer::MAX_FRAMES_IN_FLIGHT> m_descriptorSets;
+    std::array<PushConstants, Renderer::MAX_FRAMES_IN_FLIGHT> m_pushConstants;
+    uint32_t m_gridCapacity;
+    uint32_t m_gridWidth;
+    uint32_t m_gridHeight;
+    std::vector<glm::vec4> m_pendingAnchors;
+
+    // Pipelines
+    VkDescriptorSetLayout m_descriptorSetLayout;
+    VkDescriptorPool m_descriptorPool;
+    VkPipelineLayout m_pipelineLayout;
+    VkPipeline m_claimPipeline;
+    VkPipeline m_resolvePipeline;
+    VkPipeline m_drawPipeline;
+
+    /**
+     * Rasterizes the default ImGui font and converts it to a distance field atlas.
+     */
+    void createGlyphAtlas();
+
+    /**
+     * Creates the descriptor set layout, pool and per-frame sets.
+     */
+    void createDescriptorResources();
+
+    /**
+     * Creates the declutter compute pipelines and the billboard graphics pipeline.
+     */
+    void createPipelines();
+
+    /**
+     * Grows the label, string and per-frame buffers to hold the given sizes.
+     *
+     * @param labelCount Required number of labels
+     * @param stringLength Required total number of glyphs
+     */
+    void ensureCapacity(uint32_t labelCount, uint32_t stringLength);
+
+    /**
+     * Grows the per-frame declutter grid to hold the given number of cells.
+     *
+     * @param cellCount Required number of grid cells
+     */
+    void ensureGridCapacity(uint32_t cellCount);
+
+    /**
+     * Points every per-frame descriptor set at the current buffers.
+     */
+    void updateDescriptorSets();
+
+    /**
+     * Creates a persistently mapped host-visible buffer, shared with the compute queue.
+     *
+     * @param size Buffer size in bytes
+     * @param usage Buffer usage flags
+     * @return The created buffer
+     */
+    BufferResource createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+
+    /**
+     * Destroys a buffer and frees its memory.
+     *
+     * @param resource Buffer to destroy
+     */
+    void destroyBuffer(BufferResource& resource);
+};
@@ -0,0 +1,94 @@
+#include "vulkan/model_cache.h"
+#include "vulkan/renderer.h"
+#include <limits>
+#include <stdexcept>
+
+// Views start 16-byte aligned, which keeps every accessor as aligned as in its file
+static constexpr VkDeviceSize VIEW_ALIGNMENT = 16;
+
+ModelCache::ModelCache(Renderer* renderer) : m_renderer(renderer), m_uploads(renderer) {}
+
+ModelCache::~ModelCache() {
+    VkDevice device = m_renderer->getDevice();
+
+    for (auto& entry : m_models) {
+        vkDestroyBuffer(device, entry.second->model.buffer, nullptr);
+        vkFreeMemory(device, entry.second->model.memory, nullptr);
+    }
+}
+
+const GpuModel* ModelCache::load(const std::string& path) {
+    auto known = m_modelsByPath.find(path);
+    if (known != m_modelsByPath.end()) {
+        return known->second;
+    }
+
+    const GpuModel* model = add(loadGltfModel(path));
+    m_modelsByPath[path] = model;
+    return model;
+}
+
+const GpuModel* ModelCache::add(ModelData&& model) {
+    if (model.hash == 0) {
+        model.hash = hashModelData(model);
+    }
+
+    // Same content as a model already uploaded: share it and drop this copy
+    auto [first, last] = m_models.equal_range(model.hash);
+    for (auto known = first; known != last; ++known) {
+        if (sameModelData(known->second->source, model)) {
+            return &known->second->model;
+        }
+    }
+
+    std::vector<VkDeviceSize> viewOffsets;
+    VkDeviceSize size = 0;
+    for (const ModelBufferView& view : model.views) {
+        viewOffsets.push_back(size);
+        size = (size + view.size + VIEW_ALIGNMENT - 1) / VIEW_ALIGNMENT * VIEW_ALIGNMENT;
+    }
+    if (size == 0 || size > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Failed to add model: unsupported size!");
+    }
+
+    auto cached = std::make_unique<CachedModel>();
+    GpuModel* gpuModel = &cached->model;
+    gpuModel->hash = model.hash;
+    m_renderer->createBuffer(
+        size,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        gpuModel->buffer,
+        gpuModel->memory
+    );
+
+    // Copied straight from the views during the flush
+    for (size_t i = 0; i < model.views.size(); i++) {
+        m_uploads.add(gpuModel->buffer, viewOffsets[i], model.views[i].data, model.views[i].size);
+    }
+
+    for (const ModelPrimitive& source : model.primitives) {
+        GpuPrimitive primitive{};
+        primitive.positionOffset = static_cast<uint32_t>(viewOffsets[source.position.view] + source.position.offset);
+        primitive.positionStride = source.position.stride;
+        primitive.normalOffset = static_cast<uint32_t>(viewOffsets[source.normal.view] + source.normal.offset);
+        primitive.normalStride = source.normal.stride;
+        primitive.indexOffset = viewOffsets[source.indices.view] + source.indices.offset;
+        primitive.indexType = (source.indexSize == 2) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        primitive.indexCount = source.indices.count;
+        primitive.vertexCount = source.position.count;
+        primitive.baseColor = source.baseColor;
+        primitive.transform = source.transform;
+        gpuModel->primitives.push_back(primitive);
+    }
+
+    // The source backs the queued copies and later content comparisons; moving it
+    // leaves the views valid
+    cached->source = std::move(model);
+    m_models.emplace(gpuModel->hash, std::move(cached));
+    return gpuModel;
+}
+
+void ModelCache::flushUploads() {
+    m_uploads.flush();
+}
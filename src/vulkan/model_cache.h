@@ -0,0 +1,107 @@
+#pragma once
+
+#include "vulkan/gltf_model.h"
+#include "vulkan/upload_batch.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+class Renderer;
+
+/**
+ * Primitive of an uploaded model, addressed by byte offsets into the model buffer.
+ */
+struct GpuPrimitive {
+    uint32_t positionOffset;    // First float3 position
+    uint32_t positionStride;
+    uint32_t normalOffset;      // First float3 normal
+    uint32_t normalStride;
+    VkDeviceSize indexOffset;   // First index, for vkCmdBindIndexBuffer
+    VkIndexType indexType;
+    uint32_t indexCount;        // 0 for non-indexed primitives
+    uint32_t vertexCount;
+    glm::vec4 baseColor;
+    glm::mat4 transform;        // Node to model space
+};
+
+/**
+ * Model in device memory: all of its vertex and index data in one buffer, usable
+ * both as a storage buffer (vertex pulling) and as an index buffer.
+ */
+struct GpuModel {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    std::vector<GpuPrimitive> primitives;
+    uint64_t hash = 0;
+};
+
+/**
+ * Uploads models and shares them by content.
+ *
+ * A path that was loaded before is answered without touching the file. Other
+ * models are hashed with hashModelData() and compared byte for byte with the
+ * cached models of equal hash, so the same geometry loaded twice, from copies of
+ * a file or built in memory, is uploaded once and every instance draws from the
+ * same buffer, while a hash collision still gets its own. The cache keeps each
+ * model's source (a read-only mapping or its own buffers) for these comparisons.
+ * Uploads are queued into one UploadBatch straight from the model's views and go
+ * to the GPU together in flushUploads(); returned models may only be drawn after
+ * that.
+ */
+class ModelCache {
+public:
+    /**
+     * @param renderer Renderer that owns the device
+     */
+    explicit ModelCache(Renderer* renderer);
+
+    /**
+     * Destructor frees every model; none may still be in use by the GPU.
+     */
+    ~ModelCache();
+
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    /**
+     * Loads a glTF model, or returns the cached one for this path or content.
+     * Throws if the file cannot be loaded.
+     *
+     * @param path Model file, see loadGltfModel()
+     * @return Model, owned by the cache
+     */
+    const GpuModel* load(const std::string& path);
+
+    /**
+     * Adds model data from any source, or returns the cached model of equal content.
+     * The views must point into the model's own files or buffers.
+     *
+     * @param model Model data; its hash is computed if it is 0
+     * @return Model, owned by the cache
+     */
+    const GpuModel* add(ModelData&& model);
+
+    /**
+     * Uploads every model added since the last call with one submission and waits
+     * for it.
+     */
+    void flushUploads();
+
+private:
+    Renderer* m_renderer;
+
+    // Uploaded model with the source it was uploaded from
+    struct CachedModel {
+        GpuModel model;
+        ModelData source;
+    };
+
+    std::unordered_multimap<uint64_t, std::unique_ptr<CachedModel>> m_models;  // By content hash
+    std::unordered_map<std::string, const GpuModel*> m_modelsByPath;
+
+    UploadBatch m_uploads;
+};
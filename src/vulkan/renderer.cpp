@@ -1,24 +1,39 @@
 #include "vulkan/renderer.h"
 #include "vulkan/instance.h"
 #include "vulkan/swapchain.h"
+#include "vulkan/label_renderer.h"
+#include "vulkan/trail_renderer.h"
+#include "vulkan/spacecraft_renderer.h"
+#include "vulkan/upload_batch.h"
+#include "vulkan/gpu_profiler.h"
 #include <stdexcept>
 #include <array>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/constants.hpp>
 
 Renderer::Renderer(GLFWwindow* window) 
-    : m_window(window), m_currentFrame(0), m_currentImageIndex(0) {
+    : m_window(window), m_renderPass(VK_NULL_HANDLE), m_currentFrame(0), m_currentImageIndex(0),
+      m_asyncComputeEnabled(true), m_computeSubmitted(false),
+      m_msaaSamples(VK_SAMPLE_COUNT_1_BIT), m_analyticAntialiasing(false),
+      m_dynamicRendering(false), m_overlayPassActive(false),
+      m_colorAttachmentFormat(VK_FORMAT_UNDEFINED), m_pipelineRenderingInfo{},
+      m_labelsEnabled(true), m_trailsEnabled(true), m_earthRotationAngle(0.0f) {
     
     // Create Vulkan instance and select device
     m_instance = std::make_unique<VulkanInstance>(window);
+    m_dynamicRendering = m_instance->hasDynamicRendering();
     
-    // Create render pass
-    createRenderPass();
+    // Create render pass (only needed when dynamic rendering is unavailable)
+    if (!m_dynamicRendering) {
+        createRenderPass();
+    }
     
-    // Create swapchain
-    m_swapchain = std::make_unique<VulkanSwapchain>(window, m_instance.get(), m_renderPass);
+    // Create swapchain (without framebuffers on the dynamic rendering path)
+    m_swapchain = std::make_unique<VulkanSwapchain>(window, m_instance.get(), m_renderPass, m_msaaSamples);
+    updatePipelineRenderingInfo();
     
     // Create descriptor resources for uniform buffers
     createDescriptorResources();
@@ -35,9 +50,24 @@ Renderer::Renderer(GLFWwindow* window)
     // Create synchronization objects
     createSyncObjects();
     
+    // Create the GPU timestamp profiler (scope names indexed by GpuScope)
+    m_profiler = std::make_unique<GpuProfiler>(
+        m_instance->getPhysicalDevice(), m_instance->getLogicalDevice(),
+        std::vector<std::string>{"Graphics", "Resolve", "Compute"});
+    
     // Create Earth geometry
     createEarthGeometry();
     
+    // Create the object label renderer
+    m_labelRenderer = std::make_unique<LabelRenderer>(this);
+    m_labelRenderer->resize(m_swapchain->getExtent());
+    
+    // Create the orbit trail renderer
+    m_trailRenderer = std::make_unique<TrailRenderer>(this, DEFAULT_TRAIL_LENGTH);
+    
+    // Create the spacecraft model renderer
+    m_spacecraftRenderer = std::make_unique<SpacecraftRenderer>(this);
+    
     // Initialize view and projection matrices
     m_viewMatrix = glm::lookAt(
         glm::vec3(0.0f, 0.0f, 15.0f),  // Camera position
@@ -64,15 +94,23 @@ Renderer::~Renderer() {
     // Wait for the device to finish operations
     vkDeviceWaitIdle(m_instance->getLogicalDevice());
     
+    // Clean up feature renderers
+    m_labelRenderer.reset();
+    m_trailRenderer.reset();
+    m_spacecraftRenderer.reset();
+    m_profiler.reset();
+    
     // Clean up synchronization objects
     for (size_t i = 0; i < m_inFlightFences.size(); i++) {
         vkDestroyFence(m_instance->getLogicalDevice(), m_inFlightFences[i], nullptr);
         vkDestroySemaphore(m_instance->getLogicalDevice(), m_renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(m_instance->getLogicalDevice(), m_imageAvailableSemaphores[i], nullptr);
+        vkDestroySemaphore(m_instance->getLogicalDevice(), m_computeFinishedSemaphores[i], nullptr);
     }
     
-    // Clean up command pool
+    // Clean up command pools
     vkDestroyCommandPool(m_instance->getLogicalDevice(), m_commandPool, nullptr);
+    vkDestroyCommandPool(m_instance->getLogicalDevice(), m_computeCommandPool, nullptr);
     
     // Clean up satellite vertex buffer
     vkDestroyBuffer(m_instance->getLogicalDevice(), m_satelliteVertexBuffer.buffer, nullptr);
@@ -103,8 +141,10 @@ Renderer::~Renderer() {
     // Clean up swapchain
     m_swapchain.reset();
     
-    // Clean up render pass
-    vkDestroyRenderPass(m_instance->getLogicalDevice(), m_renderPass, nullptr);
+    // Clean up render pass (none on the dynamic rendering path)
+    if (m_renderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(m_instance->getLogicalDevice(), m_renderPass, nullptr);
+    }
     
     // Clean up Vulkan instance (handled by unique_ptr)
 }
@@ -115,6 +155,9 @@ bool Renderer::beginFrame() {
     // Wait for the previous frame to finish
     vkWaitForFences(device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
     
+    // GPU timings of the last use of this frame slot are now available
+    m_profiler->collect(m_currentFrame);
+    
     // Acquire an image from the swapchain
     VkResult result = m_swapchain->acquireNextImage(
         m_imageAvailableSemaphores[m_currentFrame], m_currentImageIndex);
@@ -141,23 +184,74 @@ bool Renderer::beginFrame() {
         throw std::runtime_error("Failed to begin recording command buffer!");
     }
     
-    // Begin render pass
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_renderPass;
-    renderPassInfo.framebuffer = m_swapchain->getFramebuffers()[m_currentImageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = m_swapchain->getExtent();
+    m_profiler->resetScopes(m_commandBuffers[m_currentFrame], m_currentFrame, GPU_SCOPE_GRAPHICS, 2);
+    m_profiler->beginScope(m_commandBuffers[m_currentFrame], m_currentFrame, GPU_SCOPE_GRAPHICS);
+    
+    // Copy the latest trail sample into the history ring (kept up to date even when hidden)
+    m_trailRenderer->recordUpload(m_commandBuffers[m_currentFrame], m_currentFrame);
+    
+    // Write this frame's spacecraft instances (read directly by the vertex input)
+    m_spacecraftRenderer->uploadInstances(m_currentFrame);
+    
+    // Declutter labels before the render pass (compute work cannot run inside it).
+    // With a dedicated compute queue it is submitted separately and overlaps the
+    // previous frame's graphics work; otherwise it runs at the start of this frame.
+    m_computeSubmitted = false;
+    if (m_labelsEnabled) {
+        if (m_asyncComputeEnabled && m_instance->hasAsyncCompute()) {
+            submitAsyncCompute();
+        } else {
+            m_profiler->resetScopes(m_commandBuffers[m_currentFrame], m_currentFrame, GPU_SCOPE_COMPUTE, 1);
+            m_profiler->beginScope(m_commandBuffers[m_currentFrame], m_currentFrame, GPU_SCOPE_COMPUTE);
+            m_labelRenderer->recordDeclutter(
+                m_commandBuffers[m_currentFrame],
+                m_currentFrame,
+                m_projectionMatrix * m_viewMatrix,
+                m_swapchain->getExtent(),
+                false
+            );
+            m_profiler->endScope(m_commandBuffers[m_currentFrame], m_currentFrame, GPU_SCOPE_COMPUTE);
+        }
+    }
     
-    // Setup clear values (color and depth)
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {0.0f, 0.0f, 0.05f, 1.0f};  // Dark blue space background
-    clearValues[1].depthStencil = {1.0f, 0};           // Depth clear value (1.0 is "far")
+    m_overlayPassActive = false;
+    
+    if (m_dynamicRendering) {
+        // Attachments are bound directly; their layouts are managed here instead of by a render pass
+        recordAttachmentTransitions();
+        beginDynamicRendering(false);
+    } else {
+        // Begin render pass
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_renderPass;
+        renderPassInfo.framebuffer = m_swapchain->getFramebuffers()[m_currentImageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = m_swapchain->getExtent();
+        
+        // Setup clear values (color and depth)
+        std::array<VkClearValue, 2> clearValues{};
+        clearValues[0].color = {0.0f, 0.0f, 0.05f, 1.0f};  // Dark blue space background
+        clearValues[1].depthStencil = {1.0f, 0};           // Depth clear value (1.0 is "far")
+        
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+        
+        vkCmdBeginRenderPass(m_commandBuffers[m_currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
     
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
+    // Viewport, scissor and line width are dynamic state in the pipelines
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(m_swapchain->getExtent().width);
+    viewport.height = static_cast<float>(m_swapchain->getExtent().height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(m_commandBuffers[m_currentFrame], 0, 1, &viewport);
     
-    vkCmdBeginRenderPass(m_commandBuffers[m_currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    VkRect2D scissor{};
+    scissor.extent = m_swapchain->getExtent();
+    vkCmdSetScissor(m_commandBuffers[m_currentFrame], 0, 1, &scissor);
+    vkCmdSetLineWidth(m_commandBuffers[m_currentFrame], 1.0f);
     
     // Update uniform buffer with current matrices
     updateUniformBuffer();
@@ -166,11 +260,44 @@ bool Renderer::beginFrame() {
 }
 
 void Renderer::endFrame() {
-    // End the render pass
-    vkCmdEndRenderPass(m_commandBuffers[m_currentFrame]);
+    VkCommandBuffer cmdBuffer = m_commandBuffers[m_currentFrame];
+    
+    // On the dynamic rendering path the overlay pass performs the resolve,
+    // so it is started even if no UI was drawn
+    beginOverlayPass();
+    
+    // End the render pass; the MSAA resolve (or plain store) runs at its end
+    m_profiler->beginScope(cmdBuffer, m_currentFrame, GPU_SCOPE_RESOLVE);
+    if (m_dynamicRendering) {
+        m_instance->cmdEndRendering(cmdBuffer);
+    } else {
+        vkCmdEndRenderPass(cmdBuffer);
+    }
+    m_profiler->endScope(cmdBuffer, m_currentFrame, GPU_SCOPE_RESOLVE);
+    
+    if (m_dynamicRendering) {
+        // Without a render pass the transition to the present layout is explicit
+        VkImageMemoryBarrier presentBarrier{};
+        presentBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        presentBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        presentBarrier.dstAccessMask = 0;
+        presentBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        presentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        presentBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        presentBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        presentBarrier.image = m_swapchain->getImage(m_currentImageIndex);
+        presentBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        
+        vkCmdPipelineBarrier(cmdBuffer,
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &presentBarrier);
+    }
+    
+    m_profiler->endScope(cmdBuffer, m_currentFrame, GPU_SCOPE_GRAPHICS);
     
     // End command buffer recording
-    if (vkEndCommandBuffer(m_commandBuffers[m_currentFrame]) != VK_SUCCESS) {
+    if (vkEndCommandBuffer(cmdBuffer) != VK_SUCCESS) {
         throw std::runtime_error("Failed to record command buffer!");
     }
     
@@ -178,10 +305,11 @@ void Renderer::endFrame() {
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     
-    // Wait on the image available semaphore
-    VkSemaphore waitSemaphores[] = {m_imageAvailableSemaphores[m_currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    // Wait on the image available semaphore, and on the async compute work
+    // before the first vertex shader that reads its results
+    VkSemaphore waitSemaphores[] = {m_imageAvailableSemaphores[m_currentFrame], m_computeFinishedSemaphores[m_currentFrame]};
+    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT};
+    submitInfo.waitSemaphoreCount = m_computeSubmitted ? 2 : 1;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     
@@ -210,7 +338,7 @@ void Renderer::endFrame() {
     }
     
     // Advance to the next frame
-    m_currentFrame = (m_currentFrame + 1) % m_imageAvailableSemaphores.size();
+    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
 void Renderer::recreateSwapchain() {
@@ -243,8 +371,12 @@ void Renderer::recreateSwapchain() {
     
     // Keep pipelines and pipeline layout
     
-    // Recreate swapchain
-    m_swapchain = std::make_unique<VulkanSwapchain>(m_window, m_instance.get(), m_renderPass);
+    // Recreate swapchain (framebuffers only exist on the render pass path)
+    m_swapchain = std::make_unique<VulkanSwapchain>(m_window, m_instance.get(), m_renderPass, m_msaaSamples);
+    updatePipelineRenderingInfo();
+    
+    // The label declutter grid covers the new window size
+    m_labelRenderer->resize(m_swapchain->getExtent());
     
     // Recreate descriptor resources
     createDescriptorResources();
@@ -264,12 +396,12 @@ void Renderer::recreateSwapchain() {
     std::cout << "Swapchain recreated successfully" << std::endl;
 }
 
-void Renderer::updateCamera(const glm::vec3& position, const glm::vec3& target) {
+void Renderer::updateCamera(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up) {
     // Update the view matrix
     m_viewMatrix = glm::lookAt(
-        position,                   // Camera position
-        target,                     // Look at target
-        glm::vec3(0.0f, 1.0f, 0.0f) // Up vector
+        position,   // Camera position
+        target,     // Look at target
+        up          // Up vector
     );
 }
 
@@ -374,10 +506,133 @@ void Renderer::drawSatellite(const glm::vec3& position) {
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
     
+    // Smooth the disc edge analytically, or through alpha-to-coverage under MSAA
+    PointPushConstants pointParams{};
+    pointParams.viewportSize = glm::vec2(
+        static_cast<float>(m_swapchain->getExtent().width),
+        static_cast<float>(m_swapchain->getExtent().height));
+    pointParams.pointSize = SATELLITE_POINT_SIZE;
+    pointParams.smoothEdges = (m_analyticAntialiasing || m_msaaSamples != VK_SAMPLE_COUNT_1_BIT) ? 1u : 0u;
+    vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(PointPushConstants), &pointParams);
+    
     // Draw the satellite as a point
     vkCmdDraw(cmdBuffer, 1, 1, 0, 0);
 }
 
+void Renderer::setLabels(const std::vector<std::string>& names) {
+    m_labelRenderer->setLabels(names);
+}
+
+void Renderer::setLabelAnchors(const std::vector<glm::vec3>& positions) {
+    m_labelRenderer->setAnchors(positions);
+}
+
+void Renderer::drawLabels() {
+    if (!m_labelsEnabled) {
+        return;
+    }
+    
+    m_labelRenderer->draw(m_commandBuffers[m_currentFrame], m_currentFrame);
+}
+
+void Renderer::setAsyncComputeEnabled(bool enabled) {
+    m_asyncComputeEnabled = enabled;
+}
+
+bool Renderer::hasAsyncCompute() const {
+    return m_instance->hasAsyncCompute();
+}
+
+VkSampleCountFlagBits Renderer::getMaxMsaaSamples() const {
+    return selectMsaaSamples(VK_SAMPLE_COUNT_8_BIT);
+}
+
+VkSampleCountFlagBits Renderer::selectMsaaSamples(VkSampleCountFlagBits limit) const {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_instance->getPhysicalDevice(), &properties);
+    
+    // Color and depth share the sample count, so both must support it
+    VkSampleCountFlags counts = properties.limits.framebufferColorSampleCounts &
+                                properties.limits.framebufferDepthSampleCounts;
+    
+    // The supported counts need not be contiguous (e.g. 8x without 2x), so every
+    // count is checked rather than clamping to the highest
+    for (VkSampleCountFlagBits samples : {VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT}) {
+        if (samples <= limit && (counts & samples)) {
+            return samples;
+        }
+    }
+    
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+void Renderer::setMsaaSamples(VkSampleCountFlagBits samples) {
+    samples = selectMsaaSamples(samples);
+    if (samples == m_msaaSamples) {
+        return;
+    }
+    
+    // Everything that depends on the sample count is rebuilt
+    vkDeviceWaitIdle(m_instance->getLogicalDevice());
+    
+    vkDestroyPipeline(m_instance->getLogicalDevice(), m_satellitePipeline, nullptr);
+    vkDestroyPipeline(m_instance->getLogicalDevice(), m_earthPipeline, nullptr);
+    vkDestroyPipelineLayout(m_instance->getLogicalDevice(), m_pipelineLayout, nullptr);
+    
+    m_msaaSamples = samples;
+    
+    // The new render pass takes its color format from the current swapchain;
+    // dynamic rendering only needs the new multisampled attachments
+    VkRenderPass oldRenderPass = m_renderPass;
+    if (!m_dynamicRendering) {
+        createRenderPass();
+    }
+    
+    m_swapchain.reset();
+    m_swapchain = std::make_unique<VulkanSwapchain>(m_window, m_instance.get(), m_renderPass, m_msaaSamples);
+    updatePipelineRenderingInfo();
+    if (oldRenderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(m_instance->getLogicalDevice(), oldRenderPass, nullptr);
+    }
+    
+    createGraphicsPipelines();
+    m_labelRenderer->recreatePipelines();
+    m_trailRenderer->recreatePipelines();
+    m_spacecraftRenderer->recreatePipelines();
+    
+    std::cout << "MSAA set to " << m_msaaSamples << "x" << std::endl;
+}
+
+void Renderer::pushTrailSample(const std::vector<glm::vec3>& positions) {
+    m_trailRenderer->pushSample(positions);
+}
+
+void Renderer::setTrailLength(uint32_t trailLength) {
+    m_trailRenderer->setTrailLength(trailLength);
+}
+
+uint32_t Renderer::getTrailLength() const {
+    return m_trailRenderer->getTrailLength();
+}
+
+void Renderer::drawTrails() {
+    if (!m_trailsEnabled) {
+        return;
+    }
+    
+    m_trailRenderer->draw(m_commandBuffers[m_currentFrame], m_projectionMatrix * m_viewMatrix,
+                          m_swapchain->getExtent(), m_analyticAntialiasing);
+}
+
+void Renderer::setSpacecraftInstances(const std::vector<SpacecraftInstance>& instances) {
+    m_spacecraftRenderer->setInstances(instances);
+}
+
+void Renderer::drawSpacecraft() {
+    m_spacecraftRenderer->draw(m_commandBuffers[m_currentFrame], m_currentFrame, m_projectionMatrix * m_viewMatrix);
+}
+
 VkCommandBuffer Renderer::beginSingleTimeCommands() {
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -440,23 +695,161 @@ VkCommandBuffer Renderer::getCurrentCommandBuffer() const {
     return m_commandBuffers[m_currentFrame];
 }
 
+VkFormat Renderer::getColorFormat() const {
+    return m_swapchain->getImageFormat();
+}
+
+void Renderer::setPipelineRenderTarget(VkGraphicsPipelineCreateInfo& pipelineInfo) const {
+    if (m_dynamicRendering) {
+        pipelineInfo.pNext = &m_pipelineRenderingInfo;
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+    } else {
+        pipelineInfo.renderPass = m_renderPass;
+    }
+    pipelineInfo.subpass = 0;
+}
+
+void Renderer::updatePipelineRenderingInfo() {
+    // Pipelines record the attachment formats they render to in place of a render pass
+    m_colorAttachmentFormat = m_swapchain->getImageFormat();
+    
+    m_pipelineRenderingInfo = {};
+    m_pipelineRenderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    m_pipelineRenderingInfo.colorAttachmentCount = 1;
+    m_pipelineRenderingInfo.pColorAttachmentFormats = &m_colorAttachmentFormat;
+    m_pipelineRenderingInfo.depthAttachmentFormat = m_swapchain->getDepthFormat();
+    m_pipelineRenderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+}
+
+void Renderer::recordAttachmentTransitions() {
+    VkCommandBuffer cmdBuffer = m_commandBuffers[m_currentFrame];
+    
+    // Color targets: the swapchain image, plus the multisampled image resolved into it.
+    // The multisampled and depth images are shared by all frames, so the previous
+    // frame's attachment writes must complete first.
+    std::array<VkImage, 2> colorImages = {m_swapchain->getImage(m_currentImageIndex), m_swapchain->getColorImage()};
+    uint32_t colorImageCount = (m_msaaSamples != VK_SAMPLE_COUNT_1_BIT) ? 2 : 1;
+    
+    std::array<VkImageMemoryBarrier, 3> barriers{};
+    for (uint32_t i = 0; i < colorImageCount; i++) {
+        barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[i].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barriers[i].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barriers[i].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[i].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[i].image = colorImages[i];
+        barriers[i].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+    
+    // Depth and stencil aspects share a layout (separate layouts are not enabled)
+    VkFormat depthFormat = m_swapchain->getDepthFormat();
+    VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT) {
+        depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    
+    VkImageMemoryBarrier& depthBarrier = barriers[colorImageCount];
+    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.image = m_swapchain->getDepthImage();
+    depthBarrier.subresourceRange = {depthAspect, 0, 1, 0, 1};
+    
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+                         0, 0, nullptr, 0, nullptr, colorImageCount + 1, barriers.data());
+}
+
+void Renderer::beginDynamicRendering(bool overlay) {
+    bool multisampled = m_msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+    
+    // Color attachment; with MSAA the overlay pass resolves it into the swapchain image
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = multisampled ? m_swapchain->getColorImageView()
+                                             : m_swapchain->getImageView(m_currentImageIndex);
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = overlay ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.clearValue.color = {0.0f, 0.0f, 0.05f, 1.0f};  // Dark blue space background
+    
+    if (overlay && multisampled) {
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        colorAttachment.resolveImageView = m_swapchain->getImageView(m_currentImageIndex);
+        colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+    
+    // Depth attachment (scene pass only)
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = m_swapchain->getDepthImageView();
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue.depthStencil = {1.0f, 0};  // 1.0 is "far"
+    
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = m_swapchain->getExtent();
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = overlay ? nullptr : &depthAttachment;
+    
+    m_instance->cmdBeginRendering(m_commandBuffers[m_currentFrame], &renderingInfo);
+}
+
+void Renderer::beginOverlayPass() {
+    if (!m_dynamicRendering || m_overlayPassActive) {
+        return;
+    }
+    m_overlayPassActive = true;
+    
+    VkCommandBuffer cmdBuffer = m_commandBuffers[m_currentFrame];
+    m_instance->cmdEndRendering(cmdBuffer);
+    
+    // The overlay loads the color the scene pass stored
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+    
+    beginDynamicRendering(true);
+}
+
 void Renderer::createRenderPass() {
-    // Attachment descriptions
-    std::array<VkAttachmentDescription, 2> attachments = {};
+    bool multisampled = m_msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+    
+    // Attachment descriptions (color, depth, and the resolve target when multisampled)
+    std::array<VkAttachmentDescription, 3> attachments = {};
     
-    // Color attachment
+    // Color attachment; with MSAA its samples are discarded after the resolve
     attachments[0].format = m_swapchain->getImageFormat();
-    attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[0].samples = m_msaaSamples;
     attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[0].storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
     attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    attachments[0].finalLayout = multisampled ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     
     // Depth attachment
     attachments[1].format = findDepthFormat();
-    attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[1].samples = m_msaaSamples;
     attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -464,6 +857,16 @@ void Renderer::createRenderPass() {
     attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     
+    // Resolve attachment (the swapchain image)
+    attachments[2].format = m_swapchain->getImageFormat();
+    attachments[2].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[2].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[2].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[2].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[2].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[2].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[2].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    
     // Attachment references
     VkAttachmentReference colorAttachmentRef = {};
     colorAttachmentRef.attachment = 0;
@@ -473,11 +876,16 @@ void Renderer::createRenderPass() {
     depthAttachmentRef.attachment = 1;
     depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     
+    VkAttachmentReference resolveAttachmentRef = {};
+    resolveAttachmentRef.attachment = 2;
+    resolveAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    
     // Subpass description
     VkSubpassDescription subpass = {};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pResolveAttachments = multisampled ? &resolveAttachmentRef : nullptr;
     subpass.pDepthStencilAttachment = &depthAttachmentRef;
     
     // Subpass dependency
@@ -492,7 +900,7 @@ void Renderer::createRenderPass() {
     // Create render pass
     VkRenderPassCreateInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.attachmentCount = multisampled ? 3 : 2;
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
@@ -672,11 +1080,16 @@ void Renderer::createGraphicsPipelines() {
     // Enable larger point sizes for the satellite
     satelliteRasterizer.depthBiasEnable = VK_FALSE;
     
-    // Multisampling (disabled)
+    // Multisampling (matches the render pass sample count)
     VkPipelineMultisampleStateCreateInfo multisampling{};
     multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampling.rasterizationSamples = m_msaaSamples;
+    
+    // The satellite disc edge comes from the fragment shader, so under MSAA its
+    // coverage alpha is turned into a sample mask
+    VkPipelineMultisampleStateCreateInfo satelliteMultisampling = multisampling;
+    satelliteMultisampling.alphaToCoverageEnable = (m_msaaSamples != VK_SAMPLE_COUNT_1_BIT) ? VK_TRUE : VK_FALSE;
     
     // Depth stencil state - add depth testing
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
@@ -731,11 +1144,19 @@ void Renderer::createGraphicsPipelines() {
     dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     dynamicState.pDynamicStates = dynamicStates.data();
     
+    // Point parameters for the satellite shaders
+    VkPushConstantRange pointPushConstantRange{};
+    pointPushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pointPushConstantRange.offset = 0;
+    pointPushConstantRange.size = sizeof(PointPushConstants);
+    
     // Pipeline layout
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = 1;
     pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pointPushConstantRange;
     
     if (vkCreatePipelineLayout(m_instance->getLogicalDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create pipeline layout!");
@@ -755,8 +1176,7 @@ void Renderer::createGraphicsPipelines() {
     earthPipelineInfo.pColorBlendState = &earthColorBlending;
     earthPipelineInfo.pDynamicState = &dynamicState;
     earthPipelineInfo.layout = m_pipelineLayout;
-    earthPipelineInfo.renderPass = m_renderPass;
-    earthPipelineInfo.subpass = 0;
+    setPipelineRenderTarget(earthPipelineInfo);
     earthPipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
     // Satellite pipeline creation
@@ -768,13 +1188,12 @@ void Renderer::createGraphicsPipelines() {
     satellitePipelineInfo.pInputAssemblyState = &satelliteInputAssembly;
     satellitePipelineInfo.pViewportState = &viewportState;
     satellitePipelineInfo.pRasterizationState = &satelliteRasterizer;
-    satellitePipelineInfo.pMultisampleState = &multisampling;
+    satellitePipelineInfo.pMultisampleState = &satelliteMultisampling;
     satellitePipelineInfo.pDepthStencilState = &depthStencil;
     satellitePipelineInfo.pColorBlendState = &satelliteColorBlending;
     satellitePipelineInfo.pDynamicState = &dynamicState;
     satellitePipelineInfo.layout = m_pipelineLayout;
-    satellitePipelineInfo.renderPass = m_renderPass;
-    satellitePipelineInfo.subpass = 0;
+    setPipelineRenderTarget(satellitePipelineInfo);
     satellitePipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     
     // Create the graphics pipelines
@@ -915,7 +1334,7 @@ void Renderer::createCommandResources() {
     }
     
     // Create command buffers (one per frame in flight)
-    m_commandBuffers.resize(2);
+    m_commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
     
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -926,13 +1345,74 @@ void Renderer::createCommandResources() {
     if (vkAllocateCommandBuffers(m_instance->getLogicalDevice(), &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
         throw std::runtime_error("Failed to allocate command buffers!");
     }
+    
+    // Create the compute command pool (same family as graphics without async compute)
+    poolInfo.queueFamilyIndex = m_instance->getComputeQueueFamily();
+    
+    if (vkCreateCommandPool(m_instance->getLogicalDevice(), &poolInfo, nullptr, &m_computeCommandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute command pool!");
+    }
+    
+    m_computeCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    allocInfo.commandPool = m_computeCommandPool;
+    allocInfo.commandBufferCount = static_cast<uint32_t>(m_computeCommandBuffers.size());
+    
+    if (vkAllocateCommandBuffers(m_instance->getLogicalDevice(), &allocInfo, m_computeCommandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate compute command buffers!");
+    }
+}
+
+void Renderer::submitAsyncCompute() {
+    VkCommandBuffer computeBuffer = m_computeCommandBuffers[m_currentFrame];
+    
+    // The in-flight fence of this frame also covers its compute work, because
+    // the graphics submission that signals it waits on the compute semaphore
+    vkResetCommandBuffer(computeBuffer, 0);
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    
+    if (vkBeginCommandBuffer(computeBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording compute command buffer!");
+    }
+    
+    m_profiler->resetScopes(computeBuffer, m_currentFrame, GPU_SCOPE_COMPUTE, 1);
+    m_profiler->beginScope(computeBuffer, m_currentFrame, GPU_SCOPE_COMPUTE);
+    m_labelRenderer->recordDeclutter(
+        computeBuffer,
+        m_currentFrame,
+        m_projectionMatrix * m_viewMatrix,
+        m_swapchain->getExtent(),
+        true
+    );
+    m_profiler->endScope(computeBuffer, m_currentFrame, GPU_SCOPE_COMPUTE);
+    
+    if (vkEndCommandBuffer(computeBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record compute command buffer!");
+    }
+    
+    // Signal the semaphore that this frame's graphics submission waits on
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &computeBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &m_computeFinishedSemaphores[m_currentFrame];
+    
+    if (vkQueueSubmit(m_instance->getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit compute command buffer!");
+    }
+    
+    m_computeSubmitted = true;
 }
 
 void Renderer::createSyncObjects() {
-    // We'll use 2 frames in flight (double buffering)
-    m_imageAvailableSemaphores.resize(2);
-    m_renderFinishedSemaphores.resize(2);
-    m_inFlightFences.resize(2);
+    // One set per frame in flight
+    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    m_computeFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
     
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -941,9 +1421,10 @@ void Renderer::createSyncObjects() {
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;  // Start signaled to avoid waiting in first frame
     
-    for (size_t i = 0; i < 2; i++) {
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
         if (vkCreateSemaphore(m_instance->getLogicalDevice(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
             vkCreateSemaphore(m_instance->getLogicalDevice(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS ||
+            vkCreateSemaphore(m_instance->getLogicalDevice(), &semaphoreInfo, nullptr, &m_computeFinishedSemaphores[i]) != VK_SUCCESS ||
             vkCreateFence(m_instance->getLogicalDevice(), &fenceInfo, nullptr, &m_inFlightFences[i]) != VK_SUCCESS) {
             throw std::runtime_error("Failed to create synchronization objects!");
         }
@@ -1012,26 +1493,9 @@ void Renderer::createEarthGeometry() {
         }
     }
     
-    // Create vertex buffer
     VkDeviceSize vertexBufferSize = vertices.size() * sizeof(float);
-    
-    // Create staging buffer
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    
-    createBuffer(
-        vertexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingBufferMemory
-    );
-    
-    // Copy vertex data to staging buffer
-    void* data;
-    vkMapMemory(m_instance->getLogicalDevice(), stagingBufferMemory, 0, vertexBufferSize, 0, &data);
-    memcpy(data, vertices.data(), vertexBufferSize);
-    vkUnmapMemory(m_instance->getLogicalDevice(), stagingBufferMemory);
+    VkDeviceSize indexBufferSize = indices.size() * sizeof(uint32_t);
+    m_earthIndexCount = static_cast<uint32_t>(indices.size());
     
     // Create vertex buffer
     createBuffer(
@@ -1042,39 +1506,6 @@ void Renderer::createEarthGeometry() {
         m_earthVertexBuffer.memory
     );
     
-    // Copy from staging buffer to vertex buffer
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-    
-    VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0;
-    copyRegion.dstOffset = 0;
-    copyRegion.size = vertexBufferSize;
-    vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_earthVertexBuffer.buffer, 1, &copyRegion);
-    
-    endSingleTimeCommands(commandBuffer);
-    
-    // Cleanup staging buffer
-    vkDestroyBuffer(m_instance->getLogicalDevice(), stagingBuffer, nullptr);
-    vkFreeMemory(m_instance->getLogicalDevice(), stagingBufferMemory, nullptr);
-    
-    // Create index buffer
-    VkDeviceSize indexBufferSize = indices.size() * sizeof(uint32_t);
-    m_earthIndexCount = static_cast<uint32_t>(indices.size());
-    
-    // Create staging buffer for indices
-    createBuffer(
-        indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer,
-        stagingBufferMemory
-    );
-    
-    // Copy index data to staging buffer
-    vkMapMemory(m_instance->getLogicalDevice(), stagingBufferMemory, 0, indexBufferSize, 0, &data);
-    memcpy(data, indices.data(), indexBufferSize);
-    vkUnmapMemory(m_instance->getLogicalDevice(), stagingBufferMemory);
-    
     // Create index buffer
     createBuffer(
         indexBufferSize,
@@ -1084,28 +1515,18 @@ void Renderer::createEarthGeometry() {
         m_earthIndexBuffer.memory
     );
     
-    // Copy from staging buffer to index buffer
-    commandBuffer = beginSingleTimeCommands();
-    
-    copyRegion.size = indexBufferSize;
-    vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_earthIndexBuffer.buffer, 1, &copyRegion);
-    
-    endSingleTimeCommands(commandBuffer);
-    
-    // Cleanup staging buffer
-    vkDestroyBuffer(m_instance->getLogicalDevice(), stagingBuffer, nullptr);
-    vkFreeMemory(m_instance->getLogicalDevice(), stagingBufferMemory, nullptr);
+    // Upload both through one staging buffer and one submission
+    UploadBatch upload(this);
+    upload.add(m_earthVertexBuffer.buffer, 0, vertices.data(), vertexBufferSize);
+    upload.add(m_earthIndexBuffer.buffer, 0, indices.data(), indexBufferSize);
+    upload.flush();
 }
 
 void Renderer::updateUniformBuffer() {
-    static auto startTime = std::chrono::high_resolution_clock::now();
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-    
-    // Create Earth rotation model matrix
+    // Create Earth rotation model matrix from the angle set by the simulation
     glm::mat4 earthModel = glm::rotate(
         glm::mat4(1.0f),                  // Identity matrix
-        time * glm::radians(10.0f),       // Rotation angle (10 degrees per second)
+        m_earthRotationAngle,             // Rotation angle at the simulation epoch
         glm::vec3(0.0f, 1.0f, 0.0f)       // Rotate around Y axis
     );
     
@@ -1135,7 +1556,8 @@ void Renderer::createBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer& buffer,
-    VkDeviceMemory& bufferMemory) {
+    VkDeviceMemory& bufferMemory,
+    bool sharedWithCompute) {
     
     VkDevice device = m_instance->getLogicalDevice();
     
@@ -1146,6 +1568,14 @@ void Renderer::createBuffer(
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     
+    // Buffers used by both queues avoid ownership transfers with concurrent sharing
+    uint32_t queueFamilies[] = {m_instance->getGraphicsQueueFamily(), m_instance->getComputeQueueFamily()};
+    if (sharedWithCompute && m_instance->hasAsyncCompute()) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = queueFamilies;
+    }
+    
     if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create buffer!");
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "vulkan/buffer_resource.h"
 #include <vulkan/vulkan.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -10,6 +11,11 @@
 // Forward declarations
 class VulkanInstance;
 class VulkanSwapchain;
+class LabelRenderer;
+class TrailRenderer;
+class SpacecraftRenderer;
+struct SpacecraftInstance;
+class GpuProfiler;
 
 /**
  * Manages the Vulkan rendering pipeline and resources.
@@ -31,6 +37,10 @@ public:
      */
     ~Renderer();
     
+    // Frames recorded ahead of the GPU; every per-frame resource, here and in the
+    // sub-renderers, is indexed by getCurrentFrame() below this count
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+    
     /**
      * Begins a new frame, acquiring a swapchain image.
      * 
@@ -48,8 +58,18 @@ public:
      * 
      * @param position Camera position
      * @param target Camera target (look-at point)
+     * @param up Direction that appears up on screen
+     */
+    void updateCamera(const glm::vec3& position, const glm::vec3& target,
+                      const glm::vec3& up = glm::vec3(0.0f, 1.0f, 0.0f));
+    
+    /**
+     * Sets the Earth's rotation about its spin axis for the following frames,
+     * e.g. the Earth rotation angle at the simulation epoch.
+     * 
+     * @param angle Rotation angle in radians
      */
-    void updateCamera(const glm::vec3& position, const glm::vec3& target);
+    void setEarthRotationAngle(float angle) { m_earthRotationAngle = angle; }
     
     /**
      * Draws the Earth as a simple sphere.
@@ -63,6 +83,194 @@ public:
      */
     void drawSatellite(const glm::vec3& position);
     
+    /**
+     * Sets the label text for the drawn objects, one name per object.
+     * 
+     * @param names Object names
+     */
+    void setLabels(const std::vector<std::string>& names);
+    
+    /**
+     * Sets the label anchor positions for the next frame.
+     * Must be called before beginFrame() so the declutter pass sees them.
+     * 
+     * @param positions Object positions, one per label
+     */
+    void setLabelAnchors(const std::vector<glm::vec3>& positions);
+    
+    /**
+     * Enables or disables label rendering (including the declutter pass).
+     * 
+     * @param enabled True to draw labels
+     */
+    void setLabelsEnabled(bool enabled) { m_labelsEnabled = enabled; }
+    
+    /**
+     * Draws the object labels decluttered for this frame.
+     */
+    void drawLabels();
+    
+    /**
+     * Records one trail sample (the positions of one simulation tick).
+     * Must be called before beginFrame() so the sample is uploaded this frame.
+     * 
+     * @param positions Object positions, one per object
+     */
+    void pushTrailSample(const std::vector<glm::vec3>& positions);
+    
+    /**
+     * Sets the number of samples kept per trail. Restarts all trails.
+     * Must be called between frames, since it replaces the ring buffer frames draw from.
+     * 
+     * @param trailLength Trail length in samples
+     */
+    void setTrailLength(uint32_t trailLength);
+    
+    /**
+     * Gets the number of samples kept per trail.
+     * 
+     * @return Trail length in samples
+     */
+    uint32_t getTrailLength() const;
+    
+    /**
+     * Enables or disables trail rendering.
+     * 
+     * @param enabled True to draw trails
+     */
+    void setTrailsEnabled(bool enabled) { m_trailsEnabled = enabled; }
+    
+    /**
+     * Draws the orbit trails of all objects.
+     */
+    void drawTrails();
+    
+    /**
+     * Sets the oriented spacecraft models to draw, one instance per object.
+     * Must be called before beginFrame() so the instances are uploaded this frame.
+     * 
+     * @param instances Position, scale and attitude of each model
+     */
+    void setSpacecraftInstances(const std::vector<SpacecraftInstance>& instances);
+    
+    /**
+     * Draws the spacecraft models with one instanced draw.
+     */
+    void drawSpacecraft();
+    
+    // Number of samples kept per trail until changed by setTrailLength()
+    static constexpr uint32_t DEFAULT_TRAIL_LENGTH = 256;
+    
+    /**
+     * Enables or disables submitting compute work to the dedicated compute queue.
+     * Has no effect on devices without one (compute then always runs on the graphics queue).
+     * 
+     * @param enabled True to use async compute when available
+     */
+    void setAsyncComputeEnabled(bool enabled);
+    
+    /**
+     * Checks whether async compute is requested.
+     * 
+     * @return True if async compute is enabled
+     */
+    bool isAsyncComputeEnabled() const { return m_asyncComputeEnabled; }
+    
+    /**
+     * Checks whether the device has a dedicated compute queue.
+     * 
+     * @return True if async compute is available
+     */
+    bool hasAsyncCompute() const;
+    
+    // Profiled GPU scopes, in the order passed to the profiler
+    enum GpuScope : uint32_t {
+        GPU_SCOPE_GRAPHICS = 0,  // Whole graphics command buffer
+        GPU_SCOPE_RESOLVE,       // End of the render pass (MSAA resolve and store)
+        GPU_SCOPE_COMPUTE,       // Compute work (label declutter), on either queue
+        GPU_SCOPE_COUNT
+    };
+    
+    /**
+     * Sets the MSAA sample count, clamped to what the device supports.
+     * Rebuilds the multisampled attachments and pipelines (plus the render pass and
+     * framebuffers on the fallback path); any other pipeline owner (the ImGui
+     * backend) must be recreated afterwards.
+     * Must be called between frames.
+     * 
+     * @param samples Requested samples per pixel; the highest supported count not
+     *                above it is used, or 1 if there is none
+     */
+    void setMsaaSamples(VkSampleCountFlagBits samples);
+    
+    /**
+     * Gets the current MSAA sample count.
+     * 
+     * @return Samples per pixel
+     */
+    VkSampleCountFlagBits getMsaaSamples() const { return m_msaaSamples; }
+    
+    /**
+     * Gets the highest MSAA sample count usable for both color and depth.
+     * 
+     * @return Maximum samples per pixel
+     */
+    VkSampleCountFlagBits getMaxMsaaSamples() const;
+    
+    /**
+     * Enables or disables analytic (shader-based) antialiasing of points and lines.
+     * This is a cheap alternative to MSAA for the satellite and the orbit trails.
+     * 
+     * @param enabled True to smooth point and line edges in the shaders
+     */
+    void setAnalyticAntialiasing(bool enabled) { m_analyticAntialiasing = enabled; }
+    
+    /**
+     * Checks whether analytic antialiasing is enabled.
+     * 
+     * @return True if enabled
+     */
+    bool isAnalyticAntialiasing() const { return m_analyticAntialiasing; }
+    
+    /**
+     * Checks whether frames are recorded with dynamic rendering instead of
+     * render pass and framebuffer objects.
+     * 
+     * @return True on the dynamic rendering path
+     */
+    bool usesDynamicRendering() const { return m_dynamicRendering; }
+    
+    /**
+     * Points a pipeline at the scene pass: the render pass on the fallback path,
+     * or the attachment formats on the dynamic rendering path. The rendering info
+     * chained into pNext is owned by the renderer and stays valid until the next
+     * setMsaaSamples() call.
+     * 
+     * @param pipelineInfo Pipeline create info to complete (renderPass, subpass and pNext)
+     */
+    void setPipelineRenderTarget(VkGraphicsPipelineCreateInfo& pipelineInfo) const;
+    
+    /**
+     * Switches from the scene to the UI overlay for the rest of the frame.
+     * On the dynamic rendering path the overlay is a separate pass without a
+     * depth attachment; on the render pass path it stays in the same subpass.
+     */
+    void beginOverlayPass();
+    
+    /**
+     * Gets the format of the color attachment (the swapchain format).
+     * 
+     * @return Color attachment format
+     */
+    VkFormat getColorFormat() const;
+    
+    /**
+     * Gets the GPU timestamp profiler.
+     * 
+     * @return Profiler with per-scope GPU times
+     */
+    const GpuProfiler& getGpuProfiler() const { return *m_profiler; }
+    
     /**
      * Creates a command buffer for one-time use commands.
      * 
@@ -85,6 +293,41 @@ public:
     VkQueue getGraphicsQueue() const;
     VkRenderPass getRenderPass() const;
     VkCommandBuffer getCurrentCommandBuffer() const;
+    uint32_t getCurrentFrame() const { return m_currentFrame; }
+    
+    // Resource helpers shared with the feature renderers (labels, trails, ...)
+    
+    /**
+     * Creates a generic buffer.
+     * 
+     * @param size Buffer size in bytes
+     * @param usage Buffer usage flags
+     * @param properties Memory property flags
+     * @param buffer Output buffer handle
+     * @param bufferMemory Output buffer memory handle
+     * @param sharedWithCompute True if the buffer is accessed by both the graphics and the compute queue
+     */
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, 
+                     VkMemoryPropertyFlags properties,
+                     VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                     bool sharedWithCompute = false);
+    
+    /**
+     * Finds a suitable memory type for allocation.
+     * 
+     * @param typeFilter Type filter from memory requirements
+     * @param properties Required memory properties
+     * @return Index of a suitable memory type
+     */
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    
+    /**
+     * Loads a shader module from a file.
+     * 
+     * @param filename Shader file path
+     * @return Shader module handle
+     */
+    VkShaderModule createShaderModule(const std::string& filename);
     
 private:
     GLFWwindow* m_window;
@@ -111,11 +354,16 @@ private:
         glm::mat4 proj;
     };
     
-    struct BufferResource {
-        VkBuffer buffer;
-        VkDeviceMemory memory;
+    // Push constants for the satellite point shaders
+    struct PointPushConstants {
+        glm::vec2 viewportSize;
+        float pointSize;
+        uint32_t smoothEdges;
     };
     
+    // Satellite point diameter in pixels
+    static constexpr float SATELLITE_POINT_SIZE = 10.0f;
+    
     std::vector<BufferResource> m_uniformBuffers;
     
     // Earth mesh data
@@ -135,10 +383,49 @@ private:
     uint32_t m_currentFrame;
     uint32_t m_currentImageIndex;
     
+    // Async compute resources (compute queue family, or graphics family as fallback)
+    VkCommandPool m_computeCommandPool;
+    std::vector<VkCommandBuffer> m_computeCommandBuffers;
+    std::vector<VkSemaphore> m_computeFinishedSemaphores;
+    bool m_asyncComputeEnabled;
+    bool m_computeSubmitted;  // The current frame's graphics submission must wait for compute
+    
+    // GPU timings
+    std::unique_ptr<GpuProfiler> m_profiler;
+    
     // Camera state
     glm::mat4 m_viewMatrix;
     glm::mat4 m_projectionMatrix;
     
+    // Antialiasing settings
+    VkSampleCountFlagBits m_msaaSamples;
+    bool m_analyticAntialiasing;
+    
+    // Dynamic rendering state (m_renderPass is VK_NULL_HANDLE on this path)
+    bool m_dynamicRendering;
+    bool m_overlayPassActive;
+    VkFormat m_colorAttachmentFormat;
+    VkPipelineRenderingCreateInfoKHR m_pipelineRenderingInfo;
+    
+    // Object labels
+    std::unique_ptr<LabelRenderer> m_labelRenderer;
+    bool m_labelsEnabled;
+    
+    // Orbit trails
+    std::unique_ptr<TrailRenderer> m_trailRenderer;
+    bool m_trailsEnabled;
+    
+    // Oriented spacecraft models
+    std::unique_ptr<SpacecraftRenderer> m_spacecraftRenderer;
+    
+    // Earth orientation, driven by the simulation clock
+    float m_earthRotationAngle;
+    
+    /**
+     * Records and submits this frame's compute work on the compute queue.
+     */
+    void submitAsyncCompute();
+    
     /**
      * Recreates the swapchain when the window is resized.
      */
@@ -149,6 +436,34 @@ private:
      */
     void createRenderPass();
     
+    /**
+     * Fills the attachment formats used by pipelines on the dynamic rendering path.
+     */
+    void updatePipelineRenderingInfo();
+    
+    /**
+     * Picks the highest MSAA sample count usable for both color and depth that does
+     * not exceed a limit.
+     * 
+     * @param limit Highest acceptable samples per pixel
+     * @return Samples per pixel, 1 if no multisampled count qualifies
+     */
+    VkSampleCountFlagBits selectMsaaSamples(VkSampleCountFlagBits limit) const;
+    
+    /**
+     * Transitions the frame's attachments into attachment layouts (dynamic rendering path).
+     * Their previous contents are discarded.
+     */
+    void recordAttachmentTransitions();
+    
+    /**
+     * Begins a dynamic render pass instance on the current swapchain image.
+     * 
+     * @param overlay False for the scene pass (clears color and depth), true for
+     *                the UI overlay (loads color, no depth, resolves MSAA)
+     */
+    void beginDynamicRendering(bool overlay);
+    
     /**
      * Creates the graphics pipeline.
      */
@@ -184,36 +499,6 @@ private:
      */
     void updateUniformBuffer();
     
-    /**
-     * Creates a generic buffer.
-     * 
-     * @param size Buffer size in bytes
-     * @param usage Buffer usage flags
-     * @param properties Memory property flags
-     * @param buffer Output buffer handle
-     * @param bufferMemory Output buffer memory handle
-     */
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, 
-                     VkMemoryPropertyFlags properties,
-                     VkBuffer& buffer, VkDeviceMemory& bufferMemory);
-    
-    /**
-     * Finds a suitable memory type for allocation.
-     * 
-     * @param typeFilter Type filter from memory requirements
-     * @param properties Required memory properties
-     * @return Index of a suitable memory type
-     */
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-    
-    /**
-     * Loads a shader module from a file.
-     * 
-     * @param filename Shader file path
-     * @return Shader module handle
-     */
-    VkShaderModule createShaderModule(const std::string& filename);
-
     /**
      * Finds a suitable depth format supported by the device.
      * 
@@ -0,0 +1,425 @@
+#include "vulkan/spacecraft_renderer.h"
+#include "vulkan/renderer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+// Optional model replacing the built-in one, in body axes with +z to nadir
+static const char* MODEL_PATH = "models/spacecraft.glb";
+
+// Built-in model colors: gold foil bus, dark solar cells, white antenna
+static const glm::vec4 BUS_COLOR(0.85f, 0.65f, 0.25f, 1.0f);
+static const glm::vec4 PANEL_COLOR(0.12f, 0.18f, 0.45f, 1.0f);
+static const glm::vec4 ANTENNA_COLOR(0.9f, 0.9f, 0.9f, 1.0f);
+
+// Offset of the per-primitive part of the push constants
+static constexpr uint32_t PRIMITIVE_CONSTANTS_OFFSET = sizeof(glm::mat4);
+
+static void appendBox(const glm::vec3& low, const glm::vec3& high, std::vector<glm::vec3>& positions,
+                      std::vector<glm::vec3>& normals, std::vector<uint16_t>& indices) {
+    for (int axis = 0; axis < 3; axis++) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        for (float side : {1.0f, -1.0f}) {
+            // Corners counter-clockwise around the outward normal
+            uint16_t first = static_cast<uint16_t>(positions.size());
+            float corners[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+            for (int k = 0; k < 4; k++) {
+                int corner = (side > 0.0f) ? k : 3 - k;
+                glm::vec3 position(0.0f);
+                glm::vec3 normal(0.0f);
+                position[axis] = (side > 0.0f) ? high[axis] : low[axis];
+                position[u] = corners[corner][0] > 0.0f ? high[u] : low[u];
+                position[v] = corners[corner][1] > 0.0f ? high[v] : low[v];
+                normal[axis] = side;
+                positions.push_back(position);
+                normals.push_back(normal);
+            }
+            for (uint16_t index : {0, 1, 2, 0, 2, 3}) {
+                indices.push_back(first + index);
+            }
+        }
+    }
+}
+
+// Packs a linear color into RGBA8
+static uint32_t packColor(const glm::vec4& color) {
+    uint32_t packed = 0;
+    for (int channel = 0; channel < 4; channel++) {
+        float value = std::clamp(color[channel], 0.0f, 1.0f);
+        packed |= static_cast<uint32_t>(value * 255.0f + 0.5f) << (8 * channel);
+    }
+    return packed;
+}
+
+SpacecraftRenderer::SpacecraftRenderer(Renderer* renderer)
+    : m_renderer(renderer), m_modelCache(renderer), m_model(nullptr), m_instanceCounts{},
+      m_instanceCapacity(64), m_descriptorSetLayout(VK_NULL_HANDLE), m_descriptorPool(VK_NULL_HANDLE),
+      m_descriptorSet(VK_NULL_HANDLE), m_pipelineLayout(VK_NULL_HANDLE), m_pipeline(VK_NULL_HANDLE) {
+
+    createModel();
+    createDescriptorResources();
+    createPipeline();
+    createInstanceBuffers();
+}
+
+SpacecraftRenderer::~SpacecraftRenderer() {
+    VkDevice device = m_renderer->getDevice();
+
+    vkDestroyPipeline(device, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+
+    for (auto& instances : m_instanceBuffers) {
+        destroyBuffer(instances);
+    }
+}
+
+void SpacecraftRenderer::setInstances(const std::vector<SpacecraftInstance>& instances) {
+    m_pendingInstances = instances;
+}
+
+void SpacecraftRenderer::uploadInstances(uint32_t frameIndex) {
+    uint32_t instanceCount = static_cast<uint32_t>(m_pendingInstances.size());
+    if (instanceCount > m_instanceCapacity) {
+        m_instanceCapacity = std::max(instanceCount, m_instanceCapacity * 2);
+        createInstanceBuffers();
+    }
+
+    // The fence for this frame has been waited on, so its buffer is free to overwrite
+    if (instanceCount > 0) {
+        memcpy(m_instanceBuffers[frameIndex].mapped, m_pendingInstances.data(),
+               sizeof(SpacecraftInstance) * instanceCount);
+    }
+    m_instanceCounts[frameIndex] = instanceCount;
+}
+
+void SpacecraftRenderer::draw(VkCommandBuffer commandBuffer, uint32_t frameIndex, const glm::mat4& viewProjection) {
+    if (m_instanceCounts[frameIndex] == 0) {
+        return;
+    }
+
+    const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    uint32_t instanceCount = m_instanceCounts[frameIndex];
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout,
+                            0, 1, &m_descriptorSet, 0, nullptr);
+
+    PushConstants pushConstants{};
+    pushConstants.viewProjection = viewProjection;
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, stages, 0, sizeof(glm::mat4), &pushConstants.viewProjection);
+
+    // Vertices are pulled from the model buffer; the only vertex stream is per instance
+    VkBuffer instanceBuffer = m_instanceBuffers[frameIndex].buffer;
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &instanceBuffer, &offset);
+
+    for (const GpuPrimitive& primitive : m_model->primitives) {
+        for (int row = 0; row < 3; row++) {
+            pushConstants.transformRows[row] = glm::vec4(primitive.transform[0][row], primitive.transform[1][row],
+                                                         primitive.transform[2][row], primitive.transform[3][row]);
+        }
+        pushConstants.positionOffset = primitive.positionOffset;
+        pushConstants.normalOffset = primitive.normalOffset;
+        pushConstants.strides = primitive.positionStride | (primitive.normalStride << 16);
+        pushConstants.color = packColor(primitive.baseColor);
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, stages, PRIMITIVE_CONSTANTS_OFFSET,
+                           sizeof(PushConstants) - PRIMITIVE_CONSTANTS_OFFSET, &pushConstants.transformRows);
+
+        if (primitive.indexCount > 0) {
+            vkCmdBindIndexBuffer(commandBuffer, m_model->buffer, primitive.indexOffset, primitive.indexType);
+            vkCmdDrawIndexed(commandBuffer, primitive.indexCount, instanceCount, 0, 0, 0);
+        } else {
+            vkCmdDraw(commandBuffer, primitive.vertexCount, instanceCount, 0, 0);
+        }
+    }
+}
+
+void SpacecraftRenderer::recreatePipelines() {
+    VkDevice device = m_renderer->getDevice();
+
+    vkDestroyPipeline(device, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+
+    createPipeline();
+}
+
+void SpacecraftRenderer::createModel() {
+    try {
+        m_model = m_modelCache.load(MODEL_PATH);
+    } catch (const std::runtime_error& error) {
+        // A missing file is the normal case; a broken one is worth reporting
+        if (std::filesystem::exists(MODEL_PATH)) {
+            std::cerr << error.what() << " Using the built-in model." << std::endl;
+        }
+    }
+
+    if (m_model == nullptr) {
+        // Unit-sized model in body axes: +z to nadir, solar wings along +-y, one primitive per color
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<uint16_t> indices;
+        std::vector<std::pair<size_t, glm::vec4>> parts;   // First index of each color
+
+        parts.emplace_back(indices.size(), BUS_COLOR);
+        appendBox(glm::vec3(-0.5f, -0.4f, -0.5f), glm::vec3(0.5f, 0.4f, 0.5f), positions, normals, indices);
+        parts.emplace_back(indices.size(), ANTENNA_COLOR);
+        appendBox(glm::vec3(-0.12f, -0.12f, 0.5f), glm::vec3(0.12f, 0.12f, 0.8f), positions, normals, indices);
+        appendBox(glm::vec3(-0.02f, 0.4f, -0.02f), glm::vec3(0.02f, 0.55f, 0.02f), positions, normals, indices);
+        appendBox(glm::vec3(-0.02f, -0.55f, -0.02f), glm::vec3(0.02f, -0.4f, 0.02f), positions, normals, indices);
+        parts.emplace_back(indices.size(), PANEL_COLOR);
+        appendBox(glm::vec3(-0.4f, 0.55f, -0.015f), glm::vec3(0.4f, 2.0f, 0.015f), positions, normals, indices);
+        appendBox(glm::vec3(-0.4f, -2.0f, -0.015f), glm::vec3(0.4f, -0.55f, 0.015f), positions, normals, indices);
+        parts.emplace_back(indices.size(), glm::vec4(0.0f));
+
+        // The model owns its bytes, so the cache can keep them to compare content
+        ModelData model;
+        auto addView = [&model](const auto& values) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+            model.buffers.emplace_back(bytes, bytes + sizeof(values[0]) * values.size());
+            model.views.push_back({model.buffers.back().data(), model.buffers.back().size()});
+        };
+        addView(positions);
+        addView(normals);
+        addView(indices);
+
+        uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+        for (size_t part = 0; part + 1 < parts.size(); part++) {
+            ModelPrimitive primitive{};
+            primitive.position = {0, 0, sizeof(glm::vec3), vertexCount};
+            primitive.normal = {1, 0, sizeof(glm::vec3), vertexCount};
+            primitive.indices = {2, static_cast<uint32_t>(sizeof(uint16_t) * parts[part].first), sizeof(uint16_t),
+                                 static_cast<uint32_t>(parts[part + 1].first - parts[part].first)};
+            primitive.indexSize = sizeof(uint16_t);
+            primitive.baseColor = parts[part].second;
+            primitive.transform = glm::mat4(1.0f);
+            model.primitives.push_back(primitive);
+        }
+
+        m_model = m_modelCache.add(std::move(model));
+    }
+
+    m_modelCache.flushUploads();
+}
+
+void SpacecraftRenderer::createDescriptorResources() {
+    VkDevice device = m_renderer->getDevice();
+
+    VkDescriptorSetLayoutBinding modelBinding{};
+    modelBinding.binding = 0;
+    modelBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    modelBinding.descriptorCount = 1;
+    modelBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &modelBinding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create spacecraft descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create spacecraft descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate spacecraft descriptor set!");
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_model->buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = m_descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+}
+
+void SpacecraftRenderer::createPipeline() {
+    VkDevice device = m_renderer->getDevice();
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create spacecraft pipeline layout!");
+    }
+
+    VkShaderModule vertShaderModule = m_renderer->createShaderModule("shaders/spacecraft_vert.spv");
+    VkShaderModule fragShaderModule = m_renderer->createShaderModule("shaders/spacecraft_frag.spv");
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "VSMain";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "PSMain";
+
+    // Position/scale and attitude per instance; mesh vertices are pulled in the shader
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(SpacecraftInstance);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    std::array<VkVertexInputAttributeDescription, 2> attributes{};
+    attributes[0] = {0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SpacecraftInstance, position)};
+    attributes[1] = {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SpacecraftInstance, orientation)};
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.pVertexBindingDescriptions = &binding;
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    // The projection flips Y, so culling would depend on the winding convention (and
+    // glTF models may be double-sided)
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = m_renderer->getMsaaSamples();
+
+    // Opaque models occlude and are occluded like the Earth
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_TRUE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    m_renderer->setPipelineRenderTarget(pipelineInfo);
+
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create spacecraft pipeline!");
+    }
+
+    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+}
+
+void SpacecraftRenderer::createInstanceBuffers() {
+    VkDevice device = m_renderer->getDevice();
+
+    // The other frame in flight may still read its instances
+    vkDeviceWaitIdle(device);
+
+    for (auto& instances : m_instanceBuffers) {
+        destroyBuffer(instances);
+        m_renderer->createBuffer(
+            sizeof(SpacecraftInstance) * m_instanceCapacity,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            instances.buffer,
+            instances.memory
+        );
+        vkMapMemory(device, instances.memory, 0, VK_WHOLE_SIZE, 0, &instances.mapped);
+    }
+
+    // Instances of the other frame are gone with its buffer
+    m_instanceCounts.fill(0);
+}
+
+void SpacecraftRenderer::destroyBuffer(BufferResource& resource) {
+    if (resource.buffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkDevice device = m_renderer->getDevice();
+    if (resource.mapped) {
+        vkUnmapMemory(device, resource.memory);
+    }
+    vkDestroyBuffer(device, resource.buffer, nullptr);
+    vkFreeMemory(device, resource.memory, nullptr);
+    resource = BufferResource{};
+}
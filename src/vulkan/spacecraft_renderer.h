@@ -0,0 +1,134 @@
+#pragma once
+
+#include "vulkan/buffer_resource.h"
+#include "vulkan/model_cache.h"
+#include "vulkan/renderer.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <array>
+
+/**
+ * Per-instance data of one drawn spacecraft, laid out as the instance-rate vertex input.
+ */
+struct SpacecraftInstance {
+    glm::vec4 position;     // World position in xyz, model scale in w
+    glm::vec4 orientation;  // Unit quaternion rotating body axes into the world, (x, y, z, w)
+};
+
+/**
+ * Draws oriented spacecraft models so attitude is visible.
+ *
+ * Every spacecraft shares one model from the ModelCache: models/spacecraft.glb
+ * if present, otherwise a built-in one (a bus with a nadir antenna and two solar
+ * wings along the body y axis). The vertex shader pulls positions and normals
+ * from the model buffer through a storage buffer descriptor, so any glTF vertex
+ * layout is drawn without conversion. Position, scale and attitude quaternion of
+ * each spacecraft come from a per-instance vertex stream that is written once per
+ * frame into a persistently mapped buffer of that frame in flight, so no copy
+ * command is recorded. Each model primitive is one instanced draw over all
+ * spacecraft.
+ */
+class SpacecraftRenderer {
+public:
+    /**
+     * Constructor loads and uploads the model and creates the pipeline.
+     *
+     * @param renderer Renderer that owns the device and render pass
+     */
+    SpacecraftRenderer(Renderer* renderer);
+
+    /**
+     * Destructor cleans up Vulkan resources.
+     */
+    ~SpacecraftRenderer();
+
+    /**
+     * Queues the instances to draw from the next frame on.
+     *
+     * @param instances One entry per spacecraft
+     */
+    void setInstances(const std::vector<SpacecraftInstance>& instances);
+
+    /**
+     * Writes the queued instances into this frame's instance buffer.
+     * Must be called after the frame's fence has been waited on.
+     *
+     * @param frameIndex Index of the frame in flight
+     */
+    void uploadInstances(uint32_t frameIndex);
+
+    /**
+     * Records the instanced model draw.
+     * Must be recorded inside the main render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     * @param viewProjection Combined view-projection matrix
+     */
+    void draw(VkCommandBuffer commandBuffer, uint32_t frameIndex, const glm::mat4& viewProjection);
+
+    /**
+     * Rebuilds the pipeline after the main render pass changed (e.g. its sample count).
+     */
+    void recreatePipelines();
+
+private:
+    Renderer* m_renderer;
+
+    // Push constants for the spacecraft shaders, all 128 bytes guaranteed by Vulkan
+    struct PushConstants {
+        glm::mat4 viewProjection;
+        // Per primitive, pushed at PRIMITIVE_CONSTANTS_OFFSET
+        glm::vec4 transformRows[3]; // Node-to-body affine transform, row by row
+        uint32_t positionOffset;    // Byte offsets into the model buffer
+        uint32_t normalOffset;
+        uint32_t strides;           // Position stride in the low 16 bits, normal stride in the high
+        uint32_t color;             // Base color as RGBA8
+    };
+    static_assert(sizeof(PushConstants) == 128, "Spacecraft push constants exceed the guaranteed 128 bytes");
+
+    ModelCache m_modelCache;
+    const GpuModel* m_model;
+
+    // Instance streams, one per frame in flight
+    std::array<BufferResource, Renderer::MAX_FRAMES_IN_FLIGHT> m_instanceBuffers;
+    std::array<uint32_t, Renderer::MAX_FRAMES_IN_FLIGHT> m_instanceCounts;
+    uint32_t m_instanceCapacity;
+
+    // Latest instances waiting to be written
+    std::vector<SpacecraftInstance> m_pendingInstances;
+
+    VkDescriptorSetLayout m_descriptorSetLayout;
+    VkDescriptorPool m_descriptorPool;
+    VkDescriptorSet m_descriptorSet;
+    VkPipelineLayout m_pipelineLayout;
+    VkPipeline m_pipeline;
+
+    /**
+     * Loads the model file, falling back to the built-in model, and uploads it.
+     */
+    void createModel();
+
+    /**
+     * Creates the descriptor set that exposes the model buffer to the vertex shader.
+     */
+    void createDescriptorResources();
+
+    /**
+     * Creates the instanced model pipeline.
+     */
+    void createPipeline();
+
+    /**
+     * (Re)creates the instance buffers for the current capacity.
+     */
+    void createInstanceBuffers();
+
+    /**
+     * Destroys a buffer and frees its memory.
+     *
+     * @param resource Buffer to destroy
+     */
+    void destroyBuffer(BufferResource& resource);
+};
@@ -4,11 +4,14 @@
 #include <stdexcept>
 #include <array>
 
-VulkanSwapchain::VulkanSwapchain(GLFWwindow* window, VulkanInstance* instance, VkRenderPass renderPass)
-    : m_window(window), m_instance(instance), m_renderPass(renderPass) {
+VulkanSwapchain::VulkanSwapchain(GLFWwindow* window, VulkanInstance* instance, VkRenderPass renderPass,
+                                 VkSampleCountFlagBits samples)
+    : m_window(window), m_instance(instance), m_renderPass(renderPass), m_samples(samples),
+      m_colorImage(VK_NULL_HANDLE), m_colorImageMemory(VK_NULL_HANDLE), m_colorImageView(VK_NULL_HANDLE) {
     
     createSwapchain();
     createImageViews();
+    createColorResources();
     createDepthResources();
     createFramebuffers();
 }
@@ -26,6 +29,13 @@ VulkanSwapchain::~VulkanSwapchain() {
     vkDestroyImage(device, m_depthImage, nullptr);
     vkFreeMemory(device, m_depthImageMemory, nullptr);
     
+    // Clean up the multisampled color target
+    if (m_colorImage != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, m_colorImageView, nullptr);
+        vkDestroyImage(device, m_colorImage, nullptr);
+        vkFreeMemory(device, m_colorImageMemory, nullptr);
+    }
+    
     // Clean up image views
     for (auto imageView : m_swapchainImageViews) {
         vkDestroyImageView(device, imageView, nullptr);
@@ -159,14 +169,41 @@ void VulkanSwapchain::createImageViews() {
     }
 }
 
+void VulkanSwapchain::createColorResources() {
+    // Single-sampled rendering goes straight to the swapchain images
+    if (m_samples == VK_SAMPLE_COUNT_1_BIT) {
+        return;
+    }
+    
+    // The samples are only needed until the end-of-pass resolve, so the image can stay transient
+    createImage(
+        m_swapchainExtent.width,
+        m_swapchainExtent.height,
+        m_samples,
+        m_swapchainImageFormat,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_colorImage,
+        m_colorImageMemory
+    );
+    
+    m_colorImageView = createImageView(
+        m_colorImage,
+        m_swapchainImageFormat,
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
+}
+
 void VulkanSwapchain::createDepthResources() {
     // Find a supported depth format
     m_depthFormat = findDepthFormat();
     
-    // Create the depth image and view
+    // Create the depth image and view (same sample count as the color target)
     createImage(
         m_swapchainExtent.width,
         m_swapchainExtent.height,
+        m_samples,
         m_depthFormat,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
@@ -206,7 +243,8 @@ VkFormat VulkanSwapchain::findSupportedFormat(const std::vector<VkFormat>& candi
     throw std::runtime_error("Failed to find supported format!");
 }
 
-void VulkanSwapchain::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
+void VulkanSwapchain::createImage(uint32_t width, uint32_t height, VkSampleCountFlagBits samples,
+                                VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
                                 VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) {
     // Create the image
     VkImageCreateInfo imageInfo{};
@@ -221,7 +259,7 @@ void VulkanSwapchain::createImage(uint32_t width, uint32_t height, VkFormat form
     imageInfo.tiling = tiling;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.usage = usage;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.samples = samples;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     
     if (vkCreateImage(m_instance->getLogicalDevice(), &imageInfo, nullptr, &image) != VK_SUCCESS) {
@@ -291,16 +329,24 @@ uint32_t VulkanSwapchain::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFl
 }
 
 void VulkanSwapchain::createFramebuffers() {
+    // Dynamic rendering binds the attachment views directly
+    if (m_renderPass == VK_NULL_HANDLE) {
+        return;
+    }
+    
     // Resize the framebuffers vector to match the number of swapchain images
     m_swapchainFramebuffers.resize(m_swapchainImageViews.size());
     
     // Create a framebuffer for each image view
     for (size_t i = 0; i < m_swapchainImageViews.size(); i++) {
-        // Include both color and depth attachments
-        std::array<VkImageView, 2> attachments = {
-            m_swapchainImageViews[i],
-            m_depthImageView
-        };
+        // Include both color and depth attachments; with MSAA the swapchain
+        // image is the resolve target behind the multisampled color image
+        std::vector<VkImageView> attachments;
+        if (m_samples == VK_SAMPLE_COUNT_1_BIT) {
+            attachments = {m_swapchainImageViews[i], m_depthImageView};
+        } else {
+            attachments = {m_colorImageView, m_depthImageView, m_swapchainImageViews[i]};
+        }
         
         // Set up framebuffer create info
         VkFramebufferCreateInfo framebufferInfo{};
@@ -18,9 +18,13 @@ public:
      * 
      * @param window GLFW window handle
      * @param instance VulkanInstance for device access
-     * @param renderPass The render pass this swapchain will be used with
+     * @param renderPass The render pass this swapchain will be used with, or
+     *                   VK_NULL_HANDLE for dynamic rendering (no framebuffers are created)
+     * @param samples Sample count of the color and depth attachments; above one
+     *                a multisampled color target is resolved into the swapchain image
      */
-    VulkanSwapchain(GLFWwindow* window, VulkanInstance* instance, VkRenderPass renderPass);
+    VulkanSwapchain(GLFWwindow* window, VulkanInstance* instance, VkRenderPass renderPass,
+                    VkSampleCountFlagBits samples);
     
     /**
      * Destructor cleans up swapchain resources.
@@ -51,6 +55,15 @@ public:
     uint32_t getImageCount() const { return static_cast<uint32_t>(m_swapchainImages.size()); }
     const std::vector<VkFramebuffer>& getFramebuffers() const { return m_swapchainFramebuffers; }
     
+    // Attachment images for dynamic rendering; the color image is only valid with MSAA
+    VkImage getImage(uint32_t imageIndex) const { return m_swapchainImages[imageIndex]; }
+    VkImageView getImageView(uint32_t imageIndex) const { return m_swapchainImageViews[imageIndex]; }
+    VkImage getColorImage() const { return m_colorImage; }
+    VkImageView getColorImageView() const { return m_colorImageView; }
+    VkImage getDepthImage() const { return m_depthImage; }
+    VkImageView getDepthImageView() const { return m_depthImageView; }
+    VkFormat getDepthFormat() const { return m_depthFormat; }
+    
 private:
     GLFWwindow* m_window;
     VulkanInstance* m_instance;
@@ -63,6 +76,12 @@ private:
     
     VkFormat m_swapchainImageFormat;
     VkExtent2D m_swapchainExtent;
+    VkSampleCountFlagBits m_samples;
+    
+    // Multisampled color target (only when m_samples > 1)
+    VkImage m_colorImage;
+    VkDeviceMemory m_colorImageMemory;
+    VkImageView m_colorImageView;
     
     // Depth buffer resources
     VkImage m_depthImage;
@@ -118,6 +137,11 @@ private:
      */
     void createImageViews();
     
+    /**
+     * Creates the multisampled color image and view resolved into the swapchain images.
+     */
+    void createColorResources();
+    
     /**
      * Creates a depth buffer image and view.
      */
@@ -147,6 +171,7 @@ private:
      * 
      * @param width Image width
      * @param height Image height
+     * @param samples Number of samples per pixel
      * @param format Image format
      * @param tiling Image tiling mode
      * @param usage Image usage flags
@@ -154,7 +179,7 @@ private:
      * @param image Output image handle
      * @param imageMemory Output image memory handle
      */
-    void createImage(uint32_t width, uint32_t height,
+    void createImage(uint32_t width, uint32_t height, VkSampleCountFlagBits samples,
                     VkFormat format, VkImageTiling tiling,
                     VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
                     VkImage& image, VkDeviceMemory& imageMemory);
@@ -180,6 +205,7 @@ private:
     
     /**
      * Creates framebuffers for rendering to the swapchain images.
+     * Skipped when no render pass is given (dynamic rendering).
      */
     void createFramebuffers();
 };
@@ -0,0 +1,369 @@
+#include "vulkan/trail_renderer.h"
+#include "vulkan/renderer.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Trail color (alpha is scaled by sample age in the shader)
+static const glm::vec4 TRAIL_COLOR(1.0f, 0.75f, 0.35f, 0.8f);
+
+// Trail width in pixels for the analytically antialiased ribbons
+static const float SMOOTH_LINE_WIDTH = 1.5f;
+
+TrailRenderer::TrailRenderer(Renderer* renderer, uint32_t trailLength)
+    : m_renderer(renderer),
+      m_objectCount(0), m_objectCapacity(1), m_trailLength(std::max(trailLength, 2u)),
+      m_head(0), m_validCount(0), m_hasPendingSample(false),
+      m_descriptorSetLayout(VK_NULL_HANDLE), m_descriptorPool(VK_NULL_HANDLE),
+      m_descriptorSet(VK_NULL_HANDLE), m_pipelineLayout(VK_NULL_HANDLE),
+      m_linePipeline(VK_NULL_HANDLE), m_smoothPipeline(VK_NULL_HANDLE) {
+
+    createDescriptorResources();
+    createPipelines();
+    createRingBuffer();
+}
+
+TrailRenderer::~TrailRenderer() {
+    VkDevice device = m_renderer->getDevice();
+
+    vkDestroyPipeline(device, m_smoothPipeline, nullptr);
+    vkDestroyPipeline(device, m_linePipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+
+    for (auto& staging : m_stagingBuffers) {
+        destroyBuffer(staging);
+    }
+    destroyBuffer(m_ringBuffer);
+}
+
+void TrailRenderer::pushSample(const std::vector<glm::vec3>& positions) {
+    uint32_t objectCount = static_cast<uint32_t>(positions.size());
+
+    // A different object set invalidates the whole history
+    if (objectCount != m_objectCount) {
+        m_objectCount = objectCount;
+        if (objectCount > m_objectCapacity) {
+            m_objectCapacity = std::max(objectCount, m_objectCapacity * 2);
+            createRingBuffer();
+        }
+        m_head = 0;
+        m_validCount = 0;
+    }
+
+    m_pendingSample.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++) {
+        m_pendingSample[i] = glm::vec4(positions[i], 1.0f);
+    }
+    m_hasPendingSample = objectCount > 0;
+}
+
+void TrailRenderer::setTrailLength(uint32_t trailLength) {
+    trailLength = std::max(trailLength, 2u);
+    if (trailLength == m_trailLength) {
+        return;
+    }
+
+    m_trailLength = trailLength;
+    createRingBuffer();
+    m_head = 0;
+    m_validCount = 0;
+}
+
+void TrailRenderer::recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    if (!m_hasPendingSample) {
+        return;
+    }
+    m_hasPendingSample = false;
+
+    // Advance the ring; the new slot overwrites the oldest sample
+    m_head = (m_validCount == 0) ? 0 : (m_head + 1) % m_trailLength;
+    m_validCount = std::min(m_validCount + 1, m_trailLength);
+
+    VkDeviceSize sampleSize = sizeof(glm::vec4) * m_objectCount;
+    memcpy(m_stagingBuffers[frameIndex].mapped, m_pendingSample.data(), sampleSize);
+
+    // The previous frame may still be drawing the slot we are about to overwrite
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = 0;
+    copyRegion.dstOffset = sampleSize * m_head;
+    copyRegion.size = sampleSize;
+    vkCmdCopyBuffer(commandBuffer, m_stagingBuffers[frameIndex].buffer, m_ringBuffer.buffer, 1, &copyRegion);
+
+    // Make the new slot visible to the trail vertex shader
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void TrailRenderer::draw(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+                         VkExtent2D extent, bool smooth) {
+    if (m_objectCount == 0 || m_validCount < 2) {
+        return;
+    }
+
+    PushConstants pushConstants{};
+    pushConstants.viewProjection = viewProjection;
+    pushConstants.color = TRAIL_COLOR;
+    pushConstants.objectCount = m_objectCount;
+    pushConstants.trailLength = m_trailLength;
+    pushConstants.head = m_head;
+    pushConstants.validCount = m_validCount;
+    pushConstants.viewportSize = glm::vec2(static_cast<float>(extent.width), static_cast<float>(extent.height));
+    pushConstants.lineWidth = smooth ? SMOOTH_LINE_WIDTH : 1.0f;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, smooth ? m_smoothPipeline : m_linePipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout,
+                            0, 1, &m_descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(PushConstants), &pushConstants);
+
+    // One strip per object, sample k is the k-th newest; ribbons use two vertices per sample
+    uint32_t vertexCount = smooth ? m_validCount * 2 : m_validCount;
+    vkCmdDraw(commandBuffer, vertexCount, m_objectCount, 0, 0);
+}
+
+void TrailRenderer::recreatePipelines() {
+    VkDevice device = m_renderer->getDevice();
+
+    vkDestroyPipeline(device, m_smoothPipeline, nullptr);
+    vkDestroyPipeline(device, m_linePipeline, nullptr);
+    vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
+
+    createPipelines();
+}
+
+void TrailRenderer::createDescriptorResources() {
+    VkDevice device = m_renderer->getDevice();
+
+    VkDescriptorSetLayoutBinding ringBinding{};
+    ringBinding.binding = 0;
+    ringBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    ringBinding.descriptorCount = 1;
+    ringBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &ringBinding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create trail descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create trail descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate trail descriptor set!");
+    }
+}
+
+void TrailRenderer::createPipelines() {
+    VkDevice device = m_renderer->getDevice();
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create trail pipeline layout!");
+    }
+
+    VkShaderModule vertShaderModule = m_renderer->createShaderModule("shaders/trail_vert.spv");
+    VkShaderModule smoothVertShaderModule = m_renderer->createShaderModule("shaders/trail_smooth_vert.spv");
+    VkShaderModule fragShaderModule = m_renderer->createShaderModule("shaders/trail_frag.spv");
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "VSMain";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "PSMain";
+
+    // Positions come from the ring buffer
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = m_renderer->getMsaaSamples();
+
+    // Trails are occluded by the Earth but do not occlude each other
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_TRUE;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    std::array<VkDynamicState, 3> dynamicStates = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_LINE_WIDTH
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    m_renderer->setPipelineRenderTarget(pipelineInfo);
+
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_linePipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create trail pipeline!");
+    }
+
+    // Analytic antialiasing: screen-space ribbons with edge coverage in the pixel shader
+    shaderStages[0].module = smoothVertShaderModule;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_smoothPipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create smooth trail pipeline!");
+    }
+
+    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    vkDestroyShaderModule(device, smoothVertShaderModule, nullptr);
+    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+}
+
+void TrailRenderer::createRingBuffer() {
+    VkDevice device = m_renderer->getDevice();
+
+    // The ring may still be read by frames in flight
+    vkDeviceWaitIdle(device);
+
+    destroyBuffer(m_ringBuffer);
+    m_renderer->createBuffer(
+        sizeof(glm::vec4) * m_objectCapacity * m_trailLength,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_ringBuffer.buffer,
+        m_ringBuffer.memory
+    );
+
+    // One tick worth of positions per frame in flight
+    for (auto& staging : m_stagingBuffers) {
+        destroyBuffer(staging);
+        m_renderer->createBuffer(
+            sizeof(glm::vec4) * m_objectCapacity,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            staging.buffer,
+            staging.memory
+        );
+        vkMapMemory(device, staging.memory, 0, VK_WHOLE_SIZE, 0, &staging.mapped);
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = m_ringBuffer.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = m_descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+}
+
+void TrailRenderer::destroyBuffer(BufferResource& resource) {
+    if (resource.buffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkDevice device = m_renderer->getDevice();
+    if (resource.mapped) {
+        vkUnmapMemory(device, resource.memory);
+    }
+    vkDestroyBuffer(device, resource.buffer, nullptr);
+    vkFreeMemory(device, resource.memory, nullptr);
+    resource = BufferResource{};
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "vulkan/buffer_resource.h"
+#include "vulkan/renderer.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <array>
+
+/**
+ * Draws fading orbit-track trails behind the simulated objects.
+ *
+ * Past positions are kept on the GPU in a ring buffer of trailLength slots,
+ * each slot holding one position per object. Every simulation tick writes one
+ * slot with a single buffer copy; the CPU keeps no per-object history. All
+ * trails are drawn with one instanced line-strip draw (one instance per
+ * object), with alpha falling off towards the oldest sample.
+ *
+ * Memory is bounded by objectCount * trailLength * 16 bytes.
+ */
+class TrailRenderer {
+public:
+    /**
+     * Constructor creates the trail pipeline and an initial ring buffer.
+     *
+     * @param renderer Renderer that owns the device and render pass
+     * @param trailLength Number of past positions kept per object
+     */
+    TrailRenderer(Renderer* renderer, uint32_t trailLength);
+
+    /**
+     * Destructor cleans up Vulkan resources.
+     */
+    ~TrailRenderer();
+
+    /**
+     * Queues the positions of one simulation tick for the ring buffer.
+     * A change in object count restarts all trails.
+     *
+     * @param positions Object positions, one per object
+     */
+    void pushSample(const std::vector<glm::vec3>& positions);
+
+    /**
+     * Changes the number of samples kept per object. Restarts all trails.
+     * Must not be called while a frame is being recorded.
+     *
+     * @param trailLength New trail length in samples
+     */
+    void setTrailLength(uint32_t trailLength);
+
+    /**
+     * Gets the number of samples kept per object.
+     *
+     * @return Trail length in samples
+     */
+    uint32_t getTrailLength() const { return m_trailLength; }
+
+    /**
+     * Records the copy of the queued sample into the ring buffer.
+     * Must be recorded outside of a render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param frameIndex Index of the frame in flight
+     */
+    void recordUpload(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+    /**
+     * Records the instanced trail draw.
+     * Must be recorded inside the main render pass.
+     *
+     * @param commandBuffer Command buffer to record into
+     * @param viewProjection Combined view-projection matrix
+     * @param extent Size of the render target in pixels
+     * @param smooth True to draw analytically antialiased ribbons instead of hardware lines
+     */
+    void draw(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+              VkExtent2D extent, bool smooth);
+
+    /**
+     * Rebuilds the pipelines after the main render pass changed (e.g. its sample count).
+     */
+    void recreatePipelines();
+
+private:
+    Renderer* m_renderer;
+
+    // Push constants for the trail shaders
+    struct PushConstants {
+        glm::mat4 viewProjection;
+        glm::vec4 color;
+        uint32_t objectCount;
+        uint32_t trailLength;
+        uint32_t head;
+        uint32_t validCount;
+        glm::vec2 viewportSize;
+        float lineWidth;
+        float padding;
+    };
+
+    // Ring buffer layout is slot-major: ring[slot * objectCount + object]
+    BufferResource m_ringBuffer;
+    std::array<BufferResource, Renderer::MAX_FRAMES_IN_FLIGHT> m_stagingBuffers;
+    uint32_t m_objectCount;
+    uint32_t m_objectCapacity;
+    uint32_t m_trailLength;
+    uint32_t m_head;
+    uint32_t m_validCount;
+
+    // Latest tick waiting to be copied into the ring
+    std::vector<glm::vec4> m_pendingSample;
+    bool m_hasPendingSample;
+
+    VkDescriptorSetLayout m_descriptorSetLayout;
+    VkDescriptorPool m_descriptorPool;
+    VkDescriptorSet m_descriptorSet;
+    VkPipelineLayout m_pipelineLayout;
+    VkPipeline m_linePipeline;
+    VkPipeline m_smoothPipeline;
+
+    /**
+     * Creates the descriptor set layout, pool and set.
+     */
+    void createDescriptorResources();
+
+    /**
+     * Creates the line-strip and antialiased ribbon pipelines.
+     */
+    void createPipelines();
+
+    /**
+     * (Re)creates the ring and staging buffers for the current object count and trail length.
+     */
+    void createRingBuffer();
+
+    /**
+     * Destroys a buffer and frees its memory.
+     *
+     * @param resource Buffer to destroy
+     */
+    void destroyBuffer(BufferResource& resource);
+};
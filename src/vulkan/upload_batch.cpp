@@ -0,0 +1,77 @@
+#include "vulkan/upload_batch.h"
+#include "vulkan/renderer.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+// Staging offsets are kept 16-byte aligned so the CPU copies stay aligned
+static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+UploadBatch::UploadBatch(Renderer* renderer) : m_renderer(renderer), m_stagingSize(0) {}
+
+void UploadBatch::add(VkBuffer destination, VkDeviceSize destinationOffset, const void* source, VkDeviceSize size) {
+    if (size == 0) {
+        return;
+    }
+
+    m_regions.push_back({destination, destinationOffset, source, size, m_stagingSize});
+    m_stagingSize = (m_stagingSize + size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+}
+
+void UploadBatch::flush() {
+    if (m_regions.empty()) {
+        return;
+    }
+
+    VkDevice device = m_renderer->getDevice();
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingMemory;
+    m_renderer->createBuffer(
+        m_stagingSize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        stagingBuffer,
+        stagingMemory
+    );
+
+    void* mapped;
+    vkMapMemory(device, stagingMemory, 0, VK_WHOLE_SIZE, 0, &mapped);
+    for (const Region& region : m_regions) {
+        memcpy(static_cast<char*>(mapped) + region.stagingOffset, region.source, region.size);
+    }
+    vkUnmapMemory(device, stagingMemory);
+
+    // One vkCmdCopyBuffer per destination buffer, with all of its regions
+    auto byDestination = [](const Region& a, const Region& b) {
+        return std::less<VkBuffer>()(a.destination, b.destination);
+    };
+    std::stable_sort(m_regions.begin(), m_regions.end(), byDestination);
+
+    VkCommandBuffer commandBuffer = m_renderer->beginSingleTimeCommands();
+
+    std::vector<VkBufferCopy> copies;
+    for (size_t first = 0; first < m_regions.size();) {
+        size_t last = first;
+        copies.clear();
+        while (last < m_regions.size() && m_regions[last].destination == m_regions[first].destination) {
+            VkBufferCopy copy{};
+            copy.srcOffset = m_regions[last].stagingOffset;
+            copy.dstOffset = m_regions[last].destinationOffset;
+            copy.size = m_regions[last].size;
+            copies.push_back(copy);
+            last++;
+        }
+        vkCmdCopyBuffer(commandBuffer, stagingBuffer, m_regions[first].destination,
+                        static_cast<uint32_t>(copies.size()), copies.data());
+        first = last;
+    }
+
+    m_renderer->endSingleTimeCommands(commandBuffer);
+
+    vkDestroyBuffer(device, stagingBuffer, nullptr);
+    vkFreeMemory(device, stagingMemory, nullptr);
+
+    m_regions.clear();
+    m_stagingSize = 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+// Forward declarations
+class Renderer;
+
+/**
+ * Collects static data destined for device-local buffers and uploads all of it
+ * through one staging buffer and one queue submission.
+ *
+ * Sources are only read during flush(), so they can point straight into
+ * memory-mapped files: each byte is copied once by the CPU, from the mapping into
+ * the staging buffer, and once by the GPU. Uploading several buffers (or several
+ * models) then costs one staging allocation and one wait instead of one per buffer.
+ */
+class UploadBatch {
+public:
+    /**
+     * @param renderer Renderer that owns the device and the command pool
+     */
+    explicit UploadBatch(Renderer* renderer);
+
+    /**
+     * Queues a copy into a buffer created with VK_BUFFER_USAGE_TRANSFER_DST_BIT.
+     *
+     * @param destination Buffer to fill
+     * @param destinationOffset Offset in the buffer, in bytes
+     * @param source Data, which must stay valid until flush()
+     * @param size Size in bytes
+     */
+    void add(VkBuffer destination, VkDeviceSize destinationOffset, const void* source, VkDeviceSize size);
+
+    /**
+     * Copies every queued region to its buffer and waits for the transfer to finish.
+     * Does nothing if nothing is queued.
+     */
+    void flush();
+
+    /**
+     * Gets the number of bytes waiting for flush().
+     *
+     * @return Queued size in bytes
+     */
+    VkDeviceSize getPendingBytes() const { return m_stagingSize; }
+
+private:
+    Renderer* m_renderer;
+
+    struct Region {
+        VkBuffer destination;
+        VkDeviceSize destinationOffset;
+        const void* source;
+        VkDeviceSize size;
+        VkDeviceSize stagingOffset;
+    };
+
+    std::vector<Region> m_regions;
+    VkDeviceSize m_stagingSize;
+};